@@ -158,6 +158,14 @@ typedef struct
 	DeliveryVector	*vector;
 } MsgRule;
 
+/*	Each of the SAP's MsgRule lists is indexed by subject: the
+ *	index entry for a subject points to the first rule for that
+ *	subject in the list, if any.  Subject numbers are offset by
+ *	MAX_CONTIN_NBR to accommodate the negative pseudo-subject
+ *	numbers of message spaces.					*/
+
+#define	RULE_INDEX_SIZE	(MAX_CONTIN_NBR + 1 + MAX_SUBJ_NBR)
+
 /*	*	*	Service Access Point	*	*	*	*/
 
 typedef enum
@@ -188,6 +196,8 @@ typedef struct amssapst
 	Lyst		delivVectors;		/*	(D...Vector *)	*/
 	Lyst		subscriptions;		/*	(MsgRule *)	*/
 	Lyst		invitations;		/*	(MsgRule *)	*/
+	LystElt		subscriptionsIndex[RULE_INDEX_SIZE];
+	LystElt		invitationsIndex[RULE_INDEX_SIZE];
 
 	pthread_t	heartbeatThread;
 	int		haveHeartbeatThread;
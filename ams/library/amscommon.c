@@ -175,6 +175,30 @@ static void	eraseModule(Module *module)
 	MRELEASE(module);
 }
 
+static void	noteUnitContainment(Venture *venture)
+{
+	int	i;
+	Unit	*unit;
+	Unit	*container;
+
+	for (i = 0; i <= MAX_UNIT_NBR; i++)
+	{
+		unit = venture->units[i];
+		if (unit == NULL)
+		{
+			continue;
+		}
+
+		memset(unit->containers, 0, UNIT_BITSET_LEN);
+		for (container = unit; container;
+				container = container->superunit)
+		{
+			unit->containers[container->nbr >> 3]
+					|= (1 << (container->nbr & 7));
+		}
+	}
+}
+
 void	eraseUnit(Venture *venture, Unit *unit)
 {
 	Cell	*cell;
@@ -243,6 +267,7 @@ void	eraseUnit(Venture *venture, Unit *unit)
 
 	venture->units[unit->nbr] = NULL;
 	MRELEASE(unit);
+	noteUnitContainment(venture);
 }
 
 void	eraseVenture(Venture *venture)
@@ -423,6 +448,9 @@ extern void		vmqtsLoadTs(TransSvc *ts);
 #ifdef TCPTS
 extern void		tcptsLoadTs(TransSvc *ts);
 #endif
+#ifdef SHMTS
+extern void		shmtsLoadTs(TransSvc *ts);
+#endif
 
 static void	addTs(AmsMib *mib, TsLoadFn loadTs)
 {
@@ -463,7 +491,10 @@ static int	initializeMib(AmsMib *mib, int continuumNbr, char *ptsName,
 					vmqtsLoadTs,
 #endif
 #ifdef TCPTS
-					tcptsLoadTs
+					tcptsLoadTs,
+#endif
+#ifdef SHMTS
+					shmtsLoadTs	/*	Opt-in only.	*/
 #endif
 				};
 
@@ -1551,6 +1582,7 @@ static Unit	*initializeUnit(Venture *venture, int nbr, char *name,
 
 	unit->subunits = subunits;
 	venture->units[nbr] = unit;
+	noteUnitContainment(venture);
 	return unit;
 }
 
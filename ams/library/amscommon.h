@@ -337,7 +337,13 @@ typedef struct
 } Cell;
 
 /*	Unit encapsulates information about one organizational unit
- *	of a venture.							*/
+ *	of a venture.  The containers bitset has the bit for the
+ *	unit's own number set, together with the bits for the numbers
+ *	of all of its superunits, so that unit containment can be
+ *	tested without walking the unit hierarchy; it is recomputed
+ *	for all units whenever any unit is created or erased.		*/
+
+#define	UNIT_BITSET_LEN	((MAX_UNIT_NBR >> 3) + 1)
 
 typedef struct unit_str
 {
@@ -346,6 +352,7 @@ typedef struct unit_str
 	struct unit_str	*superunit;		/*	Parent unit.	*/
 	LystElt		inclusionElt;		/*	In superunit.	*/
 	Lyst		subunits;		/*	(Unit *)	*/
+	unsigned char	containers[UNIT_BITSET_LEN];
 
 	/*	The cellData of the unit encapsulates information
 	 *	about the portion of this unit that is within the
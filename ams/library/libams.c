@@ -429,23 +429,40 @@ static int	subunitOf(AmsSAP *sap, int argUnitNbr, int refUnitNbr)
 {
 	Unit	*argUnit;
 
+	if (argUnitNbr < 0 || argUnitNbr > MAX_UNIT_NBR
+	|| refUnitNbr < 0 || refUnitNbr > MAX_UNIT_NBR)
+	{
+		return 0;
+	}
+
 	argUnit = sap->venture->units[argUnitNbr];
-	while (argUnit)
+	if (argUnit == NULL)
 	{
-		if (argUnit->nbr == refUnitNbr)
-		{
-			return 1;
-		}
+		return 0;
+	}
+
+	return (argUnit->containers[refUnitNbr >> 3] & (1 << (refUnitNbr & 7)))
+			!= 0;
+}
 
-		argUnit = argUnit->superunit;
+static LystElt	*ruleIndexEntry(AmsSAP *sap, Lyst rules, int subjectNbr)
+{
+	LystElt	*index;
+
+	if (subjectNbr < 0 - MAX_CONTIN_NBR || subjectNbr > MAX_SUBJ_NBR)
+	{
+		return NULL;
 	}
 
-	return 0;
+	index = (rules == sap->subscriptions ?
+			sap->subscriptionsIndex : sap->invitationsIndex);
+	return index + (subjectNbr + MAX_CONTIN_NBR);
 }
 
 static LystElt	getMsgRule(AmsSAP *sap, Lyst rules, int subjectNbr, int roleNbr,
 			int continuumNbr, int unitNbr)
 {
+	LystElt	*entry;
 	LystElt	elt;
 	MsgRule	*rule;
 
@@ -453,25 +470,20 @@ static LystElt	getMsgRule(AmsSAP *sap, Lyst rules, int subjectNbr, int roleNbr,
 	 *	subject, role, continuum, unit, if any.  It is NOT used
 	 *	for determining the insertion point of a new MsgRule.	*/
 
-	for (elt = lyst_first(rules); elt; elt = lyst_next(elt))
+	entry = ruleIndexEntry(sap, rules, subjectNbr);
+	if (entry == NULL)
 	{
-		rule = (MsgRule *) lyst_data(elt);
-
-		/*	MsgRules are ordered by ascending subject
-		 *	number.						*/
-
-		if (rule->subject->nbr < subjectNbr)
-		{
-			continue;
-		}
+		return NULL;
+	}
 
-		if (rule->subject->nbr > subjectNbr)
+	for (elt = *entry; elt; elt = lyst_next(elt))
+	{
+		rule = (MsgRule *) lyst_data(elt);
+		if (rule->subject->nbr != subjectNbr)
 		{
-			break;		/*	Same as end of list.	*/
+			break;		/*	No more for subject.	*/
 		}
 
-		/*	Found a MsgRule for this subject.		*/
-
 		if (rule->roleNbr != roleNbr && rule->roleNbr != 0)
 		{
 			continue;	/*	Keep looking.		*/
@@ -4569,6 +4581,8 @@ static LystElt	findMsgRule(AmsSAP *sap, Lyst rules, int subjectNbr,
 			int roleNbr, int continuumNbr, int unitNbr,
 			LystElt *nextRule)
 {
+	LystElt	*entry;
+	LystElt	*last;
 	LystElt	elt;
 	MsgRule	*rule;
 
@@ -4576,15 +4590,39 @@ static LystElt	findMsgRule(AmsSAP *sap, Lyst rules, int subjectNbr,
 		specified subject, role, continuum, unit, if any.	*/
 
 	if (nextRule) *nextRule = NULL;	/*	Default.		*/
-	for (elt = lyst_first(rules); elt; elt = lyst_next(elt))
+	entry = ruleIndexEntry(sap, rules, subjectNbr);
+	if (entry == NULL)
 	{
-		rule = (MsgRule *) lyst_data(elt);
-		if (rule->subject->nbr < subjectNbr)
+		return NULL;
+	}
+
+	if (*entry == NULL)
+	{
+		/*	No rules for this subject.  Any new rule must
+		 *	be inserted before the first rule for the next
+		 *	higher-numbered subject, if any.		*/
+
+		if (nextRule)
 		{
-			continue;
+			last = ruleIndexEntry(sap, rules, MAX_SUBJ_NBR);
+			while (entry < last)
+			{
+				entry++;
+				if (*entry)
+				{
+					*nextRule = *entry;
+					break;
+				}
+			}
 		}
 
-		if (rule->subject->nbr > subjectNbr)
+		return NULL;
+	}
+
+	for (elt = *entry; elt; elt = lyst_next(elt))
+	{
+		rule = (MsgRule *) lyst_data(elt);
+		if (rule->subject->nbr != subjectNbr)
 		{
 			if (nextRule) *nextRule = elt;
 			break;		/*	Same as end of list.	*/
@@ -4652,6 +4690,7 @@ static int	addMsgRule(AmsSAP *sap, int ruleType, Subject *subject,
 	LystElt	elt;
 	LystElt	nextRule;
 	MsgRule	*rule;
+	LystElt	*entry;
 
 	*ruleElt = NULL;
 	rules = (ruleType == SUBSCRIPTION ?
@@ -4691,6 +4730,12 @@ static int	addMsgRule(AmsSAP *sap, int ruleType, Subject *subject,
 		return -1;
 	}
 
+	entry = ruleIndexEntry(sap, rules, subject->nbr);
+	if (*entry == NULL || *entry == nextRule)
+	{
+		*entry = elt;	/*	New first rule for subject.	*/
+	}
+
 	*ruleElt = elt;
 	return 0;
 }
@@ -4800,6 +4845,8 @@ static int	removeMsgRule(AmsSAP *sap, int ruleType, Subject *subject,
 {
 	Lyst	rules;
 	LystElt	elt;
+	LystElt	*entry;
+	LystElt	nextElt;
 
 	rules = (ruleType == SUBSCRIPTION ?
 			sap->subscriptions : sap->invitations);
@@ -4811,6 +4858,21 @@ static int	removeMsgRule(AmsSAP *sap, int ruleType, Subject *subject,
 		return -1;
 	}
 
+	entry = ruleIndexEntry(sap, rules, subject->nbr);
+	if (*entry == elt)
+	{
+		nextElt = lyst_next(elt);
+		if (nextElt && ((MsgRule *) lyst_data(nextElt))->subject->nbr
+				== subject->nbr)
+		{
+			*entry = nextElt;
+		}
+		else
+		{
+			*entry = NULL;
+		}
+	}
+
 	lyst_delete(elt);
 	return 0;
 }
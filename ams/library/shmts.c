@@ -0,0 +1,752 @@
+/*
+	shmts.c:	functions implementing shared-memory transport
+			service for AMS modules that are attached to
+			the same ION node.
+
+	Copyright (c) 2006, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+									*/
+#if defined (SHMTS)
+
+#include "amsP.h"
+
+#define	SHMTS_MAX_MSG_LEN	65535
+
+#ifndef SHMTS_RING_SLOTS
+#define	SHMTS_RING_SLOTS	(256)
+#endif
+
+#ifndef SHMTS_SLOT_DATA
+#define	SHMTS_SLOT_DATA		(224)
+#endif
+
+#ifndef SHMTS_FULL_YIELDS
+#define	SHMTS_FULL_YIELDS	(64)
+#endif
+
+#ifndef SHMTS_FULL_SNOOZE
+#define	SHMTS_FULL_SNOOZE	(100)	/*	Microseconds.		*/
+#endif
+
+#ifndef SHMTS_FULL_TIMEOUT
+#define	SHMTS_FULL_TIMEOUT	(5)	/*	Seconds.		*/
+#endif
+
+#ifndef SHMTS_CLAIM_TIMEOUT
+#define	SHMTS_CLAIM_TIMEOUT	(5)	/*	Seconds.		*/
+#endif
+
+#define	SHMTS_POOL_NAME		"shmtsPool"
+
+/*	Each AMS endpoint of this transport service is a receive
+ *	ring in ION working memory.  Any number of modules may
+ *	post messages to the ring (a bounded multi-producer queue
+ *	of fixed-size slots, each stamped with a sequence number
+ *	that tells whose turn it is to use the slot), but only the
+ *	module that owns the ring takes messages from it.  Small
+ *	messages are composed in place in the slots; larger ones
+ *	are composed in ION working memory and the slot carries
+ *	the address.  A producer gives the ring's semaphore only
+ *	when the receiver has announced that it is about to block,
+ *	so a busy receiver is never woken by system calls.
+ *
+ *	A sender waits at most SHMTS_FULL_TIMEOUT seconds for room
+ *	in a full ring.  A sender that claims a slot records its
+ *	process ID in the slot; if the receiver finds the slot at
+ *	the head of the ring claimed but not published and the
+ *	sender no longer exists -- or, if the sender had not yet
+ *	recorded its process ID, after SHMTS_CLAIM_TIMEOUT seconds
+ *	-- the receiver skips the slot.  Slots are published and
+ *	skipped by compare-and-swap on the slot's sequence number,
+ *	so a sender whose slot has been skipped fails the send.
+ *
+ *	A sender may retain the address of a ring long after the
+ *	owning module has unregistered, so rings are never freed;
+ *	they are returned to a pool for reuse instead.  The ring's
+ *	nonce, which is part of the endpoint name, identifies the
+ *	ring's current incarnation: messages from senders holding
+ *	a stale endpoint name are discarded.				*/
+
+typedef struct
+{
+	volatile unsigned long	seqNbr;
+	volatile unsigned long	claimedPos;	/*	By senderPid.	*/
+	volatile int		senderPid;
+	unsigned long		nonce;
+	PsmAddress		overflow;
+	int			length;
+	char			data[SHMTS_SLOT_DATA];
+} ShmSlot;
+
+typedef struct
+{
+	volatile unsigned long	nonce;		/*	0 if closed.	*/
+	volatile int		ownerPid;
+	volatile int		receiverWaiting;
+	sm_SemId		wakeup;
+	volatile unsigned long	enqueuePos;
+	volatile unsigned long	dequeuePos;
+	ShmSlot			slots[SHMTS_RING_SLOTS];
+} ShmRing;
+
+typedef struct
+{
+	unsigned long		lastNonce;
+	PsmAddress		freeRings;	/*	SmList of rings	*/
+} ShmPool;
+
+typedef struct
+{
+	PsmAddress		ringAddr;
+	unsigned long		nonce;
+} ShmSap;
+
+typedef struct
+{
+	ShmRing			*ring;
+	unsigned long		nonce;
+} ShmTsep;
+
+typedef struct
+{
+	unsigned long		pos;		/*	Stalled slot.	*/
+	time_t			since;
+} ShmStall;
+
+/*	*	*	*	MAMS stuff	*	*	*	*/
+
+/*	Shared memory is not suitable as a primary transport service:
+ *	as for VMQ, the endpoint ID for the configuration server
+ *	can't be known before the endpoint is created, so it can't
+ *	be advertised in the MIB to registrars and modules.		*/
+
+static int	shmComputeCsepName(char *endpointSpec, char *endpointName)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+	return -1;
+}
+
+static int	shmMamsInit(MamsInterface *tsif)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+	return -1;
+}
+
+static void	*shmMamsReceiver(void *parm)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+	return NULL;
+}
+
+static int	shmParseMamsEndpoint(MamsEndpoint *ep)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+	return -1;
+}
+
+static void	shmClearMamsEndpoint(MamsEndpoint *ep)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+}
+
+static int	shmSendMams(MamsEndpoint *ep, MamsInterface *tsif, char *msg,
+			int msgLen)
+{
+	putErrmsg("Sorry, no PTS support implemented in shmts.", NULL);
+	return -1;
+}
+
+/*	*	*	*	Ring management	*	*	*	*/
+
+static ShmPool	*getShmPool(PsmPartition wm)
+{
+	PsmAddress	poolAddr;
+	PsmAddress	elt;
+	ShmPool		*pool;
+
+	/*	Must be called while ION working memory is locked.	*/
+
+	if (psm_locate(wm, SHMTS_POOL_NAME, &poolAddr, &elt) < 0)
+	{
+		putErrmsg("Failed searching for shmts ring pool.", NULL);
+		return NULL;
+	}
+
+	if (elt)
+	{
+		return (ShmPool *) psp(wm, poolAddr);
+	}
+
+	poolAddr = psm_zalloc(wm, sizeof(ShmPool));
+	if (poolAddr == 0)
+	{
+		putErrmsg("No space for shmts ring pool.", NULL);
+		return NULL;
+	}
+
+	pool = (ShmPool *) psp(wm, poolAddr);
+	pool->lastNonce = 0;
+	pool->freeRings = sm_list_create(wm);
+	if (pool->freeRings == 0
+	|| psm_catlg(wm, SHMTS_POOL_NAME, poolAddr) < 0)
+	{
+		putErrmsg("Can't create shmts ring pool.", NULL);
+		if (pool->freeRings)
+		{
+			sm_list_destroy(wm, pool->freeRings, NULL, NULL);
+		}
+
+		psm_free(wm, poolAddr);
+		return NULL;
+	}
+
+	return pool;
+}
+
+static PsmAddress	openRing(unsigned long *nonce)
+{
+	PsmPartition	wm = getIonwm();
+	Sdr		sdr = getIonsdr();
+	ShmPool		*pool;
+	PsmAddress	elt;
+	PsmAddress	ringAddr = 0;
+	ShmRing		*ring;
+	int		i;
+
+	CHKZERO(sdr_begin_xn(sdr));	/*	To lock memory.		*/
+	pool = getShmPool(wm);
+	if (pool == NULL)
+	{
+		sdr_exit_xn(sdr);
+		return 0;
+	}
+
+	elt = sm_list_first(wm, pool->freeRings);
+	if (elt)
+	{
+		/*	Reuse a ring that was abandoned by a module
+		 *	that has since unregistered.  The ring's
+		 *	positions carry on from where its last owner
+		 *	left off, so that a stale sender that is
+		 *	part-way through posting a message can't
+		 *	corrupt the ring.				*/
+
+		ringAddr = sm_list_data(wm, elt);
+		oK(sm_list_delete(wm, elt, NULL, NULL));
+		ring = (ShmRing *) psp(wm, ringAddr);
+		sm_SemUnend(ring->wakeup);
+	}
+	else
+	{
+		ringAddr = psm_zalloc(wm, sizeof(ShmRing));
+		if (ringAddr == 0)
+		{
+			putErrmsg("No space for shmts ring.", NULL);
+			sdr_exit_xn(sdr);
+			return 0;
+		}
+
+		ring = (ShmRing *) psp(wm, ringAddr);
+		memset((char *) ring, 0, sizeof(ShmRing));
+		ring->wakeup = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		if (ring->wakeup == SM_SEM_NONE)
+		{
+			putErrmsg("Can't create shmts ring semaphore.", NULL);
+			psm_free(wm, ringAddr);
+			sdr_exit_xn(sdr);
+			return 0;
+		}
+
+		sm_SemTake(ring->wakeup);	/*	Lock.		*/
+		for (i = 0; i < SHMTS_RING_SLOTS; i++)
+		{
+			ring->slots[i].seqNbr = i;
+			ring->slots[i].claimedPos = (unsigned long) -1;
+		}
+	}
+
+	pool->lastNonce++;
+	if (pool->lastNonce == 0)
+	{
+		pool->lastNonce++;
+	}
+
+	*nonce = pool->lastNonce;
+	ring->ownerPid = sm_TaskIdSelf();
+	ring->receiverWaiting = 0;
+	__sync_synchronize();
+	ring->nonce = *nonce;
+	sdr_exit_xn(sdr);
+	return ringAddr;
+}
+
+static void	closeRing(PsmAddress ringAddr)
+{
+	PsmPartition	wm = getIonwm();
+	Sdr		sdr = getIonsdr();
+	ShmPool		*pool;
+
+	if (sdr_begin_xn(sdr) == 0)	/*	To lock memory.		*/
+	{
+		return;
+	}
+
+	pool = getShmPool(wm);
+	if (pool == NULL
+	|| sm_list_insert_last(wm, pool->freeRings, ringAddr) == 0)
+	{
+		putErrmsg("Can't return shmts ring to pool.", NULL);
+	}
+
+	sdr_exit_xn(sdr);
+}
+
+static void	releaseSlot(ShmRing *ring, ShmSlot *slot)
+{
+	if (slot->overflow)
+	{
+		MRELEASE(ionMemAtoP(slot->overflow));
+		slot->overflow = 0;
+	}
+
+	__sync_synchronize();
+	slot->seqNbr = ring->dequeuePos + SHMTS_RING_SLOTS;
+	ring->dequeuePos++;
+}
+
+static int	claimIsStale(ShmRing *ring, ShmSlot *slot, ShmStall *stall)
+{
+	unsigned long	pos = ring->dequeuePos;
+
+	/*	The slot at the head of the ring has been claimed by
+	 *	a sender but not yet published.  It is stale if the
+	 *	sender is known to be gone or, if the sender never
+	 *	recorded its claim, if it has stalled for too long.	*/
+
+	if (slot->claimedPos == pos)
+	{
+		__sync_synchronize();
+		return (!sm_TaskExists(slot->senderPid));
+	}
+
+	if (stall->pos != pos)
+	{
+		stall->pos = pos;
+		stall->since = time(NULL);
+		return 0;
+	}
+
+	return (time(NULL) - stall->since >= SHMTS_CLAIM_TIMEOUT);
+}
+
+static void	skipSlot(ShmRing *ring, ShmSlot *slot)
+{
+	unsigned long	pos = ring->dequeuePos;
+
+	if (!__sync_bool_compare_and_swap(&(slot->seqNbr), pos,
+			pos + SHMTS_RING_SLOTS))
+	{
+		return;		/*	Published after all.		*/
+	}
+
+	/*	An overflow buffer the sender may have attached is not
+	 *	ours to release: it may still belong to the sender.	*/
+
+	slot->overflow = 0;
+	ring->dequeuePos++;
+	writeMemo("[?] shmts skipped a slot abandoned by its sender.");
+}
+
+/*	*	*	*	AMS stuff	*	*	*	*/
+
+static int	shmAmsInit(AmsInterface *tsif, char *epspec)
+{
+	ShmSap		*shmSap;
+	char		endpointNameText[64];
+	int		eptLen;
+
+	CHKERR(tsif);
+	CHKERR(epspec);
+	shmSap = (ShmSap *) MTAKE(sizeof(ShmSap));
+	CHKERR(shmSap);
+	shmSap->ringAddr = openRing(&shmSap->nonce);
+	if (shmSap->ringAddr == 0)
+	{
+		MRELEASE(shmSap);
+		putErrmsg("shmts can't open AMS SAP", NULL);
+		return -1;
+	}
+
+	tsif->diligence = AmsAssured;
+	tsif->sequence = AmsTransmissionOrder;
+	isprintf(endpointNameText, sizeof endpointNameText, "%lu:%lu",
+			(unsigned long) (shmSap->ringAddr), shmSap->nonce);
+	eptLen = strlen(endpointNameText) + 1;
+	tsif->ept = MTAKE(eptLen);
+	if (tsif->ept == NULL)
+	{
+		((ShmRing *) psp(getIonwm(), shmSap->ringAddr))->nonce = 0;
+		closeRing(shmSap->ringAddr);
+		MRELEASE(shmSap);
+		putErrmsg("Can't record endpoint name.", NULL);
+		return -1;
+	}
+
+	istrcpy(tsif->ept, endpointNameText, eptLen);
+	tsif->sap = shmSap;
+	return 0;
+}
+
+static void	*shmAmsReceiver(void *parm)
+{
+	AmsInterface	*tsif = (AmsInterface *) parm;
+	ShmSap		*shmSap;
+	ShmRing		*ring;
+	AmsSAP		*amsSap;
+	ShmSlot		*slot;
+	char		*msg;
+	ShmStall	stall = { (unsigned long) -1, 0 };
+	sigset_t	signals;
+
+	CHKNULL(tsif);
+	shmSap = (ShmSap *) (tsif->sap);
+	CHKNULL(shmSap);
+	amsSap = tsif->amsSap;
+	CHKNULL(amsSap);
+	ring = (ShmRing *) psp(getIonwm(), shmSap->ringAddr);
+	sigfillset(&signals);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+	while (ring->nonce == shmSap->nonce)
+	{
+		slot = ring->slots + (ring->dequeuePos % SHMTS_RING_SLOTS);
+		if (slot->seqNbr != ring->dequeuePos + 1)
+		{
+			if (ring->enqueuePos != ring->dequeuePos)
+			{
+				/*	Slot is claimed but unpublished:
+				 *	wait for it, unless the sender
+				 *	has abandoned it.		*/
+
+				if (claimIsStale(ring, slot, &stall))
+				{
+					skipSlot(ring, slot);
+				}
+				else
+				{
+					microsnooze(SHMTS_FULL_SNOOZE);
+				}
+
+				continue;
+			}
+
+			/*	Ring is empty.  Announce that we are
+			 *	about to block, then look once more
+			 *	in case a message was posted before
+			 *	the announcement was visible.		*/
+
+			ring->receiverWaiting = 1;
+			__sync_synchronize();
+			if (slot->seqNbr == ring->dequeuePos + 1)
+			{
+				ring->receiverWaiting = 0;
+				continue;
+			}
+
+			if (sm_SemTake(ring->wakeup) < 0
+			|| sm_SemEnded(ring->wakeup))
+			{
+				ring->receiverWaiting = 0;
+				break;
+			}
+
+			ring->receiverWaiting = 0;
+			continue;
+		}
+
+		/*	Got an AMS message.				*/
+
+		__sync_synchronize();
+		if (slot->nonce == shmSap->nonce)
+		{
+			if (slot->overflow)
+			{
+				msg = (char *) ionMemAtoP(slot->overflow);
+			}
+			else
+			{
+				msg = slot->data;
+			}
+
+			if (enqueueAmsMsg(amsSap, (unsigned char *) msg,
+					slot->length) < 0)
+			{
+				writeMemo("[?] shmts discarded AMS message.");
+			}
+		}
+
+		releaseSlot(ring, slot);
+	}
+
+	/*	Discard all messages remaining in the ring, then
+	 *	return the ring to the pool.				*/
+
+	while (1)
+	{
+		slot = ring->slots + (ring->dequeuePos % SHMTS_RING_SLOTS);
+		if (slot->seqNbr != ring->dequeuePos + 1)
+		{
+			break;
+		}
+
+		__sync_synchronize();
+		releaseSlot(ring, slot);
+	}
+
+	closeRing(shmSap->ringAddr);
+	MRELEASE(shmSap);
+	tsif->sap = NULL;
+	return NULL;
+}
+
+static int	shmParseAmsEndpoint(AmsEndpoint *dp)
+{
+	unsigned long	ringAddr;
+	unsigned long	nonce;
+	ShmTsep		tsep;
+
+	CHKERR(dp);
+	CHKERR(dp->ept);
+	if (sscanf(dp->ept, "%lu:%lu", &ringAddr, &nonce) != 2
+	|| ringAddr == 0 || nonce == 0)
+	{
+		putErrmsg("shmts found AMS endpoint name invalid.", dp->ept);
+		return -1;
+	}
+
+	tsep.ring = (ShmRing *) psp(getIonwm(), (PsmAddress) ringAddr);
+	tsep.nonce = nonce;
+	dp->tsep = MTAKE(sizeof(ShmTsep));
+	CHKERR(dp->tsep);
+	memcpy((char *) (dp->tsep), (char *) &tsep, sizeof(ShmTsep));
+
+	/*	Also parse out the service mode of this endpoint.	*/
+
+	dp->diligence = AmsAssured;
+	dp->sequence = AmsTransmissionOrder;
+	return 0;
+}
+
+static void	shmClearAmsEndpoint(AmsEndpoint *dp)
+{
+	CHKVOID(dp);
+	if (dp->tsep)
+	{
+		MRELEASE(dp->tsep);
+	}
+}
+
+static int	shmSendAms(AmsEndpoint *dp, AmsSAP *sap,
+			unsigned char flowLabel, char *header,
+			int headerLen, char *content, int contentLen)
+{
+	int		len;
+	ShmTsep		*tsep;
+	ShmRing		*ring;
+	char		*shmAmsBuf = NULL;
+	ShmSlot		*slot;
+	unsigned long	pos;
+	long		diff;
+	int		yields = 0;
+	time_t		deadline = 0;
+	char		*buf;
+	unsigned short	checksum;
+
+	CHKERR(dp);
+	CHKERR(sap);
+	CHKERR(header);
+	CHKERR(headerLen >= 0);
+	CHKERR(contentLen == 0 || (contentLen > 0 && content != NULL));
+	len = headerLen + contentLen + 2;
+	CHKERR(len <= SHMTS_MAX_MSG_LEN);
+	tsep = (ShmTsep *) (dp->tsep);
+	if (tsep == NULL)	/*	Lost connectivity to endpoint.	*/
+	{
+		return 0;
+	}
+
+	ring = tsep->ring;
+	if (ring->nonce != tsep->nonce)
+	{
+		return 0;	/*	Receiver has unregistered.	*/
+	}
+
+	if (len > SHMTS_SLOT_DATA)
+	{
+		shmAmsBuf = MTAKE(len);
+		CHKERR(shmAmsBuf);
+	}
+
+	/*	Claim the next slot in the ring.  If the ring is full,
+	 *	wait for the receiver to drain it: delivery is assured,
+	 *	unless the receiving module is gone or the ring stays
+	 *	full for SHMTS_FULL_TIMEOUT seconds.			*/
+
+	pos = ring->enqueuePos;
+	while (1)
+	{
+		slot = ring->slots + (pos % SHMTS_RING_SLOTS);
+		diff = (long) (slot->seqNbr - pos);
+		if (diff == 0)
+		{
+			if (__sync_bool_compare_and_swap(&(ring->enqueuePos),
+					pos, pos + 1))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)	/*	Ring is full.		*/
+		{
+			if (ring->nonce != tsep->nonce
+			|| !sm_TaskExists(ring->ownerPid))
+			{
+				if (shmAmsBuf)
+				{
+					MRELEASE(shmAmsBuf);
+				}
+
+				return 0;
+			}
+
+			if (deadline == 0)
+			{
+				deadline = time(NULL) + SHMTS_FULL_TIMEOUT;
+			}
+			else if (time(NULL) > deadline)
+			{
+				if (shmAmsBuf)
+				{
+					MRELEASE(shmAmsBuf);
+				}
+
+				putErrmsg("shmts ring is full.", dp->ept);
+				return -1;
+			}
+
+			/*	Let the receiver run; if it doesn't
+			 *	drain the ring promptly, back off.	*/
+
+			if (yields < SHMTS_FULL_YIELDS)
+			{
+				yields++;
+				sm_TaskYield();
+			}
+			else
+			{
+				microsnooze(SHMTS_FULL_SNOOZE);
+			}
+		}
+
+		pos = ring->enqueuePos;
+	}
+
+	/*	Record the claim, so that the receiver can skip the
+	 *	slot if this task dies before publishing it.		*/
+
+	slot->senderPid = sm_TaskIdSelf();
+	__sync_synchronize();
+	slot->claimedPos = pos;
+
+	/*	Compose the message in the claimed slot.		*/
+
+	buf = shmAmsBuf ? shmAmsBuf : slot->data;
+	memcpy(buf, header, headerLen);
+	if (contentLen > 0)
+	{
+		memcpy(buf + headerLen, content, contentLen);
+	}
+
+	checksum = computeAmsChecksum((unsigned char *) buf,
+			headerLen + contentLen);
+	checksum = htons(checksum);
+	memcpy(buf + headerLen + contentLen, (char *) &checksum, 2);
+	slot->overflow = shmAmsBuf ? ionMemPtoA(shmAmsBuf) : 0;
+	slot->length = len;
+	slot->nonce = tsep->nonce;
+
+	/*	Publish the slot, then wake the receiver if it has
+	 *	announced that it is blocking.				*/
+
+	if (!__sync_bool_compare_and_swap(&(slot->seqNbr), pos, pos + 1))
+	{
+		if (shmAmsBuf)
+		{
+			MRELEASE(shmAmsBuf);
+		}
+
+		putErrmsg("shmts receiver skipped stalled message.", dp->ept);
+		return -1;
+	}
+
+	__sync_synchronize();
+	if (ring->receiverWaiting)
+	{
+		sm_SemGive(ring->wakeup);
+	}
+
+#if AMSDEBUG
+PUTS("shmSendAms succeeded.");
+#endif
+	return 0;
+}
+
+static void	shmShutdown(void *sap)
+{
+	ShmSap		*shmSap = (ShmSap *) sap;
+	ShmRing		*ring;
+
+	CHKVOID(sap);
+	ring = (ShmRing *) psp(getIonwm(), shmSap->ringAddr);
+
+	/*	The receiver thread discards any remaining messages
+	 *	and returns the ring to the pool.			*/
+
+	ring->nonce = 0;
+	__sync_synchronize();
+	sm_SemEnd(ring->wakeup);
+}
+
+void	shmtsLoadTs(TransSvc *ts)
+{
+	char		ownHostName[MAXHOSTNAMELEN + 1];
+	unsigned int	ipAddress;
+	static char	shmName[48];
+
+	/*	NOTE: shared-memory endpoints are rings in ION working
+	 *	memory, so they are meaningful only to modules that
+	 *	are attached to the same ION node on the same host.
+	 *	The transport service name is qualified by the host's
+	 *	IP address and the ION node number, so that modules
+	 *	elsewhere never select these endpoints.			*/
+
+	CHKVOID(ts);
+	getNameOfHost(ownHostName, sizeof ownHostName);
+	ipAddress = getInternetAddress(ownHostName);
+	isprintf(shmName, sizeof shmName, "shm%u." UVAST_FIELDSPEC,
+			ipAddress, getOwnNodeNbr());
+	ts->name = shmName;
+	ts->csepNameFn = shmComputeCsepName;
+	ts->mamsInitFn = shmMamsInit;
+	ts->mamsReceiverFn = shmMamsReceiver;
+	ts->parseMamsEndpointFn = shmParseMamsEndpoint;
+	ts->clearMamsEndpointFn = shmClearMamsEndpoint;
+	ts->sendMamsFn = shmSendMams;
+	ts->amsInitFn = shmAmsInit;
+	ts->amsReceiverFn = shmAmsReceiver;
+	ts->parseAmsEndpointFn = shmParseAmsEndpoint;
+	ts->clearAmsEndpointFn = shmClearAmsEndpoint;
+	ts->sendAmsFn = shmSendAms;
+	ts->shutdownFn = shmShutdown;
+}
+
+#endif
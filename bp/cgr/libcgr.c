@@ -29,6 +29,19 @@
 #define	MANAGE_OVERBOOKING	1
 #endif
 
+/*	Insertion of contacts or ranges may enable better routes to
+ *	any destination, so it causes all route lists to be discarded.
+ *	When CGR_PLAN_SETTLING_TIME is non-zero, that discard is
+ *	deferred until the contact plan has been free of insertions
+ *	for that many seconds, so that a burst of contact plan edits
+ *	results in a single recomputation of routes.  Routes that
+ *	traverse removed or revised contacts are always discarded
+ *	immediately.							*/
+
+#ifndef	CGR_PLAN_SETTLING_TIME
+#define	CGR_PLAN_SETTLING_TIME	0
+#endif
+
 /*		Perform a trace if a trace callback exists.		*/
 #define TRACE(...) do \
 { \
@@ -71,14 +84,52 @@ typedef struct
 	time_t		arrivalTime;	/*	As from time(2).	*/
 	int		visited;	/*	Boolean.		*/
 	int		suppressed;	/*	Boolean.		*/
-} CgrContactNote;	/*	IonCXref routingObject is one of these.	*/
+	int		frontierIdx;	/*	1 + position, 0 if none	*/
+
+	/*	Contact's routingObject, restored after the search.	*/
+
+	PsmAddress	routingObject;
+} CgrContactNote;
+
+/*	The contact notes for a route computation are kept in a single
+ *	array, in contactIndex order, for the duration of the
+ *	computation; the routingObject of each IonCXref is 1 + the
+ *	index of its note in that array, and the prior value of the
+ *	routingObject is restored when the search is closed; a non-
+ *	zero value indicates that the contact is traversed by some
+ *	route in the route lists.  Contacts that have been
+ *	reached but not yet visited by the Dijkstra search are kept
+ *	in a binary min-heap ("frontier") ordered by arrival time and
+ *	then by position in the contactIndex, so the next contact to
+ *	visit is always found in O(log C) time rather than by a scan
+ *	of the entire contact index.					*/
+
+typedef struct
+{
+	IonCXref	**contacts;	/*	Array, in index order.	*/
+	CgrContactNote	*notes;		/*	Parallel to contacts.	*/
+	int		*frontier;	/*	Heap of note indices.	*/
+	int		contactsCount;
+	int		frontierLength;
+} CgrSearch;
+
+/*	Each CgrDependency notes that a route traverses a contact,
+ *	enabling the routes that traverse a revised contact to be
+ *	found and discarded without discarding any other routes.	*/
+
+typedef struct
+{
+	PsmAddress	contact;	/*	IonCXref (may be gone)	*/
+	PsmAddress	route;		/*	CgrRoute		*/
+} CgrDependency;
 
 /*		Data structure for the CGR volatile database.		*/
 
 typedef struct
 {
-	time_t		lastLoadTime;	/*	Add/del contacts/ranges	*/
+	time_t		lastLoadTime;	/*	Add contacts/ranges	*/
 	PsmAddress	routeLists;	/*	SM list: CgrRoute list	*/
+	PsmAddress	dependencies;	/*	SM RB tree: CgrDependency*/
 } CgrVdb;
 
 /*		Data structure for temporary linked list.		*/
@@ -109,12 +160,108 @@ static uvast	_minCapacity(int payloadClass)
 
 /*		Functions for managing the CGR database.		*/
 
-static void	discardRouteList(PsmPartition ionwm, PsmAddress routes)
+static int	orderDependencies(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	CgrDependency	*dependency;
+	CgrDependency	*argDependency;
+
+	dependency = (CgrDependency *) psp(partition, nodeData);
+	argDependency = (CgrDependency *) dataBuffer;
+	if (dependency->contact < argDependency->contact)
+	{
+		return -1;
+	}
+
+	if (dependency->contact > argDependency->contact)
+	{
+		return 1;
+	}
+
+	/*	Matching contact.					*/
+
+	if (dependency->route < argDependency->route)
+	{
+		return -1;
+	}
+
+	if (dependency->route > argDependency->route)
+	{
+		return 1;
+	}
+
+	/*	Matching route as well.					*/
+
+	return 0;
+}
+
+static int	noteDependencies(PsmPartition ionwm, PsmAddress dependencies,
+			PsmAddress routeAddr)
+{
+	CgrRoute	*route = (CgrRoute *) psp(ionwm, routeAddr);
+	PsmAddress	elt;
+	PsmAddress	addr;
+	CgrDependency	*dependency;
+
+	for (elt = sm_list_first(ionwm, route->hops); elt;
+			elt = sm_list_next(ionwm, elt))
+	{
+		addr = psm_zalloc(ionwm, sizeof(CgrDependency));
+		if (addr == 0)
+		{
+			putErrmsg("Can't create CGR dependency.", NULL);
+			return -1;
+		}
+
+		dependency = (CgrDependency *) psp(ionwm, addr);
+		dependency->contact = sm_list_data(ionwm, elt);
+		dependency->route = routeAddr;
+		if (sm_rbt_insert(ionwm, dependencies, addr, orderDependencies,
+				dependency) == 0)
+		{
+			psm_free(ionwm, addr);
+			putErrmsg("Can't note CGR dependency.", NULL);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void	discardRoute(PsmPartition ionwm, PsmAddress dependencies,
+			PsmAddress routeAddr)
+{
+	CgrRoute	*route = (CgrRoute *) psp(ionwm, routeAddr);
+	PsmAddress	elt;
+	CgrDependency	arg;
+
+	/*	Note that the contacts in the route's hops list may
+	 *	already have been deleted, so only their addresses
+	 *	are used here.						*/
+
+	if (route->hops)
+	{
+		arg.route = routeAddr;
+		for (elt = sm_list_first(ionwm, route->hops);
+				elt && dependencies;
+				elt = sm_list_next(ionwm, elt))
+		{
+			arg.contact = sm_list_data(ionwm, elt);
+			sm_rbt_delete(ionwm, dependencies, orderDependencies,
+					&arg, rfx_erase_data, NULL);
+		}
+
+		sm_list_destroy(ionwm, route->hops, NULL, NULL);
+	}
+
+	psm_free(ionwm, routeAddr);
+}
+
+static void	discardRouteList(PsmPartition ionwm, PsmAddress dependencies,
+			PsmAddress routes)
 {
 	PsmAddress	elt2;
 	PsmAddress	next2;
-	PsmAddress	addr;
-	CgrRoute	*route;
 
 	if (routes == 0)
 	{
@@ -126,14 +273,7 @@ static void	discardRouteList(PsmPartition ionwm, PsmAddress routes)
 	for (elt2 = sm_list_first(ionwm, routes); elt2; elt2 = next2)
 	{
 		next2 = sm_list_next(ionwm, elt2);
-		addr = sm_list_data(ionwm, elt2);
-		route = (CgrRoute *) psp(ionwm, addr);
-		if (route->hops)
-		{
-			sm_list_destroy(ionwm, route->hops, NULL, NULL);
-		}
-
-		psm_free(ionwm, addr);
+		discardRoute(ionwm, dependencies, sm_list_data(ionwm, elt2));
 		sm_list_delete(ionwm, elt2, NULL, NULL);
 	}
 
@@ -164,7 +304,7 @@ static void	discardRouteLists(CgrVdb *vdb)
 
 		/*	Discard the list of routes to remote node.	*/
 
-		discardRouteList(ionwm, routes);
+		discardRouteList(ionwm, vdb->dependencies, routes);
 
 		/*	And delete the reference to the destroyed list.	*/
 
@@ -172,7 +312,48 @@ static void	discardRouteLists(CgrVdb *vdb)
 	}
 }
 
-static void	clearRoutingObjects(PsmPartition ionwm)
+static void	invalidateRoutes(CgrVdb *vdb)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
+	PsmAddress	elt;
+	CgrDependency	arg;
+	PsmAddress	elt2;
+	CgrDependency	*dependency;
+	CgrRoute	*route;
+
+	/*	For each contact that has been removed or revised
+	 *	since routes were last computed, mark every route that
+	 *	traverses that contact as ended.  Each such route will
+	 *	be discarded, and a new route through its initial
+	 *	contact computed, the next time the list of routes
+	 *	that contains it is consulted; all other routes are
+	 *	retained.						*/
+
+	while ((elt = sm_list_first(ionwm, ionvdb->revisedContacts)) != 0)
+	{
+		arg.contact = sm_list_data(ionwm, elt);
+		arg.route = 0;
+		for (oK(sm_rbt_search(ionwm, vdb->dependencies,
+				orderDependencies, &arg, &elt2)); elt2;
+				elt2 = sm_rbt_next(ionwm, elt2))
+		{
+			dependency = (CgrDependency *) psp(ionwm,
+					sm_rbt_data(ionwm, elt2));
+			if (dependency->contact != arg.contact)
+			{
+				break;
+			}
+
+			route = (CgrRoute *) psp(ionwm, dependency->route);
+			route->toTime = 0;
+		}
+
+		sm_list_delete(ionwm, elt, NULL, NULL);
+	}
+}
+
+static void	clearRoutingObjects(PsmPartition ionwm, PsmAddress dependencies)
 {
 	IonVdb		*ionvdb = getIonVdb();
 	PsmAddress	elt;
@@ -187,7 +368,7 @@ static void	clearRoutingObjects(PsmPartition ionwm)
 		{
 			routes = node->routingObject;
 			node->routingObject = 0;
-			discardRouteList(ionwm, routes);
+			discardRouteList(ionwm, dependencies, routes);
 		}
 	}
 }
@@ -238,6 +419,7 @@ static CgrVdb	*_cgrvdb(char **name)
 		vdb = (CgrVdb *) psp(ionwm, vdbAddress);
 		memset((char *) vdb, 0, sizeof(CgrVdb));
 		if ((vdb->routeLists = sm_list_create(ionwm)) == 0
+		|| (vdb->dependencies = sm_rbt_create(ionwm)) == 0
 		|| psm_catlg(ionwm, *name, vdbAddress) < 0)
 		{
 			sdr_exit_xn(sdr);
@@ -245,7 +427,7 @@ static CgrVdb	*_cgrvdb(char **name)
 			return NULL;
 		}
 
-		clearRoutingObjects(ionwm);
+		clearRoutingObjects(ionwm, vdb->dependencies);
 		sdr_exit_xn(sdr);
 	}
 
@@ -298,9 +480,213 @@ static int	getApplicableRange(IonCXref *contact, unsigned int *owlt)
 	return -1;
 }
 
-static int	computeDistanceToTerminus(IonCXref *rootContact,
-			CgrContactNote *rootWork, IonNode *terminusNode,
-			int payloadClass, CgrRoute *route, CgrTrace *trace)
+static int	openSearch(CgrSearch *search)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
+	long		count;
+	PsmAddress	elt;
+	IonCXref	*contact;
+	int		i;
+
+	memset((char *) search, 0, sizeof(CgrSearch));
+	count = sm_rbt_length(ionwm, ionvdb->contactIndex);
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	search->contacts = (IonCXref **) MTAKE(count * sizeof(IonCXref *));
+	search->notes = (CgrContactNote *)
+			MTAKE(count * sizeof(CgrContactNote));
+	search->frontier = (int *) MTAKE(count * sizeof(int));
+	if (search->contacts == NULL || search->notes == NULL
+	|| search->frontier == NULL)
+	{
+		if (search->contacts) MRELEASE(search->contacts);
+		if (search->notes) MRELEASE(search->notes);
+		if (search->frontier) MRELEASE(search->frontier);
+		putErrmsg("Can't create contact notes.", itoa(count));
+		return -1;
+	}
+
+	for (i = 0, elt = sm_rbt_first(ionwm, ionvdb->contactIndex);
+			elt && i < count; i++, elt = sm_rbt_next(ionwm, elt))
+	{
+		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
+		search->notes[i].routingObject = contact->routingObject;
+		contact->routingObject = i + 1;
+		search->contacts[i] = contact;
+	}
+
+	search->contactsCount = i;
+	return 0;
+}
+
+static void	closeSearch(CgrSearch *search)
+{
+	int	i;
+
+	for (i = 0; i < search->contactsCount; i++)
+	{
+		search->contacts[i]->routingObject =
+				search->notes[i].routingObject;
+	}
+
+	if (search->contacts) MRELEASE(search->contacts);
+	if (search->notes) MRELEASE(search->notes);
+	if (search->frontier) MRELEASE(search->frontier);
+	memset((char *) search, 0, sizeof(CgrSearch));
+}
+
+static void	clearSearch(CgrSearch *search, int clearSuppression)
+{
+	CgrContactNote	*work;
+	int		i;
+
+	for (i = 0, work = search->notes; i < search->contactsCount;
+			i++, work++)
+	{
+		if (clearSuppression)
+		{
+			work->capacity = 0;
+			work->suppressed = 0;
+		}
+
+		work->predecessor = NULL;
+		work->arrivalTime = MAX_TIME;
+		work->visited = 0;
+		work->frontierIdx = 0;
+	}
+
+	search->frontierLength = 0;
+}
+
+static CgrContactNote	*getContactNote(CgrSearch *search, IonCXref *contact)
+{
+	PsmAddress	noteNbr = contact->routingObject;
+
+	if (noteNbr == 0 || noteNbr > (PsmAddress) search->contactsCount
+	|| search->contacts[noteNbr - 1] != contact)
+	{
+		return NULL;	/*	Contact is new since search.	*/
+	}
+
+	return search->notes + (noteNbr - 1);
+}
+
+static int	precedes(CgrSearch *search, int noteIdx1, int noteIdx2)
+{
+	time_t	arrivalTime1 = search->notes[noteIdx1].arrivalTime;
+	time_t	arrivalTime2 = search->notes[noteIdx2].arrivalTime;
+
+	/*	Ties are broken by position in the contact index, so
+	 *	the same route is selected as by a scan of the index.	*/
+
+	return (arrivalTime1 < arrivalTime2
+		|| (arrivalTime1 == arrivalTime2 && noteIdx1 < noteIdx2));
+}
+
+static void	placeInFrontier(CgrSearch *search, int pos, int noteIdx)
+{
+	search->frontier[pos] = noteIdx;
+	search->notes[noteIdx].frontierIdx = pos + 1;
+}
+
+static void	raiseInFrontier(CgrSearch *search, int pos)
+{
+	int	noteIdx = search->frontier[pos];
+	int	parent;
+
+	while (pos > 0)
+	{
+		parent = (pos - 1) / 2;
+		if (!precedes(search, noteIdx, search->frontier[parent]))
+		{
+			break;
+		}
+
+		placeInFrontier(search, pos, search->frontier[parent]);
+		pos = parent;
+	}
+
+	placeInFrontier(search, pos, noteIdx);
+}
+
+static void	lowerInFrontier(CgrSearch *search, int pos)
+{
+	int	noteIdx = search->frontier[pos];
+	int	child;
+
+	while (1)
+	{
+		child = (2 * pos) + 1;
+		if (child >= search->frontierLength)
+		{
+			break;
+		}
+
+		if (child + 1 < search->frontierLength
+		&& precedes(search, search->frontier[child + 1],
+				search->frontier[child]))
+		{
+			child++;
+		}
+
+		if (!precedes(search, search->frontier[child], noteIdx))
+		{
+			break;
+		}
+
+		placeInFrontier(search, pos, search->frontier[child]);
+		pos = child;
+	}
+
+	placeInFrontier(search, pos, noteIdx);
+}
+
+static void	noteArrivalTime(CgrSearch *search, CgrContactNote *work)
+{
+	int	noteIdx = work - search->notes;
+
+	/*	Arrival time has just been reduced, so the contact
+	 *	can only move toward the top of the frontier.		*/
+
+	if (work->frontierIdx == 0)
+	{
+		placeInFrontier(search, search->frontierLength, noteIdx);
+		search->frontierLength++;
+	}
+
+	raiseInFrontier(search, work->frontierIdx - 1);
+}
+
+static int	takeFromFrontier(CgrSearch *search)
+{
+	int	noteIdx;
+
+	if (search->frontierLength == 0)
+	{
+		return -1;
+	}
+
+	noteIdx = search->frontier[0];
+	search->notes[noteIdx].frontierIdx = 0;
+	search->frontierLength--;
+	if (search->frontierLength > 0)
+	{
+		placeInFrontier(search, 0,
+				search->frontier[search->frontierLength]);
+		lowerInFrontier(search, 0);
+	}
+
+	return noteIdx;
+}
+
+static int	computeDistanceToTerminus(CgrSearch *search,
+			IonCXref *rootContact, CgrContactNote *rootWork,
+			IonNode *terminusNode, int payloadClass,
+			CgrRoute *route, CgrTrace *trace)
 {
 	PsmPartition	ionwm = getIonwm();
 	IonVdb		*ionvdb = getIonVdb();
@@ -317,8 +703,7 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 	time_t		arrivalTime;
 	IonCXref	*finalContact = NULL;
 	time_t		earliestFinalArrivalTime = MAX_TIME;
-	IonCXref	*nextContact;
-	time_t		earliestArrivalTime;
+	int		nextNoteIdx;
 	time_t		earliestEndTime;
 	uvast		maxCapacity;
 	PsmAddress	addr;
@@ -363,8 +748,7 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				continue;
 			}
 
-			work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject);
+			work = getContactNote(search, contact);
 			CHKERR(work);
 			if (work->suppressed)
 			{
@@ -447,6 +831,7 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 			{
 				work->arrivalTime = arrivalTime;
 				work->predecessor = current;
+				noteArrivalTime(search, work);
 
 				/*	Note contact if could be final.	*/
 
@@ -465,51 +850,22 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 
 		currentWork->visited = 1;
 
-		/*	Select next contact to consider, if any.	*/
+		/*	Select next contact to consider, if any: the
+		 *	unvisited contact with the earliest arrival
+		 *	time, unless that contact can't be on the
+		 *	optimal path.					*/
 
-		nextContact = NULL;
-		earliestArrivalTime = MAX_TIME;
-		for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex); elt;
-				elt = sm_rbt_next(ionwm, elt))
-		{
-			contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm,
-					elt));
-			CHKERR(contact);
-			work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject);
-			CHKERR(work);
-			if (work->suppressed || work->visited)
-			{
-				continue;	/*	Ineligible.	*/
-			}
-
-			if (work->arrivalTime > earliestFinalArrivalTime)
-			{
-				/*	Not on optimal path; ignore.	*/
-
-				continue;
-			}
-
-			if (work->arrivalTime < earliestArrivalTime)
-			{
-				nextContact = contact;
-				earliestArrivalTime = work->arrivalTime;
-			}
-		}
-
-		/*	If search is complete, stop.  Else repeat,
-		 *	with new value of "current".			*/
-
-		if (nextContact == NULL)
+		nextNoteIdx = takeFromFrontier(search);
+		if (nextNoteIdx < 0 || search->notes[nextNoteIdx].arrivalTime
+				> earliestFinalArrivalTime)
 		{
 			/*	End of search.				*/
 
 			break;
 		}
 
-		current = nextContact;
-		currentWork = (CgrContactNote *)
-				psp(ionwm, nextContact->routingObject);
+		current = search->contacts[nextNoteIdx];
+		currentWork = search->notes + nextNoteIdx;
 	}
 
 	/*	Have finished Dijkstra search of contact graph,
@@ -533,8 +889,8 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				earliestEndTime = contact->toTime;
 			}
 
-			work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject);
+			work = getContactNote(search, contact);
+			CHKERR(work);
 			if (work->capacity < maxCapacity)
 			{
 				maxCapacity = work->capacity;
@@ -565,13 +921,16 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 	return 0;
 }
 
-static int	findNextBestRoute(PsmPartition ionwm, IonCXref *rootContact,
-			CgrContactNote *rootWork, IonNode *terminusNode,
-			int payloadClass, PsmAddress *routeAddr,
-			CgrTrace *trace)
+static int	findNextBestRoute(PsmPartition ionwm, CgrSearch *search,
+			IonCXref *rootContact, CgrContactNote *rootWork,
+			IonNode *terminusNode, int payloadClass,
+			PsmAddress *routeAddr, CgrTrace *trace)
 {
+	CgrVdb		*cgrvdb = _cgrvdb(NULL);
 	PsmAddress	addr;
 	CgrRoute	*route;
+	PsmAddress	elt;
+	CgrContactNote	*work;
 
 	*routeAddr = 0;		/*	Default.			*/
 	addr = psm_zalloc(ionwm, sizeof(CgrRoute));
@@ -593,8 +952,8 @@ static int	findNextBestRoute(PsmPartition ionwm, IonCXref *rootContact,
 
 	/*	Run Dijkstra search.					*/
 
-	if (computeDistanceToTerminus(rootContact, rootWork, terminusNode,
-			payloadClass, route, trace) < 0)
+	if (computeDistanceToTerminus(search, rootContact, rootWork,
+			terminusNode, payloadClass, route, trace) < 0)
 	{
 		putErrmsg("Can't finish Dijstra search.", NULL);
 		return -1;
@@ -617,7 +976,27 @@ static int	findNextBestRoute(PsmPartition ionwm, IonCXref *rootContact,
 				(unsigned int)(route->arrivalTime),
 				route->maxCapacity, route->payloadClass);
 
-		/*	Found best route, given current exclusions.	*/
+		/*	Found best route, given current exclusions.
+		 *	Note that the route traverses its contacts, so
+		 *	that it will be discarded if any of them is
+		 *	revised.					*/
+
+		if (noteDependencies(ionwm, cgrvdb->dependencies, addr) < 0)
+		{
+			putErrmsg("Can't note CGR route dependencies.", NULL);
+			return -1;
+		}
+
+		for (elt = sm_list_first(ionwm, route->hops); elt;
+				elt = sm_list_next(ionwm, elt))
+		{
+			work = getContactNote(search, (IonCXref *) psp(ionwm,
+					sm_list_data(ionwm, elt)));
+			if (work)
+			{
+				work->routingObject = 1;
+			}
+		}
 
 		*routeAddr = addr;
 	}
@@ -632,8 +1011,7 @@ static PsmAddress	loadRouteList(IonNode *terminusNode, time_t currentTime,
 	IonVdb		*ionvdb = getIonVdb();
 	CgrVdb		*cgrvdb = _cgrvdb(NULL);
 	int		payloadClass;
-	PsmAddress	elt;
-	IonCXref	*contact;
+	CgrSearch	search;
 	CgrContactNote	*work;
 	IonCXref	rootContact;
 	CgrContactNote	rootWork;
@@ -673,6 +1051,12 @@ static PsmAddress	loadRouteList(IonNode *terminusNode, time_t currentTime,
 	 *	Each time we search, we exclude from consideration
 	 *	the first contact in every previously computed route.	*/
 
+	if (openSearch(&search) < 0)
+	{
+		putErrmsg("Can't load routes list.", NULL);
+		return 0;
+	}
+
 	rootContact.fromNode = getOwnNodeNbr();
 	rootContact.toNode = rootContact.fromNode;
 	rootWork.arrivalTime = currentTime;
@@ -681,36 +1065,14 @@ static PsmAddress	loadRouteList(IonNode *terminusNode, time_t currentTime,
 		/*	For each series of searches, clear Dijkstra
 		 *	work areas for all contacts.			*/
 
-		for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex); elt;
-				elt = sm_rbt_next(ionwm, elt))
-		{
-			contact = (IonCXref *)
-					psp(ionwm, sm_rbt_data(ionwm, elt));
-			if ((work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject)) == 0)
-			{
-				contact->routingObject = psm_zalloc(ionwm,
-						sizeof(CgrContactNote));
-				work = (CgrContactNote *) psp(ionwm,
-						contact->routingObject);
-				if (work == 0)
-				{
-					putErrmsg("Can't create contact note.",
-							NULL);
-					return 0;
-				}
-			}
-
-			memset((char *) work, 0, sizeof(CgrContactNote));
-			work->arrivalTime = MAX_TIME;
-		}
-
+		clearSearch(&search, 1);
 		while (1)
 		{
-			if (findNextBestRoute(ionwm, &rootContact, &rootWork,
-					terminusNode, payloadClass, &routeAddr,
-					trace) < 0)
+			if (findNextBestRoute(ionwm, &search, &rootContact,
+					&rootWork, terminusNode, payloadClass,
+					&routeAddr, trace) < 0)
 			{
+				closeSearch(&search);
 				putErrmsg("Can't load routes list.", NULL);
 				return 0;
 			}
@@ -730,6 +1092,7 @@ static PsmAddress	loadRouteList(IonNode *terminusNode, time_t currentTime,
 			if (sm_list_insert_last(ionwm,
 				terminusNode->routingObject, routeAddr) == 0)
 			{
+				closeSearch(&search);
 				putErrmsg("Can't add route to list.", NULL);
 				return 0;
 			}
@@ -741,23 +1104,20 @@ static PsmAddress	loadRouteList(IonNode *terminusNode, time_t currentTime,
 			firstContact = (IonCXref *)
 					psp(ionwm, sm_list_data(ionwm,
 					sm_list_first(ionwm, route->hops)));
-			work = (CgrContactNote *)
-					psp(ionwm, firstContact->routingObject);
-			work->suppressed = 1;
-			for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex);
-				       	elt; elt = sm_rbt_next(ionwm, elt))
+			work = getContactNote(&search, firstContact);
+			if (work == NULL)
 			{
-				contact = (IonCXref *)
-					psp(ionwm, sm_rbt_data(ionwm, elt));
-				work = (CgrContactNote *)
-					psp(ionwm, contact->routingObject);
-				work->arrivalTime = MAX_TIME;
-				work->predecessor = NULL;
-				work->visited = 0;
+				closeSearch(&search);
+				putErrmsg("Can't find contact note.", NULL);
+				return 0;
 			}
+
+			work->suppressed = 1;
+			clearSearch(&search, 0);
 		}
 	}
 
+	closeSearch(&search);
 	return terminusNode->routingObject;
 }
 
@@ -775,6 +1135,7 @@ static int	recomputeRouteForContact(uvast contactToNodeNbr,
 	PsmAddress	cxelt;
 	PsmAddress	nextElt;
 	IonCXref	*contact;
+	CgrSearch	search;
 	CgrContactNote	*work;
 	PsmAddress	elt;
 	CgrRoute	*route;
@@ -806,29 +1167,14 @@ static int	recomputeRouteForContact(uvast contactToNodeNbr,
 	 *	clear Dijkstra work areas for all contacts in the
 	 *	contactIndex.						*/
 
-	for (cxelt = sm_rbt_first(ionwm, vdb->contactIndex); cxelt;
-			cxelt = sm_rbt_next(ionwm, cxelt))
+	if (openSearch(&search) < 0)
 	{
-		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, cxelt));
-		if ((work = (CgrContactNote *) psp(ionwm,
-				contact->routingObject)) == 0)
-		{
-			contact->routingObject = psm_zalloc(ionwm,
-					sizeof(CgrContactNote));
-			work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject);
-			if (work == 0)
-			{
-				putErrmsg("Can't create CGR contact note.",
-						NULL);
-				return -1;
-			}
-		}
-
-		memset((char *) work, 0, sizeof(CgrContactNote));
-		work->arrivalTime = MAX_TIME;
+		putErrmsg("Can't create CGR contact notes.", NULL);
+		return -1;
 	}
 
+	clearSearch(&search, 1);
+
 	/*	Now suppress from consideration as lead contact
 	 *	every contact that is already the leading contact of
 	 *	any remaining route in terminusNode's list of routes.	*/
@@ -862,8 +1208,11 @@ static int	recomputeRouteForContact(uvast contactToNodeNbr,
 		}
 
 		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, cxelt));
-		work = (CgrContactNote *) psp(ionwm, contact->routingObject);
-		work->suppressed = 1;
+		work = getContactNote(&search, contact);
+		if (work)
+		{
+			work->suppressed = 1;
+		}
 	}
 
 	/*	Next invoke findNextBestRoute to produce a new route
@@ -872,13 +1221,16 @@ static int	recomputeRouteForContact(uvast contactToNodeNbr,
 	rootContact.fromNode = getOwnNodeNbr();
 	rootContact.toNode = rootContact.fromNode;
 	rootWork.arrivalTime = currentTime;
-	if (findNextBestRoute(ionwm, &rootContact, &rootWork, terminusNode,
-			payloadClass, &routeAddr, trace) < 0)
+	if (findNextBestRoute(ionwm, &search, &rootContact, &rootWork,
+			terminusNode, payloadClass, &routeAddr, trace) < 0)
 	{
+		closeSearch(&search);
 		putErrmsg("Can't recompute route.", NULL);
 		return -1;
 	}
 
+	closeSearch(&search);
+
 	if (routeAddr == 0)		/*	No route computed.	*/
 	{
 		return 0;
@@ -1375,6 +1727,7 @@ static int	identifyProximateNodes(IonNode *terminusNode, Bundle *bundle,
 			Lyst proximateNodes, time_t currentTime)
 {
 	PsmPartition	ionwm = getIonwm();
+	CgrVdb		*cgrvdb = _cgrvdb(NULL);
 	unsigned int	deadline;
 	PsmAddress	routes;		/*	SmList of CgrRoutes.	*/
 	PsmAddress	elt;
@@ -1422,17 +1775,13 @@ static int	identifyProximateNodes(IonNode *terminusNode, Bundle *bundle,
 		if (route->toTime < currentTime)
 		{
 			/*	This route includes a contact that
-			 *	has already ended; delete it.		*/
+			 *	has already ended, or that has been
+			 *	removed or revised; delete it.		*/
 
 			contactToNodeNbr = route->toNodeNbr;
 			contactFromTime = route->fromTime;
 			payloadClass = route->payloadClass;
-			if (route->hops)
-			{
-				sm_list_destroy(ionwm, route->hops, NULL, NULL);
-			}
-
-			psm_free(ionwm, addr);
+			discardRoute(ionwm, cgrvdb->dependencies, addr);
 			sm_list_delete(ionwm, elt, NULL, NULL);
 			switch (recomputeRouteForContact(contactToNodeNbr,
 					contactFromTime, terminusNode,
@@ -1616,8 +1965,14 @@ static int	enqueueToNeighbor(ProximateNode *proxNode, Bundle *bundle,
 
 	if (!(bundle->extendedCOS.flags & BP_MINIMUM_LATENCY))
 	{
+		if (bundle->overdueElt)
+		{
+			destroyBpTimelineEvent(bundle->overdueElt);
+		}
+
 		event.type = xmitOverdue;
-		event.time = proxNode->forfeitTime;
+		event.time.tv_sec = proxNode->forfeitTime;
+		event.time.tv_usec = 0;
 		event.ref = bundleObj;
 		bundle->overdueElt = insertBpTimelineEvent(&event);
 		if (bundle->overdueElt == 0)
@@ -1847,6 +2202,7 @@ static int 	cgrForward(Bundle *bundle, Object bundleObj,
 	Bundle		newBundle;
 	Object		newBundleObj;
 	ProximateNode	*selectedNeighbor;
+	time_t		currentTime;
 
 	/*	Determine whether or not the contact graph for this
 	 *	node identifies one or more proximate nodes to
@@ -1872,15 +2228,23 @@ static int 	cgrForward(Bundle *bundle, Object bundleObj,
 	TRACE(CgrBuildRoutes, terminusNodeNbr, bundle->payload.length,
 			(unsigned int)(atTime));
 
-	if (ionvdb->lastEditTime > cgrvdb->lastLoadTime) 
+	currentTime = getUTCTime();
+	if (ionvdb->lastEditTime > cgrvdb->lastLoadTime
+	&& currentTime - ionvdb->lastEditTime >= CGR_PLAN_SETTLING_TIME)
 	{
-		/*	Contact plan has been modified, so must discard
-		 *	all route lists and reconstruct them as needed.	*/
+		/*	Contacts have been added to the contact plan,
+		 *	so must discard all route lists and reconstruct
+		 *	them as needed.					*/
 
 		discardRouteLists(cgrvdb);
-		cgrvdb->lastLoadTime = getUTCTime();
+		cgrvdb->lastLoadTime = currentTime;
 	}
 
+	/*	Routes through contacts that have been removed or
+	 *	revised must be discarded in any case.			*/
+
+	invalidateRoutes(cgrvdb);
+
 	terminusNode = findNode(ionvdb, terminusNodeNbr, &nextNode);
 	if (terminusNode == NULL)
 	{
@@ -2247,20 +2611,21 @@ void	cgr_stop()
 	CgrVdb		*vdb;
 	char		*stop = NULL;
 
-	/*Clear Route Caches*/
-	clearRoutingObjects(wm);
-
-	/*Free volatile database*/
 	if (psm_locate(wm, name, &vdbAddress, &elt) < 0)
 	{
 		putErrmsg("Failed searching for vdb.", NULL);
 		return;
 	}
 
-	if (elt)
+	/*Clear Route Caches*/
+	vdb = (elt ? (CgrVdb *) psp(wm, vdbAddress) : NULL);
+	clearRoutingObjects(wm, (vdb ? vdb->dependencies : 0));
+
+	/*Free volatile database*/
+	if (vdb)
 	{
-		vdb = (CgrVdb *) psp(wm, vdbAddress);
 		sm_list_destroy(wm, vdb->routeLists, NULL, NULL);
+		sm_rbt_destroy(wm, vdb->dependencies, rfx_erase_data, NULL);
 		psm_free(wm, vdbAddress);
 		if (psm_uncatlg(wm, name) < 0)
 		{
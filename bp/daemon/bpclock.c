@@ -16,6 +16,10 @@
 #include "acs.h"		/* provides sendAcs */
 #endif /* ENABLE_ACS */
 
+#ifndef BP_CLOCK_BATCH
+#define	BP_CLOCK_BATCH	(64)	/*	Events per transaction.		*/
+#endif
+
 static long	_running(long *newValue)
 {
 	void	*value;
@@ -41,91 +45,69 @@ static void	shutDown()	/*	Commands bpclock termination.	*/
 	oK(_running(&stop));	/*	Terminates bpclock.		*/
 }
 
-static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
+static int	isRunning(void *arg)
 {
-	Object	elt;
-	Object	eventObj;
-		OBJ_POINTER(BpEvent, event);
-	int	result;
-
-	while (1)
-	{
-		CHKERR(sdr_begin_xn(sdr));
-		elt = sdr_list_first(sdr, events);
-		if (elt == 0)	/*	No more events to dispatch.	*/
-		{
-			sdr_exit_xn(sdr);
-			return 0;
-		}
-
-		eventObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, BpEvent, event, eventObj);
-		if (event->time > currentTime)
-		{
-			/*	This is the first future event.		*/
+	return (_running(NULL) != 0);
+}
 
-			sdr_exit_xn(sdr);
-			return 0;
-		}
+static int	dispatchEvent(Sdr sdr, Object entry, Address eventObj,
+			struct timeval *currentTime, void *arg)
+{
+			OBJ_POINTER(BpEvent, event);
+	int		result;
 
-		switch (event->type)
-		{
-		case expiredTTL:
-			result = bpDestroyBundle(event->ref, 1);
+	GET_OBJ_POINTER(sdr, BpEvent, event, (Object) eventObj);
+	switch (event->type)
+	{
+	case expiredTTL:
+		result = bpDestroyBundle(event->ref, 1);
 
-			/*	Note that bpDestroyBundle() always
-			 *	erases the bundle's timeline event,
-			 *	so we must NOT do so here.		*/
+		/*	Note that bpDestroyBundle() always erases
+		 *	the bundle's timeline event, so we must
+		 *	NOT do so here.					*/
 
-			break;		/*	Out of switch.		*/
+		break;			/*	Out of switch.		*/
 
-		case xmitOverdue:
-			result = bpReforwardBundle(event->ref);
+	case xmitOverdue:
+		result = bpReforwardBundle(event->ref);
 
-			/*	Note that bpReforwardBundle() always
-			 *	erases the bundle's xmitOverdue event,
-			 *	so we must NOT do so here.		*/
+		/*	Note that bpReforwardBundle() always erases
+		 *	the bundle's xmitOverdue event, so we must
+		 *	NOT do so here.					*/
 
-			break;		/*	Out of switch.		*/
+		break;			/*	Out of switch.		*/
 
-		case ctDue:
-			result = bpReforwardBundle(event->ref);
+	case ctDue:
+		result = bpReforwardBundle(event->ref);
 
-			/*	Note that bpReforwardBundle() always
-			 *	erases the bundle's ctDue event, so
-			 *	we must NOT do so here.			*/
+		/*	Note that bpReforwardBundle() always erases
+		 *	the bundle's ctDue event, so we must NOT do
+		 *	so here.					*/
 
-			break;		/*	Out of switch.		*/
+		break;			/*	Out of switch.		*/
 
 #ifdef ENABLE_BPACS
-        case csDue:
-            result = sendAcs(event->ref);
+	case csDue:
+		result = sendAcs(event->ref);
 
-			/* Note that sendAcs() always erases the 
-			 * csDue event, so we must NOT do so
-			 * here. */
+		/*	Note that sendAcs() always erases the csDue
+		 *	event, so we must NOT do so here.		*/
 
-			break;		/*	Out of switch.		*/
+		break;			/*	Out of switch.		*/
 #endif
 
-		default:		/*	Spurious event; erase.	*/
-			destroyBpTimelineEvent(elt);
-			result = 0;	/*	Event is ignored.	*/
-		}
-
-		if (result != 0)	/*	Dispatching failed.	*/
-		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("Failed handing BP event.", NULL);
-			return result;
-		}
+	default:			/*	Spurious event; erase.	*/
+		destroyBpTimelineEvent(entry);
+		result = 0;		/*	Event is ignored.	*/
+	}
 
-		if (sdr_end_xn(sdr) < 0)
-		{
-			putErrmsg("Failed dispatching BP event.", NULL);
-			return -1;
-		}
+	if (result != 0)		/*	Dispatching failed.	*/
+	{
+		putErrmsg("Failed handing BP event.", NULL);
+		return -1;
 	}
+
+	return 0;
 }
 
 static int	adjustThrottles()
@@ -335,6 +317,22 @@ static void	applyRateControl(Sdr sdr)
 	oK(sdr_end_xn(sdr));
 }
 
+static int	manageRates(Sdr sdr, struct timeval *currentTime, void *arg)
+{
+	/*	Once per second, adjust throttles in response to
+	 *	rate changes noted in the shared ION database, then
+	 *	apply rate control.					*/
+
+	if (adjustThrottles() < 0)
+	{
+		putErrmsg("Can't adjust throttles.", NULL);
+		return -1;
+	}
+
+	applyRateControl(sdr);
+	return 0;
+}
+
 #if defined (ION_LWT)
 int	bpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -343,10 +341,9 @@ int	bpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	BpDB	*bpConstants;
-	long	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	BpDB		*bpConstants;
+	long		state = 1;
 
 	if (bpAttach() < 0)
 	{
@@ -363,35 +360,11 @@ int	main(int argc, char *argv[])
 
 	oK(_running(&state));
 	writeMemo("[i] bpclock is running.");
-	while (_running(NULL))
+	if (sdr_wheel_run(sdr, bpConstants->timeline, BP_CLOCK_BATCH,
+			getUTCTimeval, dispatchEvent, manageRates, isRunning,
+			NULL) < 0)
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose executions times have now been reached.	*/
-
-		snooze(1);
-		currentTime = getUTCTime();
-		if (dispatchEvents(sdr, bpConstants->timeline, currentTime) < 0)
-		{
-			putErrmsg("Can't dispatch events.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Also adjust throttles in response to rate
-		 *	changes noted in the shared ION database.	*/
-
-		if (adjustThrottles() < 0)
-		{
-			putErrmsg("Can't adjust throttles.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Then apply rate control.			*/
-
-		applyRateControl(sdr);
+		putErrmsg("Can't dispatch events.", NULL);
 	}
 
 	writeErrmsgMemos();
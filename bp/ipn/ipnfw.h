@@ -88,6 +88,40 @@ typedef struct
 	Object		groups;			/*	SDR list	*/
 } IpnDB;
 
+/*	The volatile IPN database indexes all plans and groups, so
+ *	that the plan or group that applies to a given node number
+ *	can be found without walking the SDR lists of plans and
+ *	groups.  Plans are indexed by node number.  Groups are
+ *	indexed by first node number ascending, then last node
+ *	number descending; since (as noted above) group ranges may
+ *	nest but not otherwise overlap, this order places every
+ *	group after all groups that enclose it, and each group's
+ *	index entry cites the entry for the narrowest group that
+ *	encloses it, if any.  If groups are nonetheless configured
+ *	with overlapping ranges, the index notes this and group
+ *	lookup reverts to examining every group in the index.		*/
+
+typedef struct
+{
+	uvast		nodeNbr;
+	Object		planElt;		/*	In IpnDB plans	*/
+} IpnPlanRef;
+
+typedef struct
+{
+	uvast		firstNodeNbr;
+	uvast		lastNodeNbr;
+	Object		groupElt;		/*	In IpnDB groups	*/
+	PsmAddress	parent;			/*	IpnGroupRef	*/
+} IpnGroupRef;
+
+typedef struct
+{
+	PsmAddress	plans;			/*	SM RB tree	*/
+	PsmAddress	groups;			/*	SM RB tree	*/
+	int		groupsOverlap;		/*	Boolean		*/
+} IpnVdb;
+
 typedef struct
 {
 	Object		outductElt;
@@ -97,6 +131,8 @@ typedef struct
 extern int		ipnInit();
 extern Object		getIpnDbObject();
 extern IpnDB		*getIpnConstants();
+extern IpnVdb		*getIpnVdb();
+extern void		ipnDropVdb();
 
 extern void		ipn_findPlan(uvast nodeNbr, Object *planAddr,
 				Object *elt);
@@ -66,6 +66,371 @@ static IpnDB	*_ipnConstants()
 	return db;
 }
 
+static char	*_ipnvdbName()
+{
+	return "ipnvdb";
+}
+
+static int	orderPlanRefs(PsmPartition wm, PsmAddress refData,
+			void *dataBuffer)
+{
+	IpnPlanRef	*ref = (IpnPlanRef *) psp(wm, refData);
+	IpnPlanRef	*argRef = (IpnPlanRef *) dataBuffer;
+
+	if (ref->nodeNbr < argRef->nodeNbr)
+	{
+		return -1;
+	}
+
+	if (ref->nodeNbr > argRef->nodeNbr)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static int	orderGroupRefs(PsmPartition wm, PsmAddress refData,
+			void *dataBuffer)
+{
+	IpnGroupRef	*ref = (IpnGroupRef *) psp(wm, refData);
+	IpnGroupRef	*argRef = (IpnGroupRef *) dataBuffer;
+
+	/*	Ascending first node number, then descending last
+	 *	node number: enclosing groups precede the groups
+	 *	they enclose.						*/
+
+	if (ref->firstNodeNbr < argRef->firstNodeNbr)
+	{
+		return -1;
+	}
+
+	if (ref->firstNodeNbr > argRef->firstNodeNbr)
+	{
+		return 1;
+	}
+
+	if (ref->lastNodeNbr > argRef->lastNodeNbr)
+	{
+		return -1;
+	}
+
+	if (ref->lastNodeNbr < argRef->lastNodeNbr)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static void	deleteRef(PsmPartition wm, PsmAddress refData, void *arg)
+{
+	psm_free(wm, refData);
+}
+
+static int	indexPlan(IpnVdb *vdb, uvast nodeNbr, Object planElt)
+{
+	PsmPartition	wm = getIonwm();
+	PsmAddress	refAddr;
+	IpnPlanRef	*ref;
+
+	refAddr = psm_zalloc(wm, sizeof(IpnPlanRef));
+	if (refAddr == 0)
+	{
+		return -1;
+	}
+
+	ref = (IpnPlanRef *) psp(wm, refAddr);
+	ref->nodeNbr = nodeNbr;
+	ref->planElt = planElt;
+	if (sm_rbt_insert(wm, vdb->plans, refAddr, orderPlanRefs, ref) == 0)
+	{
+		psm_free(wm, refAddr);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void	unindexPlan(IpnVdb *vdb, uvast nodeNbr)
+{
+	IpnPlanRef	argRef;
+
+	argRef.nodeNbr = nodeNbr;
+	sm_rbt_delete(getIonwm(), vdb->plans, orderPlanRefs, &argRef,
+			deleteRef, NULL);
+}
+
+static PsmAddress	precedingGroupRef(PsmPartition wm, IpnVdb *vdb,
+				IpnGroupRef *argRef)
+{
+	PsmAddress	node;
+	PsmAddress	successor;
+
+	/*	Returns the last group index entry that precedes the
+	 *	indicated (absent) entry, if any.			*/
+
+	node = sm_rbt_search(wm, vdb->groups, orderGroupRefs, argRef,
+			&successor);
+	if (node == 0)
+	{
+		if (successor)
+		{
+			node = sm_rbt_prev(wm, successor);
+		}
+		else
+		{
+			node = sm_rbt_last(wm, vdb->groups);
+		}
+	}
+
+	return (node ? sm_rbt_data(wm, node) : 0);
+}
+
+static int	indexGroup(IpnVdb *vdb, uvast firstNodeNbr,
+			uvast lastNodeNbr, Object groupElt)
+{
+	PsmPartition	wm = getIonwm();
+	IpnGroupRef	argRef;
+	PsmAddress	parent;
+	PsmAddress	refAddr;
+	IpnGroupRef	*ref;
+	PsmAddress	node;
+	PsmAddress	elt;
+
+	/*	The new group's parent is the narrowest enclosing
+	 *	group, which is either the group that precedes it in
+	 *	the index or one of that group's ancestors.		*/
+
+	argRef.firstNodeNbr = firstNodeNbr;
+	argRef.lastNodeNbr = lastNodeNbr;
+	parent = precedingGroupRef(wm, vdb, &argRef);
+	while (parent)
+	{
+		ref = (IpnGroupRef *) psp(wm, parent);
+		if (ref->lastNodeNbr >= lastNodeNbr)
+		{
+			break;		/*	Encloses new group.	*/
+		}
+
+		if (ref->lastNodeNbr >= firstNodeNbr)
+		{
+			vdb->groupsOverlap = 1;
+		}
+
+		parent = ref->parent;
+	}
+
+	refAddr = psm_zalloc(wm, sizeof(IpnGroupRef));
+	if (refAddr == 0)
+	{
+		return -1;
+	}
+
+	ref = (IpnGroupRef *) psp(wm, refAddr);
+	ref->firstNodeNbr = firstNodeNbr;
+	ref->lastNodeNbr = lastNodeNbr;
+	ref->groupElt = groupElt;
+	ref->parent = parent;
+	node = sm_rbt_insert(wm, vdb->groups, refAddr, orderGroupRefs, ref);
+	if (node == 0)
+	{
+		psm_free(wm, refAddr);
+		return -1;
+	}
+
+	/*	The new group becomes the parent of every group that
+	 *	it encloses and that formerly had the same parent.	*/
+
+	for (elt = sm_rbt_next(wm, node); elt; elt = sm_rbt_next(wm, elt))
+	{
+		ref = (IpnGroupRef *) psp(wm, sm_rbt_data(wm, elt));
+		if (ref->firstNodeNbr > lastNodeNbr)
+		{
+			break;		/*	Beyond new group.	*/
+		}
+
+		if (ref->lastNodeNbr > lastNodeNbr)
+		{
+			vdb->groupsOverlap = 1;
+			continue;
+		}
+
+		if (ref->parent == parent)
+		{
+			ref->parent = refAddr;
+		}
+	}
+
+	return 0;
+}
+
+static void	unindexGroup(IpnVdb *vdb, uvast firstNodeNbr,
+			uvast lastNodeNbr)
+{
+	PsmPartition	wm = getIonwm();
+	IpnGroupRef	argRef;
+	PsmAddress	node;
+	PsmAddress	refAddr;
+	IpnGroupRef	*group;
+	PsmAddress	elt;
+	IpnGroupRef	*ref;
+
+	argRef.firstNodeNbr = firstNodeNbr;
+	argRef.lastNodeNbr = lastNodeNbr;
+	node = sm_rbt_search(wm, vdb->groups, orderGroupRefs, &argRef, NULL);
+	if (node == 0)
+	{
+		return;
+	}
+
+	/*	The groups enclosed by this group revert to this
+	 *	group's own parent.					*/
+
+	refAddr = sm_rbt_data(wm, node);
+	group = (IpnGroupRef *) psp(wm, refAddr);
+	for (elt = sm_rbt_next(wm, node); elt; elt = sm_rbt_next(wm, elt))
+	{
+		ref = (IpnGroupRef *) psp(wm, sm_rbt_data(wm, elt));
+		if (ref->firstNodeNbr > lastNodeNbr)
+		{
+			break;
+		}
+
+		if (ref->parent == refAddr)
+		{
+			ref->parent = group->parent;
+		}
+	}
+
+	sm_rbt_delete(wm, vdb->groups, orderGroupRefs, &argRef, deleteRef,
+			NULL);
+}
+
+static void	dropIndex(PsmPartition wm, IpnVdb *vdb)
+{
+	if (vdb->plans)
+	{
+		sm_rbt_destroy(wm, vdb->plans, deleteRef, NULL);
+	}
+
+	if (vdb->groups)
+	{
+		sm_rbt_destroy(wm, vdb->groups, deleteRef, NULL);
+	}
+}
+
+static int	raiseIndex(Sdr sdr, IpnVdb *vdb)
+{
+	IpnDB		*db = _ipnConstants();
+	Object		elt;
+		OBJ_POINTER(IpnPlan, plan);
+		OBJ_POINTER(IpnGroup, group);
+
+	for (elt = sdr_list_first(sdr, db->plans); elt;
+			elt = sdr_list_next(sdr, elt))
+	{
+		GET_OBJ_POINTER(sdr, IpnPlan, plan, sdr_list_data(sdr, elt));
+		if (indexPlan(vdb, plan->nodeNbr, elt) < 0)
+		{
+			return -1;
+		}
+	}
+
+	for (elt = sdr_list_first(sdr, db->groups); elt;
+			elt = sdr_list_next(sdr, elt))
+	{
+		GET_OBJ_POINTER(sdr, IpnGroup, group, sdr_list_data(sdr, elt));
+		if (indexGroup(vdb, group->firstNodeNbr, group->lastNodeNbr,
+				elt) < 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static IpnVdb	*_ipnvdb(char **name)
+{
+	static IpnVdb	*vdb = NULL;
+	PsmPartition	wm;
+	PsmAddress	vdbAddress;
+	PsmAddress	elt;
+	Sdr		sdr;
+
+	if (name)
+	{
+		if (*name == NULL)	/*	Terminating.		*/
+		{
+			vdb = NULL;
+			return vdb;
+		}
+
+		/*	Attaching to volatile database.			*/
+
+		wm = getIonwm();
+		if (psm_locate(wm, *name, &vdbAddress, &elt) < 0)
+		{
+			putErrmsg("Failed searching for vdb.", NULL);
+			return vdb;
+		}
+
+		if (elt)
+		{
+			vdb = (IpnVdb *) psp(wm, vdbAddress);
+			return vdb;
+		}
+
+		/*	IPN volatile database doesn't exist yet, unless
+		 *	another task (ipnfw, ipnadminep, ipnadmin) has
+		 *	created it since we looked.			*/
+
+		sdr = getIonsdr();
+		CHKNULL(sdr_begin_xn(sdr));	/*	To lock memory.	*/
+		if (psm_locate(wm, *name, &vdbAddress, &elt) < 0)
+		{
+			sdr_exit_xn(sdr);
+			putErrmsg("Failed searching for vdb.", NULL);
+			return NULL;
+		}
+
+		if (elt)
+		{
+			vdb = (IpnVdb *) psp(wm, vdbAddress);
+			sdr_exit_xn(sdr);
+			return vdb;
+		}
+
+		vdbAddress = psm_zalloc(wm, sizeof(IpnVdb));
+		if (vdbAddress == 0)
+		{
+			sdr_exit_xn(sdr);
+			putErrmsg("No space for dynamic database.", NULL);
+			return NULL;
+		}
+
+		vdb = (IpnVdb *) psp(wm, vdbAddress);
+		memset((char *) vdb, 0, sizeof(IpnVdb));
+		if ((vdb->plans = sm_rbt_create(wm)) == 0
+		|| (vdb->groups = sm_rbt_create(wm)) == 0
+		|| raiseIndex(sdr, vdb) < 0
+		|| psm_catlg(wm, *name, vdbAddress) < 0)
+		{
+			dropIndex(wm, vdb);
+			psm_free(wm, vdbAddress);
+			vdb = NULL;
+			sdr_exit_xn(sdr);
+			putErrmsg("Can't initialize volatile database.", NULL);
+			return NULL;
+		}
+
+		sdr_exit_xn(sdr);
+	}
+
+	return vdb;
+}
+
 /*	*	*	Routing information mgt functions	*	*/
 
 int	ipnInit()
@@ -73,6 +438,7 @@ int	ipnInit()
 	Sdr	sdr = getIonsdr();
 	Object	ipndbObject;
 	IpnDB	ipndbBuf;
+	char	*ipnvdbName = _ipnvdbName();
 
 	/*	Recover the IPN database, creating it if necessary.	*/
 
@@ -113,6 +479,12 @@ int	ipnInit()
 
 	oK(_ipndbObject(&ipndbObject));
 	oK(_ipnConstants());
+	if (_ipnvdb(&ipnvdbName) == NULL)
+	{
+		putErrmsg("IPN can't initialize vdb.", NULL);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -126,11 +498,46 @@ IpnDB	*getIpnConstants()
 	return _ipnConstants();
 }
 
+IpnVdb	*getIpnVdb()
+{
+	return _ipnvdb(NULL);
+}
+
+void	ipnDropVdb()
+{
+	PsmPartition	wm = getIonwm();
+	char		*ipnvdbName = _ipnvdbName();
+	PsmAddress	vdbAddress;
+	PsmAddress	elt;
+	char		*stop = NULL;
+
+	if (psm_locate(wm, ipnvdbName, &vdbAddress, &elt) < 0)
+	{
+		putErrmsg("Failed searching for vdb.", NULL);
+		return;
+	}
+
+	if (elt)
+	{
+		dropIndex(wm, (IpnVdb *) psp(wm, vdbAddress));
+		psm_free(wm, vdbAddress);
+		if (psm_uncatlg(wm, ipnvdbName) < 0)
+		{
+			putErrmsg("Failed uncataloging vdb.", NULL);
+		}
+	}
+
+	oK(_ipnvdb(&stop));			/*	Forget old Vdb.	*/
+}
+
 static Object	locatePlan(uvast nodeNbr, Object *nextPlan)
 {
-	Sdr	sdr = getIonsdr();
-	Object	elt;
-		OBJ_POINTER(IpnPlan, plan);
+	PsmPartition	wm = getIonwm();
+	IpnVdb		*vdb = _ipnvdb(NULL);
+	IpnPlanRef	argRef;
+	PsmAddress	node;
+	PsmAddress	successor;
+	IpnPlanRef	*ref;
 
 	/*	This function locates the IpnPlan identified by the
 	 *	specified node number, if any.  If none, notes the
@@ -138,25 +545,24 @@ static Object	locatePlan(uvast nodeNbr, Object *nextPlan)
 	 *	should be inserted.					*/
 
 	if (nextPlan) *nextPlan = 0;	/*	Default.		*/
-	for (elt = sdr_list_first(sdr, (_ipnConstants())->plans); elt;
-			elt = sdr_list_next(sdr, elt))
+	CHKZERO(vdb);
+	argRef.nodeNbr = nodeNbr;
+	node = sm_rbt_search(wm, vdb->plans, orderPlanRefs, &argRef,
+			&successor);
+	if (node == 0)
 	{
-		GET_OBJ_POINTER(sdr, IpnPlan, plan, sdr_list_data(sdr, elt));
-		if (plan->nodeNbr < nodeNbr)
+		if (nextPlan && successor)
 		{
-			continue;
-		}
-		
-		if (plan->nodeNbr > nodeNbr)
-		{
-			if (nextPlan) *nextPlan = elt;
-			break;		/*	Same as end of list.	*/
+			ref = (IpnPlanRef *) psp(wm, sm_rbt_data(wm,
+					successor));
+			*nextPlan = ref->planElt;
 		}
 
-		return elt;
+		return 0;
 	}
 
-	return 0;
+	ref = (IpnPlanRef *) psp(wm, sm_rbt_data(wm, node));
+	return ref->planElt;
 }
 
 void	ipn_findPlan(uvast nodeNbr, Object *planAddr, Object *eltp)
@@ -211,6 +617,7 @@ int	ipn_addPlan(uvast nodeNbr, DuctExpression *defaultDuct)
 	Object	nextPlan;
 	IpnPlan	plan;
 	Object	planObj;
+	Object	elt;
 
 	CHKERR(nodeNbr && defaultDuct);
 	CHKERR(sdr_begin_xn(sdr));
@@ -231,15 +638,21 @@ int	ipn_addPlan(uvast nodeNbr, DuctExpression *defaultDuct)
 	{
 		if (nextPlan)
 		{
-			oK(sdr_list_insert_before(sdr, nextPlan, planObj));
+			elt = sdr_list_insert_before(sdr, nextPlan, planObj);
 		}
 		else
 		{
-			oK(sdr_list_insert_last(sdr,
-					(_ipnConstants())->plans, planObj));
+			elt = sdr_list_insert_last(sdr,
+					(_ipnConstants())->plans, planObj);
 		}
 
 		sdr_write(sdr, planObj, (char *) &plan, sizeof(IpnPlan));
+		if (elt == 0 || indexPlan(_ipnvdb(NULL), nodeNbr, elt) < 0)
+		{
+			sdr_cancel_xn(sdr);
+			putErrmsg("Can't index plan.", utoa(nodeNbr));
+			return -1;
+		}
 	}
 
 	if (sdr_end_xn(sdr) < 0)
@@ -321,6 +734,7 @@ int	ipn_removePlan(uvast nodeNbr)
 
 	/*	Okay to remove this plan from the database.		*/
 
+	unindexPlan(_ipnvdb(NULL), nodeNbr);
 	sdr_list_delete(sdr, elt, NULL, NULL);
 	destroyXmitDirective(&(plan->defaultDirective));
 	sdr_list_destroy(sdr, plan->rules, NULL, NULL);
@@ -707,18 +1121,40 @@ int	ipn_lookupPlanDirective(uvast nodeNbr, unsigned int sourceServiceNbr,
 static Object	locateGroup(uvast firstNodeNbr, uvast lastNodeNbr,
 			Object *nextGroup)
 {
-	Sdr	sdr = getIonsdr();
-	int	targetSize;
-	int	groupSize;
-	Object	elt;
+	Sdr		sdr = getIonsdr();
+	PsmPartition	wm = getIonwm();
+	IpnVdb		*vdb = _ipnvdb(NULL);
+	IpnGroupRef	argRef;
+	PsmAddress	node;
+	uvast		targetSize;
+	uvast		groupSize;
+	Object		elt;
 		OBJ_POINTER(IpnGroup, group);
 
 	/*	This function locates the IpnGroup for the specified
-	 *	first node number, if any; if none, notes the
-	 *	location within the rules list at which such a rule
-	 *	should be inserted.					*/
+	 *	node range, if any; if none, notes the location within
+	 *	the groups list at which such a group should be
+	 *	inserted.						*/
 
 	if (nextGroup) *nextGroup = 0;	/*	Default.		*/
+	CHKZERO(vdb);
+	argRef.firstNodeNbr = firstNodeNbr;
+	argRef.lastNodeNbr = lastNodeNbr;
+	node = sm_rbt_search(wm, vdb->groups, orderGroupRefs, &argRef, NULL);
+	if (node)
+	{
+		return ((IpnGroupRef *) psp(wm, sm_rbt_data(wm, node)))
+				->groupElt;
+	}
+
+	if (nextGroup == NULL)
+	{
+		return 0;
+	}
+
+	/*	The groups list itself remains sorted by first node
+	 *	number within group size, both ascending.		*/
+
 	targetSize = lastNodeNbr - firstNodeNbr;
 	for (elt = sdr_list_first(sdr, (_ipnConstants())->groups); elt;
 			elt = sdr_list_next(sdr, elt))
@@ -730,26 +1166,12 @@ static Object	locateGroup(uvast firstNodeNbr, uvast lastNodeNbr,
 			continue;
 		}
 
-		if (groupSize > targetSize)
-		{
-			if (nextGroup) *nextGroup = elt;
-			break;		/*	Same as end of list.	*/
-		}
-
-		if (group->firstNodeNbr < firstNodeNbr)
-		{
-			continue;
-		}
-
-		if (group->firstNodeNbr > firstNodeNbr)
+		if (groupSize > targetSize
+		|| group->firstNodeNbr > firstNodeNbr)
 		{
-			if (nextGroup) *nextGroup = elt;
-			break;		/*	Same as end of list.	*/
+			*nextGroup = elt;
+			break;
 		}
-
-		/*	Matched group's first node number.		*/
-
-		return elt;
 	}
 
 	return 0;
@@ -784,6 +1206,7 @@ int	ipn_addGroup(uvast firstNodeNbr, uvast lastNodeNbr, char *viaEid)
 	Object		nextGroup;
 	IpnGroup	group;
 	Object		addr;
+	Object		elt;
 
 	CHKERR(firstNodeNbr && lastNodeNbr && viaEid);
 	CHKERR(firstNodeNbr <= lastNodeNbr);
@@ -809,15 +1232,22 @@ int	ipn_addGroup(uvast firstNodeNbr, uvast lastNodeNbr, char *viaEid)
 	{
 		if (nextGroup)
 		{
-			sdr_list_insert_before(sdr, nextGroup, addr);
+			elt = sdr_list_insert_before(sdr, nextGroup, addr);
 		}
 		else
 		{
-			sdr_list_insert_last(sdr, (_ipnConstants())->groups,
-					addr);
+			elt = sdr_list_insert_last(sdr,
+					(_ipnConstants())->groups, addr);
 		}
 
 		sdr_write(sdr, addr, (char *) &group, sizeof(IpnGroup));
+		if (elt == 0 || indexGroup(_ipnvdb(NULL), firstNodeNbr,
+				lastNodeNbr, elt) < 0)
+		{
+			sdr_cancel_xn(sdr);
+			putErrmsg("Can't index group.", utoa(firstNodeNbr));
+			return -1;
+		}
 	}
 
 	if (sdr_end_xn(sdr) < 0)
@@ -894,6 +1324,7 @@ int	ipn_removeGroup(uvast firstNodeNbr, uvast lastNodeNbr)
 
 	/*	All parameters validated, okay to remove the group.	*/
 
+	unindexGroup(_ipnvdb(NULL), firstNodeNbr, lastNodeNbr);
 	sdr_list_delete(sdr, elt, NULL, NULL);
 	sdr_free(sdr, group->defaultDirective.eid);
 	sdr_free(sdr, addr);
@@ -1116,12 +1547,75 @@ int	ipn_removeGroupRule(uvast firstNodeNbr, uvast lastNodeNbr,
 	return 1;
 }
 
+static IpnGroupRef	*lookupGroupRef(PsmPartition wm, IpnVdb *vdb,
+				uvast nodeNbr)
+{
+	IpnGroupRef	argRef;
+	PsmAddress	refAddr;
+	PsmAddress	node;
+	IpnGroupRef	*ref;
+	IpnGroupRef	*best = NULL;
+	uvast		size;
+	uvast		bestSize = 0;
+
+	/*	The best matching group is the narrowest one whose
+	 *	range encompasses the node number, the one with the
+	 *	lowest first node number if several are equally
+	 *	narrow.  When no groups partially overlap, that is
+	 *	the last group starting at or before the node number
+	 *	or the nearest of its ancestors that encompasses it.	*/
+
+	if (vdb->groupsOverlap)
+	{
+		for (node = sm_rbt_first(wm, vdb->groups); node;
+				node = sm_rbt_next(wm, node))
+		{
+			ref = (IpnGroupRef *) psp(wm, sm_rbt_data(wm, node));
+			if (ref->firstNodeNbr > nodeNbr)
+			{
+				break;
+			}
+
+			if (ref->lastNodeNbr < nodeNbr)
+			{
+				continue;
+			}
+
+			size = ref->lastNodeNbr - ref->firstNodeNbr;
+			if (best == NULL || size < bestSize)
+			{
+				best = ref;
+				bestSize = size;
+			}
+		}
+
+		return best;
+	}
+
+	argRef.firstNodeNbr = nodeNbr;
+	argRef.lastNodeNbr = 0;
+	refAddr = precedingGroupRef(wm, vdb, &argRef);
+	while (refAddr)
+	{
+		ref = (IpnGroupRef *) psp(wm, refAddr);
+		if (ref->lastNodeNbr >= nodeNbr)
+		{
+			return ref;
+		}
+
+		refAddr = ref->parent;
+	}
+
+	return NULL;
+}
+
 int	ipn_lookupGroupDirective(uvast nodeNbr, unsigned int sourceServiceNbr,
 		uvast sourceNodeNbr, FwdDirective *dirbuf)
 {
 	Sdr		sdr = getIonsdr();
-	Object		elt;
-	Object		addr;
+	PsmPartition	wm = getIonwm();
+	IpnVdb		*vdb = _ipnvdb(NULL);
+	IpnGroupRef	*ref;
 	IpnGroup	group;
 
 	/*	This function determines the relevant FwdDirective for
@@ -1129,31 +1623,19 @@ int	ipn_lookupGroupDirective(uvast nodeNbr, unsigned int sourceServiceNbr,
 
 	CHKERR(ionLocked());
 	CHKERR(nodeNbr && dirbuf);
+	CHKERR(vdb);
 
-	/*	Find best matching group.  Groups are sorted by first
-	 *	node number within group size, both ascending.  So
-	 *	the first group whose range encompasses the node number
-	 *	is the best fit (narrowest applicable range), but
-	 *	there's no way to terminate the search early.		*/
-
-	for (elt = sdr_list_first(sdr, (_ipnConstants())->groups); elt;
-			elt = sdr_list_next(sdr, elt))
-	{
-		addr = sdr_list_data(sdr, elt);
-		sdr_read(sdr, (char *) &group, addr, sizeof(IpnGroup));
-		if (group.lastNodeNbr < nodeNbr || group.firstNodeNbr > nodeNbr)
-		{
-			continue;
-		}
-
-		break;
-	}
+	/*	Find best matching group.				*/
 
-	if (elt == 0)
+	ref = lookupGroupRef(wm, vdb, nodeNbr);
+	if (ref == NULL)
 	{
 		return 0;		/*	No group found.		*/
 	}
 
+	sdr_read(sdr, (char *) &group, sdr_list_data(sdr, ref->groupElt),
+			sizeof(IpnGroup));
+
 	/*	Find best matching rule.				*/
 
 	if (lookupRule(group.rules, sourceServiceNbr, sourceNodeNbr,
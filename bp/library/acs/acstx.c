@@ -559,10 +559,11 @@ int trySendAcs(SdrAcsPendingCust *custodian,
 	if(signal.acsDue == 0)
 	{
 		timelineEvent.type = csDue;
+		getUTCTimeval(&timelineEvent.time);
 		if(custodian->acsDelay == 0) {
-			timelineEvent.time = getUTCTime() + DEFAULT_ACS_DELAY;
+			timelineEvent.time.tv_sec += DEFAULT_ACS_DELAY;
 		} else {
-			timelineEvent.time = getUTCTime() + custodian->acsDelay;
+			timelineEvent.time.tv_sec += custodian->acsDelay;
 		}
 		timelineEvent.ref  = signalLElt;
 		signal.acsDue = insertBpTimelineEvent(&timelineEvent);
@@ -939,6 +939,43 @@ int	acquireExtensionBlock(AcqWorkArea *work, ExtensionDef *def,
 	return 0;
 }
 
+int	prepareExtensionBlocks(AcqWorkArea *work)
+{
+	int		i;
+	LystElt		elt;
+	AcqExtBlock	*blk;
+	ExtensionDef	*def;
+
+	/*	Invoked outside of any SDR transaction, so that
+	 *	extension-specific processing that is expensive but
+	 *	needs no database update (e.g., computing a digest
+	 *	over a large payload) doesn't hold the SDR locked.	*/
+
+	CHKERR(work);
+	for (i = 0; i < 2; i++)
+	{
+		for (elt = lyst_first(work->extBlocks[i]); elt;
+				elt = lyst_next(elt))
+		{
+			blk = (AcqExtBlock *) lyst_data(elt);
+			def = findExtensionDef(blk->type);
+			if (def == NULL || def->prepare == NULL)
+			{
+				continue;
+			}
+
+			if (def->prepare(blk, work) < 0)
+			{
+				putErrmsg("Can't prepare extension block.",
+						def->name);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
 int	decryptPerExtensionBlocks(AcqWorkArea *work)
 {
 	Bundle		*bundle = &(work->bundle);
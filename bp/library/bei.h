@@ -126,6 +126,7 @@ typedef int		(*BpAcqExtBlkParseFn)(AcqExtBlock *, AcqWorkArea *);
 typedef int		(*BpAcqExtBlkCheckFn)(AcqExtBlock *, AcqWorkArea *);
 typedef int		(*BpExtBlkRecordFn)(ExtensionBlock *, AcqExtBlock *);
 typedef void		(*BpAcqExtBlkClearFn)(AcqExtBlock *);
+typedef int		(*BpAcqExtBlkPrepareFn)(AcqExtBlock *, AcqWorkArea *);
 
 /**
  *  \struct ExtensionDef
@@ -156,6 +157,12 @@ typedef struct
 	BpAcqExtBlkCheckFn	check;		/** Check 		*/
 	BpExtBlkRecordFn	record;		/** Record 		*/
 	BpAcqExtBlkClearFn	clear;		/** Clear 		*/
+
+	/*	Optional acquisition callback invoked before the
+	 *	transaction in which the bundle is acquired is begun,
+	 *	for lengthy computation over the bundle's content.	*/
+
+	BpAcqExtBlkPrepareFn	prepare;	/** Prepare		*/
 } ExtensionDef;
 
 /**
@@ -286,6 +293,7 @@ extern int	acquireExtensionBlock(AcqWorkArea *wk, ExtensionDef *def,
 			unsigned char *startOfBlock, unsigned int blockLength,
 			unsigned char blkType, unsigned int blkProcFlags,
 			Lyst *eidReferences, unsigned int dataLength);
+extern int	prepareExtensionBlocks(AcqWorkArea *wk);
 extern int	decryptPerExtensionBlocks(AcqWorkArea *wk);
 extern int	parseExtensionBlocks(AcqWorkArea *wk);
 extern int	checkPerExtensionBlocks(AcqWorkArea *wk);
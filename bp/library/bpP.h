@@ -19,6 +19,7 @@
 
 #include "rfx.h"
 #include "ionsec.h"
+#include "sdrwheel.h"
 #include "bp.h"
 
 #ifdef __cplusplus
@@ -343,7 +344,7 @@ typedef struct
 
 	Object		hashEntry;	/*	Entry in bundles hash.	*/
 
-	Object		timelineElt;	/*	TTL expire list ref.	*/
+	Object		timelineElt;	/*	TTL expire wheel ref.	*/
 	Object		overdueElt;	/*	Xmit overdue ref.	*/
 	Object		ctDueElt;	/*	CT deadline ref.	*/
 	Object		transitElt;	/*	Transit queue ref.	*/
@@ -583,10 +584,17 @@ typedef enum
 	csDue = 4
 } BpEventType;
 
+/*	The timeline is a timing wheel that advances in ticks of
+ *	10 milliseconds, so that timers that are set relative to the
+ *	current time (custody and ACS timers) expire on time rather
+ *	than at the start of some later second.				*/
+
+#define	BP_TIMELINE_RESOLUTION	10
+
 typedef struct
 {
 	BpEventType	type;
-	time_t		time;		/*	as from time(2)		*/
+	struct timeval	time;		/*	as from getUTCTimeval()	*/
 	Object		ref;		/*	Bundle, etc.		*/
 } BpEvent;
 
@@ -600,7 +608,7 @@ typedef struct
 {
 	Object		schemes;	/*	SDR list of Schemes	*/
 	Object		protocols;	/*	SDR list of ClProtocols	*/
-	Object		timeline;	/*	SDR list of BpEvents	*/
+	Object		timeline;	/*	SDR wheel of BpEvents	*/
 	Object		bundles;	/*	SDR hash of BundleSets	*/
 	Object		inboundBundles;	/*	SDR list of ZCOs	*/
 
@@ -730,7 +738,6 @@ typedef struct
 	PsmAddress	schemes;	/*	SM list: VScheme.	*/
 	PsmAddress	inducts;	/*	SM list: VInduct.	*/
 	PsmAddress	outducts;	/*	SM list: VOutduct.	*/
-	PsmAddress	timeline;	/*	SM RB tree: list xref.	*/
 } BpVdb;
 
 /*	*	*	Acquisition structures	*	*	*	*/
@@ -1029,6 +1036,65 @@ extern int		bpDequeue(	VOutduct *vduct,
 			 *
 			 *	Returns 0 on success, -1 on failure.	*/
 
+typedef struct
+{
+	Object		bundleZco;
+	BpExtendedCOS	extendedCOS;
+	char		destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
+} BpDequeuedBundle;
+
+#define	BP_DEQUEUE_BATCH	(16)
+
+extern int		bpDequeueBatch(	VOutduct *vduct,
+					Outflow *outflows,
+					BpDequeuedBundle *batch,
+					int maxBundles,
+					unsigned int maxBytes,
+					unsigned int maxPayloadLength,
+					int timeoutInterval);
+			/*	This function is like bpDequeue except
+			 *	that it may return more than one bundle
+			 *	for transmission, all obtained within
+			 *	a single transaction.  It blocks (as
+			 *	bpDequeue does) until the first bundle
+			 *	is available; it then continues to
+			 *	dequeue bundles, without blocking, until
+			 *	no more bundles are ready, maxBundles
+			 *	bundles have been dequeued, the total
+			 *	length of the catenated bundles reaches
+			 *	maxBytes (if maxBytes is greater than
+			 *	zero), or the outduct's xmitThrottle
+			 *	runs out of capacity.
+			 *
+			 *	The catenated bundle ZCO, extended
+			 *	class of service, and destination duct
+			 *	name of each dequeued bundle are placed
+			 *	in successive elements of batch, which
+			 *	must be an array of at least maxBundles
+			 *	BpDequeuedBundle structures.  The
+			 *	significance of maxPayloadLength and
+			 *	timeoutInterval is as for bpDequeue;
+			 *	in particular, if timeoutInterval is
+			 *	negative then the calling function
+			 *	must disposition every returned bundle
+			 *	by calling either bpHandleXmitSuccess
+			 *	or bpHandleXmitFailure.
+			 *
+			 *	Returns the number of bundles dequeued
+			 *	(zero if interrupted), -1 on failure.	*/
+
+extern int		bpReturnBundle(Object bundleZco);
+			/*	Hands a bundle that was dequeued (with
+			 *	negative timeoutInterval) but will not
+			 *	be transmitted back to BP for re-
+			 *	forwarding, as for bpHandleXmitFailure,
+			 *	and then destroys the caller's
+			 *	reference to the bundle's ZCO.  For
+			 *	use by CLOs that stop partway through
+			 *	a dequeued batch.
+			 *
+			 *	Returns 0 on success, -1 on failure.	*/
+
 extern int		bpIdentify(Object bundleZco, Object *bundleObj);
 			/*	This function parses out the ID fields
 			 *	of the catenated outbound bundle in
@@ -1366,7 +1432,7 @@ extern int		bpBlockOutduct(char *protocolName, char *ductName);
 extern int		bpUnblockOutduct(char *protocolName, char *ductName);
 
 extern Object		insertBpTimelineEvent(BpEvent *newEvent);
-extern void		destroyBpTimelineEvent(Object timelineElt);
+extern void		destroyBpTimelineEvent(Object timelineEntry);
 
 extern void	        removeBundleFromQueue(Bundle *bundle, Object bundleObj,
 			        ClProtocol *protocol, Object outductObj,
@@ -1379,6 +1445,12 @@ extern int		findBundle(char *sourceEid, BpTimestamp *creationTime,
 				unsigned int fragmentOffset,
 				unsigned int fragmentLength,
 				Object *bundleAddr);
+extern int		findBundleById(EndpointId *sourceEid,
+				char *dictionary,
+				BpTimestamp *creationTime,
+				unsigned int fragmentOffset,
+				unsigned int fragmentLength,
+				Object *bundleAddr);
 extern int		retrieveSerializedBundle(Object bundleZco, Object *obj);
 
 extern int		deliverBundle(Object bundleObj, Bundle *bundle,
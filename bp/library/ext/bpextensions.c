@@ -134,7 +134,8 @@ static ExtensionDef	extensionDefs[] =
 				0,
 				bsp_babCheck,
 				0,
-				bsp_babClear
+				bsp_babClear,
+				bsp_babPrepare
 		},
 		{ "bcb", EXTENSION_TYPE_BCB,
 				bsp_bcbOffer,
@@ -166,7 +167,8 @@ static ExtensionDef	extensionDefs[] =
 				bsp_bibParse,
 				bsp_bibCheck,
 				0,
-				bsp_bibClear
+				bsp_bibClear,
+				bsp_bibPrepare
 		},
 #endif /* ORIGINAL_BSP */
 		{ "ecos", EXTENSION_TYPE_ECOS,
@@ -28,6 +28,8 @@ extern char		gMsg[];		/*	Debug message buffer.	*/
  *   bsp_babRelease (Last)                                                   *
  *                                                  bsp_babAcquire (First)   *
  *                                                  bsp_babAcquire (Last)    *
+ *                                                  bsp_babPrepare (First)   *
+ *                                                  bsp_babPrepare (Last)    *
  *                                                  bsp_babCheck (First)     *
  *                                                  bsp_babCheck (Last)      *
  *                                                  bsp_babClear (First)     *
@@ -398,17 +400,11 @@ int	bsp_babAcquire(AcqExtBlock *blk, AcqWorkArea *wk)
 	return result;
 }
 
-static int	babCheck(AcqExtBlock *blk, AcqWorkArea *wk)
+static void	babGetInboundCiphersuite(AcqWorkArea *wk, BspBabRule *babRule,
+			BabCiphersuite **cs)
 {
 	char		*fromEid;
 	char		*toEid;
-	BspBabRule	babRule;
-	BabCiphersuite	*cs;
-	LystElt		lastBab;
-	BspInboundBlock	*asb;
-
-	CHKERR(blk);
-	CHKERR(wk);
 
 	/*	For BABs, the security destination is the receiving
 	 *	node (the local node) and the security source is the
@@ -429,7 +425,74 @@ static int	babCheck(AcqExtBlock *blk, AcqWorkArea *wk)
 
 	/*	Given sender & receiver EIDs, get applicable BAB rule.	*/
 
-	babGetCiphersuite(fromEid, toEid, &babRule, &cs);
+	babGetCiphersuite(fromEid, toEid, babRule, cs);
+}
+
+/******************************************************************************
+ *
+ * \par Function Name: bsp_babPrepare
+ *
+ * \par Purpose: This callback is called after a bundle containing a BAB
+ *               has been parsed but before the transaction in which the
+ *               bundle is acquired is begun.  If the applicable ciphersuite
+ *               can compute the bundle's security result in advance, it
+ *               does so now, so that the digest is computed without the
+ *               SDR being locked.
+ *
+ * \retval int  0 - Preparation succeeded or was not applicable.
+ *             -1 - There was a system error.
+ *
+ * \param[in]  blk  The acquisition block being prepared.
+ * \param[in]  wk   The work area associated with this bundle acquisition.
+ *
+ * \par Notes:
+ *      1. bsp_babCheck still verifies the block, using the digest that
+ *         was computed here if there is one.
+ *****************************************************************************/
+
+int	bsp_babPrepare(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	Sdr		bpSdr = getIonsdr();
+	BspBabRule	babRule;
+	BabCiphersuite	*cs;
+	BspInboundBlock	*asb;
+	int		result;
+
+	BAB_DEBUG_PROC("+ bsp_babPrepare(%d, %x)", blk->occurrence,
+			(unsigned long) blk);
+
+	CHKERR(blk);
+	CHKERR(wk);
+	asb = (BspInboundBlock *) (blk->object);
+	if (asb == NULL)
+	{
+		return 0;
+	}
+
+	CHKERR(sdr_begin_xn(bpSdr));
+	babGetInboundCiphersuite(wk, &babRule, &cs);
+	sdr_exit_xn(bpSdr);
+	if (cs == NULL || cs->prepare == NULL)
+	{
+		return 0;
+	}
+
+	memcpy((char *) (asb->keyName), babRule.keyName, BSP_KEY_NAME_LEN);
+	result = cs->prepare(wk, blk);
+	BAB_DEBUG_PROC("- bsp_babPrepare --> %d", result);
+	return result;
+}
+
+static int	babCheck(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	BspBabRule	babRule;
+	BabCiphersuite	*cs;
+	LystElt		lastBab;
+	BspInboundBlock	*asb;
+
+	CHKERR(blk);
+	CHKERR(wk);
+	babGetInboundCiphersuite(wk, &babRule, &cs);
 	if (cs == NULL)
 	{
 		discardExtensionBlock(blk);
@@ -463,6 +526,16 @@ in the bundle.  Discarding this one.", NULL);
 	/*	Fill in missing information in the scratchpad area. 	*/
 
 	asb = (BspInboundBlock *) (blk->object);
+	if (asb->digest && memcmp(asb->keyName, babRule.keyName,
+			BSP_KEY_NAME_LEN) != 0)
+	{
+		/*	Rule changed since the digest was prepared.	*/
+
+		MRELEASE(asb->digest);
+		asb->digest = NULL;
+		asb->digestLen = 0;
+	}
+
 	memcpy((char *) (asb->keyName), babRule.keyName, BSP_KEY_NAME_LEN);
 
 	/*	Invoke ciphersuite-specific check procedure.  For the
@@ -570,6 +643,11 @@ void	bsp_babClear(AcqExtBlock *blk)
 			MRELEASE(asb->resultsData);
 		}
 
+		if (asb->digest)
+		{
+			MRELEASE(asb->digest);
+		}
+
 		MRELEASE(blk->object);
 		blk->object = NULL;
 		blk->size = 0;
@@ -255,6 +255,24 @@ void	bsp_babRelease(ExtensionBlock *blk);
 
 int	bsp_babAcquire(AcqExtBlock *blk, AcqWorkArea *wk);
 
+/******************************************************************************
+ *
+ * \par Function Name: bsp_babPrepare
+ *
+ * \par Purpose: This callback computes the security result of a received
+ *               bundle, if the applicable ciphersuite supports doing so,
+ *               before the transaction in which the bundle is acquired.
+ * 		 See the bspbab.c comments for details.
+ *
+ * \retval int  0 - Preparation succeeded or was not applicable.
+ *             -1 - There was a system error.
+ *
+ * \param[in]  blk  The acquisition block being prepared.
+ * \param[in]  wk   The work area associated with this bundle acquisition.
+ *****************************************************************************/
+
+int	bsp_babPrepare(AcqExtBlock *blk, AcqWorkArea *wk);
+
 /******************************************************************************
  *
  * \par Function Name: bsp_babCheck
@@ -17,6 +17,7 @@ extern char		gMsg[];		/*	Debug message buffer.	*/
  *   bsp_bibProcessOnDequeue                                                 *
  *   bsp_bibRelease                                                          *
  *   bsp_bibCopy                                                             *
+ *                                                  bsp_bibPrepare           *
  *                                                  bsp_bibParse             *
  *                                                  bsp_bibCheck             *
  *                                                  bsp_bibRecord            *
@@ -484,6 +485,12 @@ int	bsp_bibParse(AcqExtBlock *blk, AcqWorkArea *wk)
 
 	CHKERR(blk);
 	CHKERR(wk);
+	if (blk->object)	/*	Deserialized by prepare.	*/
+	{
+		BIB_DEBUG_PROC("- bsp_bibParse -> %d", 1);
+		return 1;
+	}
+
 	result = bsp_deserializeASB(blk, wk);
 	BIB_DEBUG_INFO("i bsp_bibParse: Deserialize result %d", result);
 
@@ -492,47 +499,14 @@ int	bsp_bibParse(AcqExtBlock *blk, AcqWorkArea *wk)
 	return result;
 }
 
-/******************************************************************************
- *
- * \par Function Name: bsp_bibCheck
- *
- * \par Purpose: This callback determine whether or not a BIB's security
- * 		 target block has been corrupted end route.  Specifically,
- * 		 a newly computed hash for the security target block
- * 		 must match the security result encoded in the BIB.
- *
- * \retval int 0 - The block was not found to be corrupt.
- *             3 - The block was found to be corrupt.
- *            -1 - There was a system error.
- *
- * \param[in]  blk  The BIB whose target must be checked.
- * \param[in]  wk   The working area holding other acquisition blocks and the
- *                  rest of the received bundle.
- *
- * \par Notes:
- *****************************************************************************/
-
-int	bsp_bibCheck(AcqExtBlock *blk, AcqWorkArea *wk)
+static int	bibGetInboundCiphersuite(AcqExtBlock *blk, AcqWorkArea *wk,
+			BspBibRule *bibRule, BibCiphersuite **cs)
 {
 	Bundle		*bundle;
 	char		*dictionary;
-	BspInboundBlock	*asb = NULL;
+	BspInboundBlock	*asb;
 	char		*fromEid;
 	char		*toEid;
-	BspBibRule	bibRule;
-	BibCiphersuite	*cs;
-	int		result;
-
-	BIB_DEBUG_PROC("+ bsp_bibCheck(%x, %x)", (unsigned long) blk,
-			(unsigned long) wk);
-
-	if (blk == NULL || blk->object == NULL || wk == NULL)
-	{
-		BIB_DEBUG_ERR("x bsp_bibCheck:  Blocks are NULL. %x",
-				(unsigned long) blk);
-		BIB_DEBUG_PROC("- bsp_bibCheck --> %d", -1);
-		return -1;
-	}
 
 	/*	For BIBs, the security destination is always the final
 	 *	destination of the bundle.  The security source is
@@ -576,9 +550,154 @@ int	bsp_bibCheck(AcqExtBlock *blk, AcqWorkArea *wk)
 
 	/*	Given sender & receiver EIDs, get applicable BIB rule.	*/
 
-	bibGetCiphersuite(fromEid, toEid, asb->targetBlockType, &bibRule, &cs);
+	bibGetCiphersuite(fromEid, toEid, asb->targetBlockType, bibRule, cs);
 	MRELEASE(fromEid);
 	MRELEASE(toEid);
+	return 0;
+}
+
+static int	bundleHasBcb(AcqWorkArea *wk)
+{
+	int		i;
+	LystElt		elt;
+	AcqExtBlock	*blk;
+
+	for (i = 0; i < 2; i++)
+	{
+		for (elt = lyst_first(wk->extBlocks[i]); elt;
+				elt = lyst_next(elt))
+		{
+			blk = (AcqExtBlock *) lyst_data(elt);
+			if (blk->type == EXTENSION_TYPE_BCB)
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ *
+ * \par Function Name: bsp_bibPrepare
+ *
+ * \par Purpose: This callback is called after a bundle containing a BIB
+ * 		 has been parsed but before the transaction in which the
+ * 		 bundle is acquired is begun.  If the applicable ciphersuite
+ * 		 can compute the digest of the BIB's security target in
+ * 		 advance, it does so now, so that the digest is computed
+ * 		 without the SDR being locked.
+ *
+ * \retval int 0 - Preparation succeeded or was not applicable.
+ *            -1 - There was a system error.
+ *
+ * \param[in]  blk  The BIB to prepare.
+ * \param[in]  wk   The work area associated with this bundle acquisition.
+ *
+ * \par Notes:
+ *	1. Nothing is prepared for a bundle that contains any BCB, as
+ *	   decryption may change both the BIB and its security target.
+ *****************************************************************************/
+
+int	bsp_bibPrepare(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	Sdr		bpSdr = getIonsdr();
+	BspInboundBlock	*asb;
+	BspBibRule	bibRule;
+	BibCiphersuite	*cs;
+	int		result;
+
+	BIB_DEBUG_PROC("+ bsp_bibPrepare(%x, %x)", (unsigned long) blk,
+			(unsigned long) wk);
+
+	CHKERR(blk);
+	CHKERR(wk);
+	if (bundleHasBcb(wk))
+	{
+		return 0;
+	}
+
+	result = bsp_deserializeASB(blk, wk);
+	if (result < 0)
+	{
+		return -1;
+	}
+
+	if (result == 0)
+	{
+		return 0;	/*	Malformed: parse reports.	*/
+	}
+
+	asb = (BspInboundBlock *) (blk->object);
+	if (asb->targetBlockType != BLOCK_TYPE_PAYLOAD)
+	{
+		return 0;
+	}
+
+	CHKERR(sdr_begin_xn(bpSdr));
+	result = bibGetInboundCiphersuite(blk, wk, &bibRule, &cs);
+	sdr_exit_xn(bpSdr);
+	if (result < 0)
+	{
+		return -1;
+	}
+
+	if (cs == NULL || cs->prepare == NULL)
+	{
+		return 0;
+	}
+
+	memcpy(asb->keyName, bibRule.keyName, BSP_KEY_NAME_LEN);
+	result = cs->prepare(wk, blk);
+	BIB_DEBUG_PROC("- bsp_bibPrepare --> %d", result);
+	return result;
+}
+
+/******************************************************************************
+ *
+ * \par Function Name: bsp_bibCheck
+ *
+ * \par Purpose: This callback determine whether or not a BIB's security
+ * 		 target block has been corrupted end route.  Specifically,
+ * 		 a newly computed hash for the security target block
+ * 		 must match the security result encoded in the BIB.
+ *
+ * \retval int 0 - The block was not found to be corrupt.
+ *             3 - The block was found to be corrupt.
+ *            -1 - There was a system error.
+ *
+ * \param[in]  blk  The BIB whose target must be checked.
+ * \param[in]  wk   The working area holding other acquisition blocks and the
+ *                  rest of the received bundle.
+ *
+ * \par Notes:
+ *****************************************************************************/
+
+int	bsp_bibCheck(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	BspInboundBlock	*asb = NULL;
+	BspBibRule	bibRule;
+	BibCiphersuite	*cs;
+	int		result;
+
+	BIB_DEBUG_PROC("+ bsp_bibCheck(%x, %x)", (unsigned long) blk,
+			(unsigned long) wk);
+
+	if (blk == NULL || blk->object == NULL || wk == NULL)
+	{
+		BIB_DEBUG_ERR("x bsp_bibCheck:  Blocks are NULL. %x",
+				(unsigned long) blk);
+		BIB_DEBUG_PROC("- bsp_bibCheck --> %d", -1);
+		return -1;
+	}
+
+	if (bibGetInboundCiphersuite(blk, wk, &bibRule, &cs) < 0)
+	{
+		return -1;
+	}
+
+	asb = (BspInboundBlock *) (blk->object);
 	if (cs == NULL)
 	{
 		/*	We can't verify this signature.			*/
@@ -608,6 +727,16 @@ int	bsp_bibCheck(AcqExtBlock *blk, AcqWorkArea *wk)
 
 	/*	Fill in missing information in the scratchpad area.	*/
 
+	if (asb->digest && memcmp(asb->keyName, bibRule.keyName,
+			BSP_KEY_NAME_LEN) != 0)
+	{
+		/*	Rule changed since the digest was prepared.	*/
+
+		MRELEASE(asb->digest);
+		asb->digest = NULL;
+		asb->digestLen = 0;
+	}
+
 	memcpy(asb->keyName, bibRule.keyName, BSP_KEY_NAME_LEN);
 
 	/*	Invoke ciphersuite-specific check procedure.		*/
@@ -672,6 +801,11 @@ void	bsp_bibClear(AcqExtBlock *blk)
 			MRELEASE(asb->resultsData);
 		}
 
+		if (asb->digest)
+		{
+			MRELEASE(asb->digest);
+		}
+
 		BIB_DEBUG_INFO("i bsp_bibClear: Release ASB len %d", blk->size);
 
 		MRELEASE(blk->object);
@@ -233,6 +233,23 @@ extern int bsp_bibCopy(ExtensionBlock *newBlk, ExtensionBlock *oldBlk);
  *  06/15/09  E. Birrane           Initial Implementation.
  *****************************************************************************/
 
+/******************************************************************************
+ *
+ * \par Function Name: bsp_bibPrepare
+ *
+ * \par Purpose: This callback computes the digest of a BIB's security
+ * 		 target, if the applicable ciphersuite supports doing so,
+ * 		 before the transaction in which the bundle is acquired.
+ *
+ * \retval int 0 - Preparation succeeded or was not applicable.
+ *            -1 - There was a system error.
+ *
+ * \param[in]  blk  The BIB to prepare.
+ * \param[in]  wk   The work area associated with this bundle acquisition.
+ *****************************************************************************/
+
+int bsp_bibPrepare(AcqExtBlock *blk, AcqWorkArea *wk);
+
 int bsp_bibParse(AcqExtBlock *blk, AcqWorkArea *wk);
 
 /******************************************************************************
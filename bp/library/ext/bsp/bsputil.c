@@ -471,6 +471,105 @@ with %.*s", keyLength, MIN(128, keyLength), keyValueBuffer);
 	return keyValueBuffer;
 }
 
+/******************************************************************************
+ *
+ * \par Function Name: bsp_hashZcoSource
+ *
+ * \par Purpose: Passes a range of the source data of a ZCO, one buffer at
+ *               a time, to a digest update function, locking the SDR only
+ *               while each buffer is being filled.
+ *
+ * \retval int -- 0 - The whole range was passed to the update function.
+ *               -1 - There was a system error.
+ *
+ * \param[in]  zco      The ZCO whose source data are to be hashed.
+ * \param[in]  offset   Offset of the start of the range within the data.
+ * \param[in]  length   Length of the range.
+ * \param[in]  update   The digest update function.
+ * \param[in]  context  The digest context passed to the update function.
+ *
+ * \par Notes:
+ *      1. Must not be called from within a transaction.
+ *****************************************************************************/
+
+int	bsp_hashZcoSource(Object zco, vast offset, vast length,
+		BspHashFn update, void *context)
+{
+	Sdr		sdr = getIonsdr();
+	ZcoReader	reader;
+	unsigned char	*buffer;
+	vast		bytesRemaining = length;
+	int		chunkSize;
+	vast		bytesRetrieved;
+
+	BSP_DEBUG_PROC("+ bsp_hashZcoSource(%lu)", (unsigned long) zco);
+
+	CHKERR(zco);
+	CHKERR(update);
+	buffer = MTAKE(BSP_ZCO_HASH_BUF_SIZE);
+	if (buffer == NULL)
+	{
+		putErrmsg("No space for ZCO hashing buffer.", NULL);
+		return -1;
+	}
+
+	zco_start_receiving(zco, &reader);
+	if (offset > 0)
+	{
+		if (sdr_begin_xn(sdr) == 0)
+		{
+			MRELEASE(buffer);
+			return -1;
+		}
+
+		bytesRetrieved = zco_receive_source(sdr, &reader, offset,
+				NULL);
+		sdr_exit_xn(sdr);
+		if (bytesRetrieved != offset)
+		{
+			MRELEASE(buffer);
+			putErrmsg("Can't skip to start of range to hash.",
+					NULL);
+			return -1;
+		}
+	}
+
+	while (bytesRemaining > 0)
+	{
+		chunkSize = BSP_ZCO_HASH_BUF_SIZE;
+		if (bytesRemaining < chunkSize)
+		{
+			chunkSize = bytesRemaining;
+		}
+
+		if (sdr_begin_xn(sdr) == 0)
+		{
+			MRELEASE(buffer);
+			return -1;
+		}
+
+		bytesRetrieved = zco_receive_source(sdr, &reader, chunkSize,
+				(char *) buffer);
+		sdr_exit_xn(sdr);
+		if (bytesRetrieved != chunkSize)
+		{
+			MRELEASE(buffer);
+			putErrmsg("Can't read data to hash.", itoa(chunkSize));
+			return -1;
+		}
+
+		/*	The SDR is not locked while the digest is
+		 *	being updated.					*/
+
+		update(context, buffer, chunkSize);
+		bytesRemaining -= chunkSize;
+	}
+
+	MRELEASE(buffer);
+	BSP_DEBUG_PROC("- bsp_hashZcoSource", NULL);
+	return 0;
+}
+
 /******************************************************************************
  *
  * \par Function Name: bsp_serializeASB
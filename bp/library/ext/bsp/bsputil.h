@@ -192,6 +192,7 @@
 
 /** Misc **/
 #define BSP_ZCO_TRANSFER_BUF_SIZE 4096
+#define BSP_ZCO_HASH_BUF_SIZE	65536	/*	Outside transaction.	*/
 
 /*****************************************************************************
  *                                DATA STRUCTURES                            *
@@ -217,6 +218,8 @@ typedef struct
 	unsigned char	*parmsData;	/*  IFF flags & BSP_ASB_PARM	*/
 	unsigned int	resultsLen;	/*  IFF flags & BSP_ASB_RES	*/
 	unsigned char	*resultsData;	/*  IFF flags & BSP_ASB_RES	*/
+	unsigned int	digestLen;	/*  Computed before check.	*/
+	unsigned char	*digest;	/*  Computed before check.	*/
 } BspInboundBlock;
 
 /** 
@@ -353,6 +356,37 @@ extern void	bsp_insertSecuritySource(Bundle *bundle, BspOutboundBlock *asb);
 
 extern unsigned char	*bsp_retrieveKey(int *keyLen, char *keyName);
 
+/******************************************************************************
+ *
+ * \par Function Name: bsp_hashZcoSource
+ *
+ * \par Purpose: Passes a range of the source data of a ZCO, one buffer at
+ *               a time, to a digest update function.  The SDR is locked
+ *               only while each buffer is being filled, so the digest is
+ *               computed outside of any transaction.
+ *
+ * \retval int -- 0 - The whole range was passed to the update function.
+ *               -1 - There was a system error.
+ *
+ * \param[in]  zco      The ZCO whose source data are to be hashed.
+ * \param[in]  offset   Offset of the start of the range within the data.
+ * \param[in]  length   Length of the range.
+ * \param[in]  update   The digest update function.
+ * \param[in]  context  The digest context passed to the update function.
+ *
+ * \par Notes:
+ *      1. Must not be called from within a transaction.
+ *      2. The caller must ensure that the ZCO is neither modified nor
+ *         destroyed while it is being hashed, e.g., because it is the
+ *         private acquisition ZCO of the calling thread.
+ *****************************************************************************/
+
+typedef void		(*BspHashFn)(void *context, unsigned char *data,
+				int length);
+
+extern int		bsp_hashZcoSource(Object zco, vast offset,
+				vast length, BspHashFn update, void *context);
+
 /******************************************************************************
  *
  * \par Function Name: bsp_serializeASB
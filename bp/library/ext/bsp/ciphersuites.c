@@ -24,7 +24,8 @@ static BabCiphersuite	*_bab_ciphersuites(int *count)
 		{	1, "BAB-HMAC-SHA1", 1,
 			bab_hmac_sha1_construct,
 			bab_hmac_sha1_sign,
-			bab_hmac_sha1_verify				}
+			bab_hmac_sha1_verify,
+			bab_hmac_sha1_prepare				}
 	};
 
 	*count = sizeof suites / sizeof(BabCiphersuite);
@@ -76,7 +77,8 @@ static BibCiphersuite	*_bib_ciphersuites(int *count)
 		{	2, "BIB-HMAC-SHA256", 0,
 			bib_hmac_sha256_construct,
 			bib_hmac_sha256_sign,
-			bib_hmac_sha256_verify				}
+			bib_hmac_sha256_verify,
+			bib_hmac_sha256_prepare				}
 	};
 
 	*count = sizeof suites / sizeof(BibCiphersuite);
@@ -19,10 +19,12 @@
 typedef int	(*BabConstructFn)(ExtensionBlock *, BspOutboundBlock *);
 typedef int	(*BabSignFn)(Bundle *, ExtensionBlock *, BspOutboundBlock *);
 typedef int	(*BabVerifyFn)(AcqWorkArea *, AcqExtBlock *);
+typedef int	(*BabPrepareFn)(AcqWorkArea *, AcqExtBlock *);
 
 typedef int	(*BibConstructFn)(ExtensionBlock *, BspOutboundBlock *);
 typedef int	(*BibSignFn)(Bundle *, ExtensionBlock *, BspOutboundBlock *);
 typedef int	(*BibVerifyFn)(AcqWorkArea *, AcqExtBlock *);
+typedef int	(*BibPrepareFn)(AcqWorkArea *, AcqExtBlock *);
 
 typedef int	(*BcbConstructFn)(ExtensionBlock *, BspOutboundBlock *);
 typedef int	(*BcbEncryptFn)(Bundle *, ExtensionBlock *, BspOutboundBlock *);
@@ -36,6 +38,7 @@ typedef struct
 	BabConstructFn	construct;
 	BabSignFn	sign;
 	BabVerifyFn	verify;
+	BabPrepareFn	prepare;	/*	Optional.		*/
 } BabCiphersuite;
 
 typedef struct
@@ -46,6 +49,7 @@ typedef struct
 	BibConstructFn	construct;
 	BibSignFn	sign;
 	BibVerifyFn	verify;
+	BibPrepareFn	prepare;	/*	Optional.		*/
 } BibCiphersuite;
 
 typedef struct
@@ -271,6 +271,85 @@ int	bab_hmac_sha1_sign(Bundle *bundle, ExtensionBlock *blk,
 	return result;
 }
 
+/******************************************************************************
+ *
+ * \par Function Name: bab_hmac_sha1_prepare
+ *
+ * \par Purpose: Computes the HMAC SHA1 digest of an inbound bundle before
+ *		 the acquisition transaction begins, retaining it in the
+ *		 First BAB for use when that BAB is verified.
+ *
+ * \retval int	- 0 on success (digest may or may not have been computed),
+ *		  -1 on system failure.
+ *
+ * \param[in]  wk		- The acquisition work area.
+ * \param[in]  blk		- The inbound BAB, already deserialized.
+ *
+ * \par Notes:
+ *	1. The bundle is read from the work area's acquisition ZCO,
+ *	   which belongs to the acquiring thread, so it cannot change
+ *	   while being hashed even though the SDR is mostly unlocked.
+ *****************************************************************************/
+
+int	bab_hmac_sha1_prepare(AcqWorkArea *wk, AcqExtBlock *blk)
+{
+	BspInboundBlock	*asb;
+	unsigned char	*keyValue;
+	int		keyLen;
+	char		*authContext;
+	int		authCtxLen;
+	unsigned char	*hashData;
+
+	asb = (BspInboundBlock *) (blk->object);
+	if (asb->instance != 0
+	|| findAcqExtensionBlock(wk, EXTENSION_TYPE_BAB, 1) == NULL
+	|| wk->bundleLength <= BAB_HMAC_SHA1_ASB_RESULTS_LEN)
+	{
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	keyValue = bsp_retrieveKey(&keyLen, asb->keyName);
+	if (keyValue == NULL)
+	{
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	if ((authCtxLen = hmac_sha1_context_length()) <= 0
+	|| (authContext = MTAKE(authCtxLen)) == NULL)
+	{
+		MRELEASE(keyValue);
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	/*	As in computeDigest: the entire bundle except the
+	 *	results of the digest computation.			*/
+
+	hmac_sha1_init(authContext, keyValue, keyLen);
+	MRELEASE(keyValue);
+	if (bsp_hashZcoSource(wk->zco, wk->zcoBytesConsumed,
+			wk->bundleLength - BAB_HMAC_SHA1_ASB_RESULTS_LEN,
+			hmac_sha1_update, authContext) < 0)
+	{
+		MRELEASE(authContext);
+		putErrmsg("Can't compute bundle digest.", NULL);
+		return -1;
+	}
+
+	if ((hashData = MTAKE(BAB_HMAC_SHA1_RESULT_LEN)) == NULL)
+	{
+		MRELEASE(authContext);
+		putErrmsg("Failed allocating buffer for hash result.", NULL);
+		return -1;
+	}
+
+	hmac_sha1_final(authContext, hashData, BAB_HMAC_SHA1_RESULT_LEN);
+	hmac_sha1_reset(authContext);
+	MRELEASE(authContext);
+	asb->digest = hashData;
+	asb->digestLen = BAB_HMAC_SHA1_RESULT_LEN;
+	return 0;
+}
+
 int	bab_hmac_sha1_verify(AcqWorkArea *wk, AcqExtBlock *blk)
 {
 	int		outcome = 0;	/*	Default: fails.		*/
@@ -304,10 +383,21 @@ int	bab_hmac_sha1_verify(AcqWorkArea *wk, AcqExtBlock *blk)
 		 *	this bundle and simply stash it in this BAB's
 		 *	resultsData for use when Last BAB is checked.	*/
 
-		keyValue = bsp_retrieveKey(&keyLen, asb->keyName);
-		digest = computeDigest(wk->rawBundle, keyValue, keyLen,
-				&digestLen);
-		MRELEASE(keyValue);
+		if (asb->digest)	/*	Computed by prepare.	*/
+		{
+			digest = asb->digest;
+			digestLen = asb->digestLen;
+			asb->digest = NULL;
+			asb->digestLen = 0;
+		}
+		else
+		{
+			keyValue = bsp_retrieveKey(&keyLen, asb->keyName);
+			digest = computeDigest(wk->rawBundle, keyValue, keyLen,
+					&digestLen);
+			MRELEASE(keyValue);
+		}
+
 		if (digestLen != BAB_HMAC_SHA1_RESULT_LEN)   
 		{
 			if (digest != NULL)
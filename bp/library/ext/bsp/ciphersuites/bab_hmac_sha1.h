@@ -19,5 +19,6 @@ extern int	bab_hmac_sha1_construct(ExtensionBlock *, BspOutboundBlock *);
 extern int	bab_hmac_sha1_sign(Bundle *, ExtensionBlock *,
 			BspOutboundBlock *);
 extern int	bab_hmac_sha1_verify(AcqWorkArea *wk, AcqExtBlock *blk);
+extern int	bab_hmac_sha1_prepare(AcqWorkArea *wk, AcqExtBlock *blk);
 
 #endif /* BAB_HMAC_SHA1_H */
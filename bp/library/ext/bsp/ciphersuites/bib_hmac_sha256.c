@@ -170,6 +170,81 @@ but expected %d.", bytesRetrieved, chunkSize);
 	return (unsigned char *) hashData;
 }
 
+/******************************************************************************
+ *
+ * \par Function Name: bib_hmac_sha256_prepare
+ *
+ * \par Purpose: Computes the HMAC SHA256 digest of the payload of an
+ *		 inbound bundle before the acquisition transaction begins,
+ *		 retaining it for use when the BIB is verified.
+ *
+ * \retval int	- 0 on success (digest may or may not have been computed),
+ *		  -1 on system failure.
+ *
+ * \param[in]  wk		- The acquisition work area.
+ * \param[in]  blk		- The inbound BIB, already deserialized.
+ *
+ * \par Notes:
+ *	1. The payload is read from the work area's acquisition ZCO,
+ *	   which belongs to the acquiring thread, so it cannot change
+ *	   while being hashed even though the SDR is mostly unlocked.
+ *****************************************************************************/
+
+int	bib_hmac_sha256_prepare(AcqWorkArea *wk, AcqExtBlock *blk)
+{
+	BspInboundBlock	*asb;
+	unsigned char	*keyValue;
+	int		keyLen;
+	char		*authContext;
+	int		authCtxLen;
+	unsigned char	*hashData;
+
+	asb = (BspInboundBlock *) (blk->object);
+	if (asb->targetBlockType != BLOCK_TYPE_PAYLOAD)
+	{
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	keyValue = bsp_retrieveKey(&keyLen, asb->keyName);
+	if (keyValue == NULL)
+	{
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	if ((authCtxLen = hmac_sha256_context_length()) <= 0
+	|| (authContext = MTAKE(authCtxLen)) == NULL)
+	{
+		MRELEASE(keyValue);
+		return 0;	/*	Leave it to verify.		*/
+	}
+
+	hmac_sha256_init(authContext, keyValue, keyLen);
+	MRELEASE(keyValue);
+	if (bsp_hashZcoSource(wk->zco, wk->zcoBytesConsumed + wk->headerLength,
+			wk->bundle.payload.length, hmac_sha256_update,
+			authContext) < 0)
+	{
+		MRELEASE(authContext);
+		putErrmsg("Can't compute payload digest.", NULL);
+		return -1;
+	}
+
+	if ((hashData = MTAKE(BIB_HMAC_SHA256_RESULT_LEN)) == NULL)
+	{
+		MRELEASE(authContext);
+		putErrmsg("Failed allocating buffer for hash result.", NULL);
+		return -1;
+	}
+
+	memset(hashData, 0, BIB_HMAC_SHA256_RESULT_LEN);
+	hmac_sha256_final(authContext, hashData, BIB_HMAC_SHA256_RESULT_LEN);
+	hmac_sha256_reset(authContext);
+	MRELEASE(authContext);
+	asb->digest = hashData;
+	asb->digestLen = BIB_HMAC_SHA256_RESULT_LEN;
+	return 0;
+}
+
 int	bib_hmac_sha256_sign(Bundle *bundle, ExtensionBlock *blk,
 		BspOutboundBlock *asb)
 {
@@ -274,6 +349,15 @@ for primary block: canonicalization not implemented.", NULL);
 		return 0;
 
 	case BLOCK_TYPE_PAYLOAD:
+		if (asb->digest)	/*	Computed by prepare.	*/
+		{
+			digest = asb->digest;
+			digestLen = asb->digestLen;
+			asb->digest = NULL;
+			asb->digestLen = 0;
+			break;
+		}
+
 		digest = computePayloadDigest(wk->bundle.payload.content,
 				keyValue, keyLen, &digestLen);
 		break;
@@ -20,5 +20,6 @@ extern int	bib_hmac_sha256_construct(ExtensionBlock *,
 extern int	bib_hmac_sha256_sign(Bundle *, ExtensionBlock *,
 			BspOutboundBlock *);
 extern int	bib_hmac_sha256_verify(AcqWorkArea *wk, AcqExtBlock *blk);
+extern int	bib_hmac_sha256_prepare(AcqWorkArea *wk, AcqExtBlock *blk);
 
 #endif /* BIB_HMAC_SHA256_H */
@@ -39,7 +39,7 @@
 #endif
 
 #ifndef BUNDLES_HASH_SEARCH_LEN
-#define	BUNDLES_HASH_SEARCH_LEN	20
+#define	BUNDLES_HASH_SEARCH_LEN	4
 #endif
 
 /*	We hitchhike on the ZCO heap space management system to 
@@ -1229,62 +1229,6 @@ static char	*_bpvdbName()
 	return "bpvdb";
 }
 
-int	orderBpEvents(PsmPartition partition, PsmAddress nodeData,
-		void *dataBuffer)
-{
-	Sdr	sdr = getIonsdr();
-	BpEvent	*argEvent;
-	Object	elt;
-	BpEvent	event;
-
-	if (partition == NULL || nodeData == 0 || dataBuffer == 0)
-	{
-		putErrmsg("Error calling smrbt BP timeline compare function.",
-				NULL);
-		return 0;
-	}
-
-	argEvent = (BpEvent *) dataBuffer;
-	elt = (Object) nodeData;
-	sdr_read(sdr, (char *) &event, sdr_list_data(sdr, elt),
-			sizeof(BpEvent));
-	if (event.time < argEvent->time)
-	{
-		return -1;
-	}
-
-	if (event.time > argEvent->time)
-	{
-		return 1;
-	}
-
-	/*	Same time.						*/
-
-	if (event.ref < argEvent->ref)
-	{
-		return -1;
-	}
-
-	if (event.ref > argEvent->ref)
-	{
-		return 1;
-	}
-
-	/*	Same object.						*/
-
-	if (event.type < argEvent->type)
-	{
-		return -1;
-	}
-
-	if (event.type > argEvent->type)
-	{
-		return 1;
-	}
-
-	return 0;
-}
-
 static BpVdb	*_bpvdb(char **name)
 {
 	static BpVdb	*vdb = NULL;
@@ -1295,7 +1239,6 @@ static BpVdb	*_bpvdb(char **name)
 	BpDB		*db;
 	Object		sdrElt;
 	Object		addr;
-	BpEvent		event;
 
 	if (name)
 	{
@@ -1352,7 +1295,6 @@ static BpVdb	*_bpvdb(char **name)
 		if ((vdb->schemes = sm_list_create(wm)) == 0
 		|| (vdb->inducts = sm_list_create(wm)) == 0
 		|| (vdb->outducts = sm_list_create(wm)) == 0
-		|| (vdb->timeline = sm_rbt_create(wm)) == 0
 		|| psm_catlg(wm, *name, vdbAddress) < 0)
 		{
 			sdr_exit_xn(sdr);
@@ -1387,22 +1329,6 @@ static BpVdb	*_bpvdb(char **name)
 			}
 		}
 
-		/*	Raise the timeline.				*/
-
-		for (sdrElt = sdr_list_first(sdr, (_bpConstants())->timeline);
-				sdrElt; sdrElt = sdr_list_next(sdr, sdrElt))
-		{
-			addr = sdr_list_data(sdr, sdrElt);
-			sdr_read(sdr, (char *) &event, addr, sizeof(BpEvent));
-			if (sm_rbt_insert(wm, vdb->timeline, (PsmAddress)
-					sdrElt, orderBpEvents, &event) == 0)
-			{
-				sdr_exit_xn(sdr);
-				putErrmsg("Can't stage event timeline.", NULL);
-				return NULL;
-			}
-		}
-
 		sdr_exit_xn(sdr);	/*	Unlock memory.		*/
 	}
 
@@ -1458,9 +1384,9 @@ int	bpInit()
 		memset((char *) &bpdbBuf, 0, sizeof(BpDB));
 		bpdbBuf.schemes = sdr_list_create(bpSdr);
 		bpdbBuf.protocols = sdr_list_create(bpSdr);
-		bpdbBuf.timeline = sdr_list_create(bpSdr);
-		bpdbBuf.bundles = sdr_hash_create(bpSdr,
-				BUNDLES_HASH_KEY_LEN,
+		bpdbBuf.timeline = sdr_wheel_create(bpSdr,
+				BP_TIMELINE_RESOLUTION);
+		bpdbBuf.bundles = sdr_lhash_create(bpSdr,
 				BUNDLES_HASH_ENTRIES,
 				BUNDLES_HASH_SEARCH_LEN);
 		bpdbBuf.inboundBundles = sdr_list_create(bpSdr);
@@ -1588,7 +1514,6 @@ static void	dropVdb(PsmPartition wm, PsmAddress vdbAddress)
 	}
 
 	sm_list_destroy(wm, vdb->outducts, NULL, NULL);
-	sm_rbt_destroy(wm, vdb->timeline, NULL, NULL);
 }
 
 void	bpDropVdb()
@@ -2594,19 +2519,13 @@ static void	purgeDuctXmitElt(Bundle *bundle, Object bundleObj)
 			&outduct);
 }
 
-void	destroyBpTimelineEvent(Object timelineElt)
+void	destroyBpTimelineEvent(Object timelineEntry)
 {
 	Sdr	sdr = getIonsdr();
-	Object	eventObj;
-	BpEvent	event;
 
-	CHKVOID(timelineElt);
-	eventObj = sdr_list_data(sdr, timelineElt);
-	sdr_read(sdr, (char *) &event, eventObj, sizeof(BpEvent));
-	sm_rbt_delete(getIonwm(), (getBpVdb())->timeline, orderBpEvents,
-			&event, NULL, NULL);
-	sdr_free(sdr, eventObj);
-	sdr_list_delete(sdr, timelineElt, NULL, NULL);
+	CHKVOID(timelineEntry);
+	sdr_free(sdr, sdr_wheel_data(sdr, timelineEntry));
+	sdr_wheel_delete(sdr, timelineEntry);
 }
 
 static void	purgeStationsStack(Bundle *bundle)
@@ -2759,13 +2678,15 @@ incomplete bundle.", NULL);
 	destroyBpTimelineEvent(bundle.timelineElt);
 	if (bundle.hashEntry)
 	{
-		bsetObj = sdr_hash_entry_value(bpSdr, (_bpConstants())->bundles,
-				bundle.hashEntry);
+		bsetObj = sdr_lhash_entry_value(bpSdr,
+				(_bpConstants())->bundles, bundle.hashEntry);
 		sdr_stage(bpSdr, (char *) &bset, bsetObj, sizeof(BundleSet));
 		bset.count--;
 		if (bset.count == 0)
 		{
-			sdr_hash_delete_entry(bpSdr, bundle.hashEntry);
+			sdr_lhash_delete_entry(bpSdr,
+					(_bpConstants())->bundles,
+					bundle.hashEntry);
 			sdr_free(bpSdr, bsetObj);
 		}
 		else
@@ -2874,40 +2795,110 @@ incomplete bundle.", NULL);
 
 /*	*	*	BP database mgt and access functions	*	*/
 
+/*	Bundles whose source EIDs are "ipn"-scheme EIDs are
+ *	catalogued in the bundles hash table by a fixed-length binary
+ *	key; all other bundles are catalogued by a textual key.  The
+ *	binary key always begins with a zero byte, which can never
+ *	begin a textual key, so the two kinds of key never collide.
+ *	The null EID ipn:0.0 is printed as "dtn:none", so bundles
+ *	with that source EID are catalogued by textual key and can
+ *	be found by the printed EID as before.				*/
+
+typedef struct
+{
+	unsigned int	zero;
+	unsigned int	serviceNbr;
+	uvast		nodeNbr;
+	unsigned int	seconds;
+	unsigned int	count;
+	unsigned int	offset;
+	unsigned int	length;
+} CbheBundleKey;
+
+static int	constructCbheBundleKey(char *buffer, uvast nodeNbr,
+			unsigned int serviceNbr, unsigned int seconds,
+			unsigned int count, unsigned int offset,
+			unsigned int length)
+{
+	CbheBundleKey	key;
+
+	memset((char *) &key, 0, sizeof(CbheBundleKey));
+	key.serviceNbr = serviceNbr;
+	key.nodeNbr = nodeNbr;
+	key.seconds = seconds;
+	key.count = count;
+	key.offset = offset;
+	key.length = length;
+	memcpy(buffer, (char *) &key, sizeof(CbheBundleKey));
+	return sizeof(CbheBundleKey);
+}
+
 static int	constructBundleHashKey(char *buffer, char *sourceEid,
 			unsigned int seconds, unsigned int count,
 			unsigned int offset, unsigned int length)
 {
+	uvast		nodeNbr;
+	unsigned int	serviceNbr;
+	char		extra;
+
+	if (strncmp(sourceEid, "ipn:", 4) == 0
+	&& sscanf(sourceEid + 4, UVAST_FIELDSPEC ".%u%c", &nodeNbr,
+			&serviceNbr, &extra) == 2
+	&& !(nodeNbr == 0 && serviceNbr == 0))
+	{
+		return constructCbheBundleKey(buffer, nodeNbr, serviceNbr,
+				seconds, count, offset, length);
+	}
+
 	memset(buffer, 0, BUNDLES_HASH_KEY_BUFLEN);
 	isprintf(buffer, BUNDLES_HASH_KEY_BUFLEN, "%s:%u:%u:%u:%u",
 			sourceEid, seconds, count, offset, length);
 	return strlen(buffer);
 }
 
-int	findBundle(char *sourceEid, BpTimestamp *creationTime,
-		unsigned int fragmentOffset, unsigned int fragmentLength,
-		Object *bundleAddr)
+static int	constructBundleIdKey(char *buffer, EndpointId *sourceEid,
+			char *dictionary, unsigned int seconds,
+			unsigned int count, unsigned int offset,
+			unsigned int length)
+{
+	char	*eidString;
+	int	keyLength;
+
+	if (sourceEid->cbhe && sourceEid->unicast
+	&& !(sourceEid->c.nodeNbr == 0 && sourceEid->c.serviceNbr == 0))
+	{
+		return constructCbheBundleKey(buffer, sourceEid->c.nodeNbr,
+				sourceEid->c.serviceNbr, seconds, count,
+				offset, length);
+	}
+
+	if (printEid(sourceEid, dictionary, &eidString) < 0)
+	{
+		putErrmsg("Can't print source EID.", NULL);
+		return -1;
+	}
+
+	keyLength = constructBundleHashKey(buffer, eidString, seconds, count,
+			offset, length);
+	MRELEASE(eidString);
+	return keyLength;
+}
+
+static int	lookUpBundle(char *key, int keyLength, Object *bundleAddr)
 {
 	Sdr		bpSdr = getIonsdr();
-	char		key[BUNDLES_HASH_KEY_BUFLEN];
 	Address		bsetObj;
 	Object		hashElt;
 	BundleSet	bset;
 
-	CHKERR(sourceEid);
-	CHKERR(creationTime);
-	CHKERR(bundleAddr);
 	*bundleAddr = 0;	/*	Default: not found.		*/
-	CHKERR(ionLocked());
-	if (constructBundleHashKey(key, sourceEid, creationTime->seconds,
-			creationTime->count, fragmentOffset, fragmentLength)
-			> BUNDLES_HASH_KEY_LEN)
+	if (keyLength > BUNDLES_HASH_KEY_LEN)
 	{
 		return 0;	/*	Can't be in hash table.		*/
 	}
 
-	switch (sdr_hash_retrieve(bpSdr, (_bpConstants())->bundles, key,
-			&bsetObj, &hashElt))
+	switch (sdr_lhash_retrieve(bpSdr, (_bpConstants())->bundles, key,
+			keyLength, &bsetObj, &hashElt))
 	{
 	case -1:
 		putErrmsg("Failed locating bundle in hash table.", NULL);
@@ -2923,6 +2914,47 @@ int	findBundle(char *sourceEid, BpTimestamp *creationTime,
 	}
 }
 
+int	findBundle(char *sourceEid, BpTimestamp *creationTime,
+		unsigned int fragmentOffset, unsigned int fragmentLength,
+		Object *bundleAddr)
+{
+	char	key[BUNDLES_HASH_KEY_BUFLEN];
+	int	keyLength;
+
+	CHKERR(sourceEid);
+	CHKERR(creationTime);
+	CHKERR(bundleAddr);
+	*bundleAddr = 0;	/*	Default: not found.		*/
+	CHKERR(ionLocked());
+	keyLength = constructBundleHashKey(key, sourceEid,
+			creationTime->seconds, creationTime->count,
+			fragmentOffset, fragmentLength);
+	return lookUpBundle(key, keyLength, bundleAddr);
+}
+
+int	findBundleById(EndpointId *sourceEid, char *dictionary,
+		BpTimestamp *creationTime, unsigned int fragmentOffset,
+		unsigned int fragmentLength, Object *bundleAddr)
+{
+	char	key[BUNDLES_HASH_KEY_BUFLEN];
+	int	keyLength;
+
+	CHKERR(sourceEid);
+	CHKERR(creationTime);
+	CHKERR(bundleAddr);
+	*bundleAddr = 0;	/*	Default: not found.		*/
+	CHKERR(ionLocked());
+	keyLength = constructBundleIdKey(key, sourceEid, dictionary,
+			creationTime->seconds, creationTime->count,
+			fragmentOffset, fragmentLength);
+	if (keyLength < 0)
+	{
+		return -1;
+	}
+
+	return lookUpBundle(key, keyLength, bundleAddr);
+}
+
 void	findScheme(char *schemeName, VScheme **scheme, PsmAddress *schemeElt)
 {
 	PsmPartition	bpwm = getIonwm();
@@ -4459,25 +4491,12 @@ static int	findIncomplete(Bundle *bundle, VEndpoint *vpoint,
 
 Object	insertBpTimelineEvent(BpEvent *newEvent)
 {
-	PsmPartition	wm = getIonwm();
-	PsmAddress	timeline = (getBpVdb())->timeline;
-	PsmAddress	node;
-	PsmAddress	successor;
 	Sdr		bpSdr = getIonsdr();
 	BpDB		*bpConstants = _bpConstants();
 	Address		addr;
-	Object		nextElt;
-	Object		elt;
+	Object		entry;
 
 	CHKZERO(ionLocked());
-	node = sm_rbt_search(wm, timeline, orderBpEvents, newEvent, &successor);
-	if (node != 0)
-	{
-		/*	Event already exists; return its list elt.	*/
-
-		return sm_rbt_data(wm, node);
-	}
-
 	addr = sdr_malloc(bpSdr, sizeof(BpEvent));
 	if (addr == 0)
 	{
@@ -4485,28 +4504,22 @@ Object	insertBpTimelineEvent(BpEvent *newEvent)
 		return 0;
 	}
 
-	sdr_write(bpSdr, addr, (char *) newEvent, sizeof(BpEvent));
-	if (successor)
-	{
-		nextElt = (Object) sm_rbt_data(wm, successor);
-		elt = sdr_list_insert_before(bpSdr, nextElt, addr);
-	}
-	else
-	{
-		elt = sdr_list_insert_last(bpSdr, bpConstants->timeline, addr);
-	}
+	/*	No two events in the timeline are ever identical,
+	 *	so there is no need to search for an existing event
+	 *	before inserting: every event's referenced object
+	 *	retains the wheel entry for that event, and each
+	 *	event is inserted only when the referenced object
+	 *	retains no entry for an event of the same type.		*/
 
-	if (elt == 0)
-	{
-		return 0;	/*	No room for list element.	*/
-	}
-
-	if (sm_rbt_insert(wm, timeline, elt, orderBpEvents, newEvent) == 0)
+	sdr_write(bpSdr, addr, (char *) newEvent, sizeof(BpEvent));
+	entry = sdr_wheel_insert(bpSdr, bpConstants->timeline,
+			&newEvent->time, addr);
+	if (entry == 0)
 	{
-		return 0;	/*	No room for lookup tree node.	*/
+		return 0;	/*	No room for wheel entry.	*/
 	}
 
-	return elt;
+	return entry;
 }
 
 /*	*	*	Bundle origination functions	*	*	*/
@@ -4606,7 +4619,8 @@ static int	setBundleTTL(Bundle *bundle, Object bundleObj)
 	 *	time-to-live.  Bundle expiration time is event time.	*/
 
 	event.type = expiredTTL;
-	event.time = bundle->expirationTime + EPOCH_2000_SEC;
+	event.time.tv_sec = bundle->expirationTime + EPOCH_2000_SEC;
+	event.time.tv_usec = 0;
 	event.ref = bundleObj;
 	bundle->timelineElt = insertBpTimelineEvent(&event);
 	if (bundle->timelineElt == 0)
@@ -4623,8 +4637,8 @@ static int	catalogueBundle(Bundle *bundle, Object bundleObj)
 	Sdr		sdr = getIonsdr();
 	Object		bundles = (_bpConstants())->bundles;
 	char		*dictionary;
-	char		*sourceEid;
 	char		bundleKey[BUNDLES_HASH_KEY_BUFLEN];
+	int		keyLength;
 	Address		bsetObj;
 	Object		hashElt;
 	BundleSet	bset;
@@ -4640,24 +4654,23 @@ static int	catalogueBundle(Bundle *bundle, Object bundleObj)
 		return -1;
 	}
 
-	if (printEid(&(bundle->id.source), dictionary, &sourceEid) < 0)
+	keyLength = constructBundleIdKey(bundleKey, &(bundle->id.source),
+			dictionary, bundle->id.creationTime.seconds,
+			bundle->id.creationTime.count,
+			bundle->id.fragmentOffset,
+			bundle->totalAduLength == 0 ? 0 :
+			bundle->payload.length);
+	releaseDictionary(dictionary);
+	if (keyLength < 0)
 	{
-		putErrmsg("Can't print source EID.", NULL);
-		releaseDictionary(dictionary);
+		putErrmsg("Can't construct bundle hash key.", NULL);
 		return -1;
 	}
 
-	if (constructBundleHashKey(bundleKey, sourceEid,
-			bundle->id.creationTime.seconds,
-			bundle->id.creationTime.count,
-			bundle->id.fragmentOffset,
-			bundle->totalAduLength == 0 ? 0 :
-			bundle->payload.length) > BUNDLES_HASH_KEY_LEN)
+	if (keyLength > BUNDLES_HASH_KEY_LEN)
 	{
 		writeMemoNote("[?] Max hash key length exceeded; bundle \
 cannot be retrieved by key", bundleKey);
-		MRELEASE(sourceEid);
-		releaseDictionary(dictionary);
 		return 0;
 	}
 
@@ -4668,7 +4681,8 @@ cannot be retrieved by key", bundleKey);
 	 *	exists.  If we find it, we set its bundleObj to zero
 	 *	and add 1 to its count.  If not, we insert a new entry.	*/
 
-	switch (sdr_hash_retrieve(sdr, bundles, bundleKey, &bsetObj, &hashElt))
+	switch (sdr_lhash_retrieve(sdr, bundles, bundleKey, keyLength,
+			&bsetObj, &hashElt))
 	{
 	case -1:
 		putErrmsg("Can't revise hash table entry.", NULL);
@@ -4699,16 +4713,14 @@ cannot be retrieved by key", bundleKey);
 		bset.bundleObj = bundleObj;
 		bset.count = 1;
 		sdr_write(sdr, bsetObj, (char *) &bset, sizeof(BundleSet));
-		if (sdr_hash_insert(sdr, bundles, bundleKey, bsetObj,
-				&(bundle->hashEntry)) < 0)
+		if (sdr_lhash_insert(sdr, bundles, bundleKey, keyLength,
+				bsetObj, &(bundle->hashEntry)) < 0)
 		{
 			putErrmsg("Can't insert into hash table.", NULL);
 			result = -1;
 		}
 	}
 
-	MRELEASE(sourceEid);
-	releaseDictionary(dictionary);
 	return result;
 }
 
@@ -6907,6 +6919,7 @@ static int	applyRecvRateControl(AcqWorkArea *work)
 
 static int	advanceWorkBuffer(AcqWorkArea *work, int bytesParsed)
 {
+	Sdr	sdr = getIonsdr();
 	int	bytesRemaining = work->zcoLength - work->zcoBytesReceived;
 	int	bytesToReceive;
 	int	bytesReceived;
@@ -6927,8 +6940,10 @@ static int	advanceWorkBuffer(AcqWorkArea *work, int bytesParsed)
 
 	if (bytesToReceive > 0)
 	{
-		bytesReceived = zco_receive_source(getIonsdr(), &(work->reader),
+		CHKERR(sdr_begin_xn(sdr));	/*	To lock memory.	*/
+		bytesReceived = zco_receive_source(sdr, &(work->reader),
 			bytesToReceive, work->buffer + work->bytesBuffered);
+		sdr_exit_xn(sdr);
 		CHKERR(bytesReceived == bytesToReceive);
 		work->zcoBytesReceived += bytesReceived;
 		work->bytesBuffered += bytesReceived;
@@ -6960,8 +6975,7 @@ static int	acquirePrimaryBlock(AcqWorkArea *work)
 	unsigned char	*cursor;
 	int		version;
 	unsigned int	residualBlockLength;
-	int		i;
-	uvast		eidSdnvValues[8];
+	uvast		sdnvValues[12];
 	char		*eidString;
 	int		nullEidLen;
 	int		bytesParsed;
@@ -7007,22 +7021,14 @@ static int	acquirePrimaryBlock(AcqWorkArea *work)
 
 	extractSmallSdnv(&residualBlockLength, &cursor, &unparsedBytes);
 
-	/*	Get all EID SDNV values.				*/
+	/*	Get all EID SDNV values, then creation timestamp,
+	 *	lifetime, and dictionary length, in a single pass.	*/
 
-	for (i = 0; i < 8; i++)
-	{
-		extractSdnv(&(eidSdnvValues[i]), &cursor, &unparsedBytes);
-	}
-
-	/*	Get creation timestamp, lifetime, dictionary length.	*/
-
-	extractSmallSdnv(&(bundle->id.creationTime.seconds), &cursor,
-			&unparsedBytes);
-
-	extractSmallSdnv(&(bundle->id.creationTime.count), &cursor,
-			&unparsedBytes);
+	extractSdnvArray(sdnvValues, 12, &cursor, &unparsedBytes);
 
-	extractSmallSdnv(&(bundle->timeToLive), &cursor, &unparsedBytes);
+	bundle->id.creationTime.seconds = sdnvValues[8];
+	bundle->id.creationTime.count = sdnvValues[9];
+	bundle->timeToLive = sdnvValues[10];
 	if (ionClockIsSynchronized() && bundle->id.creationTime.seconds > 0)
 	{
 		/*	Default bundle age, pending override by BAE.	*/
@@ -7034,7 +7040,7 @@ static int	acquirePrimaryBlock(AcqWorkArea *work)
 		bundle->age = 0;
 	}
 
-	extractSmallSdnv(&(bundle->dictionaryLength), &cursor, &unparsedBytes);
+	bundle->dictionaryLength = sdnvValues[11];
 	bundle->dbOverhead += bundle->dictionaryLength;
 
 	/*	Get the dictionary, if present.				*/
@@ -7057,20 +7063,20 @@ static int	acquirePrimaryBlock(AcqWorkArea *work)
 			bundle->destination.unicast = 0;
 		}
 
-		bundle->destination.c.nodeNbr = eidSdnvValues[0];
-		bundle->destination.c.serviceNbr = eidSdnvValues[1];
+		bundle->destination.c.nodeNbr = sdnvValues[0];
+		bundle->destination.c.serviceNbr = sdnvValues[1];
 		bundle->id.source.cbhe = 1;
 		bundle->id.source.unicast = 1;
-		bundle->id.source.c.nodeNbr = eidSdnvValues[2];
-		bundle->id.source.c.serviceNbr = eidSdnvValues[3];
+		bundle->id.source.c.nodeNbr = sdnvValues[2];
+		bundle->id.source.c.serviceNbr = sdnvValues[3];
 		bundle->reportTo.cbhe = 1;
 		bundle->reportTo.unicast = 1;
-		bundle->reportTo.c.nodeNbr = eidSdnvValues[4];
-		bundle->reportTo.c.serviceNbr = eidSdnvValues[5];
+		bundle->reportTo.c.nodeNbr = sdnvValues[4];
+		bundle->reportTo.c.serviceNbr = sdnvValues[5];
 		bundle->custodian.cbhe = 1;
 		bundle->custodian.unicast = 1;
-		bundle->custodian.c.nodeNbr = eidSdnvValues[6];
-		bundle->custodian.c.serviceNbr = eidSdnvValues[7];
+		bundle->custodian.c.nodeNbr = sdnvValues[6];
+		bundle->custodian.c.serviceNbr = sdnvValues[7];
 	}
 	else
 	{
@@ -7086,20 +7092,20 @@ static int	acquirePrimaryBlock(AcqWorkArea *work)
 		unparsedBytes -= bundle->dictionaryLength;
 		bundle->destination.cbhe = 0;
 		bundle->destination.unicast = 1;
-		bundle->destination.d.schemeNameOffset = eidSdnvValues[0];
-		bundle->destination.d.nssOffset = eidSdnvValues[1];
+		bundle->destination.d.schemeNameOffset = sdnvValues[0];
+		bundle->destination.d.nssOffset = sdnvValues[1];
 		bundle->id.source.cbhe = 0;
 		bundle->id.source.unicast = 1;
-		bundle->id.source.d.schemeNameOffset = eidSdnvValues[2];
-		bundle->id.source.d.nssOffset = eidSdnvValues[3];
+		bundle->id.source.d.schemeNameOffset = sdnvValues[2];
+		bundle->id.source.d.nssOffset = sdnvValues[3];
 		bundle->reportTo.cbhe = 0;
 		bundle->reportTo.unicast = 1;
-		bundle->reportTo.d.schemeNameOffset = eidSdnvValues[4];
-		bundle->reportTo.d.nssOffset = eidSdnvValues[5];
+		bundle->reportTo.d.schemeNameOffset = sdnvValues[4];
+		bundle->reportTo.d.nssOffset = sdnvValues[5];
 		bundle->custodian.cbhe = 0;
 		bundle->custodian.unicast = 1;
-		bundle->custodian.d.schemeNameOffset = eidSdnvValues[6];
-		bundle->custodian.d.nssOffset = eidSdnvValues[7];
+		bundle->custodian.d.schemeNameOffset = sdnvValues[6];
+		bundle->custodian.d.nssOffset = sdnvValues[7];
 	}
 
 	if (printEid(&(bundle->id.source), work->dictionary, &eidString) < 0)
@@ -7408,8 +7414,10 @@ static int	acqFromWork(AcqWorkArea *work)
 
 		unreceivedPayload = work->bundle.payload.length
 				- work->bytesBuffered;
+		CHKERR(sdr_begin_xn(sdr));	/*	To lock memory.	*/
 		bytesRecd = zco_receive_source(sdr, &(work->reader),
 				unreceivedPayload, NULL);
+		sdr_exit_xn(sdr);
 		CHKERR(bytesRecd >= 0);
 		if (bytesRecd != unreceivedPayload)
 		{
@@ -7644,11 +7652,7 @@ static int	acquireBundle(Sdr bpSdr, AcqWorkArea *work, VEndpoint **vpoint)
 	MetaEid		senderMetaEid;
 	Object		bundleObj;
 
-	if (acqFromWork(work) < 0)
-	{
-		putErrmsg("Acquisition from work area failed.", NULL);
-		return -1;
-	}
+	/*	Bundle has already been parsed by acqFromWork().	*/
 
 	if (work->bundleLength > 0)
 	{
@@ -7788,22 +7792,12 @@ static int	acquireBundle(Sdr bpSdr, AcqWorkArea *work, VEndpoint **vpoint)
 			 *	receiving the bundle.			*/
 
 			MRELEASE(eidString);
-			if (printEid(&(bundle->id.source), work->dictionary,
-					&eidString) < 0)
-			{
-				putErrmsg("Can't print source EID string.",
-						NULL);
-				sdr_cancel_xn(bpSdr);
-				return -1;
-			}
-
-			count = findBundle(eidString,
-				&(bundle->id.creationTime),
+			count = findBundleById(&(bundle->id.source),
+				work->dictionary, &(bundle->id.creationTime),
 				bundle->id.fragmentOffset,
 				(bundle->bundleProcFlags & BDL_IS_FRAGMENT ?
 					bundle->payload.length : 0),
 				&bundleAddr);
-			MRELEASE(eidString);
 			switch (count)
 			{
 			case -1:
@@ -8100,6 +8094,32 @@ int	bpEndAcq(AcqWorkArea *work)
 	acqLength = work->zcoLength;
 	while (acqLength > 0)
 	{
+		/*	Parse next bundle in acquisition ZCO.  Parsing
+		 *	operates on the work area's private buffer, so
+		 *	it is done outside of any transaction: the SDR
+		 *	is locked only briefly, to refill the buffer.	*/
+
+		if (acqFromWork(work) < 0)
+		{
+			putErrmsg("Acquisition from work area failed.", NULL);
+			return -1;
+		}
+
+		/*	Extension-block processing that is lengthy but
+		 *	updates nothing in the database, such as
+		 *	computing a security digest over the payload,
+		 *	is likewise done before the SDR is locked.	*/
+
+		if (work->bundleLength > 0 && !work->malformed)
+		{
+			if (prepareExtensionBlocks(work) < 0)
+			{
+				putErrmsg("Can't prepare extension blocks.",
+						NULL);
+				return -1;
+			}
+		}
+
 		/*	Acquire next bundle in acquisition ZCO.		*/
 
 		vpoint = NULL;
@@ -10130,7 +10150,7 @@ static void	noteFragmentation(Bundle *bundle)
 static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 			Outduct *outduct, Object outductObj,
 			ClProtocol *protocol, unsigned int maxPayloadLength,
-			Object *bundleObj, Bundle *bundle)
+			int blocking, Object *bundleObj, Bundle *bundle)
 {
 	Sdr		bpSdr = getIonsdr();
 	PsmPartition	bpwm = getIonwm();
@@ -10154,6 +10174,16 @@ static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 		selectNextBundleForTransmission(flows, &selectedFlow, &xmitElt);
 		if (xmitElt == 0)		/*	Nothing ready.	*/
 		{
+			if (!blocking)
+			{
+				/*	Caller will not wait for a
+				 *	bundle; transaction remains
+				 *	open.				*/
+
+				*bundleObj = 0;
+				return 0;
+			}
+
 			sdr_exit_xn(bpSdr);
 
 			/*	Wait until forwarder announces an
@@ -10373,40 +10403,9 @@ static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 	}
 }
 
-int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
-		BpExtendedCOS *extendedCOS, char *destDuctName,
-		unsigned int maxPayloadLength, int timeoutInterval)
+static int	waitForXmitCapacity(VOutduct *vduct)
 {
-	Sdr		bpSdr = getIonsdr();
-	int		stewardshipAccepted;
-	Object		outductObj;
-	Outduct		outduct;
-			OBJ_POINTER(ClProtocol, protocol);
-	Object		bundleObj;
-	Bundle		bundle;
-	BundleSet	bset;
-	char		proxNodeEid[SDRSTRING_BUFSZ];
-	DequeueContext	context;
-	char		*dictionary;
-	int		xmitLength;
-
-	CHKERR(vduct && flows && bundleZco && extendedCOS && destDuctName);
-	*bundleZco = 0;			/*	Default behavior.	*/
-	*destDuctName = '\0';		/*	Default behavior.	*/
-	if (timeoutInterval < 0)	/*	CLA is a steward.	*/
-	{
-		/*	Note that stewardship and custody acceptance
-		 *	timeout are mutually exclusive.			*/
-
-		stewardshipAccepted = 1;
-		timeoutInterval = 0;
-	}
-	else
-	{
-		stewardshipAccepted = 0;
-	}
-
-	CHKERR(sdr_begin_xn(bpSdr));
+	Sdr	bpSdr = getIonsdr();
 
 	/*	Transmission rate control: wait for capacity.  But
 	 *	no rate control if throttle nominal rate < 0.		*/
@@ -10436,6 +10435,49 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 		}
 	}
 
+	return 0;
+}
+
+static int	dequeueBundle(VOutduct *vduct, Outflow *flows,
+			Object *bundleZco, BpExtendedCOS *extendedCOS,
+			char *destDuctName, unsigned int maxPayloadLength,
+			int timeoutInterval, int blocking)
+{
+	Sdr		bpSdr = getIonsdr();
+	int		stewardshipAccepted;
+	Object		outductObj;
+	Outduct		outduct;
+			OBJ_POINTER(ClProtocol, protocol);
+	Object		bundleObj;
+	Bundle		bundle;
+	BundleSet	bset;
+	char		proxNodeEid[SDRSTRING_BUFSZ];
+	DequeueContext	context;
+	char		*dictionary;
+	int		xmitLength;
+
+	/*	Must be invoked within a transaction.  On failure,
+	 *	the transaction is canceled; if the outduct is stopped
+	 *	while waiting for a bundle, the transaction has been
+	 *	exited.  Either way, returns -1.  If blocking is zero
+	 *	and no bundle is ready, returns 0 with *bundleZco set
+	 *	to zero and the transaction still open.			*/
+
+	*bundleZco = 0;			/*	Default behavior.	*/
+	*destDuctName = '\0';		/*	Default behavior.	*/
+	if (timeoutInterval < 0)	/*	CLA is a steward.	*/
+	{
+		/*	Note that stewardship and custody acceptance
+		 *	timeout are mutually exclusive.			*/
+
+		stewardshipAccepted = 1;
+		timeoutInterval = 0;
+	}
+	else
+	{
+		stewardshipAccepted = 0;
+	}
+
 	outductObj = sdr_list_data(bpSdr, vduct->outductElt);
 	sdr_read(bpSdr, (char *) &outduct, outductObj, sizeof(Outduct));
 	GET_OBJ_POINTER(bpSdr, ClProtocol, protocol, outduct.protocol);
@@ -10443,17 +10485,21 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 	/*	Get a transmittable bundle.				*/
 
 	if (getOutboundBundle(flows, vduct, &outduct, outductObj, protocol,
-			maxPayloadLength, &bundleObj, &bundle) < 0)
+			maxPayloadLength, blocking, &bundleObj, &bundle) < 0)
 	{
 		putErrmsg("CLO can't get next outbound bundle.", NULL);
 		sdr_cancel_xn(bpSdr);
 		return -1;
 	}
 
-	if (bundleObj == 0)	/*	Outduct has been stopped.	*/
+	if (bundleObj == 0)
 	{
-		sdr_exit_xn(bpSdr);
-		return -1;	/*	End task, but without error.	*/
+		if (blocking)	/*	Outduct has been stopped.	*/
+		{
+			return -1;	/*	End task without error.	*/
+		}
+
+		return 0;	/*	No bundle is ready.		*/
 	}
 
 	if (bundle.proxNodeEid)
@@ -10565,7 +10611,7 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 	}
 	else	/*	Does hash entry resolve to only this bundle?	*/
 	{
-		sdr_read(bpSdr, (char *) &bset, sdr_hash_entry_value(bpSdr,
+		sdr_read(bpSdr, (char *) &bset, sdr_lhash_entry_value(bpSdr,
 				(_bpConstants())->bundles, bundle.hashEntry),
 				sizeof(BundleSet));
 		if (bset.bundleObj != bundleObj)
@@ -10673,6 +10719,30 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 		}
 	}
 
+	return 0;
+}
+
+int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
+		BpExtendedCOS *extendedCOS, char *destDuctName,
+		unsigned int maxPayloadLength, int timeoutInterval)
+{
+	Sdr	bpSdr = getIonsdr();
+
+	CHKERR(vduct && flows && bundleZco && extendedCOS && destDuctName);
+	*bundleZco = 0;			/*	Default behavior.	*/
+	*destDuctName = '\0';		/*	Default behavior.	*/
+	CHKERR(sdr_begin_xn(bpSdr));
+	if (waitForXmitCapacity(vduct) < 0)
+	{
+		return -1;
+	}
+
+	if (dequeueBundle(vduct, flows, bundleZco, extendedCOS, destDuctName,
+			maxPayloadLength, timeoutInterval, 1) < 0)
+	{
+		return -1;
+	}
+
 	if (sdr_end_xn(bpSdr))
 	{
 		putErrmsg("Can't get outbound bundle.", NULL);
@@ -10682,6 +10752,91 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 	return 0;
 }
 
+int	bpDequeueBatch(VOutduct *vduct, Outflow *flows, BpDequeuedBundle *batch,
+		int maxBundles, unsigned int maxBytes,
+		unsigned int maxPayloadLength, int timeoutInterval)
+{
+	Sdr			bpSdr = getIonsdr();
+	int			count;
+	BpDequeuedBundle	*dequeued;
+	unsigned int		bytesDequeued = 0;
+
+	CHKERR(vduct && flows && batch && maxBundles > 0);
+	CHKERR(sdr_begin_xn(bpSdr));
+	if (waitForXmitCapacity(vduct) < 0)
+	{
+		return -1;
+	}
+
+	/*	Only the first bundle is waited for.  After that,
+	 *	keep dequeuing within the same transaction until
+	 *	the outduct's queues are empty, the batch is full,
+	 *	the byte budget is reached, or the transmission
+	 *	throttle runs out of capacity.				*/
+
+	for (count = 0; count < maxBundles; count++)
+	{
+		if (count > 0)
+		{
+			if (maxBytes > 0 && bytesDequeued >= maxBytes)
+			{
+				break;
+			}
+
+			if (vduct->xmitThrottle.nominalRate >= 0
+			&& vduct->xmitThrottle.capacity <= 0)
+			{
+				break;
+			}
+		}
+
+		dequeued = batch + count;
+		if (dequeueBundle(vduct, flows, &dequeued->bundleZco,
+				&dequeued->extendedCOS, dequeued->destDuctName,
+				maxPayloadLength, timeoutInterval, count == 0)
+				< 0)
+		{
+			return -1;
+		}
+
+		if (dequeued->bundleZco == 0)
+		{
+			break;		/*	Nothing more is ready.	*/
+		}
+
+		bytesDequeued += zco_length(bpSdr, dequeued->bundleZco);
+	}
+
+	if (sdr_end_xn(bpSdr))
+	{
+		putErrmsg("Can't get outbound bundles.", NULL);
+		return -1;
+	}
+
+	return count;
+}
+
+int	bpReturnBundle(Object bundleZco)
+{
+	Sdr	bpSdr = getIonsdr();
+
+	if (bpHandleXmitFailure(bundleZco) < 0)
+	{
+		putErrmsg("Can't return bundle for re-forwarding.", NULL);
+		return -1;
+	}
+
+	CHKERR(sdr_begin_xn(bpSdr));
+	zco_destroy(bpSdr, bundleZco);
+	if (sdr_end_xn(bpSdr) < 0)
+	{
+		putErrmsg("Can't destroy bundle ZCO.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int	nextBlock(Sdr sdr, ZcoReader *reader, unsigned char *buffer,
 			int *bytesBuffered, int bytesParsed)
 {
@@ -11012,7 +11167,6 @@ int	bpIdentify(Object bundleZco, Object *bundleObj)
 	char		*dictionary = 0;	/*	To hush gcc.	*/
 	unsigned int	bundleLength;
 	int		result;
-	char		*sourceEid;
 
 	CHKERR(bundleZco);
 	CHKERR(bundleObj);
@@ -11037,24 +11191,15 @@ int	bpIdentify(Object bundleZco, Object *bundleObj)
 		return 0;
 	}
 
-	/*	Recreate the source EID.				*/
-
-	result = printEid(&image.id.source, dictionary, &sourceEid);
-	MRELEASE(buffer);
-	if (result < 0)
-	{
-		putErrmsg("No memory for source EID.", NULL);
-		return -1;
-	}
-
 	/*	Now use this bundle ID to find the bundle.		*/
 
 	CHKERR(sdr_begin_xn(bpSdr));	/*	Just to lock memory.	*/
-	result = findBundle(sourceEid, &image.id.creationTime,
-			image.id.fragmentOffset, image.totalAduLength == 0 ? 0
-			: image.payload.length, bundleObj);
+	result = findBundleById(&image.id.source, dictionary,
+			&image.id.creationTime, image.id.fragmentOffset,
+			image.totalAduLength == 0 ? 0 : image.payload.length,
+			bundleObj);
 	sdr_exit_xn(bpSdr);
-	MRELEASE(sourceEid);
+	MRELEASE(buffer);
 	if (result < 0)
 	{
 		putErrmsg("Failed seeking bundle.", NULL);
@@ -11073,7 +11218,8 @@ int	bpMemo(Object bundleObj, unsigned int interval)
 	CHKERR(bundleObj);
 	CHKERR(interval > 0);
 	event.type = ctDue;
-	event.time = getUTCTime() + interval;
+	getUTCTimeval(&event.time);
+	event.time.tv_sec += interval;
 	event.ref = bundleObj;
 	CHKERR(sdr_begin_xn(bpSdr));
 	sdr_stage(bpSdr, (char *) &bundle, bundleObj, sizeof(Bundle));
@@ -11102,7 +11248,6 @@ int	retrieveSerializedBundle(Object bundleZco, Object *bundleObj)
 	char		*dictionary = 0;	/*	To hush gcc.	*/
 	unsigned int	bundleLength;
 	int		result;
-	char		*sourceEid;
 
 	CHKERR(bundleZco);
 	CHKERR(bundleObj);
@@ -11129,22 +11274,13 @@ int	retrieveSerializedBundle(Object bundleZco, Object *bundleObj)
 		return 0;
 	}
 
-	/*	Recreate the source EID.				*/
-
-	result = printEid(&image.id.source, dictionary, &sourceEid);
-	MRELEASE(buffer);
-	if (result < 0)
-	{
-		putErrmsg("No memory for source EID.", NULL);
-		return -1;
-	}
-
 	/*	Now use this bundle ID to retrieve the bundle.		*/
 
-	result = findBundle(sourceEid, &image.id.creationTime,
-			image.id.fragmentOffset, image.totalAduLength == 0 ? 0
-			: image.payload.length, bundleObj);
-	MRELEASE(sourceEid);
+	result = findBundleById(&image.id.source, dictionary,
+			&image.id.creationTime, image.id.fragmentOffset,
+			image.totalAduLength == 0 ? 0 : image.payload.length,
+			bundleObj);
+	MRELEASE(buffer);
 	return (result < 0 ? result : 0);
 }
 
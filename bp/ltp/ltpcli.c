@@ -11,6 +11,7 @@
 	
 									*/
 #include "ltpcla.h"
+#include "llcv.h"
 #include "ipnfw.h"
 #include "dtn2fw.h"
 
@@ -20,12 +21,25 @@ static void	interruptThread()
 	ionKillMainThread("ltpcli");
 }
 
+#ifndef LTPCLI_ACQ_THREADS
+#define	LTPCLI_ACQ_THREADS	(4)
+#endif
+
 /*	*	*	Receiver thread functions	*	*	*/
 
+typedef struct
+{
+	Object		zco;		/*	0 means "stop".		*/
+	uvast		senderEngineNbr;
+} RedBlock;
+
 typedef struct
 {
 	VInduct		*vduct;
 	int		running;
+	Lyst		redBlocks;		/*	(RedBlock *)	*/
+	struct llcv_str	redBlocksCV_str;
+	Llcv		redBlocksCV;
 } ReceiverThreadParms;
 
 static int	acquireRedBundles(AcqWorkArea *work, Object zco,
@@ -52,6 +66,102 @@ static int	acquireRedBundles(AcqWorkArea *work, Object zco,
 	return 0;
 }
 
+static int	enqueueRedBlock(ReceiverThreadParms *rtp, Object zco,
+			uvast senderEngineNbr)
+{
+	RedBlock	*block;
+	LystElt		elt;
+
+	block = (RedBlock *) MTAKE(sizeof(RedBlock));
+	if (block == NULL)
+	{
+		putErrmsg("Can't note red block for acquisition.", NULL);
+		return -1;
+	}
+
+	block->zco = zco;
+	block->senderEngineNbr = senderEngineNbr;
+	llcv_lock(rtp->redBlocksCV);
+	elt = lyst_insert_last(rtp->redBlocks, block);
+	llcv_unlock(rtp->redBlocksCV);
+	if (elt == NULL)
+	{
+		MRELEASE(block);
+		putErrmsg("Can't queue red block for acquisition.", NULL);
+		return -1;
+	}
+
+	llcv_signal(rtp->redBlocksCV, llcv_lyst_not_empty);
+	return 0;
+}
+
+static void	*acquireRedBlocks(void *parm)
+{
+	/*	Main loop for acquisition of bundles from red blocks.
+	 *	Each acquisition thread has its own work area, so red
+	 *	blocks are acquired in parallel: each thread parses
+	 *	the bundles in its blocks without holding the SDR
+	 *	lock, which it takes only to load block data and to
+	 *	record and dispatch each bundle.			*/
+
+	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
+	char			*procName = "ltpcli";
+	AcqWorkArea		*work;
+	LystElt			elt;
+	RedBlock		*block;
+
+	work = bpGetAcqArea(rtp->vduct);
+	if (work == NULL)
+	{
+		putErrmsg("ltpcli can't get acquisition work area", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	while (1)
+	{
+		if (llcv_wait(rtp->redBlocksCV, llcv_lyst_not_empty,
+				LLCV_BLOCKING) < 0)
+		{
+			putErrmsg("ltpcli can't get red block.", NULL);
+			ionKillMainThread(procName);
+			break;
+		}
+
+		llcv_lock(rtp->redBlocksCV);
+		elt = lyst_first(rtp->redBlocks);
+		if (elt == NULL)
+		{
+			llcv_unlock(rtp->redBlocksCV);
+			continue;
+		}
+
+		block = (RedBlock *) lyst_data(elt);
+		lyst_delete(elt);
+		llcv_unlock(rtp->redBlocksCV);
+		if (block->zco == 0)		/*	Stop.		*/
+		{
+			MRELEASE(block);
+			break;
+		}
+
+		if (acquireRedBundles(work, block->zco,
+				block->senderEngineNbr) < 0)
+		{
+			putErrmsg("Can't acquire bundle(s).", NULL);
+			ionKillMainThread(procName);
+			MRELEASE(block);
+			break;
+		}
+
+		MRELEASE(block);
+	}
+
+	writeErrmsgMemos();
+	bpReleaseAcqArea(work);
+	return NULL;
+}
+
 static int	handleGreenSegment(AcqWorkArea *work, LtpSessionId *sessionId,
 			unsigned char endOfBlock, unsigned int offset,
 			unsigned int length, Object zco, unsigned int *buflen,				char **buffer)
@@ -235,7 +345,6 @@ static void	*handleNotices(void *parm)
 	Sdr			sdr = getIonsdr();
 	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
 	char			*procName = "ltpcli";
-	AcqWorkArea		*redWork;
 	AcqWorkArea		*greenWork;
 	LtpNoticeType		type;
 	LtpSessionId		sessionId;
@@ -256,12 +365,11 @@ static void	*handleNotices(void *parm)
 		return NULL;
 	}
 
-	redWork = bpGetAcqArea(rtp->vduct);
 	greenWork = bpGetAcqArea(rtp->vduct);
-	if (redWork == NULL || greenWork == NULL)
+	if (greenWork == NULL)
 	{
 		ltp_close(BpLtpClientId);
-		putErrmsg("ltpcli can't get acquisition work areas", NULL);
+		putErrmsg("ltpcli can't get acquisition work area", NULL);
 		ionKillMainThread(procName);
 		return NULL;
 	}
@@ -375,7 +483,7 @@ static void	*handleNotices(void *parm)
 				break;		/*	Out of switch.	*/
 			}
 
-			if (acquireRedBundles(redWork, data,
+			if (enqueueRedBlock(rtp, data,
 					sessionId.sourceEngineId) < 0)
 			{
 				putErrmsg("Can't acquire bundle(s).", NULL);
@@ -428,13 +536,57 @@ static void	*handleNotices(void *parm)
 	}
 
 	bpReleaseAcqArea(greenWork);
-	bpReleaseAcqArea(redWork);
 	ltp_close(BpLtpClientId);
 	return NULL;
 }
 
 /*	*	*	Main thread functions	*	*	*	*/
 
+static void	stopAcqThreads(ReceiverThreadParms *rtp, pthread_t *threads,
+			int threadCount)
+{
+	Sdr		sdr = getIonsdr();
+	int		i;
+	LystElt		elt;
+	RedBlock	*block;
+
+	/*	Queue one "stop" block per thread, behind all red
+	 *	blocks still awaiting acquisition.			*/
+
+	for (i = 0; i < threadCount; i++)
+	{
+		if (enqueueRedBlock(rtp, 0, 0) < 0)
+		{
+			putErrmsg("Can't stop acquisition threads.", NULL);
+			return;
+		}
+	}
+
+	for (i = 0; i < threadCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	/*	Discard whatever a failed thread left behind.		*/
+
+	while ((elt = lyst_first(rtp->redBlocks)) != NULL)
+	{
+		block = (RedBlock *) lyst_data(elt);
+		if (block->zco)
+		{
+			oK(sdr_begin_xn(sdr));
+			zco_destroy(sdr, block->zco);
+			oK(sdr_end_xn(sdr));
+		}
+
+		MRELEASE(block);
+		lyst_delete(elt);
+	}
+
+	llcv_close(rtp->redBlocksCV);
+	lyst_destroy(rtp->redBlocks);
+}
+
 #if defined (ION_LWT)
 int	ltpcli(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -449,6 +601,8 @@ int	main(int argc, char *argv[])
 	PsmAddress		vductElt;
 	ReceiverThreadParms	rtp;
 	pthread_t		receiverThread;
+	pthread_t		acqThreads[LTPCLI_ACQ_THREADS];
+	int			acqThreadCount = 0;
 
 	if (ductName == NULL)
 	{
@@ -489,13 +643,45 @@ int	main(int argc, char *argv[])
 	ionNoteMainThread("ltpcli");
 	isignal(SIGTERM, interruptThread);
 
-	/*	Start the receiver thread.				*/
+	/*	Start the acquisition threads.				*/
 
 	rtp.vduct = vduct;
 	rtp.running = 1;
-	if (pthread_begin(&receiverThread, NULL, handleNotices, &rtp))
+	rtp.redBlocks = lyst_create_using(getIonMemoryMgr());
+	if (rtp.redBlocks == NULL)
+	{
+		putErrmsg("ltpcli can't create red block queue.", NULL);
+		return 1;
+	}
+
+	rtp.redBlocksCV = llcv_open(rtp.redBlocks, &(rtp.redBlocksCV_str));
+	if (rtp.redBlocksCV == NULL)
+	{
+		putErrmsg("ltpcli can't open red block queue.", NULL);
+		lyst_destroy(rtp.redBlocks);
+		return 1;
+	}
+
+	while (acqThreadCount < LTPCLI_ACQ_THREADS)
+	{
+		if (pthread_begin(&acqThreads[acqThreadCount], NULL,
+				acquireRedBlocks, &rtp))
+		{
+			putSysErrmsg("ltpcli can't create acquisition thread",
+					NULL);
+			break;
+		}
+
+		acqThreadCount++;
+	}
+
+	/*	Start the receiver thread.				*/
+
+	if (acqThreadCount == 0
+	|| pthread_begin(&receiverThread, NULL, handleNotices, &rtp))
 	{
 		putSysErrmsg("ltpcli can't create receiver thread", NULL);
+		stopAcqThreads(&rtp, acqThreads, acqThreadCount);
 		return 1;
 	}
 
@@ -513,6 +699,11 @@ int	main(int argc, char *argv[])
 
 	ltp_interrupt(BpLtpClientId);
 	pthread_join(receiverThread, NULL);
+
+	/*	Stop the acquisition threads once they have acquired
+	 *	all red blocks already received.			*/
+
+	stopAcqThreads(&rtp, acqThreads, acqThreadCount);
 	writeErrmsgMemos();
 	writeMemo("[i] ltpcli duct has ended.");
 	ionDetach();
@@ -60,9 +60,10 @@ int	main(int argc, char *argv[])
 	Outflow		outflows[3];
 	int		i;
 	int		running = 1;
+	BpDequeuedBundle	batch[BP_DEQUEUE_BATCH];
+	int		batchLength;
+	int		j;
 	Object		bundleZco;
-	BpExtendedCOS	extendedCOS;
-	char		destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int	redPartLength;
 	LtpSessionId	sessionId;
 
@@ -125,37 +126,53 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] ltpclo is running.");
 	while (running && !(sm_SemEnded(ltpcloSemaphore(NULL))))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName, 0, -1) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows, batch,
+				BP_DEQUEUE_BATCH, 0, 0, -1);
+		if (batchLength < 0)
 		{
 			running = 0;	/*	Terminate CLO.		*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
-		}
-
-		if (extendedCOS.flags & BP_BEST_EFFORT)
-		{
-			redPartLength = 0;
-		}
-		else
-		{
-			redPartLength = LTP_ALL_RED;
-		}
-
-		switch (ltp_send(destEngineNbr, BpLtpClientId, bundleZco,
-				redPartLength, &sessionId))
-		{
-		case 0:
-			putErrmsg("Unable to send this bundle via LTP.", NULL);
-			break;
-
-		case -1:
-			putErrmsg("LtpSend failed.", NULL);
-			running = 0;	/*	Terminate CLO.		*/
+			bundleZco = batch[j].bundleZco;
+			if (!running)
+			{
+				/*	CLO is terminating; return the
+				 *	rest of the batch to BP for
+				 *	re-forwarding.			*/
+
+				if (bpReturnBundle(bundleZco) < 0)
+				{
+					putErrmsg("Can't release bundle.",
+							NULL);
+				}
+
+				continue;
+			}
+
+			if (batch[j].extendedCOS.flags & BP_BEST_EFFORT)
+			{
+				redPartLength = 0;
+			}
+			else
+			{
+				redPartLength = LTP_ALL_RED;
+			}
+
+			switch (ltp_send(destEngineNbr, BpLtpClientId,
+					bundleZco, redPartLength, &sessionId))
+			{
+			case 0:
+				putErrmsg("Unable to send this bundle via LTP.",
+						NULL);
+				break;
+
+			case -1:
+				putErrmsg("LtpSend failed.", NULL);
+				running = 0;	/*	Terminate CLO.	*/
+			}
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
@@ -205,10 +205,339 @@ int	sendBytesByTCP(int *bundleSocket, char *from, int length,
 	}
 }
 
+#ifndef mingw
+/*	Bundles are sent without copying their file-resident data:
+ *	within each transaction the heap-resident spans of the
+ *	bundle's ZCO are copied into a buffer, to be written by
+ *	writev(), and each file-resident span is described by a
+ *	duplicated file descriptor, to be sent by sendfile() where
+ *	available.  So a transaction is needed only per TCPCLA_BUFSZ
+ *	bytes of heap text or TCPCLA_MAX_SPANS spans, however large
+ *	the files, and nothing the spans refer to can change while
+ *	they are being sent outside the transaction.			*/
+
+static int	sendIovByTCP(int *bundleSocket, struct iovec *iov, int iovCount)
+{
+	int	totalBytesSent = 0;
+	int	bytesSent;
+
+	while (iovCount > 0)
+	{
+		bytesSent = writev(*bundleSocket, iov, iovCount);
+		if (bytesSent < 0)
+		{
+			switch (errno)
+			{
+			case EINTR:	/*	Interrupted; retry.	*/
+				continue;
+
+			case EPIPE:	/*	Lost connection.	*/
+			case EBADF:
+			case ETIMEDOUT:
+			case ECONNRESET:
+			case EHOSTUNREACH:
+				closesocket(*bundleSocket);
+				*bundleSocket = -1;
+				return totalBytesSent;
+			}
+
+			putSysErrmsg("writev() error on socket", NULL);
+			return -1;
+		}
+
+		totalBytesSent += bytesSent;
+
+		/*	Skip over all data that have been sent.		*/
+
+		while (iovCount > 0 && bytesSent >= iov->iov_len)
+		{
+			bytesSent -= iov->iov_len;
+			iov++;
+			iovCount--;
+		}
+
+		if (iovCount > 0)
+		{
+			iov->iov_base = ((char *) (iov->iov_base)) + bytesSent;
+			iov->iov_len -= bytesSent;
+		}
+	}
+
+	return totalBytesSent;
+}
+
+static int	sendFileBytesByTCP(int *bundleSocket, int fd, vast offset,
+			vast length, unsigned char *buffer, struct sockaddr *sn)
+{
+	int	totalBytesSent = 0;
+	int	bytesToRead;
+	int	bytesRead;
+	char	*from;
+	int	bytesToSend;
+	int	bytesSent;
+
+	while (length > 0)
+	{
+		bytesToRead = TCPCLA_BUFSZ;
+		if (bytesToRead > length)
+		{
+			bytesToRead = length;
+		}
+
+		bytesRead = pread(fd, buffer, bytesToRead, offset);
+		if (bytesRead < 0)
+		{
+			bytesRead = 0;
+		}
+
+		/*	If the file has been truncated, send fill.	*/
+
+		memset(buffer + bytesRead, ZCO_FILE_FILL_CHAR,
+				bytesToRead - bytesRead);
+		from = (char *) buffer;
+		bytesToSend = bytesToRead;
+		while (bytesToSend > 0)
+		{
+			bytesSent = sendBytesByTCP(bundleSocket, from,
+					bytesToSend, sn);
+			if (bytesSent < 0)
+			{
+				return -1;
+			}
+
+			if (*bundleSocket == -1)
+			{
+				return totalBytesSent;
+			}
+
+			totalBytesSent += bytesSent;
+			from += bytesSent;
+			bytesToSend -= bytesSent;
+		}
+
+		offset += bytesToRead;
+		length -= bytesToRead;
+	}
+
+	return totalBytesSent;
+}
+
+static int	sendFileByTCP(int *bundleSocket, int fd, vast offset,
+			vast length, unsigned char *buffer, struct sockaddr *sn)
+{
+	int	totalBytesSent = 0;
+#ifdef linux
+	off_t	fileOffset = offset;
+	ssize_t	bytesSent;
+	int	result;
+
+	while (length > 0)
+	{
+		bytesSent = sendfile(*bundleSocket, fd, &fileOffset,
+				length > TCPCLA_BUFSZ * 16 ?
+				TCPCLA_BUFSZ * 16 : length);
+		if (bytesSent < 0)
+		{
+			switch (errno)
+			{
+			case EINTR:	/*	Interrupted; retry.	*/
+				continue;
+
+			case EPIPE:	/*	Lost connection.	*/
+			case EBADF:
+			case ETIMEDOUT:
+			case ECONNRESET:
+			case EHOSTUNREACH:
+				closesocket(*bundleSocket);
+				*bundleSocket = -1;
+				return totalBytesSent;
+			}
+
+			break;		/*	Fall back to copying.	*/
+		}
+
+		if (bytesSent == 0)
+		{
+			break;		/*	File has been truncated.	*/
+		}
+
+		totalBytesSent += bytesSent;
+		length -= bytesSent;
+	}
+
+	if (length == 0)
+	{
+		return totalBytesSent;
+	}
+
+	offset = fileOffset;
+	result = sendFileBytesByTCP(bundleSocket, fd, offset, length, buffer,
+			sn);
+	if (result < 0)
+	{
+		return -1;
+	}
+
+	return totalBytesSent + result;
+#else
+	totalBytesSent = sendFileBytesByTCP(bundleSocket, fd, offset, length,
+			buffer, sn);
+	return totalBytesSent;
+#endif
+}
+
+static void	closeFileSpans(ZcoSpan *spans, int spanCount)
+{
+	int	i;
+
+	for (i = 0; i < spanCount; i++)
+	{
+		if (spans[i].medium == ZcoFileSource && spans[i].fd >= 0)
+		{
+			close(spans[i].fd);
+		}
+	}
+}
+
+static int	sendSpansByTCP(int *bundleSocket, ZcoSpan *spans,
+			int spanCount, struct iovec *iov, int iovCount,
+			unsigned char *buffer, struct sockaddr *sn)
+{
+	int	totalBytesSent = 0;
+	ZcoSpan	*span;
+	int	i;
+	int	bytesSent;
+
+	for (i = 0, span = spans; i <= spanCount; i++, span++)
+	{
+		if (i < spanCount && span->medium == ZcoSdrSource)
+		{
+			iov[iovCount].iov_base = span->data;
+			iov[iovCount].iov_len = span->length;
+			iovCount++;
+			continue;
+		}
+
+		/*	Next span is in a file, or end of spans: send
+		 *	all pending heap text before "buffer" can be
+		 *	reused for sending file data.			*/
+
+		if (iovCount > 0)
+		{
+			bytesSent = sendIovByTCP(bundleSocket, iov, iovCount);
+			if (bytesSent < 0 || *bundleSocket == -1)
+			{
+				return bytesSent;
+			}
+
+			totalBytesSent += bytesSent;
+			iovCount = 0;
+		}
+
+		if (i == spanCount)
+		{
+			break;
+		}
+
+		bytesSent = sendFileByTCP(bundleSocket, span->fd, span->offset,
+				span->length, buffer, sn);
+		if (bytesSent < 0 || *bundleSocket == -1)
+		{
+			return bytesSent;
+		}
+
+		totalBytesSent += bytesSent;
+	}
+
+	return totalBytesSent;
+}
+
+static int	sendZcoSpansByTCP(int *bundleSocket, unsigned int bundleLength,
+			Object bundleZco, unsigned char *buffer, unsigned int
+			tcpclSegmentHeaderLength, struct sockaddr *sn)
+{
+	Sdr		sdr = getIonsdr();
+	int		totalBytesSent = 0;
+	unsigned int	bytesRemaining = bundleLength;
+	ZcoReader	reader;
+	char		*text;
+	ZcoSpan		spans[TCPCLA_MAX_SPANS];
+	struct iovec	iov[TCPCLA_MAX_SPANS + 1];
+	int		spanCount;
+	int		iovCount = 0;
+	vast		bytesLoaded;
+	int		bytesSent;
+
+	text = MTAKE(TCPCLA_BUFSZ);
+	if (text == NULL)
+	{
+		putErrmsg("No memory for bundle text.", NULL);
+		return -1;
+	}
+
+	if (tcpclSegmentHeaderLength > 0)
+	{
+		iov[0].iov_base = (char *) buffer;
+		iov[0].iov_len = tcpclSegmentHeaderLength;
+		iovCount = 1;
+	}
+
+	zco_start_transmitting(bundleZco, &reader);
+	zco_track_file_offset(&reader);
+	while (bytesRemaining > 0)
+	{
+		spanCount = TCPCLA_MAX_SPANS;
+		if (sdr_begin_xn(sdr) < 0)
+		{
+			MRELEASE(text);
+			return -1;
+		}
+
+		bytesLoaded = zco_transmit_iov(sdr, &reader, bytesRemaining,
+				text, TCPCLA_BUFSZ, spans, &spanCount);
+		if (sdr_end_xn(sdr) < 0 || bytesLoaded <= 0)
+		{
+			closeFileSpans(spans, spanCount);
+			MRELEASE(text);
+			putErrmsg("ZCO length error.", NULL);
+			return -1;
+		}
+
+		bytesRemaining -= bytesLoaded;
+		bytesSent = sendSpansByTCP(bundleSocket, spans, spanCount,
+				iov, iovCount, buffer, sn);
+		closeFileSpans(spans, spanCount);
+		if (bytesSent < 0)
+		{
+			MRELEASE(text);
+			putErrmsg("Failed to send by TCP.", NULL);
+			return -1;
+		}
+
+		if (*bundleSocket == -1)
+		{
+			MRELEASE(text);
+			writeMemo("[?] Disconnected from CLI.");
+			return 0;
+		}
+
+		totalBytesSent += bytesSent;
+		iovCount = 0;
+	}
+
+	MRELEASE(text);
+	return totalBytesSent;
+}
+#endif
+
 static int	sendZcoByTCP(int *bundleSocket, unsigned int bundleLength,
 			Object bundleZco, unsigned char *buffer, unsigned int
 			tcpclSegmentHeaderLength, struct sockaddr *sn)
 {
+#ifndef mingw
+	return sendZcoSpansByTCP(bundleSocket, bundleLength, bundleZco,
+			buffer, tcpclSegmentHeaderLength, sn);
+#else
 	Sdr		sdr = getIonsdr();
 	int		totalBytesSent = 0;
 	unsigned int	bytesRemaining = bundleLength;
@@ -275,6 +604,7 @@ static int	sendZcoByTCP(int *bundleSocket, unsigned int bundleLength,
 	}
 
 	return totalBytesSent;
+#endif
 }
 
 static int	handleTcpFailure(struct sockaddr *sn, Object bundleZco)
@@ -123,9 +123,10 @@ int	main(int argc, char *argv[])
 	pthread_mutex_t		mutex;
 	KeepaliveThreadParms	parms;
 	pthread_t		keepaliveThread;
+	BpDequeuedBundle	batch[BP_DEQUEUE_BATCH];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -256,29 +257,43 @@ int	main(int argc, char *argv[])
 
 	while (!(sm_SemEnded(stcpcloSemaphore(NULL))))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName, 0, -1) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows, batch,
+				BP_DEQUEUE_BATCH, 0, 0, -1);
+		if (batchLength < 0)
 		{
 			sm_SemEnd(stcpcloSemaphore(NULL));
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
-		}
-
-		CHKZERO(sdr_begin_xn(sdr));
-		bundleLength = zco_length(sdr, bundleZco);
-		sdr_exit_xn(sdr);
-		pthread_mutex_lock(&mutex);
-		bytesSent = sendBundleByTCP(&socketName, &ductSocket,
-				bundleLength, bundleZco, buffer);
-		pthread_mutex_unlock(&mutex);
-		if (bytesSent < 0)	/*	System error.		*/
-		{
-			sm_SemEnd(stcpcloSemaphore(NULL));
-			continue;
+			bundleZco = batch[j].bundleZco;
+			if (sm_SemEnded(stcpcloSemaphore(NULL)))
+			{
+				/*	CLO is stopping; return the
+				 *	rest of the batch to BP for
+				 *	re-forwarding.			*/
+
+				if (bpReturnBundle(bundleZco) < 0)
+				{
+					putErrmsg("Can't release bundle.",
+							NULL);
+				}
+
+				continue;
+			}
+
+			CHKZERO(sdr_begin_xn(sdr));
+			bundleLength = zco_length(sdr, bundleZco);
+			sdr_exit_xn(sdr);
+			pthread_mutex_lock(&mutex);
+			bytesSent = sendBundleByTCP(&socketName, &ductSocket,
+					bundleLength, bundleZco, buffer);
+			pthread_mutex_unlock(&mutex);
+			if (bytesSent < 0)	/*	System error.	*/
+			{
+				sm_SemEnd(stcpcloSemaphore(NULL));
+			}
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
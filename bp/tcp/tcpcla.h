@@ -18,6 +18,12 @@
 #include <pthread.h>
 #include "ipnfw.h"
 #include "dtn2fw.h"
+#ifndef mingw
+#include <sys/uio.h>
+#endif
+#ifdef linux
+#include <sys/sendfile.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +34,7 @@ extern "C" {
 #endif
 
 #define TCPCLA_BUFSZ		(64 * 1024)
+#define TCPCLA_MAX_SPANS	(64)
 #define BpTcpDefaultPortNbr	4556
 
 #define	DEFAULT_TCP_RATE	-1
@@ -268,9 +268,10 @@ int	main(int argc, char *argv[])
 	ReceiveThreadParms	rparms;
 	pthread_t		keepaliveThread;
 	pthread_t		receiverThread;
+	BpDequeuedBundle	batch[BP_DEQUEUE_BATCH];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -434,28 +435,44 @@ int	main(int argc, char *argv[])
 
 	while (running && !(sm_SemEnded(tcpcloSemaphore(NULL))))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName, 0, -1) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows, batch,
+				BP_DEQUEUE_BATCH, 0, 0, -1);
+		if (batchLength < 0)
 		{
 			running = 0;	/*	Terminate CLO.		*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
-		}
+			bundleZco = batch[j].bundleZco;
+			if (!running)
+			{
+				/*	CLO is terminating; return the
+				 *	rest of the batch to BP for
+				 *	re-forwarding.			*/
 
-		CHKZERO(sdr_begin_xn(sdr));
-		bundleLength = zco_length(sdr, bundleZco);
-		sdr_exit_xn(sdr);
-		pthread_mutex_lock(&mutex);
-		bytesSent = sendBundleByTCPCL(&socketName, &ductSocket,
-			bundleLength, bundleZco, buffer, &keepalivePeriod);
-		pthread_mutex_unlock(&mutex);
-		if(bytesSent < 0)
-		{
-			running = 0;	/*	Terminate CLO.		*/
+				if (bpReturnBundle(bundleZco) < 0)
+				{
+					putErrmsg("Can't release bundle.",
+							NULL);
+				}
+
+				continue;
+			}
+
+			CHKZERO(sdr_begin_xn(sdr));
+			bundleLength = zco_length(sdr, bundleZco);
+			sdr_exit_xn(sdr);
+			pthread_mutex_lock(&mutex);
+			bytesSent = sendBundleByTCPCL(&socketName, &ductSocket,
+				bundleLength, bundleZco, buffer,
+				&keepalivePeriod);
+			pthread_mutex_unlock(&mutex);
+			if(bytesSent < 0)
+			{
+				running = 0;	/*	Terminate CLO.	*/
+			}
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
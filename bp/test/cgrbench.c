@@ -0,0 +1,316 @@
+/*
+	cgrbench.c:	benchmark for Contact Graph Routing route
+			computation over a synthetic contact plan.
+
+	Adds a synthetic contact plan to the contact plan of the
+	local node, computes the CGR route lists to a sample of
+	destination nodes in that plan, reports the rate at which
+	routes were computed, and then removes the synthetic plan.
+	Should only be run on a node that is not forwarding traffic.
+									*/
+
+#include "cgr.h"
+
+#define	CGRBENCH_BASE_NODE	(1000000)
+#define	CGRBENCH_DEGREE		(4)
+#define	CGRBENCH_PERIOD		(3600)
+#define	CGRBENCH_XMIT_RATE	(100000)
+#define	DEFAULT_NODES		(1000)
+#define	DEFAULT_CONTACTS	(10000)
+#define	DEFAULT_DESTINATIONS	(10)
+
+typedef struct
+{
+	uvast	fromNode;
+	uvast	toNode;
+	time_t	phase;
+} BenchLink;
+
+static unsigned long	_routesComputed = 0;
+
+static void	countRoutes(void *data, unsigned int lineNbr,
+			CgrTraceType traceType, ...)
+{
+	if (traceType == CgrAcceptRoute)
+	{
+		_routesComputed++;
+	}
+}
+
+static int	getDirective(uvast nodeNbr, Object plans, Bundle *bundle,
+			FwdDirective *directive)
+{
+	memset((char *) directive, 0, sizeof(FwdDirective));
+	directive->outductElt = *((Object *) plans);
+	return 1;
+}
+
+static Object	findAnyOutduct()
+{
+	PsmPartition	ionwm = getIonwm();
+	BpVdb		*bpvdb = getBpVdb();
+	PsmAddress	elt;
+	VOutduct	*vduct;
+
+	elt = sm_list_first(ionwm, bpvdb->outducts);
+	if (elt == 0)
+	{
+		return 0;
+	}
+
+	vduct = (VOutduct *) psp(ionwm, sm_list_data(ionwm, elt));
+	return vduct->outductElt;
+}
+
+static int	isDuplicate(BenchLink *link, int priorLinks)
+{
+	BenchLink	*prior;
+
+	for (prior = link - priorLinks; prior < link; prior++)
+	{
+		if (prior->toNode == link->toNode)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int	loadPlan(BenchLink *links, int linkCount, int passes,
+			time_t startTime)
+{
+	BenchLink	*link;
+	int		i;
+	int		j;
+	time_t		fromTime;
+	time_t		toTime;
+
+	for (i = 0, link = links; i < linkCount; i++, link++)
+	{
+		if (rfx_insert_range(startTime, startTime
+				+ (passes * CGRBENCH_PERIOD) + CGRBENCH_PERIOD,
+				link->fromNode, link->toNode, 1) == 0)
+		{
+			putErrmsg("Can't insert range.", utoa(link->fromNode));
+			return -1;
+		}
+
+		for (j = 0; j < passes; j++)
+		{
+			fromTime = startTime + link->phase
+					+ (j * CGRBENCH_PERIOD);
+			toTime = fromTime + (CGRBENCH_PERIOD / 6)
+					+ (rand() % (CGRBENCH_PERIOD / 3));
+			if (rfx_insert_contact(fromTime, toTime, link->fromNode,
+					link->toNode, CGRBENCH_XMIT_RATE, 1.0)
+					== 0)
+			{
+				putErrmsg("Can't insert contact.",
+						utoa(link->fromNode));
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void	unloadPlan(BenchLink *links, int linkCount, time_t startTime)
+{
+	BenchLink	*link;
+	int		i;
+
+	for (i = 0, link = links; i < linkCount; i++, link++)
+	{
+		oK(rfx_remove_contact(0, link->fromNode, link->toNode));
+		oK(rfx_remove_range(startTime, link->fromNode, link->toNode));
+	}
+}
+
+static int	run_cgrbench(int nodeCount, int contactCount,
+			int destinationCount)
+{
+	Sdr		sdr;
+	uvast		ownNodeNbr;
+	int		linkCount;
+	BenchLink	*links;
+	BenchLink	*link;
+	int		passes;
+	int		i;
+	int		j;
+	time_t		currentTime;
+	Object		outductElt;
+	Bundle		bundle;
+	CgrTrace	trace;
+	uvast		destNodeNbr;
+	struct timeval	startTime;
+	struct timeval	endTime;
+	double		interval;
+	char		textBuf[256];
+
+	if (nodeCount < CGRBENCH_DEGREE + 1 || contactCount < 1
+	|| destinationCount < 1)
+	{
+		PUTS("Usage: cgrbench [<number of nodes> [<number of \
+contacts> [<number of destinations>]]]");
+		return 0;
+	}
+
+	if (bp_attach() < 0)
+	{
+		putErrmsg("Can't attach to BP.", NULL);
+		return 0;
+	}
+
+	sdr = bp_get_sdr();
+	ownNodeNbr = getOwnNodeNbr();
+	outductElt = findAnyOutduct();
+	if (outductElt == 0)
+	{
+		putErrmsg("cgrbench needs at least one outduct.", NULL);
+		bp_detach();
+		return 0;
+	}
+
+	/*	Each synthetic node has contacts with CGRBENCH_DEGREE
+	 *	other nodes, recurring once per period; the local
+	 *	node has contacts with the first CGRBENCH_DEGREE
+	 *	synthetic nodes.					*/
+
+	linkCount = (nodeCount + 1) * CGRBENCH_DEGREE;
+	passes = contactCount / linkCount;
+	if (passes < 1)
+	{
+		passes = 1;
+	}
+
+	links = (BenchLink *) MTAKE(linkCount * sizeof(BenchLink));
+	if (links == NULL)
+	{
+		putErrmsg("Can't allocate synthetic links.", itoa(linkCount));
+		bp_detach();
+		return 0;
+	}
+
+	srand(1);
+	for (i = 0, link = links; i <= nodeCount; i++)
+	{
+		for (j = 0; j < CGRBENCH_DEGREE; j++, link++)
+		{
+			if (i == nodeCount)
+			{
+				link->fromNode = ownNodeNbr;
+				link->toNode = CGRBENCH_BASE_NODE + j;
+			}
+			else	/*	Pick a new neighbor at random.	*/
+			{
+				link->fromNode = CGRBENCH_BASE_NODE + i;
+				do
+				{
+					link->toNode = CGRBENCH_BASE_NODE
+						+ ((i + 1 + (rand()
+						% (nodeCount - 1)))
+						% nodeCount);
+				} while (isDuplicate(link, j));
+			}
+
+			link->phase = rand() % (CGRBENCH_PERIOD / 2);
+		}
+	}
+
+	currentTime = getUTCTime();
+	PUTS("Loading synthetic contact plan...");
+	if (loadPlan(links, linkCount, passes, currentTime) < 0)
+	{
+		unloadPlan(links, linkCount, currentTime);
+		MRELEASE(links);
+		bp_detach();
+		return 0;
+	}
+
+	memset((char *) &bundle, 0, sizeof(Bundle));
+	bundle.payload.length = 1024;
+	bundle.expirationTime = (currentTime + (passes * CGRBENCH_PERIOD))
+			- EPOCH_2000_SEC;
+	bundle.extendedCOS.flags = BP_BEST_EFFORT;
+	bundle.clDossier.senderNodeNbr = ownNodeNbr;
+	trace.fn = countRoutes;
+	trace.data = NULL;
+	cgr_start();
+	getCurrentTime(&startTime);
+	for (i = 0; i < destinationCount; i++)
+	{
+		destNodeNbr = CGRBENCH_BASE_NODE + (rand() % nodeCount);
+		CHKZERO(sdr_begin_xn(sdr));
+		if (cgr_preview_forward(&bundle, (Object) &bundle, destNodeNbr,
+				(Object) &outductElt, getDirective,
+				currentTime, &trace) < 0)
+		{
+			sdr_exit_xn(sdr);
+			putErrmsg("Can't compute routes.", utoa(destNodeNbr));
+			break;
+		}
+
+		sdr_exit_xn(sdr);
+	}
+
+	getCurrentTime(&endTime);
+	PUTS("Removing synthetic contact plan...");
+	unloadPlan(links, linkCount, currentTime);
+	MRELEASE(links);
+	writeErrmsgMemos();
+	if (endTime.tv_usec < startTime.tv_usec)
+	{
+		endTime.tv_usec += 1000000;
+		endTime.tv_sec -= 1;
+	}
+
+	interval = (endTime.tv_usec - startTime.tv_usec)
+			+ (1000000 * (endTime.tv_sec - startTime.tv_sec));
+	PUTMEMO("Contacts", itoa(linkCount * passes));
+	PUTMEMO("Destinations", itoa(i));
+	PUTMEMO("Routes computed", utoa(_routesComputed));
+	isprintf(textBuf, sizeof textBuf, "%.3f", interval / 1000000);
+	PUTMEMO("Time (seconds)", textBuf);
+	if (interval > 0.0)
+	{
+		isprintf(textBuf, sizeof textBuf, "%.1f",
+				_routesComputed / (interval / 1000000));
+		PUTMEMO("Routes per second", textBuf);
+	}
+
+	bp_detach();
+	return 0;
+}
+
+#if defined (ION_LWT)
+int	cgrbench(int a1, int a2, int a3, int a4, int a5,
+		int a6, int a7, int a8, int a9, int a10)
+{
+	int	nodeCount = (a1 == 0 ? DEFAULT_NODES : atoi((char *) a1));
+	int	contactCount = (a2 == 0 ? DEFAULT_CONTACTS : atoi((char *) a2));
+	int	destinationCount = (a3 == 0 ? DEFAULT_DESTINATIONS
+					: atoi((char *) a3));
+#else
+int	main(int argc, char **argv)
+{
+	int	nodeCount = DEFAULT_NODES;
+	int	contactCount = DEFAULT_CONTACTS;
+	int	destinationCount = DEFAULT_DESTINATIONS;
+
+	if (argc > 4) argc = 4;
+	switch (argc)
+	{
+	case 4:
+		destinationCount = atoi(argv[3]);
+	case 3:
+		contactCount = atoi(argv[2]);
+	case 2:
+		nodeCount = atoi(argv[1]);
+	default:
+		break;
+	}
+#endif
+	return run_cgrbench(nodeCount, contactCount, destinationCount);
+}
@@ -70,9 +70,23 @@ int	sendBundleByUDP(struct sockaddr *socketName, int *bundleSocket,
 	int		bytesSent;
 
 	CHKERR(socketName && bundleSocket && buffer);
+	sdr = getIonsdr();
 	if (bundleLength > UDPCLA_BUFSZ)
 	{
 		putErrmsg("Bundle is too big for UDP CLA.", itoa(bundleLength));
+
+		/*	The bundle can never be sent by UDP, so
+		 *	don't re-forward it; drop it as though
+		 *	it had been sent.				*/
+
+		if (bpHandleXmitSuccess(bundleZco, 0) < 0)
+		{
+			putErrmsg("Can't handle xmit success.", NULL);
+		}
+
+		CHKERR(sdr_begin_xn(sdr));
+		zco_destroy(sdr, bundleZco);
+		oK(sdr_end_xn(sdr));
 		return -1;
 	}
 
@@ -85,13 +99,26 @@ int	sendBundleByUDP(struct sockaddr *socketName, int *bundleSocket,
 			/*	Treat I/O error as a transient anomaly,
 			 *	note incomplete transmission.		*/
 
+			if (bpHandleXmitFailure(bundleZco) < 0)
+			{
+				putErrmsg("Can't handle xmit failure.", NULL);
+				return -1;
+			}
+
+			CHKERR(sdr_begin_xn(sdr));
+			zco_destroy(sdr, bundleZco);
+			if (sdr_end_xn(sdr) < 0)
+			{
+				putErrmsg("Can't destroy bundle ZCO.", NULL);
+				return -1;
+			}
+
 			return 0;
 		}
 	}
 
 	/*	Send the bundle in a single UDP datagram.		*/
 
-	sdr = getIonsdr();
 	zco_start_transmitting(bundleZco, &reader);
 	zco_track_file_offset(&reader);
 	CHKERR(sdr_begin_xn(sdr));
@@ -130,6 +157,14 @@ when connectivity is restored.");
 			return -1;
 		}
 	}
+	else
+	{
+		if (bpHandleXmitSuccess(bundleZco, 0) < 0)
+		{
+			putErrmsg("Can't handle xmit success.", NULL);
+			return -1;
+		}
+	}
 
 	CHKERR(sdr_begin_xn(sdr));
 	zco_destroy(sdr, bundleZco);
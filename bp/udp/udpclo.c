@@ -32,6 +32,28 @@ static void	shutDownClo()	/*	Commands CLO termination.	*/
 	sm_SemEnd(udpcloSemaphore(NULL));
 }
 
+static int	discardBundle(Sdr sdr, Object bundleZco)
+{
+	/*	The bundle can't be sent to its destination duct;
+	 *	drop it, as though it had been sent.			*/
+
+	if (bpHandleXmitSuccess(bundleZco, 0) < 0)
+	{
+		putErrmsg("Can't handle xmit success.", NULL);
+		return -1;
+	}
+
+	CHKERR(sdr_begin_xn(sdr));
+	zco_destroy(sdr, bundleZco);
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("Can't destroy ZCO reference.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 /*	*	*	Main thread functions	*	*	*	*/
 
 #if defined (ION_LWT)
@@ -54,9 +76,11 @@ int	main(int argc, char *argv[])
 	unsigned int		hostNbr;
 	struct sockaddr		socketName;
 	struct sockaddr_in	*inetName;
+	BpDequeuedBundle	batch[BP_DEQUEUE_BATCH];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
+	char			*destDuctName;
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -126,56 +150,69 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] udpclo is running.");
 	while (!(sm_SemEnded(vduct->semaphore)))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName, outduct.maxPayloadLen, 0) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows, batch,
+				BP_DEQUEUE_BATCH, 0, outduct.maxPayloadLen,
+				-1);
+		if (batchLength < 0)
 		{
 			sm_SemEnd(udpcloSemaphore(NULL));/*	Stop.	*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
-		}
+			bundleZco = batch[j].bundleZco;
+			destDuctName = batch[j].destDuctName;
+			if (sm_SemEnded(vduct->semaphore))
+			{
+				/*	CLO is stopping; return the
+				 *	rest of the batch to BP for
+				 *	re-forwarding.			*/
 
-		parseSocketSpec(destDuctName, &portNbr, &hostNbr);
-		if (portNbr == 0)
-		{
-			portNbr = BpUdpDefaultPortNbr;
-		}
+				if (bpReturnBundle(bundleZco) < 0)
+				{
+					putErrmsg("Can't release bundle.",
+							NULL);
+				}
 
-		portNbr = htons(portNbr);
-		if (hostNbr == 0)	/*	Can't send bundle.	*/
-		{
-			writeMemoNote("[?] Can't get IP address for host",
-					destDuctName);
-			CHKZERO(sdr_begin_xn(sdr));
-			zco_destroy(sdr, bundleZco);
-			if (sdr_end_xn(sdr) < 0)
+				continue;
+			}
+
+			parseSocketSpec(destDuctName, &portNbr, &hostNbr);
+			if (portNbr == 0)
 			{
-				putErrmsg("Can't destroy ZCO reference.", NULL);
-				sm_SemEnd(udpcloSemaphore(NULL));
+				portNbr = BpUdpDefaultPortNbr;
 			}
 
-			continue;
-		}
+			portNbr = htons(portNbr);
+			if (hostNbr == 0)	/*	Can't send.	*/
+			{
+				writeMemoNote("[?] Can't get IP address for \
+host", destDuctName);
+				if (discardBundle(sdr, bundleZco) < 0)
+				{
+					sm_SemEnd(udpcloSemaphore(NULL));
+				}
+
+				continue;
+			}
 
-		hostNbr = htonl(hostNbr);
-		memset((char *) &socketName, 0, sizeof socketName);
-		inetName = (struct sockaddr_in *) &socketName;
-		inetName->sin_family = AF_INET;
-		inetName->sin_port = portNbr;
-		memcpy((char *) &(inetName->sin_addr.s_addr),
-				(char *) &hostNbr, 4);
-		CHKZERO(sdr_begin_xn(sdr));
-		bundleLength = zco_length(sdr, bundleZco);
-		sdr_exit_xn(sdr);
-		bytesSent = sendBundleByUDP(&socketName, &ductSocket,
-				bundleLength, bundleZco, buffer);
-		if (bytesSent < bundleLength)
-		{
-			sm_SemEnd(udpcloSemaphore(NULL));/*	Stop.	*/
-			continue;
+			hostNbr = htonl(hostNbr);
+			memset((char *) &socketName, 0, sizeof socketName);
+			inetName = (struct sockaddr_in *) &socketName;
+			inetName->sin_family = AF_INET;
+			inetName->sin_port = portNbr;
+			memcpy((char *) &(inetName->sin_addr.s_addr),
+					(char *) &hostNbr, 4);
+			CHKZERO(sdr_begin_xn(sdr));
+			bundleLength = zco_length(sdr, bundleZco);
+			sdr_exit_xn(sdr);
+			bytesSent = sendBundleByUDP(&socketName, &ductSocket,
+					bundleLength, bundleZco, buffer);
+			if (bytesSent < bundleLength)	/*	Stop.	*/
+			{
+				sm_SemEnd(udpcloSemaphore(NULL));
+			}
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
@@ -11,6 +11,7 @@
 
 #include "bpP.h"
 #include "crypto.h"
+#include "sdrhash.h"
 
 static int	_echo(int *newValue)
 {
@@ -87,6 +88,7 @@ payload length");
 	PUTS("\t   {d|i} protocol <protocol name>");
 	PUTS("\t   {d|i} induct <protocol name> <duct name>");
 	PUTS("\t   {d|i} outduct <protocol name> <duct name>");
+	PUTS("\t   i bundles");
 	PUTS("\tl\tList");
 	PUTS("\t   l scheme");
 	PUTS("\t   l endpoint");
@@ -752,6 +754,33 @@ static void	infoOutduct(int tokenCount, char **tokens)
 	sdr_exit_xn(sdr);
 }
 
+static void	infoBundles(int tokenCount, char **tokens)
+{
+	Sdr		sdr = getIonsdr();
+	SdrLhashStats	stats;
+	char		buffer[256];
+
+	if (tokenCount != 2)
+	{
+		SYNTAX_ERROR;
+		return;
+	}
+
+	CHKVOID(sdr_begin_xn(sdr));
+	if (sdr_lhash_stats(sdr, (getBpConstants())->bundles, &stats) < 0)
+	{
+		sdr_exit_xn(sdr);
+		printText("Can't get bundles hash table statistics.");
+		return;
+	}
+
+	sdr_exit_xn(sdr);
+	isprintf(buffer, sizeof buffer, "entries: %u  rows: %u  empty rows: \
+%u  longest chain: %u  load factor: %.2f", stats.entries, stats.rows,
+			stats.emptyRows, stats.longestChain, stats.loadFactor);
+	printText(buffer);
+}
+
 static void	executeInfo(int tokenCount, char **tokens)
 {
 	if (tokenCount < 2)
@@ -790,6 +819,12 @@ static void	executeInfo(int tokenCount, char **tokens)
 		return;
 	}
 
+	if (strcmp(tokens[1], "bundles") == 0)
+	{
+		infoBundles(tokenCount, tokens);
+		return;
+	}
+
 	SYNTAX_ERROR;
 }
 
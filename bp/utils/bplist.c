@@ -344,11 +344,10 @@ in outduct '%.64s' of protocol '%.16s', priority %d.", ductName, protocolName,
 	if (protocolName == NULL)	/*	All bundles.		*/
 	{
 		bpConstants = getBpConstants();
-		list = bpConstants->timeline;
-		for (elt = sdr_list_first(sdr, bpConstants->timeline); elt;
-				elt = sdr_list_next(sdr, elt))
+		for (elt = sdr_wheel_first(sdr, bpConstants->timeline); elt;
+				elt = sdr_wheel_next(sdr, elt))
 		{
-			addr = sdr_list_data(sdr, elt);
+			addr = sdr_wheel_data(sdr, elt);
 			GET_OBJ_POINTER(sdr, BpEvent, event, addr);
 			if (event->type != expiredTTL)
 			{
@@ -10,6 +10,10 @@
 									*/
 #include "cfdpP.h"
 
+#ifndef CFDP_CLOCK_BATCH
+#define	CFDP_CLOCK_BATCH	(64)	/*	Events per transaction.	*/
+#endif
+
 static long	_running(long *newValue)
 {
 	void	*value;
@@ -35,6 +39,11 @@ static void	shutDown()	/*	Commands cfdpclock termination.	*/
 	oK(_running(&stop));	/*	Terminates cfdpclock.		*/
 }
 
+static int	isRunning(void *arg)
+{
+	return (_running(NULL) != 0);
+}
+
 static int	scanInFdus(Sdr sdr, time_t currentTime)
 {
 	CfdpDB		*cfdpConstants;
@@ -152,42 +161,19 @@ static int	handleFinishOverdue(Sdr sdr, Object fduObj)
 	return 0;
 }
 
-static int	scanFinsPending(Sdr sdr, time_t currentTime)
+static int	handleFinishPending(Sdr sdr, Object entry, Address fpObj,
+			struct timeval *currentTime, void *arg)
 {
-	CfdpDB	*cfdpConstants;
-	Object	elt;
-	Object	nextElt;
-	Object	fpObj;
-		OBJ_POINTER(FinishPending, fp);
-	Object	fduObj;
-
-	cfdpConstants = getCfdpConstants();
-	CHKERR(sdr_begin_xn(sdr));	/*	Lock database.		*/
-	for (elt = sdr_list_first(sdr, cfdpConstants->finsPending); elt;
-			elt = nextElt)
-	{
-		nextElt = sdr_list_next(sdr, elt);
-		fpObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, FinishPending, fp, fpObj);
-		if (fp->deadline > currentTime)
-		{
-			break;
-		}
-
-		fduObj = fp->fdu;
-		sdr_free(sdr, fpObj);
-		sdr_list_delete(sdr, elt, NULL, NULL);
-		if (handleFinishOverdue(sdr, fduObj) < 0)
-		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("Can't handle overdue closure.", NULL);
-			return -1;
-		}
-	}
+			OBJ_POINTER(FinishPending, fp);
+	Object		fduObj;
 
-	if (sdr_end_xn(sdr) < 0)
+	GET_OBJ_POINTER(sdr, FinishPending, fp, (Object) fpObj);
+	fduObj = fp->fdu;
+	sdr_free(sdr, (Object) fpObj);
+	sdr_wheel_delete(sdr, entry);
+	if (handleFinishOverdue(sdr, fduObj) < 0)
 	{
-		putErrmsg("cfdpclock failed scanning closures.", NULL);
+		putErrmsg("Can't handle overdue closure.", NULL);
 		return -1;
 	}
 
@@ -199,23 +185,11 @@ static int	noteFinishPending(Sdr sdr, OutFdu *fdu, Object fduObj,
 {
 	CfdpDB		*db = getCfdpConstants();
 	FinishPending	newFP;
-	Object		elt;
-			OBJ_POINTER(FinishPending, fp);
 	Object		obj;
+	struct timeval	deadline;
 
 	newFP.deadline = currentTime + fdu->closureLatency;
 	newFP.fdu = fduObj;
-	for (elt = sdr_list_last(sdr, db->finsPending); elt;
-			elt = sdr_list_prev(sdr, elt))
-	{
-		GET_OBJ_POINTER(sdr, FinishPending, fp,
-				sdr_list_data(sdr, elt));
-		if (fp->deadline <= newFP.deadline)
-		{
-			break;
-		}
-	}
-
 	obj = sdr_malloc(sdr, sizeof(FinishPending));
 	if (obj == 0)
 	{
@@ -224,16 +198,10 @@ static int	noteFinishPending(Sdr sdr, OutFdu *fdu, Object fduObj,
 	}
 
 	sdr_write(sdr, obj, (char *) &newFP, sizeof(FinishPending));
-	if (elt)
-	{
-		fdu->closureElt = sdr_list_insert_after(sdr, elt, obj);
-	}
-	else
-	{
-		fdu->closureElt = sdr_list_insert_first(sdr, db->finsPending,
-				obj);
-	}
-
+	deadline.tv_sec = newFP.deadline;
+	deadline.tv_usec = 0;
+	fdu->closureElt = sdr_wheel_insert(sdr, db->finsPending, &deadline,
+			obj);
 	if (fdu->closureElt == 0)
 	{
 		putErrmsg("Can't schedule pending finish.", NULL);
@@ -420,6 +388,26 @@ static int	scanOutFdus(Sdr sdr, time_t currentTime)
 	return 0;
 }
 
+static int	scanFdus(Sdr sdr, struct timeval *currentTime, void *arg)
+{
+	/*	Once per second, update check counts for inbound
+	 *	FDUs and clean out completed outbound FDUs.		*/
+
+	if (scanInFdus(sdr, currentTime->tv_sec) < 0)
+	{
+		putErrmsg("Can't scan inbound FDUs.", NULL);
+		return -1;
+	}
+
+	if (scanOutFdus(sdr, currentTime->tv_sec) < 0)
+	{
+		putErrmsg("Can't scan outbound FDUs.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 #if defined (ION_LWT)
 int	cfdpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -428,9 +416,8 @@ int	cfdpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	long	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	long		state = 1;
 
 	if (cfdpInit() < 0 || bp_attach() < 0)
 	{
@@ -441,43 +428,17 @@ int	main(int argc, char *argv[])
 	sdr = getIonsdr();
 	isignal(SIGTERM, shutDown);
 
-	/*	Main loop: wait one second, then scan all FDUS.		*/
+	/*	Main loop: wait for the next closure deadline or the
+	 *	next second, then scan all FDUs once per second and
+	 *	check for overdue closures.				*/
 
 	oK(_running(&state));
 	writeMemo("[i] cfdpclock is running.");
-	while (_running(NULL))
+	if (sdr_wheel_run(sdr, (getCfdpConstants())->finsPending,
+			CFDP_CLOCK_BATCH, getUTCTimeval, handleFinishPending,
+			scanFdus, isRunning, NULL) < 0)
 	{
-		snooze(1);
-		currentTime = getUTCTime();
-
-		/*	Update check counts for inbound FDUs.		*/
-
-		if (scanInFdus(sdr, currentTime) < 0)
-		{
-			putErrmsg("Can't scan inbound FDUs.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Check for overdue transaction closures.		*/
-
-		if (scanFinsPending(sdr, currentTime) < 0)
-		{
-			putErrmsg("Can't scan pending closures.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Clean out completed outbound FDUs.		*/
-
-		if (scanOutFdus(sdr, currentTime) < 0)
-		{
-			putErrmsg("Can't scan inbound FDUs.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-		}
+		putErrmsg("Can't scan pending closures.", NULL);
 	}
 
 	writeErrmsgMemos();
@@ -11,6 +11,7 @@
 
 #include "lyst.h"
 #include "zco.h"
+#include "sdrwheel.h"
 #include "cfdp.h"
 
 #ifndef _CFDPP_H_
@@ -85,6 +86,11 @@ typedef struct
 	Object			metadata;
 } FileDataPdu;
 
+/*	Closure latencies are whole seconds, so the wheel of pending
+ *	Finished PDUs advances in ticks of one second.			*/
+
+#define	CFDP_FINS_PENDING_RESOLUTION	1000
+
 typedef struct
 {
 	time_t			deadline;
@@ -120,22 +126,33 @@ typedef struct
 	Object			eofPdu;		/*	bytes		*/
 	unsigned int		epduLength;	/*	in bytes	*/
 	Object			extantPdus;	/*	sdrlist		*/
-	Object			closureElt;	/*	in sdrlist	*/
+	Object			closureElt;	/*	in sdrwheel	*/
 } OutFdu;
 
 /*	Each CfdpExtent in "extents" indicates a range of bytes of file
  *	data received so far in the course of receiving this FDU.  The
- *	extents list in the InFdu is managed in ascending offset
- *	order.  The arrival of a file data PDU creates a CfdpExtent
- *	if necessary but merely increases the length of an existing
- *	CfdpExtent if possible.  When the arrival of a file data PDU
- *	results in the length of one CfdpExtent being extended to
- *	equal or exceed the offset of the next, the two CfdpExtent
- *	objects are combined into a single CfdpExtent whose offset
- *	is the offset of the earlier extent and whose length is
- *	the sum of the offset and length of the later extent.  The
+ *	extents of the InFdu are the nodes of a height-balanced (AVL)
+ *	binary search tree keyed by offset, so that the extent at or
+ *	before any offset is found in logarithmic time no matter how
+ *	far out of order file data PDUs arrive.  The arrival of a
+ *	file data PDU creates a CfdpExtent if necessary but merely
+ *	increases the length of an existing CfdpExtent if possible.
+ *	When the arrival of a file data PDU results in the length of
+ *	one CfdpExtent being extended to equal or exceed the offset
+ *	of the next, the two CfdpExtent objects are combined into a
+ *	single CfdpExtent whose offset is the offset of the earlier
+ *	extent and whose length is the sum of the offset and length
+ *	of the later extent.  So extents never overlap or abut.  The
  *	"progress" of an InFdu is the sum of the offset and length
- *	of the last extent in the list.					*/
+ *	of the last extent in the tree.					*/
+
+typedef struct
+{
+	CfdpExtent		extent;		/*	Must be first.	*/
+	Object			left;		/*	CfdpExtentNode	*/
+	Object			right;		/*	CfdpExtentNode	*/
+	int			height;		/*	Of subtree.	*/
+} CfdpExtentNode;
 
 typedef struct
 {
@@ -179,7 +196,8 @@ typedef struct
 	time_t			checkTime;
 	int			checkTimeouts;
 	uvast			bytesReceived;
-	Object			extents;		/*	sdrlist	*/
+	Object			extents;	/*	CfdpExtentNode	*/
+	unsigned int		extentsCount;
 	time_t			inactivityDeadline;
 } InFdu;
 
@@ -241,7 +259,7 @@ typedef struct
 	Object		events;		/*	SDR list: CfdpEvent	*/
 	Object		entities;	/*	SDR list: Entity	*/
 	Object		finishPdus;	/*	SDR list: FinishPdu	*/
-	Object		finsPending;	/*	SDR list: FinishPending	*/
+	Object		finsPending;	/*	SDR wheel: FinishPending*/
 } CfdpDB;
 
 /*	The volatile database object encapsulates the current volatile
@@ -317,6 +335,9 @@ extern int		checkFile(char *);
 
 extern void		addToChecksum(unsigned char octet, uvast *offset,
 				unsigned int *checksum, CfdpCksumType ckType);
+extern void		addBytesToChecksum(unsigned char *octets, int length,
+				uvast *offset, unsigned int *checksum,
+				CfdpCksumType ckType);
 
 extern int		getReqNbr();	/*	Returns next req nbr.	*/
 
@@ -338,6 +359,8 @@ extern Object		findInFdu(CfdpTransactionId *id, InFdu *fdu,
 				Object *elt, int createIfNotFound);
 extern int		completeInFdu(InFdu *fdu, Object fduObj, Object fduElt,
 				CfdpCondition c, int reqNbr);
+extern unsigned int	mapInFduExtents(InFdu *fdu, CfdpExtent *extentsArray,
+				unsigned int limit);
 
 extern int		enqueueCfdpEvent(CfdpEvent *event);
 
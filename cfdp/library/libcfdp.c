@@ -134,6 +134,12 @@ void	cfdp_update_checksum(unsigned char octet, uvast *offset,
 	addToChecksum(octet, offset, checksum, ckType);
 }
 
+void	cfdp_update_checksum_buffer(unsigned char *octets, int length,
+		uvast *offset, unsigned int *checksum, CfdpCksumType ckType)
+{
+	addBytesToChecksum(octets, length, offset, checksum, ckType);
+}
+
 static int	defaultReader(int fd, unsigned int *checksum,
 			CfdpCksumType ckType)
 {
@@ -141,8 +147,6 @@ static int	defaultReader(int fd, unsigned int *checksum,
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	uvast		offset;
 	int		length;
-	int		i;
-	char		*octet;
 
 	offset = (uvast) lseek(fd, 0, SEEK_CUR);
 	if (offset == (uvast) -1)
@@ -158,11 +162,8 @@ static int	defaultReader(int fd, unsigned int *checksum,
 		return -1;
 	}
 
-	for (i = 0, octet = defaultReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBytesToChecksum((unsigned char *) defaultReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -174,7 +175,6 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum,
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	uvast		offset;
 	int		length;
-	int		i;
 	char		*octet;
 	unsigned int	recordLen;
 	unsigned short	pktlen;
@@ -250,11 +250,8 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum,
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = pktReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBytesToChecksum((unsigned char *) pktReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -316,11 +313,8 @@ int	cfdp_read_text_lines(int fd, unsigned int *checksum,
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = textReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBytesToChecksum((unsigned char *) textReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -2219,10 +2213,7 @@ int	cfdp_map(CfdpTransactionId *transactionId, unsigned int *extentCount,
 	Object		fduObj;
 	InFdu		fduBuf;
 	Object		fduElt;
-	Object		elt;
-	CfdpExtent	extent;
 	unsigned int	i;
-	CfdpExtent	*eptr;
 
 	CHKERR(transactionId);
 	CHKERR(extentCount);
@@ -2247,25 +2238,8 @@ int	cfdp_map(CfdpTransactionId *transactionId, unsigned int *extentCount,
 		return 0;
 	}
 
-	*extentCount = sdr_list_length(sdr, fduBuf.extents);
-	elt = sdr_list_first(sdr, fduBuf.extents);
-	eptr = extentsArray;
-	while (i > 0)
-	{
-		if (elt == 0)
-		{
-			break;
-		}
-
-		sdr_read(sdr, (char *) &extent, sdr_list_data(sdr, elt),
-				sizeof(CfdpExtent));
-		eptr->offset = extent.offset;
-		eptr->length = extent.length;
-		eptr++;
-		elt = sdr_list_next(sdr, elt);
-		i--;
-	}
-
+	*extentCount = fduBuf.extentsCount;
+	mapInFduExtents(&fduBuf, extentsArray, i);
 	sdr_exit_xn(sdr);
 	return 0;
 }
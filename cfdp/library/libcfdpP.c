@@ -255,8 +255,6 @@ static void	addToModularChecksum(unsigned char octet, uvast *offset,
 	(*offset)++;
 }
 
-static void	addToCrc32(unsigned char octet, unsigned int *checksum)
-{
 /*----------------------------------------------------------------------------*\
  *  CRC-32 version 2.0.0 by Craig Bruce, 2006-04-29.
  *
@@ -292,7 +290,7 @@ static void	addToCrc32(unsigned char octet, unsigned int *checksum)
  *     (no errors are possible)
 \*----------------------------------------------------------------------------*/
 
-	static const unsigned int crcTable[256] = {
+static const unsigned int crcTable[256] = {
    0x00000000,0x77073096,0xEE0E612C,0x990951BA,0x076DC419,0x706AF48F,0xE963A535,
    0x9E6495A3,0x0EDB8832,0x79DCB8A4,0xE0D5E91E,0x97D2D988,0x09B64C2B,0x7EB17CBD,
    0xE7B82D07,0x90BF1D91,0x1DB71064,0x6AB020F2,0xF3B97148,0x84BE41DE,0x1ADAD47D,
@@ -330,6 +328,9 @@ static void	addToCrc32(unsigned char octet, unsigned int *checksum)
    0x47B2CF7F,0x30B5FFE9,0xBDBDF21C,0xCABAC28A,0x53B39330,0x24B4A3A6,0xBAD03605,
    0xCDD70693,0x54DE5729,0x23D967BF,0xB3667A2E,0xC4614AB8,0x5D681B02,0x2A6F2B94,
    0xB40BBE37,0xC30C8EA1,0x5A05DF1B,0x2D02EF8D };
+
+static void	addToCrc32(unsigned char octet, unsigned int *checksum)
+{
 	unsigned int	crc32;
 
 	crc32 = (*checksum) ^ 0xFFFFFFFF;
@@ -354,6 +355,159 @@ void	addToChecksum(unsigned char octet, uvast *offset,
 	}
 }
 
+static void	addBytesToModularChecksum(unsigned char *octets, int length,
+			uvast *offset, unsigned int *checksum)
+{
+	unsigned int	sum = *checksum;
+
+	/*	Add leading octets one at a time until the offset
+	 *	is aligned on a 4-byte word boundary of the file.	*/
+
+	while (length > 0 && (*offset & 0x03) != 0)
+	{
+		addToModularChecksum(*octets, offset, &sum);
+		octets++;
+		length--;
+	}
+
+	/*	Then add whole big-endian 4-byte words, two at a time
+	 *	to allow the loads and additions to overlap.		*/
+
+	*offset += length & ~0x03;
+	while (length >= 8)
+	{
+		sum += (((unsigned int) octets[0]) << 24)
+			+ (((unsigned int) octets[1]) << 16)
+			+ (((unsigned int) octets[2]) << 8)
+			+ ((unsigned int) octets[3])
+			+ (((unsigned int) octets[4]) << 24)
+			+ (((unsigned int) octets[5]) << 16)
+			+ (((unsigned int) octets[6]) << 8)
+			+ ((unsigned int) octets[7]);
+		octets += 8;
+		length -= 8;
+	}
+
+	if (length >= 4)
+	{
+		sum += (((unsigned int) octets[0]) << 24)
+			+ (((unsigned int) octets[1]) << 16)
+			+ (((unsigned int) octets[2]) << 8)
+			+ ((unsigned int) octets[3]);
+		octets += 4;
+		length -= 4;
+	}
+
+	/*	Finally add any trailing octets of a partial word.	*/
+
+	while (length > 0)
+	{
+		addToModularChecksum(*octets, offset, &sum);
+		octets++;
+		length--;
+	}
+
+	*checksum = sum;
+}
+
+/*	Slicing-by-8 CRC-32: eight 256-entry tables, derived from
+ *	crcTable, let the CRC be advanced by eight octets per step
+ *	with eight independent table lookups instead of a chain of
+ *	eight dependent ones.  crcSlices[0] is crcTable itself.		*/
+
+static unsigned int	(*_crcSlices())[256]
+{
+	static int		crcSlicesInitialized = 0;
+	static unsigned int	crcSlices[8][256];
+	int			i;
+	int			j;
+	unsigned int		crc32;
+
+	if (!crcSlicesInitialized)
+	{
+		for (i = 0; i < 256; i++)
+		{
+			crc32 = crcTable[i];
+			crcSlices[0][i] = crc32;
+			for (j = 1; j < 8; j++)
+			{
+				crc32 = (crc32 >> 8) ^ crcTable[crc32 & 0xFF];
+				crcSlices[j][i] = crc32;
+			}
+		}
+
+		crcSlicesInitialized = 1;
+	}
+
+	return crcSlices;
+}
+
+static void	addBytesToCrc32(unsigned char *octets, int length,
+			unsigned int *checksum)
+{
+	unsigned int	(*slices)[256] = _crcSlices();
+	unsigned int	crc32;
+	unsigned int	lo;
+	unsigned int	hi;
+
+	crc32 = (*checksum) ^ 0xFFFFFFFF;
+	while (length >= 8)
+	{
+		lo = crc32 ^ (((unsigned int) octets[0])
+				| (((unsigned int) octets[1]) << 8)
+				| (((unsigned int) octets[2]) << 16)
+				| (((unsigned int) octets[3]) << 24));
+		hi = ((unsigned int) octets[4])
+				| (((unsigned int) octets[5]) << 8)
+				| (((unsigned int) octets[6]) << 16)
+				| (((unsigned int) octets[7]) << 24);
+		crc32 = slices[7][lo & 0xFF]
+			^ slices[6][(lo >> 8) & 0xFF]
+			^ slices[5][(lo >> 16) & 0xFF]
+			^ slices[4][lo >> 24]
+			^ slices[3][hi & 0xFF]
+			^ slices[2][(hi >> 8) & 0xFF]
+			^ slices[1][(hi >> 16) & 0xFF]
+			^ slices[0][hi >> 24];
+		octets += 8;
+		length -= 8;
+	}
+
+	while (length > 0)
+	{
+		crc32 = (crc32 >> 8) ^ crcTable[(crc32 ^ *octets) & 0xFF];
+		octets++;
+		length--;
+	}
+
+	*checksum = crc32 ^ 0xFFFFFFFF;
+}
+
+void	addBytesToChecksum(unsigned char *octets, int length, uvast *offset,
+		unsigned int *checksum, CfdpCksumType ckType)
+{
+	CHKVOID(octets);
+	CHKVOID(offset);
+	CHKVOID(checksum);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	if (ckType == ModularChecksum)
+	{
+		addBytesToModularChecksum(octets, length, offset, checksum);
+		return;
+	}
+
+	if (ckType == CRC32)
+	{
+		addBytesToCrc32(octets, length, checksum);
+	}
+
+	*offset += length;
+}
+
 int	getReqNbr()
 {
 	Sdr	sdr = getIonsdr();
@@ -575,7 +729,8 @@ int	cfdpInit()
 		cfdpdbBuf.events = sdr_list_create(sdr);
 		cfdpdbBuf.entities = sdr_list_create(sdr);
 		cfdpdbBuf.finishPdus = sdr_list_create(sdr);
-		cfdpdbBuf.finsPending = sdr_list_create(sdr);
+		cfdpdbBuf.finsPending = sdr_wheel_create(sdr,
+				CFDP_FINS_PENDING_RESOLUTION);
 		sdr_write(sdr, cfdpdbObject, (char *) &cfdpdbBuf,
 				sizeof(CfdpDB));
 		sdr_catlg(sdr, _cfdpdbName(), 0, cfdpdbObject);
@@ -1121,6 +1276,311 @@ Object	findOutFdu(CfdpTransactionId *transactionId, OutFdu *fduBuf,
 	return 0;
 }
 
+/*	*	*	Received extents functions	*	*	*/
+
+static int	extentHeight(Sdr sdr, Object nodeObj)
+{
+	CfdpExtentNode	node;
+	int		height;
+
+	if (nodeObj == 0)
+	{
+		return 0;
+	}
+
+	sdr_read(sdr, (char *) &height, nodeObj + FLD_OFFSET(&node.height,
+			&node), sizeof(int));
+	return height;
+}
+
+static void	fixExtentHeight(Sdr sdr, Object nodeObj, CfdpExtentNode *node)
+{
+	int	leftHeight = extentHeight(sdr, node->left);
+	int	rightHeight = extentHeight(sdr, node->right);
+
+	node->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+	sdr_stage(sdr, NULL, nodeObj, 0);
+	sdr_write(sdr, nodeObj, (char *) node, sizeof(CfdpExtentNode));
+}
+
+static Object	rotateExtents(Sdr sdr, Object nodeObj, CfdpExtentNode *node,
+			int rightward)
+{
+	Object		pivotObj;
+	CfdpExtentNode	pivot;
+
+	if (rightward)
+	{
+		pivotObj = node->left;
+		sdr_read(sdr, (char *) &pivot, pivotObj,
+				sizeof(CfdpExtentNode));
+		node->left = pivot.right;
+		fixExtentHeight(sdr, nodeObj, node);
+		pivot.right = nodeObj;
+	}
+	else
+	{
+		pivotObj = node->right;
+		sdr_read(sdr, (char *) &pivot, pivotObj,
+				sizeof(CfdpExtentNode));
+		node->right = pivot.left;
+		fixExtentHeight(sdr, nodeObj, node);
+		pivot.left = nodeObj;
+	}
+
+	fixExtentHeight(sdr, pivotObj, &pivot);
+	return pivotObj;
+}
+
+static Object	balanceExtents(Sdr sdr, Object nodeObj, CfdpExtentNode *node)
+{
+	int		balance;
+	CfdpExtentNode	child;
+
+	/*	Writes the node, which the caller has modified, and
+	 *	returns the root of the rebalanced subtree.		*/
+
+	balance = extentHeight(sdr, node->left) - extentHeight(sdr, node->right);
+	if (balance > 1)
+	{
+		sdr_read(sdr, (char *) &child, node->left,
+				sizeof(CfdpExtentNode));
+		if (extentHeight(sdr, child.left)
+				< extentHeight(sdr, child.right))
+		{
+			node->left = rotateExtents(sdr, node->left, &child, 0);
+		}
+
+		return rotateExtents(sdr, nodeObj, node, 1);
+	}
+
+	if (balance < -1)
+	{
+		sdr_read(sdr, (char *) &child, node->right,
+				sizeof(CfdpExtentNode));
+		if (extentHeight(sdr, child.right)
+				< extentHeight(sdr, child.left))
+		{
+			node->right = rotateExtents(sdr, node->right, &child, 1);
+		}
+
+		return rotateExtents(sdr, nodeObj, node, 0);
+	}
+
+	fixExtentHeight(sdr, nodeObj, node);
+	return nodeObj;
+}
+
+static Object	insertExtent(Sdr sdr, Object nodeObj, CfdpExtent *extent)
+{
+	CfdpExtentNode	node;
+	Object		subtree;
+
+	/*	Returns the new root of the subtree, or 0 on failure.	*/
+
+	if (nodeObj == 0)
+	{
+		memset((char *) &node, 0, sizeof(CfdpExtentNode));
+		node.extent.offset = extent->offset;
+		node.extent.length = extent->length;
+		node.height = 1;
+		nodeObj = sdr_malloc(sdr, sizeof(CfdpExtentNode));
+		if (nodeObj)
+		{
+			sdr_write(sdr, nodeObj, (char *) &node,
+					sizeof(CfdpExtentNode));
+		}
+
+		return nodeObj;
+	}
+
+	sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+	if (extent->offset < node.extent.offset)
+	{
+		subtree = insertExtent(sdr, node.left, extent);
+		if (subtree == 0)
+		{
+			return 0;
+		}
+
+		node.left = subtree;
+	}
+	else
+	{
+		subtree = insertExtent(sdr, node.right, extent);
+		if (subtree == 0)
+		{
+			return 0;
+		}
+
+		node.right = subtree;
+	}
+
+	return balanceExtents(sdr, nodeObj, &node);
+}
+
+static Object	deleteExtent(Sdr sdr, Object nodeObj, uvast offset)
+{
+	CfdpExtentNode	node;
+	Object		successorObj;
+	CfdpExtentNode	successor;
+
+	/*	Returns the new root of the subtree, possibly 0.	*/
+
+	if (nodeObj == 0)
+	{
+		return 0;
+	}
+
+	sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+	if (offset < node.extent.offset)
+	{
+		node.left = deleteExtent(sdr, node.left, offset);
+	}
+	else if (offset > node.extent.offset)
+	{
+		node.right = deleteExtent(sdr, node.right, offset);
+	}
+	else
+	{
+		if (node.left == 0 || node.right == 0)
+		{
+			successorObj = node.left ? node.left : node.right;
+			sdr_free(sdr, nodeObj);
+			return successorObj;
+		}
+
+		/*	Replace this extent with the next one, then
+		 *	delete the next one from the right subtree.	*/
+
+		successorObj = node.right;
+		while (1)
+		{
+			sdr_read(sdr, (char *) &successor, successorObj,
+					sizeof(CfdpExtentNode));
+			if (successor.left == 0)
+			{
+				break;
+			}
+
+			successorObj = successor.left;
+		}
+
+		node.extent.offset = successor.extent.offset;
+		node.extent.length = successor.extent.length;
+		node.right = deleteExtent(sdr, node.right,
+				successor.extent.offset);
+	}
+
+	return balanceExtents(sdr, nodeObj, &node);
+}
+
+static Object	findExtentAtOrBefore(Sdr sdr, Object nodeObj, uvast offset,
+			CfdpExtent *extent)
+{
+	CfdpExtentNode	node;
+	Object		found = 0;
+
+	memset((char *) extent, 0, sizeof(CfdpExtent));
+	while (nodeObj)
+	{
+		sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+		if (node.extent.offset <= offset)
+		{
+			found = nodeObj;
+			extent->offset = node.extent.offset;
+			extent->length = node.extent.length;
+			nodeObj = node.right;
+		}
+		else
+		{
+			nodeObj = node.left;
+		}
+	}
+
+	return found;
+}
+
+static Object	findExtentAfter(Sdr sdr, Object nodeObj, uvast offset,
+			CfdpExtent *extent)
+{
+	CfdpExtentNode	node;
+	Object		found = 0;
+
+	memset((char *) extent, 0, sizeof(CfdpExtent));
+	while (nodeObj)
+	{
+		sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+		if (node.extent.offset > offset)
+		{
+			found = nodeObj;
+			extent->offset = node.extent.offset;
+			extent->length = node.extent.length;
+			nodeObj = node.left;
+		}
+		else
+		{
+			nodeObj = node.right;
+		}
+	}
+
+	return found;
+}
+
+static void	destroyExtents(Sdr sdr, Object nodeObj)
+{
+	CfdpExtentNode	node;
+
+	if (nodeObj == 0)
+	{
+		return;
+	}
+
+	sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+	destroyExtents(sdr, node.left);
+	destroyExtents(sdr, node.right);
+	sdr_free(sdr, nodeObj);
+}
+
+static void	mapExtents(Sdr sdr, Object nodeObj, CfdpExtent **cursor,
+			unsigned int *room)
+{
+	CfdpExtentNode	node;
+
+	if (nodeObj == 0 || *room == 0)
+	{
+		return;
+	}
+
+	sdr_read(sdr, (char *) &node, nodeObj, sizeof(CfdpExtentNode));
+	mapExtents(sdr, node.left, cursor, room);
+	if (*room == 0)
+	{
+		return;
+	}
+
+	(*cursor)->offset = node.extent.offset;
+	(*cursor)->length = node.extent.length;
+	(*cursor)++;
+	(*room)--;
+	mapExtents(sdr, node.right, cursor, room);
+}
+
+unsigned int	mapInFduExtents(InFdu *fdu, CfdpExtent *extentsArray,
+			unsigned int limit)
+{
+	CfdpExtent	*cursor = extentsArray;
+	unsigned int	room = limit;
+
+	/*	Copies up to "limit" extents, in ascending offset
+	 *	order, and returns the number copied.			*/
+
+	CHKZERO(fdu);
+	CHKZERO(extentsArray);
+	mapExtents(getIonsdr(), fdu->extents, &cursor, &room);
+	return limit - room;
+}
+
 static Object	createInFdu(CfdpTransactionId *transactionId, Entity *entity,
 			InFdu *fdubuf, Object *fduElt)
 {
@@ -1133,11 +1593,10 @@ static Object	createInFdu(CfdpTransactionId *transactionId, Entity *entity,
 			sizeof(CfdpTransactionId));
 	fdubuf->messagesToUser = sdr_list_create(sdr);
 	fdubuf->filestoreRequests = sdr_list_create(sdr);
-	fdubuf->extents = sdr_list_create(sdr);
 	fdubuf->ckType = ModularChecksum;
 	fduObj = sdr_malloc(sdr, sizeof(InFdu));
 	if (fduObj == 0 || fdubuf->messagesToUser == 0
-	|| fdubuf->filestoreRequests == 0 || fdubuf->extents == 0
+	|| fdubuf->filestoreRequests == 0
 	|| (*fduElt = sdr_list_insert_last(sdr, entity->inboundFdus,
 			fduObj)) == 0)
 	{
@@ -1387,8 +1846,8 @@ void	destroyOutFdu(OutFdu *fdu, Object fduObj, Object fduElt)
 
 	if (fdu->closureElt)
 	{
-		sdr_free(sdr,  sdr_list_data(sdr, fdu->closureElt));
-		sdr_list_delete(sdr, fdu->closureElt, NULL, NULL);
+		sdr_free(sdr,  sdr_wheel_data(sdr, fdu->closureElt));
+		sdr_wheel_delete(sdr, fdu->closureElt);
 	}
 
 	if (fdu->fileRef)
@@ -1509,20 +1968,9 @@ void	destroyInFdu(InFdu *fdu, Object fduObj, Object fduElt)
 		sdr_list_delete(sdr, elt, NULL, NULL);
 	}
 
-	while (fdu->extents)
-	{
-		elt = sdr_list_first(sdr, fdu->extents);
-		if (elt == 0)
-		{
-			sdr_list_destroy(sdr, fdu->extents, NULL, NULL);
-			fdu->extents = 0;
-			continue;
-		}
-
-		obj = sdr_list_data(sdr, elt);
-		sdr_free(sdr, obj);	/*	A CfdpExtent structure.	*/
-		sdr_list_delete(sdr, elt, NULL, NULL);
-	}
+	destroyExtents(sdr, fdu->extents);
+	fdu->extents = 0;
+	fdu->extentsCount = 0;
 
 	sdr_free(sdr, fduObj);
 	sdr_list_delete(sdr, fduElt, NULL, NULL);
@@ -3403,8 +3851,8 @@ static int	handleFinishPdu(unsigned char *cursor, int bytesRemaining,
 	fdu->finishReceived = 1;
 	if (fdu->closureElt)
 	{
-		sdr_free(sdr,  sdr_list_data(sdr, fdu->closureElt));
-		sdr_list_delete(sdr, fdu->closureElt, NULL, NULL);
+		sdr_free(sdr,  sdr_wheel_data(sdr, fdu->closureElt));
+		sdr_wheel_delete(sdr, fdu->closureElt);
 		fdu->closureElt = 0;
 	}
 
@@ -3530,6 +3978,48 @@ static int	handleFilestoreRejection(InFdu *fdu, int returnCode,
 	return returnCode;
 }
 
+static int	writeToFile(int fd, unsigned char *buffer, int length,
+			uvast offset)
+{
+#if (defined(mingw) || defined(ION4WIN))
+	if (lseek(fd, offset, SEEK_SET) == (off_t) -1)
+	{
+		return -1;
+	}
+
+	return write(fd, buffer, length);
+#else
+	return pwrite(fd, buffer, length, offset);
+#endif
+}
+
+static int	writeFill(int fd, unsigned char fillCharacter, uvast offset,
+			uvast length)
+{
+	unsigned char	fill[1024];
+	int		chunkSize;
+
+	memset(fill, fillCharacter, sizeof fill);
+	while (length > 0)
+	{
+		chunkSize = sizeof fill;
+		if (length < chunkSize)
+		{
+			chunkSize = length;
+		}
+
+		if (writeToFile(fd, fill, chunkSize, offset) < 0)
+		{
+			return -1;
+		}
+
+		offset += chunkSize;
+		length -= chunkSize;
+	}
+
+	return 0;
+}
+
 static int	writeSegmentData(InFdu *fdu, unsigned char **cursor,
 			int *bytesRemaining, uvast *segmentOffset,
 			int bytesToWrite)
@@ -3548,22 +4038,18 @@ static int	writeSegmentData(InFdu *fdu, unsigned char **cursor,
 		}
 	}
 
-	if (write(cfdpvdb->currentFile, *cursor, bytesToWrite) < 0)
+	if (writeToFile(cfdpvdb->currentFile, *cursor, bytesToWrite,
+			*segmentOffset) < 0)
 	{
 		putSysErrmsg("Can't write to file", itoa(bytesToWrite));
 		return handleFilestoreRejection(fdu, -1, &handler);
 	}
 
 	fdu->bytesReceived += bytesToWrite;
-	while (bytesToWrite > 0)
-	{
-		addToChecksum(**cursor, segmentOffset, &fdu->computedChecksum,
-				fdu->ckType);
-		(*cursor)++;
-		(*bytesRemaining)--;
-		bytesToWrite--;
-	}
-
+	addBytesToChecksum(*cursor, bytesToWrite, segmentOffset,
+			&fdu->computedChecksum, fdu->ckType);
+	(*cursor) += bytesToWrite;
+	(*bytesRemaining) -= bytesToWrite;
 	return 0;
 }
 
@@ -3576,25 +4062,23 @@ static int	handleFileDataPdu(unsigned char *cursor, int bytesRemaining,
 	int		offsetLength;
 	int		i;
 	uvast		segmentOffset;
-	unsigned int	segmentEnd;
+	uvast		segmentEnd;
 	CfdpHandler	handler;
 	Sdr		sdr = getIonsdr();
 	CfdpVdb		*cfdpvdb = _cfdpvdb(NULL);
 	CfdpDB		cfdpdb;
-	Object		elt;
-	Object		addr;
+	Object		extentObj;
 	CfdpExtent	extent;
-	unsigned int	extentEnd = 0;
-	Object		nextElt = 0;
+	uvast		extentEnd = 0;
 	unsigned int	bytesToSkip;
 	char		stringBuf[256];
 	char		workingNameBuffer[MAXPATHLEN + 2];
 	off_t		endOfFile;
-	unsigned int	fileLength;
-	Object		nextAddr;
+	uvast		fileLength;
 	CfdpExtent	nextExtent;
 	unsigned int	bytesToWrite;
-	unsigned int	nextExtentEnd;
+	uvast		nextExtentEnd;
+	Object		newRoot;
 
 	/*	Prepare to issue indication.				*/
 
@@ -3681,31 +4165,26 @@ static int	handleFileDataPdu(unsigned char *cursor, int bytesRemaining,
 		}
 	}
 
-	/*	Figure out how much of the file data PDU is new data.	*/
+	/*	Figure out how much of the file data PDU is new data:
+	 *	find the last extent that starts at or before the
+	 *	start of this segment.					*/
 
-	for (elt = sdr_list_first(sdr, fdu->extents); elt;
-			elt = sdr_list_next(sdr, elt))
+	extentObj = findExtentAtOrBefore(sdr, fdu->extents, segmentOffset,
+			&extent);
+	if (extentObj)
 	{
-		addr = sdr_list_data(sdr, elt);
-		sdr_stage(sdr, (char *) &extent, addr, sizeof(CfdpExtent));
 		extentEnd = extent.offset + extent.length;
 #if CFDPDEBUG
-printf("Viewing extent from %d to %d.\n", extent.offset, extent.offset + extent.length);
+printf("Viewing extent from " UVAST_FIELDSPEC " to " UVAST_FIELDSPEC ".\n", extent.offset, extentEnd);
 #endif
 		if (extentEnd < segmentOffset)	/*	No relation.	*/
 		{
-			continue;	/*	Look for later extent.	*/
+			extentObj = 0;	/*	New extent needed.	*/
 		}
-
-		/*	This extent ends at or after the start of
-		 *	this segment.  Don't search any further in
-		 *	the extents.					*/
-
-		if (extent.offset <= segmentOffset)
+		else
 		{
-			/*	This extent starts before the start
-			 *	of the segment, i.e., part or all of
-			 *	this segment has already been received.	*/
+			/*	Part or all of this segment has
+			 *	already been received.			*/
 
 			bytesToSkip = extentEnd - segmentOffset;
 			if (bytesToSkip >= bytesRemaining)
@@ -3713,60 +4192,22 @@ printf("Viewing extent from %d to %d.\n", extent.offset, extent.offset + extent.
 				return 0;	/*	Ignore.		*/
 			}
 
-			/*	This segment extends this extent.	*/
-
-			extent.length = segmentEnd - extent.offset;
-			sdr_write(sdr, addr, (char *) &extent,
-					sizeof(CfdpExtent));
-#if CFDPDEBUG
-printf("Rewriting extent at %d, to %d.\n", extent.offset, extent.offset + extent.length);
-#endif
-			extentEnd = extent.offset + extent.length;
-
-			/*	Skip over any repeated data at the
+			/*	This segment extends this extent.
+			 *	Skip over any repeated data at the
 			 *	start of the segment.			*/
 
 			segmentOffset += bytesToSkip;
 			cursor += bytesToSkip;
 			bytesRemaining -= bytesToSkip;
-#if CFDPDEBUG
-printf("Skipping %d bytes, segmentOffset changed to %d.\n", bytesToSkip, segmentOffset);
-#endif
-		}
-		else	/*	This segment starts a new extent.	*/
-		{
-			nextElt = elt;
-			elt = 0;	/*	New extent needed.	*/
 		}
-
-		break;
 	}
 
-	/*	Insert new extent if necessary.				*/
-
-	if (elt == 0)	/*	Must write the new extent to database.	*/
+	if (extentObj == 0)	/*	Segment starts a new extent.	*/
 	{
 		extent.offset = segmentOffset;
-		extent.length = bytesRemaining;
-		addr = sdr_malloc(sdr, sizeof (CfdpExtent));
-		if (addr == 0
-		|| (elt = (nextElt == 0	?
-			sdr_list_insert_last(sdr, fdu->extents, addr)
-					:
-			sdr_list_insert_before(sdr, nextElt, addr))) == 0)
-		{
-			putErrmsg("Can't insert extent.", NULL);
-			return -1;
-		}
-
-		sdr_write(sdr, addr, (char *) &extent, sizeof(CfdpExtent));
-#if CFDPDEBUG
-printf("Writing extent from %d to %d.\n", extent.offset, extent.offset + extent.length);
-#endif
-		extentEnd = extent.offset + extent.length;
 	}
 
-	nextElt = sdr_list_next(sdr, elt);
+	extentEnd = segmentEnd;		/*	So far.			*/
 
 	/*	Open the file (possibly a temporary working file) if
 	 *	it's not the currently open file.  First figure out
@@ -3814,39 +4255,26 @@ printf("Writing extent from %d to %d.\n", extent.offset, extent.offset + extent.
 	}
 
 	fileLength = endOfFile;
-	while (fileLength < segmentOffset)
+	if (fileLength < segmentOffset)
 	{
-		if (write(cfdpvdb->currentFile,
-				&(cfdpdb.fillCharacter), 1) < 0)
+		if (writeFill(cfdpvdb->currentFile, cfdpdb.fillCharacter,
+				fileLength, segmentOffset - fileLength) < 0)
 		{
 			putSysErrmsg("Can't write to file", workingNameBuffer);
 			return handleFilestoreRejection(fdu, -1, &handler);
 		}
-
-		fileLength++;
 	}
 
-	/*	Reposition at offset of new file data bytes.		*/
+	/*	Now write new file data, each hunk at its own offset,
+	 *	updating checksum in the process.  While doing this,
+	 *	merge subsequent extents into the current one until
+	 *	an unbridged gap in continuity is reached.  This may
+	 *	entail filling any number of inter-extent gaps.		*/
 
-	if (lseek(cfdpvdb->currentFile, segmentOffset, SEEK_SET) == (off_t) -1)
+	while (findExtentAfter(sdr, fdu->extents, extent.offset, &nextExtent))
 	{
-		putSysErrmsg("Can't lseek in file", workingNameBuffer);
-		return handleFilestoreRejection(fdu, -1, &handler);
-	}
-
-	/*	Now write new file data, updating checksum in the
-	 *	process.  While doing this, collapse subsequent
-	 *	extents into the current one until an unbridged gap
-	 *	in continuity is reached.  This may entail filling
-	 *	any number of inter-extent gaps.			*/
-
-	while (nextElt)
-	{
-		nextAddr = sdr_list_data(sdr, nextElt);
-		sdr_stage(sdr, (char *) &nextExtent, nextAddr,
-				sizeof(CfdpExtent));
 #if CFDPDEBUG
-printf("Continuing to extent from %d to %d; segmentOffset is %d.\n", nextExtent.offset, nextExtent.offset + nextExtent.length, segmentOffset);
+printf("Continuing to extent from " UVAST_FIELDSPEC " to " UVAST_FIELDSPEC "; segmentOffset is " UVAST_FIELDSPEC ".\n", nextExtent.offset, nextExtent.offset + nextExtent.length, segmentOffset);
 #endif
 		if (nextExtent.offset > segmentEnd)
 		{
@@ -3878,18 +4306,12 @@ printf("Continuing to extent from %d to %d; segmentOffset is %d.\n", nextExtent.
 		nextExtentEnd = nextExtent.offset + nextExtent.length;
 		if (nextExtentEnd > extentEnd)
 		{
-			/*	Extend the prior extent.		*/
-
-			extent.length = nextExtentEnd - extent.offset;
-			sdr_write(sdr, addr, (char *) &extent,
-					sizeof(CfdpExtent));
-			extentEnd = extent.offset + extent.length;
+			extentEnd = nextExtentEnd;
 		}
 
-		elt = sdr_list_next(sdr, nextElt);
-		sdr_free(sdr, nextAddr);
-		sdr_list_delete(sdr, nextElt, NULL, NULL);
-		nextElt = elt;
+		fdu->extents = deleteExtent(sdr, fdu->extents,
+				nextExtent.offset);
+		fdu->extentsCount--;
 	}
 
 	/*	Write final hunk of segment data.			*/
@@ -3906,6 +4328,35 @@ printf("Continuing to extent from %d to %d; segmentOffset is %d.\n", nextExtent.
 		}
 	}
 
+	/*	Record the extent.  Deleting later extents never moves
+	 *	an earlier extent to another node, so extentObj is
+	 *	still the node of the extent that has been extended.	*/
+
+	extent.length = extentEnd - extent.offset;
+	if (extentObj)
+	{
+		sdr_stage(sdr, NULL, extentObj, 0);
+		sdr_write(sdr, extentObj, (char *) &extent, sizeof(CfdpExtent));
+#if CFDPDEBUG
+printf("Rewriting extent at " UVAST_FIELDSPEC ", to " UVAST_FIELDSPEC ".\n", extent.offset, extentEnd);
+#endif
+	}
+	else
+	{
+		newRoot = insertExtent(sdr, fdu->extents, &extent);
+		if (newRoot == 0)
+		{
+			putErrmsg("Can't insert extent.", NULL);
+			return -1;
+		}
+
+		fdu->extents = newRoot;
+		fdu->extentsCount++;
+#if CFDPDEBUG
+printf("Writing extent from " UVAST_FIELDSPEC " to " UVAST_FIELDSPEC ".\n", extent.offset, extentEnd);
+#endif
+	}
+
 #ifdef TargetFFS
 	close(cfdpvdb->currentFile);
 	cfdpvdb->currentFile = -1;
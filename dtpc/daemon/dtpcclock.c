@@ -10,6 +10,10 @@
 
 #include "dtpcP.h"
 
+#ifndef DTPC_CLOCK_BATCH
+#define	DTPC_CLOCK_BATCH	(64)	/*	Events per transaction.		*/
+#endif
+
 static int	_running(long *newValue)
 {
 	void	*value;
@@ -35,8 +39,15 @@ static void	shutDown()	/*	Commands dtpcclock termination.	*/
 	oK(_running(&stop));	/*	Terminates dtpcclock.		*/
 }
 
-static int	updateAdus(Sdr sdr)
+static int	isRunning(void *arg)
+{
+	return (_running(NULL) != 0);
+}
+
+static int	updateAdus(Sdr sdr, struct timeval *currentTime, void *arg)
 {
+	/*	Update age for all outbound ADUs, once per second.	*/
+
 	DtpcDB		*dtpcConstants = getDtpcConstants();
 	Object		aggrElt;
 	Object		aduElt;
@@ -105,83 +116,54 @@ static int	updateAdus(Sdr sdr)
 	return 0;
 }
 
-static int	handleEvents(Sdr sdr, time_t currentTime)
+static int	handleEvent(Sdr sdr, Object entry, Address eventObj,
+			struct timeval *currentTime, void *arg)
 {
-	DtpcDB		*dtpcConstants = getDtpcConstants();
-	Object		elt;
-	Object		eventObj;
 	int		result;
 			OBJ_POINTER(DtpcEvent, event);
 
-	while (1)
+	GET_OBJ_POINTER(sdr, DtpcEvent, event, (Object) eventObj);
+	switch (event->type)
 	{
-		CHKERR(sdr_begin_xn(sdr));
-		elt = sdr_list_first(sdr, dtpcConstants->events);
-		if (elt == 0)	/* 	Event list is empty.		*/
-		{
-			sdr_exit_xn(sdr);
-			return 0;
-		}	
+	case ResendAdu:
+		result = resendAdu(sdr, event->aduElt, currentTime->tv_sec);
+		break;			/*	Out of switch.		*/
 
-		eventObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, DtpcEvent, event, eventObj);
-		if (event->scheduledTime > currentTime)
+	case DeleteAdu:
+		deleteAdu(sdr, event->aduElt);
+		if ((getDtpcVdb())->watching & WATCH_m)
 		{
-			/*	This is the first future event.		*/
-
-			sdr_exit_xn(sdr);
-			return 0;
+			putchar('m');
+			fflush(stdout);
 		}
 
-		switch (event->type)
-		{
-		case ResendAdu:
-			result = resendAdu(sdr, event->aduElt, currentTime);
-			break;		/*	Out of switch.		*/
-
-		case DeleteAdu:
-			deleteAdu(sdr, event->aduElt);
-			if ((getDtpcVdb())->watching & WATCH_m)
-			{
-				putchar('m');
-				fflush(stdout);
-			}
-
-			result = 0;
-			break;		/*	Out of switch.		*/
-
-		case DeleteGap:
-			deleteGap(sdr, event->aduElt);
-			if ((getDtpcVdb())->watching & WATCH_expire)
-			{
-				putchar('*');
-				fflush(stdout);
-			}
-
-			result = parseInAdus(sdr);
-			break;		/*	Out of switch.		*/
-
-		default:		/*	Spurious event; erase.	*/
-			sdr_free(sdr, eventObj);
-			sdr_list_delete(sdr, elt, NULL, NULL);
-			result = 0;	/*	Event is ignored.	*/
-		}
+		result = 0;
+		break;			/*	Out of switch.		*/
 
-		if (result !=0)
+	case DeleteGap:
+		deleteGap(sdr, event->aduElt);
+		if ((getDtpcVdb())->watching & WATCH_expire)
 		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("Failed handling Dtpc event.", NULL);
-			return result;
+			putchar('*');
+			fflush(stdout);
 		}
 
-		if (sdr_end_xn(sdr) < 0)
-		{
-			putErrmsg("Failed handling Dtpc event.", NULL);
-			return -1;
-		}
+		result = parseInAdus(sdr);
+		break;			/*	Out of switch.		*/
+
+	default:			/*	Spurious event; erase.	*/
+		destroyDtpcTimelineEvent(sdr, entry);
+		result = 0;		/*	Event is ignored.	*/
+	}
+
+	if (result != 0)
+	{
+		putErrmsg("Failed handling Dtpc event.", NULL);
+		return -1;
 	}
-}
 
+	return 0;
+}
 
 #if defined (ION_LWT)
 int	dtpcclock(int a1, int a2, int a3, int a4, int a5,
@@ -191,9 +173,8 @@ int	dtpcclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	long	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	long		state = 1;
 
 	if (dtpcInit() < 0)
 	{
@@ -204,31 +185,16 @@ int	main(int argc, char *argv[])
 	sdr = getIonsdr();
 	isignal(SIGTERM, shutDown);
 
-	/* Main loop: wait one second, then parse all events and ADUs.	*/
+	/* Main loop: wait for the next event or the next second, then
+	 * update all ADUs once per second and handle all due events.	*/
 
 	oK(_running(&state));
 	writeMemo("[i] dtpcclock is running.");
-
-	while (_running(NULL))
+	if (sdr_wheel_run(sdr, (getDtpcConstants())->events,
+			DTPC_CLOCK_BATCH, getUTCTimeval, handleEvent,
+			updateAdus, isRunning, NULL) < 0)
 	{
-		snooze(1);
-		currentTime = getUTCTime();
-
-		/*	Parse list of events				*/
-
-		if (handleEvents(sdr, currentTime) < 0)
-		{
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-		}
-
-		/*	Update age for all outbound ADUs		*/
-
-		if (updateAdus(sdr) < 0)
-		{
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-		}
+		putErrmsg("Can't handle Dtpc events.", NULL);
 	}
 
 	writeErrmsgMemos();
@@ -11,6 +11,7 @@
 */
 
 #include "dtpc.h"
+#include "sdrwheel.h"
 
 #define DTPC_SEND_SVC_NBR	(128)
 #define	DTPC_RECV_SVC_NBR	(129)
@@ -83,6 +84,11 @@ typedef struct
 	Object		outAduElt;	/* Ref. to OutAdu - not used	*/
 } Topic;
 
+/*	DTPC event times are whole seconds, so the timeline advances
+ *	in ticks of one second.						*/
+
+#define	DTPC_TIMELINE_RESOLUTION	1000
+
 typedef struct
 {
 	DtpcEventType	type;
@@ -130,7 +136,7 @@ typedef struct
 {
 	Object		outAggregators;	/* SDR list OutboundAggregators	*/
 	Object		inAggregators;	/* SDR list InboundAggregators	*/
-	Object		events;		/* SDR list dtpcEvents		*/
+	Object		events;		/* SDR wheel of DtpcEvents	*/
 	Object		profiles;	/* SDR list Profiles		*/
 	Object		queues;		/* SDR list topic delivery queues 
 					 * identified by list USER DATA	*/
@@ -215,6 +221,7 @@ extern int		handleInAdu(Sdr sdr, BpDelivery *dlv,
 extern int		handleAck(Sdr sdr, BpDelivery *dlv,
 				unsigned int profNum, Scalar seqNum);
 extern void		deleteGap(Sdr sdr, Object aduElt);
+extern void		destroyDtpcTimelineEvent(Sdr sdr, Object timelineEntry);
 extern int		parseInAdus(Sdr sdr);
 extern int		sendAck(BpSAP sap, unsigned int profileID,
 				Scalar seqNum, BpDelivery *dlv);
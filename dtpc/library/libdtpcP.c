@@ -280,7 +280,8 @@ int	dtpcInit()
 
 		dtpcdbBuf.outAggregators = sdr_list_create(sdr);
 		dtpcdbBuf.inAggregators = sdr_list_create(sdr);
-		dtpcdbBuf.events = sdr_list_create(sdr);
+		dtpcdbBuf.events = sdr_wheel_create(sdr,
+				DTPC_TIMELINE_RESOLUTION);
 		dtpcdbBuf.profiles = sdr_list_create(sdr);
 		dtpcdbBuf.queues = sdr_list_create(sdr);
 		dtpcdbBuf.outboundAdus = sdr_list_create(sdr);
@@ -831,8 +832,7 @@ static Object	insertDtpcTimelineEvent(DtpcEvent *newEvent)
 	Sdr		sdr = getIonsdr();
 	DtpcDB		*dtpcConstants = _dtpcConstants();
 	Address		addr;
-	Object		elt;
-			OBJ_POINTER(DtpcEvent, event);
+	struct timeval	eventTime;
 
 	CHKZERO(ionLocked());
 	addr = sdr_malloc(sdr,sizeof(DtpcEvent));
@@ -843,18 +843,16 @@ static Object	insertDtpcTimelineEvent(DtpcEvent *newEvent)
 	}
 
 	sdr_write(sdr, addr,(char *) newEvent, sizeof(DtpcEvent));
-	for (elt = sdr_list_last(sdr, dtpcConstants->events); elt;
-			elt = sdr_list_prev(sdr, elt))
-	{
-		GET_OBJ_POINTER(sdr, DtpcEvent, event,
-				sdr_list_data(sdr, elt));
-		if (event->scheduledTime <= newEvent->scheduledTime)
-		{
-			return sdr_list_insert_after(sdr, elt, addr);
-		}
-	}
+	eventTime.tv_sec = newEvent->scheduledTime;
+	eventTime.tv_usec = 0;
+	return sdr_wheel_insert(sdr, dtpcConstants->events, &eventTime, addr);
+}
 
-	return sdr_list_insert_first(sdr, dtpcConstants->events, addr);
+void	destroyDtpcTimelineEvent(Sdr sdr, Object timelineEntry)
+{
+	CHKVOID(timelineEntry);
+	sdr_free(sdr, sdr_wheel_data(sdr, timelineEntry));
+	sdr_wheel_delete(sdr, timelineEntry);
 }
 
 int	createAdu(Profile *profile, Object outAduObj, Object outAduElt)
@@ -1251,14 +1249,12 @@ void	deleteAdu(Sdr sdr, Object aduElt)
 
 	if (adu->rtxEventElt)
 	{
-		sdr_list_delete(sdr, adu->rtxEventElt, deleteEltObjContent,
-				NULL);
+		destroyDtpcTimelineEvent(sdr, adu->rtxEventElt);
 	}
 
 	if (adu->delEventElt)
 	{
-		sdr_list_delete(sdr, adu->delEventElt, deleteEltObjContent,
-				NULL);
+		destroyDtpcTimelineEvent(sdr, adu->delEventElt);
 	}
 
 	/*	Finally, destroy the adu and its element.		*/
@@ -1299,7 +1295,7 @@ int	resendAdu(Sdr sdr, Object aduElt, time_t currentTime)
 
 	/*		Delete the old rtxEvent.			*/
 
-	sdr_list_delete(sdr, adu.rtxEventElt, deleteEltObjContent, NULL);
+	destroyDtpcTimelineEvent(sdr, adu.rtxEventElt);
 	adu.rtxEventElt = 0;
 	if (aduIsQueued == 1)	/*	Bundle containing adu exists.	*/
 	{
@@ -1913,8 +1909,8 @@ item.", NULL);
 			if (result == 0)
 			{	/*		Fill Gap		*/
 				inAdu.aggregatedZCO = dlv->adu;
-				sdr_list_delete(sdr, inAdu.gapEventElt,
-						deleteEltObjContent, NULL);
+				destroyDtpcTimelineEvent(sdr,
+						inAdu.gapEventElt);
 				inAdu.gapEventElt = 0;
 			}
 			else
@@ -2099,9 +2095,8 @@ duplicate inbound adu.", NULL);
 				if (result == 0)
 				{	/*	Fill gap.		*/
 					inAdu.aggregatedZCO = dlv->adu;
-					sdr_list_delete(sdr, inAdu.gapEventElt,
-							deleteEltObjContent,
-							NULL);
+					destroyDtpcTimelineEvent(sdr,
+							inAdu.gapEventElt);
 					inAdu.gapEventElt = 0;
 					sdr_write(sdr, inAduObj, (char *)
 							&inAdu, sizeof(InAdu));
@@ -2240,7 +2235,7 @@ void	deleteGap(Sdr sdr, Object aduElt)
 
 	/*	Delete the event, the InAdu and their elements.		*/
 
-	sdr_list_delete(sdr, adu->gapEventElt, deleteEltObjContent, NULL);
+	destroyDtpcTimelineEvent(sdr, adu->gapEventElt);
 	sdr_free(sdr, aduObj);
 	sdr_list_delete(sdr, aduElt, NULL, NULL);
 }
@@ -41,6 +41,47 @@ static void	shutDown()	/*	Commands rfxclock termination.	*/
 	oK(_running(&stop));	/*	Terminates rfxclock.		*/
 }
 
+static pthread_t	memoWriter;
+static int		memoWriterRunning = 0;
+
+static void	*writeMemos(void *parm)
+{
+	while (ionWriteMemos() == 0)
+	{
+		/*	Keep draining the memo ring until stopped.	*/
+	}
+
+	return NULL;
+}
+
+static void	startMemoWriter()
+{
+	if (ionStartMemoWriter() < 0)
+	{
+		return;		/*	Memos are written directly.	*/
+	}
+
+	if (pthread_begin(&memoWriter, NULL, writeMemos, NULL))
+	{
+		ionStopMemoWriter();
+		oK(ionWriteMemos());	/*	Any posted meanwhile.	*/
+		putSysErrmsg("rfxclock can't create memo writer thread", NULL);
+		return;
+	}
+
+	memoWriterRunning = 1;
+}
+
+static void	stopMemoWriter()
+{
+	if (memoWriterRunning)
+	{
+		ionStopMemoWriter();
+		pthread_join(memoWriter, NULL);
+		memoWriterRunning = 0;
+	}
+}
+
 static int	setProbeIsDue(unsigned long destNodeNbr,
 			unsigned long neighborNodeNbr)
 {
@@ -341,6 +382,7 @@ int	main(int argc, char *argv[])
 	ionwm = getIonwm();
 	vdb = getIonVdb();
 	isignal(SIGTERM, shutDown);
+	startMemoWriter();
 
 	/*	Main loop: wait for event occurrence time, then
 	 *	execute applicable events.				*/
@@ -391,6 +433,7 @@ int	main(int argc, char *argv[])
 			{
 				putErrmsg("Can't enable probes.", NULL);
 				sdr_cancel_xn(sdr);
+				stopMemoWriter();
 				return -1;
 			}
 		}
@@ -468,6 +511,7 @@ int	main(int argc, char *argv[])
 		if (sdr_end_xn(sdr) < 0)
 		{
 			putErrmsg("Can't do ION 1Hz updates.", NULL);
+			stopMemoWriter();
 			return -1;
 		}
 
@@ -477,6 +521,7 @@ int	main(int argc, char *argv[])
 		}
 	}
 
+	stopMemoWriter();
 	writeErrmsgMemos();
 	writeMemo("[i] rfxclock has ended.");
 	ionDetach();
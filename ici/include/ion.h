@@ -221,6 +221,17 @@ typedef struct
 	PsmAddress	routingObject;	/*	Routing-dependent.	*/
 } IonCXref;
 
+/*	A non-zero routingObject in an IonCXref indicates that the
+ *	routing system has computed routes that traverse the contact.
+ *	When such a contact is removed, or the range that applies to
+ *	it is removed or overridden, its address is appended to the
+ *	revisedContacts list in the IonVdb and its routingObject is
+ *	cleared, so that the routing system can discard only those
+ *	routes that traverse the revised contacts.  Insertion of
+ *	contacts and ranges instead updates the lastEditTime of the
+ *	IonVdb, since new contacts may enable better routes to any
+ *	destination.							*/
+
 typedef enum
 {
 	IonStopImputedRange = 0,
@@ -270,7 +281,8 @@ typedef struct
 {
 	int		clockPid;	/*	For stopping rfxclock.	*/
 	int		deltaFromUTC;	/*	In seconds.		*/
-	time_t		lastEditTime;	/*	Add/del contacts/ranges	*/
+	time_t		lastEditTime;	/*	Add contacts/ranges	*/
+	PsmAddress	revisedContacts;/*	SM list: IonCXref addr	*/
 	PsmAddress	nodes;		/*	SM RB tree: IonNode	*/
 	PsmAddress	neighbors;	/*	SM RB tree: IonNeighbor	*/
 	PsmAddress	contactIndex;	/*	SM RB tree: IonCXref	*/
@@ -278,6 +290,7 @@ typedef struct
 	PsmAddress	timeline;	/*	SM RB tree: IonEvent	*/
 	PsmAddress	probes;		/*	SM list: IonProbe	*/
 	PsmAddress	requisitions[2];/*	SM list: Requisition	*/
+	PsmAddress	memoRing;	/*	Memos bound for ion.log	*/
 } IonVdb;
 
 typedef struct
@@ -314,6 +327,21 @@ extern void		ionProd(	uvast fromNode,
 					unsigned int owlt);
 extern void		ionTerminate();
 
+/*	Memos written to ion.log by any task of the node are posted to
+ *	a ring buffer in ION working memory, without blocking, while a
+ *	memo writer thread of rfxclock is draining the ring; otherwise
+ *	they are written to ion.log directly.  ionWriteMemos blocks
+ *	until memos are posted, writes them all to ion.log in a single
+ *	batch, and returns 0; it returns -1 once the memo writer has
+ *	been stopped, after writing any memos posted meanwhile.  Once
+ *	the ring is full while the task running the memo writer
+ *	doesn't exist (e.g., it was killed), memos are again written
+ *	to ion.log directly.						*/
+
+extern int		ionStartMemoWriter();
+extern int		ionWriteMemos();
+extern void		ionStopMemoWriter();
+
 extern int		ionStartAttendant(ReqAttendant *attendant);
 extern void		ionPauseAttendant(ReqAttendant *attendant);
 extern void		ionResumeAttendant(ReqAttendant *attendant);
@@ -360,6 +388,7 @@ extern void		stopIonMemTrace();
 
 extern int		setDeltaFromUTC(int newDelta);
 extern time_t		getUTCTime();	/*	UTC scale, 1970 epoch.	*/
+extern void		getUTCTimeval(struct timeval *utcTime);
 extern int		ionClockIsSynchronized();
 
 extern time_t		readTimestampLocal(char *timestampBuffer,
@@ -385,6 +414,14 @@ extern int		_extractSmallSdnv(unsigned int *into,
 					unsigned char **from,
 					int *nbrOfBytesRemaining,
 					int lineNbr);
+#define extractSdnvArray(into, count, from, remnant) \
+if (_extractSdnvArray(into, count, (unsigned char **) from, remnant, \
+__LINE__) < 1) return 0
+extern int		_extractSdnvArray(uvast *into,
+					int count,
+					unsigned char **from,
+					int *nbrOfBytesRemaining,
+					int lineNbr);
 
 extern int		ionLocked();
 
@@ -566,10 +566,12 @@ typedef void	(*FUNCPTR)(int, int, int, int, int, int, int, int, int, int);
 
 #if defined (SVR4_SHM)
 #include <sys/shm.h>
+#include <sys/mman.h>		/****	For file-mapped SDR heap.    ****/
+#define	MMAP_FILES
 #endif
 
-/*	Note: if we ever need POSIX shared-memory services, we
- *	need to #include <sys/mman.h>.					*/
+/*	Note: if we ever need POSIX shared-memory services, they
+ *	are also declared in <sys/mman.h>.				*/
 
 #if defined (SVR4_SEMAPHORES)	/****	SVR4_SEMAPHORES		     ****/
 
@@ -726,6 +728,15 @@ typedef struct
 extern void			encodeSdnv(Sdnv *, uvast);
 extern int			decodeSdnv(uvast *, unsigned char *);
 
+/*	decodeSdnvArray decodes the next count SDNVs of a text of
+ *	sdnvTxtLength bytes into vals, never reading beyond the end of
+ *	the text.  Returns the total number of bytes decoded, or zero
+ *	if the text is truncated or any SDNV exceeds 70 bits.		*/
+
+extern int			decodeSdnvArray(uvast *vals, int count,
+				unsigned char *sdnvTxt,
+				int sdnvTxtLength);
+
 typedef struct
 {
 	signed int	gigs;
@@ -34,6 +34,9 @@ typedef struct
 	unsigned long	largePoolFree;
 	unsigned long	largePoolAllocated;
 	unsigned long	unusedSize;
+	unsigned long	magazineHits;	/*	No semaphore taken.	*/
+	unsigned long	magazineRefills;
+	unsigned long	magazineDrains;
 } PsmUsageSummary;
 
 typedef struct psm_str		/*	Local view of managed memory.	*/
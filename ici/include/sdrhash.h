@@ -23,6 +23,17 @@
 			declared length will have unpredictable
 			results.
 
+			Resizable ("linear") hash tables, operated
+			on by the sdr_lhash functions, are similar
+			except that keys may be of any length from
+			1 to 255 bytes, each key is stored in only
+			as many bytes as it occupies, and the number
+			of rows grows as entries are inserted: one
+			row at a time is split, in the course of an
+			insertion, whenever the mean number of
+			entries per row exceeds the maximum declared
+			at the time the hash table is created.
+
 	Author: Scott Burleigh, JPL
 	
 	Copyright (c) 2008 California Institute of Technology.
@@ -88,6 +99,72 @@ Sdr_hash_destroy(__FILE__, __LINE__, sdr, hash)
 extern void		Sdr_hash_destroy(const char *file, int line, Sdr sdr,
 				Object hash);
 
+/*	Functions for operating on resizable hash tables in SDR.	*/
+
+#define	SDR_LHASH_MAX_KEY_LEN	255
+
+typedef struct
+{
+	unsigned int	entries;
+	unsigned int	rows;
+	unsigned int	emptyRows;
+	unsigned int	longestChain;
+	double		loadFactor;	/*	Mean entries per row.	*/
+} SdrLhashStats;
+
+#define sdr_lhash_create(sdr, estNbrOfEntries, maxSearchLength) \
+Sdr_lhash_create(__FILE__, __LINE__, sdr, estNbrOfEntries, maxSearchLength)
+extern Object		Sdr_lhash_create(const char *file, int line, Sdr sdr,
+				int estNbrOfEntries, int maxSearchLength);
+
+#define sdr_lhash_insert(sdr, hash, key, keyLength, value, entry) \
+Sdr_lhash_insert(__FILE__, __LINE__, sdr, hash, key, keyLength, value, entry)
+extern int		Sdr_lhash_insert(const char *file, int line, Sdr sdr,
+				Object hash, char *key, int keyLength,
+				Address value, Object *entry);
+
+#define sdr_lhash_delete_entry(sdr, hash, entry) \
+Sdr_lhash_delete_entry(__FILE__, __LINE__, sdr, hash, entry)
+extern int		Sdr_lhash_delete_entry(const char *file, int line,
+				Sdr sdr, Object hash, Object entry);
+
+extern Address		sdr_lhash_entry_value(Sdr sdr,
+				Object hash, Object entry);
+
+extern int		sdr_lhash_retrieve(Sdr sdr,
+				Object hash, char *key, int keyLength,
+				Address *value, Object *entry);
+
+typedef void	(*sdr_lhash_callback)(Sdr sdr, Object hash,
+				char *key, int keyLength, Address value,
+				void *args);
+
+extern int 		sdr_lhash_foreach(Sdr sdrv, Object hash,
+				sdr_lhash_callback callback, void *args);
+
+extern int		sdr_lhash_count(Sdr sdr,
+				Object hash);
+
+extern int		sdr_lhash_stats(Sdr sdr,
+				Object hash, SdrLhashStats *stats);
+
+#define sdr_lhash_revise(sdr, hash, key, keyLength, value) \
+Sdr_lhash_revise(__FILE__, __LINE__, sdr, hash, key, keyLength, value)
+extern int		Sdr_lhash_revise(const char *file, int line, Sdr sdr,
+				Object hash, char *key, int keyLength,
+				Address value);
+
+#define sdr_lhash_remove(sdr, hash, key, keyLength, value) \
+Sdr_lhash_remove(__FILE__, __LINE__, sdr, hash, key, keyLength, value)
+extern int		Sdr_lhash_remove(const char *file, int line, Sdr sdr,
+				Object hash, char *key, int keyLength,
+				Address *value);
+
+#define sdr_lhash_destroy(sdr, hash) \
+Sdr_lhash_destroy(__FILE__, __LINE__, sdr, hash)
+extern void		Sdr_lhash_destroy(const char *file, int line, Sdr sdr,
+				Object hash);
+
 #ifdef __cplusplus
 }
 #endif
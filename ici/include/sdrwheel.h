@@ -0,0 +1,118 @@
+/*
+
+	sdrwheel.h:	definitions supporting use of SDR timing wheels.
+
+			A timing wheel is a hierarchical calendar of
+			timed entries.  Each entry carries an SDR
+			Address (nominally the address of some event
+			object, but the significance of the value may
+			be anything that fits into an unsigned long)
+			and an expiration time.  The wheel's clock
+			advances in "ticks" of a resolution that is
+			declared, in milliseconds, at the time the
+			wheel is created.
+
+			Inserting an entry and deleting an entry are
+			constant-time operations, regardless of the
+			number of entries in the wheel: the wheel
+			comprises SDR_WHEEL_LEVELS levels of
+			SDR_WHEEL_SLOTS slots each, and each entry is
+			simply appended to the slot that covers its
+			expiration tick.  Entries that are due far in
+			the future are placed in slots of higher
+			levels and are "cascaded" to lower levels as
+			the wheel's clock approaches their expiration
+			times.  Entries whose expiration times lie
+			beyond the span of the highest level are
+			retained in an overflow slot.
+
+			Each entry is an SDR Object that remains valid
+			until the entry is deleted, so the entry may
+			be retained as a handle by which the entry
+			may be deleted without search.
+
+	Copyright (c) 2008 California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#ifndef _SDRWHEEL_H_
+#define _SDRWHEEL_H_
+
+#include "sdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define	SDR_WHEEL_LEVELS	4
+#define	SDR_WHEEL_SLOTS		64
+
+/*	Functions for operating on timing wheels in SDR.		*/
+
+#define sdr_wheel_create(sdr, resolution) \
+Sdr_wheel_create(__FILE__, __LINE__, sdr, resolution)
+extern Object		Sdr_wheel_create(const char *file, int line, Sdr sdr,
+				unsigned int resolution);
+
+#define sdr_wheel_insert(sdr, wheel, time, data) \
+Sdr_wheel_insert(__FILE__, __LINE__, sdr, wheel, time, data)
+extern Object		Sdr_wheel_insert(const char *file, int line, Sdr sdr,
+				Object wheel, struct timeval *time,
+				Address data);
+
+#define sdr_wheel_delete(sdr, entry) \
+Sdr_wheel_delete(__FILE__, __LINE__, sdr, entry)
+extern void		Sdr_wheel_delete(const char *file, int line, Sdr sdr,
+				Object entry);
+
+#define sdr_wheel_due(sdr, wheel, time) \
+Sdr_wheel_due(__FILE__, __LINE__, sdr, wheel, time)
+extern Object		Sdr_wheel_due(const char *file, int line, Sdr sdr,
+				Object wheel, struct timeval *time);
+
+extern Address		sdr_wheel_data(Sdr sdr, Object entry);
+
+extern void		sdr_wheel_time(Sdr sdr, Object entry,
+				struct timeval *time);
+
+extern int		sdr_wheel_next_time(Sdr sdr, Object wheel,
+				struct timeval *time);
+
+extern unsigned long	sdr_wheel_length(Sdr sdr, Object wheel);
+
+extern Object		sdr_wheel_first(Sdr sdr, Object wheel);
+
+extern Object		sdr_wheel_next(Sdr sdr, Object entry);
+
+typedef void		(*SdrWheelDeleteFn)(Sdr sdr, Object entry,
+				Address data, void *arg);
+
+#define sdr_wheel_destroy(sdr, wheel, deleteFn, arg) \
+Sdr_wheel_destroy(__FILE__, __LINE__, sdr, wheel, deleteFn, arg)
+extern void		Sdr_wheel_destroy(const char *file, int line, Sdr sdr,
+				Object wheel, SdrWheelDeleteFn deleteFn,
+				void *arg);
+
+typedef void		(*SdrWheelTimeFn)(struct timeval *currentTime);
+
+typedef int		(*SdrWheelEventFn)(Sdr sdr, Object entry,
+				Address data, struct timeval *currentTime,
+				void *arg);
+
+typedef int		(*SdrWheelTickFn)(Sdr sdr,
+				struct timeval *currentTime, void *arg);
+
+typedef int		(*SdrWheelRunningFn)(void *arg);
+
+extern int		sdr_wheel_run(Sdr sdr, Object wheel, int batchLimit,
+				SdrWheelTimeFn timeFn,
+				SdrWheelEventFn eventFn,
+				SdrWheelTickFn tickFn,
+				SdrWheelRunningFn runningFn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _SDRWHEEL_H_ */
@@ -36,6 +36,7 @@ typedef struct sdrv_str	*Sdr;	/*	Local view of an SDR.		*/
 #define	SDR_IN_FILE	2	/*	Write file; read file if nec.	*/
 #define	SDR_REVERSIBLE	4	/*	Transactions may be reversed.	*/
 #define	SDR_BOUNDED	8	/*	Object boundaries defended.	*/
+#define	SDR_IN_MMAP	16	/*	Memory-mapped file; no copy.	*/
 
 /*		SDR system administration functions.			*/
 
@@ -159,6 +160,20 @@ extern int		sdr_load_profile(char *name, int configFlags,
 				by total data space size will be
 				created and filled with zeros.
 
+				SDR_IN_MMAP is an alternative to
+				SDR_IN_DRAM and SDR_IN_FILE (it may
+				not be combined with either): the
+				db file is created as for SDR_IN_FILE
+				but is then mapped into the address
+				space of every process that uses the
+				SDR, so the heap is read and written
+				in memory like an SDR_IN_DRAM heap but
+				only one copy of the data space is
+				maintained and that copy survives
+				reboot like an SDR_IN_FILE heap.  The
+				option is available only on platforms
+				that support memory-mapped files.
+
 				If a cleanup task must be run whenever
 				a transaction is reversed, the command
 				to execute this task must be provided
@@ -218,6 +233,18 @@ extern void		sdr_exit_xn(Sdr sdr);
 extern void		sdr_cancel_xn(Sdr sdr);
 extern int		sdr_end_xn(Sdr sdr);
 
+/*	Read-only transactions are shared: any number of tasks may be
+ *	in read-only transactions on the same SDR concurrently, but
+ *	an update transaction (sdr_begin_xn) begins only after all
+ *	read-only transactions have ended, and no read-only
+ *	transaction begins while an update transaction is in progress.
+ *	A read-only transaction may be nested within an update
+ *	transaction but not the reverse.				*/
+
+extern int		sdr_begin_ro_xn(Sdr sdr);
+extern int		sdr_in_ro_xn(Sdr sdr);		/*	Boolean	*/
+extern void		sdr_end_ro_xn(Sdr sdr);
+
 /*		Low-level SDR I/O functions.				*/
 
 typedef long		SdrAddress;
@@ -76,6 +76,15 @@ typedef enum
 	ZcoZcoSource = 3
 } ZcoMedium;
 
+typedef struct
+{
+	ZcoMedium	medium;		/*	ZcoSdrSource or File.	*/
+	char		*data;		/*	Heap text, if SDR.	*/
+	int		fd;		/*	Open file, if File.	*/
+	vast		offset;		/*	Within file.		*/
+	vast		length;
+} ZcoSpan;
+
 typedef struct
 {
 	Object	zco;
@@ -440,6 +449,37 @@ extern vast	zco_transmit(	Sdr sdr,
 			 *	this ZCO.  Returns the number of bytes
 			 *	copied, or -1 on any error.		*/
 
+extern vast	zco_transmit_iov(Sdr sdr,
+				ZcoReader *reader,
+				vast length,
+				char *buffer,
+				vast bufferLength,
+				ZcoSpan *spans,
+				int *spanCount);
+			/*	Like zco_transmit, but instead of
+			 *	copying up to "length" as-yet-uncopied
+			 *	bytes of the ZCO into a buffer, fills
+			 *	the "spans" array with descriptions of
+			 *	where those bytes reside, so that they
+			 *	can be sent after the transaction has
+			 *	ended.  Capsule text and heap-resident
+			 *	source data are copied into "buffer",
+			 *	of length "bufferLength", and each
+			 *	span of them points into "buffer".
+			 *	Each span of file-resident source data
+			 *	is a newly duplicated file descriptor
+			 *	and an offset; the caller must close
+			 *	every such descriptor that is not -1,
+			 *	whatever the return value.  On entry,
+			 *	*spanCount is the number of elements
+			 *	in "spans"; on return it is the number
+			 *	of spans that were filled in.  Fewer
+			 *	than "length" bytes are described if
+			 *	"spans" or "buffer" fills up first.
+			 *	Returns the number of bytes described,
+			 *	zero if a source file could not be
+			 *	read, or -1 on any error.		*/
+
 extern void	zco_start_receiving(Object zco,
 				ZcoReader *reader);
 			/*	Used by overlying protocol layer to
@@ -38,6 +38,110 @@ static char	*_ionvdbName()
 	return "ionvdb";
 }
 
+/*	The memo ring is a bounded multi-producer, single-consumer
+ *	queue: each slot's sequence number tells whether the slot is
+ *	free for the producer that claims the next enqueue position
+ *	or holds a memo for the consumer.  Enqueue positions are
+ *	claimed by atomic compare-and-swap, so memo posting never
+ *	blocks; when the ring is full, the memo is counted and then
+ *	discarded.
+ *
+ *	A poster that claims a slot records its process ID in the
+ *	slot.  If the writer finds the slot at the head of the ring
+ *	claimed but not published and the poster no longer exists --
+ *	or, if the poster had not yet recorded its process ID, after
+ *	ION_MEMO_CLAIM_TIMEOUT seconds -- the writer skips the slot.
+ *	Slots are published and skipped by compare-and-swap on the
+ *	slot's sequence number, so a poster whose slot has been
+ *	skipped writes its memo to ion.log directly.			*/
+
+#if !defined (FSWLOGGER) && !defined (GDSLOGGER) && defined (__GNUC__) \
+		&& !defined (ION_NO_MEMO_RING)
+#define	ION_MEMO_RING
+#endif
+
+#ifndef ION_MEMO_RING_SLOTS
+#define	ION_MEMO_RING_SLOTS	(256)	/*	A power of 2.	*/
+#endif
+
+#ifndef ION_MEMO_BATCH
+#define	ION_MEMO_BATCH		(8192)	/*	Per write().	*/
+#endif
+
+#ifndef ION_MEMO_CLAIM_TIMEOUT
+#define	ION_MEMO_CLAIM_TIMEOUT	(5)	/*	Seconds.	*/
+#endif
+
+typedef struct
+{
+	volatile unsigned int	seqNbr;
+	volatile unsigned int	claimedPos;	/*	By posterPid.	*/
+	volatile int		posterPid;
+	time_t			time;
+	char			text[256];
+} MemoSlot;
+
+typedef struct
+{
+	volatile unsigned int	enqueuePos;
+	unsigned int		dequeuePos;	/*	Writer only.	*/
+	volatile unsigned int	memosDropped;
+	unsigned int		dropsReported;	/*	Writer only.	*/
+	unsigned int		stallPos;	/*	Writer only.	*/
+	time_t			stallSince;	/*	Writer only.	*/
+	volatile int		writerPid;	/*	ERROR if none.	*/
+	volatile int		posters;	/*	In progress.	*/
+	sm_SemId		memosPosted;
+	MemoSlot		slots[ION_MEMO_RING_SLOTS];
+} MemoRing;
+
+#ifdef ION_MEMO_RING
+static PsmAddress	createMemoRing(PsmPartition wm)
+{
+	PsmAddress	ringAddr;
+	MemoRing	*ring;
+	int		i;
+
+	ringAddr = psm_zalloc(wm, sizeof(MemoRing));
+	if (ringAddr == 0)
+	{
+		return 0;
+	}
+
+	ring = (MemoRing *) psp(wm, ringAddr);
+	memset((char *) ring, 0, sizeof(MemoRing));
+	ring->memosPosted = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	if (ring->memosPosted == SM_SEM_NONE)
+	{
+		psm_free(wm, ringAddr);
+		return 0;
+	}
+
+	sm_SemEnd(ring->memosPosted);	/*	No writer yet.		*/
+	ring->writerPid = ERROR;
+	ring->stallPos = (unsigned int) -1;
+	for (i = 0; i < ION_MEMO_RING_SLOTS; i++)
+	{
+		ring->slots[i].seqNbr = i;
+		ring->slots[i].claimedPos = (unsigned int) -1;
+	}
+
+	return ringAddr;
+}
+#endif
+
+static void	destroyMemoRing(PsmPartition wm, PsmAddress ringAddr)
+{
+	MemoRing	*ring;
+
+	if (ringAddr)
+	{
+		ring = (MemoRing *) psp(wm, ringAddr);
+		sm_SemDelete(ring->memosPosted);
+		psm_free(wm, ringAddr);
+	}
+}
+
 /*	*	*	Datatbase access	 *	*	*	*/
 
 static Sdr	_ionsdr(Sdr *newSdr)
@@ -270,8 +374,12 @@ static IonVdb	*_ionvdb(char **name)
 		|| (vdb->rangeIndex = sm_rbt_create(ionwm)) == 0
 		|| (vdb->timeline = sm_rbt_create(ionwm)) == 0
 		|| (vdb->probes = sm_list_create(ionwm)) == 0
+		|| (vdb->revisedContacts = sm_list_create(ionwm)) == 0
 		|| (vdb->requisitions[0] = sm_list_create(ionwm)) == 0
 		|| (vdb->requisitions[1] = sm_list_create(ionwm)) == 0
+#ifdef ION_MEMO_RING
+		|| (vdb->memoRing = createMemoRing(ionwm)) == 0
+#endif
 		|| psm_catlg(ionwm, *name, vdbAddress) < 0)
 		{
 			sdr_exit_xn(sdr);
@@ -297,37 +405,21 @@ static IonVdb	*_ionvdb(char **name)
 #include "gdslogger.c"
 #else
 
-static void	writeMemoToIonLog(char *text)
-{
-	static ResourceLock	logFileLock;
-	static char		ionLogFileName[264] = "";
-	static int		ionLogFile = -1;
-	time_t			currentTime = getUTCTime();
-	char			timestampBuffer[20];
-	int			textLen;
-	static char		msgbuf[256];
-
-	if (text == NULL) return;
-	if (*text == '\0')	/*	Claims that log file is closed.	*/
-	{
-		if (ionLogFile != -1)
-		{
-			close(ionLogFile);	/*	To be sure.	*/
-			ionLogFile = -1;
-		}
-
-		return;		/*	Ignore zero-length memo.	*/
-	}
+static ResourceLock	ionLogFileLock;
+static char		ionLogFileName[264] = "";
+static int		ionLogFile = -1;
 
+static void	writeToIonLog(char *text, int textLen)
+{
 	/*	The log file is shared, so access to it must be
 	 *	mutexed.						*/
 
-	if (initResourceLock(&logFileLock) < 0)
+	if (initResourceLock(&ionLogFileLock) < 0)
 	{
 		return;
 	}
 
-	lockResource(&logFileLock);
+	lockResource(&ionLogFileLock);
 	if (ionLogFile == -1)
 	{
 		if (ionLogFileName[0] == '\0')
@@ -342,16 +434,13 @@ static void	writeMemoToIonLog(char *text)
 				O_WRONLY | O_APPEND | O_CREAT, 0666);
 		if (ionLogFile == -1)
 		{
-			unlockResource(&logFileLock);
+			unlockResource(&ionLogFileLock);
 			perror("Can't redirect ION error msgs to log");
 			return;
 		}
 	}
 
-	writeTimestampLocal(currentTime, timestampBuffer);
-	isprintf(msgbuf, sizeof msgbuf, "[%s] %s\n", timestampBuffer, text);
-	textLen = strlen(msgbuf);
-	if (write(ionLogFile, msgbuf, textLen) < 0)
+	if (write(ionLogFile, text, textLen) < 0)
 	{
 		perror("Can't write ION error message to log file");
 	}
@@ -359,7 +448,253 @@ static void	writeMemoToIonLog(char *text)
 	close(ionLogFile);
 	ionLogFile = -1;
 #endif
-	unlockResource(&logFileLock);
+	unlockResource(&ionLogFileLock);
+}
+
+static int	formatMemo(time_t memoTime, char *text, char *buffer)
+{
+	char	timestampBuffer[20];
+
+	writeTimestampLocal(memoTime, timestampBuffer);
+	isprintf(buffer, 256, "[%s] %s\n", timestampBuffer, text);
+	return strlen(buffer);
+}
+
+#ifdef ION_MEMO_RING
+static MemoRing	*_memoRing()
+{
+	IonVdb	*vdb = _ionvdb(NULL);
+
+	if (vdb == NULL || vdb->memoRing == 0)
+	{
+		return NULL;
+	}
+
+	return (MemoRing *) psp(_ionwm(NULL), vdb->memoRing);
+}
+
+static int	postMemo(char *text)
+{
+	MemoRing	*ring = _memoRing();
+	unsigned int	pos;
+	MemoSlot	*slot;
+	int		dif;
+
+	if (ring == NULL)
+	{
+		return -1;	/*	Caller must write the memo.	*/
+	}
+
+	/*	The writer is checked only after this poster has
+	 *	been counted, so that a writer that is stopping can
+	 *	wait for the memos of all posters that found it
+	 *	still running.  A writer that was killed never clears
+	 *	writerPid; it is found to be gone when the ring fills.	*/
+
+	oK(__sync_fetch_and_add(&ring->posters, 1));
+	if (ring->writerPid == ERROR)
+	{
+		oK(__sync_fetch_and_sub(&ring->posters, 1));
+		return -1;	/*	Caller must write the memo.	*/
+	}
+
+	pos = ring->enqueuePos;
+	while (1)
+	{
+		slot = ring->slots + (pos & (ION_MEMO_RING_SLOTS - 1));
+		dif = (int) (slot->seqNbr - pos);
+		if (dif == 0)	/*	Slot is free; try to claim it.	*/
+		{
+			if (__sync_bool_compare_and_swap(&ring->enqueuePos,
+					pos, pos + 1))
+			{
+				break;
+			}
+		}
+		else if (dif < 0)	/*	Ring is full.		*/
+		{
+			if (!sm_TaskExists(ring->writerPid))
+			{
+				oK(__sync_fetch_and_sub(&ring->posters, 1));
+				return -1;	/*	Writer is gone.	*/
+			}
+
+			/*	Wake the writer in case the ring is
+			 *	full because a slot is stalled.		*/
+
+			oK(__sync_fetch_and_add(&ring->memosDropped, 1));
+			oK(__sync_fetch_and_sub(&ring->posters, 1));
+			sm_SemGive(ring->memosPosted);
+			return 0;
+		}
+
+		/*	Another producer claimed this position.		*/
+
+		pos = ring->enqueuePos;
+	}
+
+	/*	Record the claim, so that the writer can skip the
+	 *	slot if this task dies before publishing it.		*/
+
+	slot->posterPid = sm_TaskIdSelf();
+	__sync_synchronize();
+	slot->claimedPos = pos;
+	slot->time = getUTCTime();
+	istrcpy(slot->text, text, sizeof slot->text);
+	if (!__sync_bool_compare_and_swap(&slot->seqNbr, pos, pos + 1))
+	{
+		/*	Writer skipped the slot as stalled.		*/
+
+		oK(__sync_fetch_and_sub(&ring->posters, 1));
+		return -1;	/*	Caller must write the memo.	*/
+	}
+
+	oK(__sync_fetch_and_sub(&ring->posters, 1));
+	sm_SemGive(ring->memosPosted);
+	return 0;
+}
+
+static int	claimIsStale(MemoRing *ring, MemoSlot *slot)
+{
+	unsigned int	pos = ring->dequeuePos;
+
+	/*	The slot at the head of the ring has been claimed by
+	 *	a poster but not yet published.  It is stale if the
+	 *	poster is known to be gone or, if the poster never
+	 *	recorded its claim, if it has stalled for too long.	*/
+
+	if (slot->claimedPos == pos)
+	{
+		__sync_synchronize();
+		return (!sm_TaskExists(slot->posterPid));
+	}
+
+	if (ring->stallPos != pos)
+	{
+		ring->stallPos = pos;
+		ring->stallSince = time(NULL);
+		return 0;
+	}
+
+	return (time(NULL) - ring->stallSince >= ION_MEMO_CLAIM_TIMEOUT);
+}
+
+static void	skipSlot(MemoRing *ring, MemoSlot *slot)
+{
+	unsigned int	pos = ring->dequeuePos;
+
+	if (!__sync_bool_compare_and_swap(&slot->seqNbr, pos,
+			pos + ION_MEMO_RING_SLOTS))
+	{
+		return;		/*	Published after all.		*/
+	}
+
+	ring->dequeuePos++;
+	oK(__sync_fetch_and_add(&ring->memosDropped, 1));
+}
+
+static void	drainMemoRing(MemoRing *ring)
+{
+	char		batch[ION_MEMO_BATCH];
+	int		batchLen = 0;
+	MemoSlot	*slot;
+	unsigned int	dropped;
+	char		dropMemo[64];
+
+	while (1)
+	{
+		slot = ring->slots + (ring->dequeuePos
+				& (ION_MEMO_RING_SLOTS - 1));
+		if (slot->seqNbr != ring->dequeuePos + 1)
+		{
+			if (ring->enqueuePos != ring->dequeuePos
+			&& slot->seqNbr == ring->dequeuePos
+			&& claimIsStale(ring, slot))
+			{
+				skipSlot(ring, slot);
+				continue;
+			}
+
+			break;	/*	Empty, or memo not yet posted.	*/
+		}
+
+		__sync_synchronize();
+		if (batchLen > ION_MEMO_BATCH - 256)
+		{
+			writeToIonLog(batch, batchLen);
+			batchLen = 0;
+		}
+
+		batchLen += formatMemo(slot->time, slot->text,
+				batch + batchLen);
+		__sync_synchronize();
+		slot->seqNbr = ring->dequeuePos + ION_MEMO_RING_SLOTS;
+		ring->dequeuePos++;
+	}
+
+	dropped = ring->memosDropped;
+	if (dropped != ring->dropsReported)
+	{
+		if (batchLen > ION_MEMO_BATCH - 256)
+		{
+			writeToIonLog(batch, batchLen);
+			batchLen = 0;
+		}
+
+		isprintf(dropMemo, sizeof dropMemo,
+				"[?] Memo ring overflow, %u memos lost.",
+				dropped - ring->dropsReported);
+		batchLen += formatMemo(getUTCTime(), dropMemo,
+				batch + batchLen);
+		ring->dropsReported = dropped;
+	}
+
+	if (batchLen > 0)
+	{
+		writeToIonLog(batch, batchLen);
+	}
+}
+
+static void	drainStoppedMemoRing(MemoRing *ring)
+{
+	int	i;
+
+	/*	writerPid has been cleared, so no new memos will be
+	 *	posted.  Wait briefly for posters that found the
+	 *	writer still running, then write their memos.		*/
+
+	for (i = 0; i < 100 && ring->posters > 0; i++)
+	{
+		microsnooze(10000);
+	}
+
+	drainMemoRing(ring);
+}
+#endif
+
+static void	writeMemoToIonLog(char *text)
+{
+	char	msgbuf[256];
+
+	if (text == NULL) return;
+	if (*text == '\0')	/*	Claims that log file is closed.	*/
+	{
+		if (ionLogFile != -1)
+		{
+			close(ionLogFile);	/*	To be sure.	*/
+			ionLogFile = -1;
+		}
+
+		return;		/*	Ignore zero-length memo.	*/
+	}
+
+#ifdef ION_MEMO_RING
+	if (postMemo(text) == 0)
+	{
+		return;		/*	Memo writer will handle it.	*/
+	}
+#endif
+	writeToIonLog(msgbuf, formatMemo(getUTCTime(), text, msgbuf));
 }
 
 static void	ionRedirectMemos()
@@ -368,6 +703,73 @@ static void	ionRedirectMemos()
 }
 #endif
 
+int	ionStartMemoWriter()
+{
+#ifdef ION_MEMO_RING
+	MemoRing	*ring = _memoRing();
+
+	if (ring == NULL)
+	{
+		return -1;
+	}
+
+	/*	Any memos left in the ring by a prior writer are
+	 *	written as soon as the new writer starts draining.	*/
+
+	sm_SemUnend(ring->memosPosted);
+	ring->writerPid = sm_TaskIdSelf();
+	sm_SemGive(ring->memosPosted);
+	return 0;
+#else
+	return -1;			/*	No memo ring.		*/
+#endif
+}
+
+int	ionWriteMemos()
+{
+#ifdef ION_MEMO_RING
+	MemoRing	*ring = _memoRing();
+
+	if (ring == NULL)
+	{
+		return -1;
+	}
+
+	if (sm_SemTake(ring->memosPosted) < 0)
+	{
+		putErrmsg("Memo writer can't take semaphore.", NULL);
+		ring->writerPid = ERROR;
+		drainStoppedMemoRing(ring);
+		return -1;
+	}
+
+	if (sm_SemEnded(ring->memosPosted))
+	{
+		drainStoppedMemoRing(ring);
+		return -1;
+	}
+
+	drainMemoRing(ring);
+
+	return 0;
+#else
+	return -1;			/*	No memo ring.		*/
+#endif
+}
+
+void	ionStopMemoWriter()
+{
+#ifdef ION_MEMO_RING
+	MemoRing	*ring = _memoRing();
+
+	if (ring)
+	{
+		ring->writerPid = ERROR;
+		sm_SemEnd(ring->memosPosted);
+	}
+#endif
+}
+
 #if defined (FSWWATCHER)
 #include "fswwatcher.c"
 #elif defined (GDSWATCHER)
@@ -807,11 +1209,19 @@ static void	dropVdb(PsmPartition wm, PsmAddress vdbAddress)
 	Requisition	*req;
 
 	vdb = (IonVdb *) psp(wm, vdbAddress);
+	addr = vdb->memoRing;
+	vdb->memoRing = 0;		/*	Memos now unbuffered.	*/
+	destroyMemoRing(wm, addr);
 
 	/*	Time-ordered list of probes can simply be destroyed.	*/
 
 	sm_list_destroy(wm, vdb->probes, rfx_erase_data, NULL);
 
+	/*	List of revised contacts holds only the addresses of
+	 *	contacts, so it too can simply be destroyed.		*/
+
+	sm_list_destroy(wm, vdb->revisedContacts, NULL, NULL);
+
 	/*	Three of the red-black tables in the Vdb are
 	 *	emptied and recreated by rfx_stop().  Destroy them.	*/
 
@@ -1222,6 +1632,22 @@ time_t	getUTCTime()
 	return clocktime - delta;
 }
 
+void	getUTCTimeval(struct timeval *utcTime)
+{
+#if defined(FSWCLOCK)
+	CHKVOID(utcTime);
+	utcTime->tv_sec = getUTCTime();
+	utcTime->tv_usec = 0;
+#else
+	IonVdb	*ionvdb = _ionvdb(NULL);
+	int	delta = ionvdb ? ionvdb->deltaFromUTC : 0;
+
+	CHKVOID(utcTime);
+	getCurrentTime(utcTime);
+	utcTime->tv_sec -= delta;
+#endif
+}
+
 static time_t	readTimestamp(char *timestampBuffer, time_t referenceTime,
 			int timestampIsUTC)
 {
@@ -1363,6 +1789,30 @@ int	_extractSmallSdnv(unsigned int *into, unsigned char **from,
 	return sdnvLength;
 }
 
+int	_extractSdnvArray(uvast *into, int count, unsigned char **from,
+		int *remnant, int lineNbr)
+{
+	int	length;
+
+	CHKZERO(into && from && remnant);
+	if (*remnant < count)
+	{
+		writeMemoNote("[?] Missing SDNVs at line...", itoa(lineNbr));
+		return 0;
+	}
+
+	length = decodeSdnvArray(into, count, *from, *remnant);
+	if (length < 1)
+	{
+		writeMemoNote("[?] Invalid SDNVs at line...", itoa(lineNbr));
+		return 0;
+	}
+
+	(*from) += length;
+	(*remnant) -= length;
+	return length;
+}
+
 /*	*	*	Debugging 	*	*	*	*	*/
 
 int	ionLocked()
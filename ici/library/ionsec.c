@@ -1363,7 +1363,7 @@ static Object	locateKey(char *keyName, Object *nextKey)
 	 *	location within the keys list at which such a key
 	 *	should be inserted.					*/
 
-	CHKZERO(ionLocked());
+	CHKZERO(ionLocked() || sdr_in_ro_xn(sdr));
 	if (nextKey) *nextKey = 0;	/*	Default.		*/
 	if (secdb == NULL)	/*	No security database declared.	*/
 	{
@@ -1404,16 +1404,16 @@ void	sec_findKey(char *keyName, Object *keyAddr, Object *eltp)
 	CHKVOID(keyAddr);
 	CHKVOID(eltp);
 	*eltp = 0;
-	CHKVOID(sdr_begin_xn(sdr));
+	CHKVOID(sdr_begin_ro_xn(sdr));
 	elt = locateKey(keyName, NULL);
 	if (elt == 0)
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_ro_xn(sdr);
 		return;
 	}
 
 	*keyAddr = sdr_list_data(sdr, elt);
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 	*eltp = elt;
 }
 
@@ -1656,24 +1656,24 @@ int	sec_get_key(char *keyName, int *keyBufferLength, char *keyValueBuffer)
 	CHKERR(keyName);
 	CHKERR(keyBufferLength);
 	CHKERR(keyValueBuffer);
-	CHKERR(sdr_begin_xn(sdr));
+	CHKERR(sdr_begin_ro_xn(sdr));
 	sec_findKey(keyName, &keyAddr, &elt);
 	if (elt == 0)
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_ro_xn(sdr);
 		return 0;
 	}
 
 	GET_OBJ_POINTER(sdr, SecKey, key, keyAddr);
 	if (key->length > *keyBufferLength)
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_ro_xn(sdr);
 		*keyBufferLength = key->length;
 		return 0;
 	}
 
 	sdr_read(sdr, keyValueBuffer, key->value, key->length);
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 	return key->length;
 }
 
@@ -1817,7 +1817,7 @@ void	sec_get_bspBabRule(char *srcEid, char *destEid, Object *ruleAddr,
 		return;
 	}
 
-	CHKVOID(sdr_begin_xn(sdr));
+	CHKVOID(sdr_begin_ro_xn(sdr));
 	for (elt = sdr_list_first(sdr, secdb->bspBabRules); elt;
 			elt = sdr_list_next(sdr, elt))
 	{
@@ -1839,7 +1839,7 @@ void	sec_get_bspBabRule(char *srcEid, char *destEid, Object *ruleAddr,
 		}
 	}
 
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 }
 
 /* 1 if found. 0 if not. and -1 on error. */
@@ -2080,7 +2080,7 @@ int	sec_get_bspPibRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		return 0;
 	}
 
-	CHKERR(sdr_begin_xn(sdr));
+	CHKERR(sdr_begin_ro_xn(sdr));
 	for (elt = sdr_list_first(sdr, secdb->bspPibRules); elt;
 			elt = sdr_list_next(sdr, elt))
 	{
@@ -2108,7 +2108,7 @@ int	sec_get_bspPibRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		*ruleAddr = 0;
 	}
 
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 	return result;
 }
 
@@ -2323,7 +2323,7 @@ int    sec_get_bspPcbRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		return 0;
 	}
 
-        CHKERR(sdr_begin_xn(sdr));
+        CHKERR(sdr_begin_ro_xn(sdr));
         for (elt = sdr_list_first(sdr, secdb->bspPcbRules); elt;
                         elt = sdr_list_next(sdr, elt))
         {
@@ -2351,7 +2351,7 @@ int    sec_get_bspPcbRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
                 *ruleAddr = 0;
         }
 
-        sdr_exit_xn(sdr);
+        sdr_end_ro_xn(sdr);
         return result;
 }
 
@@ -2567,7 +2567,7 @@ void	sec_get_bspBabRule(char *senderEid, char *receiverEid, Object *ruleAddr,
 		return;
 	}
 
-	CHKVOID(sdr_begin_xn(sdr));
+	CHKVOID(sdr_begin_ro_xn(sdr));
 	for (elt = sdr_list_first(sdr, secdb->bspBabRules); elt;
 			elt = sdr_list_next(sdr, elt))
 	{
@@ -2590,7 +2590,7 @@ void	sec_get_bspBabRule(char *senderEid, char *receiverEid, Object *ruleAddr,
 		}
 	}
 
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 }
 
 int	sec_findBspBabRule(char *senderEid, char *receiverEid, Object *ruleAddr,
@@ -2798,7 +2798,7 @@ void	sec_get_bspBibRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		return;
 	}
 
-	CHKVOID(sdr_begin_xn(sdr));
+	CHKVOID(sdr_begin_ro_xn(sdr));
 	for (elt = sdr_list_first(sdr, secdb->bspBibRules); elt;
 			elt = sdr_list_next(sdr, elt))
 	{
@@ -2827,7 +2827,7 @@ void	sec_get_bspBibRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		}
 	}
 
-	sdr_exit_xn(sdr);
+	sdr_end_ro_xn(sdr);
 }
 
 int	sec_findBspBibRule(char *secSrcEid, char *secDestEid, int blkType,
@@ -3037,7 +3037,7 @@ void    sec_get_bspBcbRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
 		return;
 	}
 
-        CHKVOID(sdr_begin_xn(sdr));
+        CHKVOID(sdr_begin_ro_xn(sdr));
         for (elt = sdr_list_first(sdr, secdb->bspBcbRules); elt;
                         elt = sdr_list_next(sdr, elt))
         {
@@ -3066,7 +3066,7 @@ void    sec_get_bspBcbRule(char *secSrcEid, char *secDestEid, int blockTypeNbr,
                 }
         }
 
-        sdr_exit_xn(sdr);
+        sdr_end_ro_xn(sdr);
 }
 
 int     sec_findBspBcbRule(char *secSrcEid, char *secDestEid, int blkType,
@@ -1717,87 +1717,187 @@ void	printStackTrace()
 
 void	encodeSdnv(Sdnv *sdnv, uvast val)
 {
-	static uvast	sdnvMask = ((uvast) -1) / 128;
 	uvast		remnant;
-	int		i;
-	unsigned char	flag = 0;
 	unsigned char	*text;
 
 	/*	Get length of SDNV text: one byte for each 7 bits of
-	 *	significant numeric value.  On each iteration of the
-	 *	loop, until what's left of the original value is zero,
-	 *	shift the remaining value 7 bits to the right and add
-	 *	1 to the imputed SDNV length.				*/
+	 *	significant numeric value.  uvast is unsigned, so
+	 *	the right shifts need no masking.			*/
 
 	CHKVOID(sdnv);
-	sdnv->length = 0;
-	remnant = val;
-	do
+	if (val < 0x80)		/*	Most common case.		*/
+	{
+		sdnv->length = 1;
+		sdnv->text[0] = val;
+		return;
+	}
+
+	sdnv->length = 1;
+	for (remnant = val >> 7; remnant > 0; remnant >>= 7)
 	{
-		remnant = (remnant >> 7) & sdnvMask;
 		(sdnv->length)++;
-	} while (remnant > 0);
+	}
 
-	/*	Now fill the SDNV text from the numeric value bits.	*/
+	/*	Now fill the SDNV text from the numeric value bits,
+	 *	last byte (flag 0) first.				*/
 
-	text = sdnv->text + sdnv->length;
-	i = sdnv->length;
-	remnant = val;
-	while (i > 0)
+	text = sdnv->text + sdnv->length - 1;
+	*text = val & 0x7f;
+	remnant = val >> 7;
+	while (text > sdnv->text)
 	{
 		text--;
-
-		/*	Get low-order 7 bits of what's left, OR'ing
-		 *	it with high-order bit flag for this position
-		 *	of the SDNV.					*/
-
-		*text = (remnant & 0x7f) | flag;
-
-		/*	Shift those bits out of the value.		*/
-
-		remnant = (remnant >> 7) & sdnvMask;
-		flag = 0x80;		/*	Flag is now 1.		*/
-		i--;
+		*text = (remnant & 0x7f) | 0x80;
+		remnant >>= 7;
 	}
 }
 
 int	decodeSdnv(uvast *val, unsigned char *sdnvTxt)
 {
-	int		sdnvLength = 0;
+	int		sdnvLength;
 	unsigned char	*cursor;
+	uvast		result;
 
 	CHKZERO(val);
 	CHKZERO(sdnvTxt);
-	*val = 0;
 	cursor = sdnvTxt;
-	while (1)
+	if ((*cursor & 0x80) == 0)	/*	Most common case.	*/
 	{
-		sdnvLength++;
-		if (sdnvLength > 10)
+		*val = *cursor;
+		return 1;
+	}
+
+	/*	Each SDNV byte contributes its low-order 7 bits to
+	 *	the numeric value; the high-order bit is set in every
+	 *	byte but the last.  The text is not length-bounded,
+	 *	so it is examined one byte at a time; for bounded
+	 *	text, decodeSdnvArray is faster.			*/
+
+	result = *cursor & 0x7f;
+	for (sdnvLength = 2; sdnvLength <= 10; sdnvLength++)
+	{
+		cursor++;
+		result = (result << 7) | (*cursor & 0x7f);
+		if ((*cursor & 0x80) == 0)	/*	Last SDNV byte.	*/
 		{
-			return 0;	/*	More than 70 bits.	*/
+			*val = result;
+			return sdnvLength;
 		}
+	}
+
+	*val = result;
+	return 0;			/*	More than 70 bits.	*/
+}
 
-		/*	Shift numeric value 7 bits to the left (that
-		 *	is, multiply by 128) to make room for 7 bits
-		 *	of SDNV byte value.				*/
+/*	Word-at-a-time SDNV decoding: eight bytes of SDNV text are
+ *	loaded at once, the terminating byte (the first one whose
+ *	high-order bit is zero) is located by a single bit scan, and
+ *	the 7-bit groups of an SDNV of up to 8 bytes are compacted
+ *	into the numeric value by three mask-and-shift steps.  Only
+ *	available where GCC-compatible builtins, the byte order, and
+ *	a 64-bit uvast are all known at compile time.			*/
 
-		*val <<= 7;
+#if defined (__GNUC__) && defined (__BYTE_ORDER__) && (LONG_LONG_OKAY)
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
+		|| (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define	SDNV_WORD_DECODE
+#endif
+#endif
 
-		/*	Insert SDNV byte value (with its high-order
-		 *	bit masked off) as low-order 7 bits of the
-		 *	numeric value.					*/
+#ifdef SDNV_WORD_DECODE
+static int	decodeSdnvWord(uvast *val, unsigned char *sdnvTxt)
+{
+	unsigned long long	word;
+	unsigned long long	stops;
+	int			sdnvLength;
 
-		*val |= (*cursor & 0x7f);
-		if ((*cursor & 0x80) == 0)	/*	Last SDNV byte.	*/
+	memcpy((char *) &word, (char *) sdnvTxt, 8);
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	word = __builtin_bswap64(word);
+#endif
+	/*	First byte of text is now the high-order byte of word.	*/
+
+	stops = ~word & 0x8080808080808080ULL;
+	if (stops == 0)
+	{
+		return 0;		/*	Longer than 8 bytes.	*/
+	}
+
+	sdnvLength = (__builtin_clzll(stops) >> 3) + 1;
+	word = (word & 0x7f7f7f7f7f7f7f7fULL) >> ((8 - sdnvLength) << 3);
+	word = (word & 0x007f007f007f007fULL)
+			| ((word & 0x7f007f007f007f00ULL) >> 1);
+	word = (word & 0x00003fff00003fffULL)
+			| ((word & 0x3fff00003fff0000ULL) >> 2);
+	word = (word & 0x000000000fffffffULL)
+			| ((word & 0x0fffffff00000000ULL) >> 4);
+	*val = word;
+	return sdnvLength;
+}
+#endif
+
+int	decodeSdnvArray(uvast *vals, int count, unsigned char *sdnvTxt,
+		int sdnvTxtLength)
+{
+	unsigned char	*cursor = sdnvTxt;
+	int		remnant = sdnvTxtLength;
+	int		i;
+	int		sdnvLength;
+	uvast		result;
+
+	CHKZERO(vals);
+	CHKZERO(sdnvTxt);
+	for (i = 0; i < count; i++)
+	{
+		if (remnant < 1)
 		{
-			return sdnvLength;
+			return 0;	/*	Text exhausted.		*/
 		}
 
-		/*	Haven't reached the end of the SDNV yet.	*/
+		if ((*cursor & 0x80) == 0)	/*	Single byte.	*/
+		{
+			vals[i] = *cursor;
+			cursor++;
+			remnant--;
+			continue;
+		}
 
-		cursor++;
+#ifdef SDNV_WORD_DECODE
+		if (remnant >= 8)
+		{
+			sdnvLength = decodeSdnvWord(vals + i, cursor);
+			if (sdnvLength > 0)
+			{
+				cursor += sdnvLength;
+				remnant -= sdnvLength;
+				continue;
+			}
+		}
+#endif
+		/*	Near end of text, or longer than 8 bytes.	*/
+
+		result = 0;
+		sdnvLength = 0;
+		while (1)
+		{
+			if (sdnvLength == remnant || sdnvLength == 10)
+			{
+				return 0;	/*	Short/too long.	*/
+			}
+
+			result = (result << 7) | (cursor[sdnvLength] & 0x7f);
+			if ((cursor[sdnvLength++] & 0x80) == 0)
+			{
+				break;
+			}
+		}
+
+		vals[i] = result;
+		cursor += sdnvLength;
+		remnant -= sdnvLength;
 	}
+
+	return sdnvTxtLength - remnant;
 }
 
 void	loadScalar(Scalar *s, signed int i)
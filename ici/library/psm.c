@@ -16,6 +16,10 @@
 #define	PSM_TRACE
 #endif
 
+#if !defined (NO_PSM_MAGAZINES) && !defined (ION_LWT)
+#define	PSM_MAGAZINES
+#endif
+
 #include "psm.h"
 #include "smlist.h"
 
@@ -93,6 +97,11 @@ struct big_ohd2				/*	Trailing overhead.	*/
 #define	INITIALIZED	(0x99999999)
 #define	MANAGED		(0xbbbbbbbb)
 
+#ifndef PSM_MAGAZINE_SIZE
+#define	PSM_MAGAZINE_SIZE	(16)	/*	Blocks per size class.	*/
+#endif
+#define	PSM_MAGAZINE_BATCH	(PSM_MAGAZINE_SIZE / 2)
+
 typedef struct			/*	Global view in shared memory.	*/
 {
 	PsmAddress	directory;
@@ -113,6 +122,11 @@ typedef struct			/*	Global view in shared memory.	*/
 	PsmAddress	endOfLargePool;
 	PsmAddress	firstLargeFree[LARGE_ORDERS];
 	u_long		unassignedSpace;
+	int		generation;	/*	Validates magazines.	*/
+	PsmAddress	magazines;	/*	List of magazines.	*/
+	u_long		magazineHits;
+	u_long		magazineRefills;
+	u_long		magazineDrains;
 } PartitionMap;
 
 typedef struct
@@ -189,6 +203,448 @@ static void	discard(PsmPartition partition)
 	}
 }
 
+#ifdef PSM_MAGAZINES
+/*	*	Per-thread small-pool magazines	*	*	*	*/
+
+/*	Each thread keeps, for each partition in which it allocates
+ *	small-pool blocks, a "magazine" of free blocks of each small
+ *	block size.  Most small-block allocations and releases are
+ *	satisfied from and to the magazine without taking the
+ *	partition semaphore; the magazine is refilled from the
+ *	small pool, or drained back into it, PSM_MAGAZINE_BATCH
+ *	blocks at a time.  A block held in a magazine is "parked":
+ *	its overhead word is set to SMALL_IN_USE with a user data
+ *	size of zero, so it is neither on a free list nor in use.
+ *
+ *	The magazine itself is a large-pool block of the partition,
+ *	on a list of all of the partition's magazines and stamped
+ *	with the ID of the owning task, so parked blocks are never
+ *	lost.  A thread drains its magazine back into the small pool
+ *	and releases it when the thread terminates or unmanages
+ *	the partition.  The magazines of tasks that no longer exist
+ *	(a process that crashed, was killed, or simply exited) are
+ *	reclaimed in the same way whenever a new magazine is
+ *	created and whenever the partition's usage is reported.  A
+ *	forked child never uses its parent's magazines, as they
+ *	don't bear its task ID.  Magazines are bypassed while the
+ *	partition is being traced, and no new magazine is created
+ *	while the partition's unassigned space is scarce.		*/
+
+typedef struct			/*	In the partition.		*/
+{
+	int		ownerTask;
+	u_long		hits;		/*	Not yet posted to map.	*/
+	int		count[SMALL_SIZES];
+	PsmAddress	blocks[SMALL_SIZES][PSM_MAGAZINE_SIZE];
+	PsmAddress	next;		/*	Partition's magazines.	*/
+} PsmMagazine;
+
+typedef struct psm_mag_ref		/*	In private memory.	*/
+{
+	PartitionMap	*map;
+	int		generation;	/*	Of map when created.	*/
+	PsmMagazine	*magazine;
+	struct psm_mag_ref
+			*next;
+} PsmMagazineRef;
+
+#define	MAGAZINE_HEADROOM	(16 * sizeof(PsmMagazine))
+
+static pthread_key_t	_magazineKey;
+static int		_magazineKeyCreated = 0;
+static pthread_once_t	_magazineOnce = PTHREAD_ONCE_INIT;
+
+static PsmAddress	mallocLarge(PartitionMap *map, register u_int nbytes);
+static void		freeLarge(PartitionMap *map, PsmAddress block);
+
+static void	postMagazineHits(PartitionMap *map, PsmMagazine *mag)
+{
+	/*	Partition must be locked.				*/
+
+	map->magazineHits += mag->hits;
+	mag->hits = 0;
+}
+
+static void	drainMagazine(PartitionMap *map, PsmMagazine *mag, int i,
+			int blocksToDrain)
+{
+	PsmAddress		block;
+	struct small_ohd	*blk;
+
+	/*	Partition must be locked.				*/
+
+	while (blocksToDrain > 0 && mag->count[i] > 0)
+	{
+		mag->count[i]--;
+		block = mag->blocks[i][mag->count[i]];
+		blk = SMALL(block);
+		blk->next = map->firstSmallFree[i];
+		map->firstSmallFree[i] = block;
+		blocksToDrain--;
+	}
+}
+
+static void	destroyMagazine(PartitionMap *map, PsmAddress magAddr)
+{
+	PsmMagazine	*mag = (PsmMagazine *) (((char *) map) + magAddr);
+	PsmAddress	*prevNext;
+	int		i;
+
+	/*	Partition must be locked.				*/
+
+	for (i = 0; i < SMALL_SIZES; i++)
+	{
+		drainMagazine(map, mag, i, mag->count[i]);
+	}
+
+	map->magazineDrains++;
+	postMagazineHits(map, mag);
+	prevNext = &(map->magazines);
+	while (*prevNext != magAddr)
+	{
+		prevNext = &(((PsmMagazine *)
+				(((char *) map) + *prevNext))->next);
+	}
+
+	*prevNext = mag->next;
+	freeLarge(map, magAddr - LG_OHD_SIZE);
+}
+
+static void	reclaimMagazines(PartitionMap *map)
+{
+	PsmAddress	magAddr;
+	PsmMagazine	*mag;
+
+	/*	Partition must be locked.  Releases the magazines of
+	 *	all tasks that have terminated.				*/
+
+	magAddr = map->magazines;
+	while (magAddr)
+	{
+		mag = (PsmMagazine *) (((char *) map) + magAddr);
+		if (sm_TaskExists(mag->ownerTask))
+		{
+			magAddr = mag->next;
+			continue;
+		}
+
+		destroyMagazine(map, magAddr);
+		magAddr = map->magazines;	/*	Start over.	*/
+	}
+}
+
+static int	magazineIsValid(PsmMagazineRef *ref)
+{
+	return (ref->map->status == MANAGED
+			&& ref->map->generation == ref->generation
+			&& ref->magazine->ownerTask == sm_TaskIdSelf());
+}
+
+static void	releaseMagazineRef(PsmMagazineRef *ref)
+{
+	PartitionMap	*map = ref->map;
+
+	if (magazineIsValid(ref))
+	{
+		lockPartition(map);
+		destroyMagazine(map, ((char *) (ref->magazine))
+				- ((char *) map));
+		unlockPartition(map);
+	}
+
+	/*	Otherwise the partition no longer exists or the
+	 *	magazine is not this task's (in a forked child), so
+	 *	the magazine is not ours to release.			*/
+
+	free(ref);
+}
+
+static void	releaseMagazines(void *arg)
+{
+	PsmMagazineRef	*ref = (PsmMagazineRef *) arg;
+	PsmMagazineRef	*next;
+
+	while (ref)
+	{
+		next = ref->next;
+		releaseMagazineRef(ref);
+		ref = next;
+	}
+}
+
+static void	createMagazineKey()
+{
+	if (pthread_key_create(&_magazineKey, releaseMagazines) == 0)
+	{
+		_magazineKeyCreated = 1;
+	}
+}
+
+static PsmMagazine	*createMagazine(PartitionMap *map)
+{
+	PsmAddress	magAddr;
+	PsmMagazine	*mag;
+
+	lockPartition(map);
+	reclaimMagazines(map);
+	if (map->desperate || map->unassignedSpace < MAGAZINE_HEADROOM)
+	{
+		unlockPartition(map);
+		return NULL;	/*	Just use the partition.		*/
+	}
+
+	magAddr = mallocLarge(map, sizeof(PsmMagazine));
+	if (magAddr == 0)
+	{
+		unlockPartition(map);
+		return NULL;
+	}
+
+	mag = (PsmMagazine *) (((char *) map) + magAddr);
+	memset((char *) mag, 0, sizeof(PsmMagazine));
+	mag->ownerTask = sm_TaskIdSelf();
+	mag->next = map->magazines;
+	map->magazines = magAddr;
+	unlockPartition(map);
+	return mag;
+}
+
+static PsmMagazine	*getMagazine(PartitionMap *map)
+{
+	PsmMagazineRef	*refs;
+	PsmMagazineRef	*ref;
+	PsmMagazineRef	*prev = NULL;
+
+	if (map->status != MANAGED || map->traceSize > 0)
+	{
+		return NULL;
+	}
+
+	oK(pthread_once(&_magazineOnce, createMagazineKey));
+	if (!_magazineKeyCreated)
+	{
+		return NULL;
+	}
+
+	refs = (PsmMagazineRef *) pthread_getspecific(_magazineKey);
+	for (ref = refs; ref; prev = ref, ref = ref->next)
+	{
+		if (ref->map != map)
+		{
+			continue;
+		}
+
+		if (magazineIsValid(ref))
+		{
+			return ref->magazine;
+		}
+
+		/*	Partition has been re-initialized since the
+		 *	magazine was created, or this is a forked
+		 *	child: the magazine is not ours to use.		*/
+
+		if (prev)
+		{
+			prev->next = ref->next;
+		}
+		else
+		{
+			refs = ref->next;
+			oK(pthread_setspecific(_magazineKey, refs));
+		}
+
+		free(ref);
+		break;
+	}
+
+	ref = (PsmMagazineRef *) acquireSystemMemory(sizeof(PsmMagazineRef));
+	if (ref == NULL)
+	{
+		return NULL;	/*	Just use the partition.		*/
+	}
+
+	ref->magazine = createMagazine(map);
+	if (ref->magazine == NULL)
+	{
+		free(ref);
+		return NULL;
+	}
+
+	ref->map = map;
+	ref->generation = map->generation;
+	ref->next = refs;
+	if (pthread_setspecific(_magazineKey, ref) != 0)
+	{
+		releaseMagazineRef(ref);
+		return NULL;
+	}
+
+	return ref->magazine;
+}
+
+static void	releaseMagazine(PartitionMap *map)
+{
+	PsmMagazineRef	*refs;
+	PsmMagazineRef	*ref;
+	PsmMagazineRef	*prev = NULL;
+
+	if (!_magazineKeyCreated)
+	{
+		return;
+	}
+
+	refs = (PsmMagazineRef *) pthread_getspecific(_magazineKey);
+	for (ref = refs; ref; prev = ref, ref = ref->next)
+	{
+		if (ref->map == map)
+		{
+			if (prev)
+			{
+				prev->next = ref->next;
+			}
+			else
+			{
+				oK(pthread_setspecific(_magazineKey,
+						ref->next));
+			}
+
+			releaseMagazineRef(ref);
+			return;
+		}
+	}
+}
+
+static void	countParkedBlocks(PartitionMap *map, PsmUsageSummary *usage)
+{
+	PsmAddress	magAddr;
+	PsmMagazine	*mag;
+	int		i;
+
+	/*	Partition must be locked.  Counts are advisory, as
+	 *	owners take and park blocks without locking.		*/
+
+	for (magAddr = map->magazines; magAddr; magAddr = mag->next)
+	{
+		mag = (PsmMagazine *) (((char *) map) + magAddr);
+		for (i = 0; i < SMALL_SIZES; i++)
+		{
+			usage->smallPoolFreeBlockCount[i] += mag->count[i];
+		}
+	}
+}
+
+static PsmAddress	magazineAlloc(PartitionMap *map, u_long nbytes)
+{
+	PsmMagazine		*mag;
+	int			i;
+	u_long			increment;
+	PsmAddress		block;
+	struct small_ohd	*blk;
+
+	mag = getMagazine(map);
+	if (mag == NULL)
+	{
+		return 0;
+	}
+
+	nbytes += (SMALL_BLOCK_OHD - 1);
+	nbytes >>= SPACE_ORDER;	/*	Truncate.			*/
+	i = nbytes - 1;		/*	(gives bucket #)		*/
+	nbytes <<= SPACE_ORDER;	/*	Restore size.			*/
+	if (mag->count[i] > 0)
+	{
+		mag->hits++;
+	}
+	else	/*	Refill the magazine from the small pool.	*/
+	{
+		increment = nbytes + SMALL_BLOCK_OHD;
+		lockPartition(map);
+		map->magazineRefills++;
+		postMagazineHits(map, mag);
+		while (mag->count[i] < PSM_MAGAZINE_BATCH)
+		{
+			block = map->firstSmallFree[i];
+			if (block)
+			{
+				map->firstSmallFree[i] = (SMALL(block))->next;
+			}
+			else
+			{
+				if (map->unassignedSpace < increment)
+				{
+					break;
+				}
+
+				block = map->endOfSmallPool;
+				map->endOfSmallPool += increment;
+				map->unassignedSpace -= increment;
+			}
+
+			(SMALL(block))->next = SMALL_IN_USE;	/*	Parked.	*/
+			mag->blocks[i][mag->count[i]] = block;
+			mag->count[i]++;
+		}
+
+		unlockPartition(map);
+		if (mag->count[i] == 0)	/*	Small pool exhausted.	*/
+		{
+			return 0;
+		}
+	}
+
+	mag->count[i]--;
+	block = mag->blocks[i][mag->count[i]];
+	blk = SMALL(block);
+	blk->next = SMALL_IN_USE + i + 1;
+	return block + SMALL_BLOCK_OHD;
+}
+
+static int	magazineFree(PartitionMap *map, PsmAddress address)
+{
+	PsmMagazine		*mag;
+	PsmAddress		block;
+	struct small_ohd	*blk;
+	int			i;
+
+	if (address < map->startOfSmallPool || address >= map->endOfSmallPool)
+	{
+		return 0;
+	}
+
+	block = address - SMALL_BLOCK_OHD;
+	blk = SMALL(block);
+	if (blk->next <= SMALL_IN_USE)
+	{
+		return 0;	/*	Let Psm_free report the error.	*/
+	}
+
+	mag = getMagazine(map);
+	if (mag == NULL)
+	{
+		return 0;
+	}
+
+	i = (int) (blk->next - SMALL_IN_USE) - 1;
+	if (mag->count[i] == PSM_MAGAZINE_SIZE)
+	{
+		lockPartition(map);
+		map->magazineDrains++;
+		postMagazineHits(map, mag);
+		drainMagazine(map, mag, i, PSM_MAGAZINE_BATCH);
+		unlockPartition(map);
+	}
+	else
+	{
+		mag->hits++;
+	}
+
+	blk->next = SMALL_IN_USE;	/*	Parked.			*/
+	mag->blocks[i][mag->count[i]] = block;
+	mag->count[i]++;
+	return 1;
+}
+#endif
+
 int	psm_manage(char *start, u_long length, char *name, PsmPartition *psmp,
 		PsmMgtOutcome *outcome)
 {
@@ -304,6 +760,11 @@ actual name.", map->name);
 				map->endOfSmallPool;
 		map->traceKey = sm_GetUniqueKey();
 		map->traceSize = 0;
+		map->generation = sm_GetUniqueKey();
+		map->magazines = 0;
+		map->magazineHits = 0;
+		map->magazineRefills = 0;
+		map->magazineDrains = 0;
 	}
 
 	map->semaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
@@ -343,6 +804,9 @@ void	psm_unmanage(PsmPartition partition)
 
 	CHKVOID(partition);
 	map = (PartitionMap *) (partition->space);
+#ifdef PSM_MAGAZINES
+	releaseMagazine(map);
+#endif
 	if (map->status == MANAGED)
 	{
 	/*	Wait for partition to be no longer in use; unmanage.	*/
@@ -858,6 +1322,12 @@ void	Psm_free(const char *file, int line, PsmPartition partition,
 	}
 
 	map = (PartitionMap *) (partition->space);
+#ifdef PSM_MAGAZINES
+	if (magazineFree(map, address))
+	{
+		return;
+	}
+#endif
 	lockPartition(map);
 	if (address >= map->startOfSmallPool
 	&& address < map->endOfSmallPool)
@@ -1145,6 +1615,16 @@ block size %lu", nbytes);
 	}
 
 	map = (PartitionMap *) (partition->space);
+#ifdef PSM_MAGAZINES
+	if (nbytes <= SMALL_BLK_LIMIT)
+	{
+		block = magazineAlloc(map, nbytes);
+		if (block)
+		{
+			return block;
+		}
+	}
+#endif
 	lockPartition(map);
 	if (nbytes > SMALL_BLK_LIMIT)
 	{
@@ -1210,12 +1690,18 @@ void	psm_usage(PsmPartition partition, PsmUsageSummary *usage)
 	istrcpy(usage->partitionName, map->name, sizeof usage->partitionName);
 	usage->partitionSize = map->partitionSize;
 	usage->smallPoolSize = map->endOfSmallPool - map->startOfSmallPool;
+	memset((char *) (usage->smallPoolFreeBlockCount), 0,
+			sizeof usage->smallPoolFreeBlockCount);
+#ifdef PSM_MAGAZINES
+	reclaimMagazines(map);
+	countParkedBlocks(map, usage);
+#endif
 	freeTotal = 0;
 	size = 0;
 	for (i = 0; i < SMALL_SIZES; i++)
 	{
 		size += WORD_SIZE;
-		count = 0;
+		count = usage->smallPoolFreeBlockCount[i];
 		for (block = map->firstSmallFree[i]; block; block = nextBlock)
 		{
 			count++;
@@ -1251,6 +1737,9 @@ void	psm_usage(PsmPartition partition, PsmUsageSummary *usage)
 			(sizeof(PartitionMap) +
 			 usage->smallPoolSize +
 			 usage->largePoolSize);
+	usage->magazineHits = map->magazineHits;
+	usage->magazineRefills = map->magazineRefills;
+	usage->magazineDrains = map->magazineDrains;
 	unlockPartition(map);
 }
 
@@ -1259,6 +1748,7 @@ void	psm_report(PsmUsageSummary *usage)
 	int	i;
 	u_long	size;
 	int	count;
+	u_long	total;
 	char	textbuf[100];
 
 	CHKVOID(usage);
@@ -1318,6 +1808,24 @@ void	psm_report(PsmUsageSummary *usage)
 	isprintf(textbuf, sizeof textbuf,
 			"total unused:      %10ld", usage->unusedSize);
 	writeMemo(textbuf);
+	total = usage->magazineHits + usage->magazineRefills
+			+ usage->magazineDrains;
+	if (total > 0)
+	{
+		isprintf(textbuf, sizeof textbuf,
+			"magazine hits:     %10lu", usage->magazineHits);
+		writeMemo(textbuf);
+		isprintf(textbuf, sizeof textbuf,
+			"magazine refills:  %10lu", usage->magazineRefills);
+		writeMemo(textbuf);
+		isprintf(textbuf, sizeof textbuf,
+			"magazine drains:   %10lu", usage->magazineDrains);
+		writeMemo(textbuf);
+		isprintf(textbuf, sizeof textbuf,
+			"magazine hit rate: %10lu%%",
+			(usage->magazineHits * 100) / total);
+		writeMemo(textbuf);
+	}
 }
 
 int	psm_start_trace(PsmPartition partition, long shmSize, char *shm)
@@ -509,6 +509,79 @@ PsmAddress	postProbeEvent(IonNode *node, Embargo *embargo)
 
 /*	*	RFX contact list management functions	*	*	*/
 
+static void	noteRevisedContact(PsmAddress cxaddr)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb 		*vdb = getIonVdb();
+	IonCXref	*cxref;
+
+	/*	Only contacts traversed by computed routes need be
+	 *	noted, and each such contact need be noted only once
+	 *	until routes are again computed through it.		*/
+
+	cxref = (IonCXref *) psp(ionwm, cxaddr);
+	if (cxref->routingObject == 0)
+	{
+		return;
+	}
+
+	if (sm_list_insert_last(ionwm, vdb->revisedContacts, cxaddr) == 0)
+	{
+		putErrmsg("Can't note revised contact.", NULL);
+		return;
+	}
+
+	cxref->routingObject = 0;
+}
+
+static void	noteRevisedContacts(uvast fromNode, uvast toNode,
+			time_t fromTime, time_t toTime)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb 		*vdb = getIonVdb();
+	IonCXref	arg;
+	PsmAddress	elt;
+	PsmAddress	cxaddr;
+	IonCXref	*cxref;
+
+	/*	Note revision of all contacts between these two nodes
+	 *	that overlap the indicated interval, e.g., because
+	 *	the range that applies to them has changed.		*/
+
+	memset((char *) &arg, 0, sizeof(IonCXref));
+	arg.fromNode = fromNode;
+	arg.toNode = toNode;
+	for (oK(sm_rbt_search(ionwm, vdb->contactIndex, rfx_order_contacts,
+			&arg, &elt)); elt; elt = sm_rbt_next(ionwm, elt))
+	{
+		cxaddr = sm_rbt_data(ionwm, elt);
+		cxref = (IonCXref *) psp(ionwm, cxaddr);
+		if (cxref->fromNode > fromNode || cxref->toNode > toNode
+		|| cxref->fromTime >= toTime)
+		{
+			break;	/*	No more matches.		*/
+		}
+
+		if (cxref->toTime > fromTime)
+		{
+			noteRevisedContact(cxaddr);
+		}
+	}
+}
+
+static void	noteAllContactsRevised()
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb 		*vdb = getIonVdb();
+	PsmAddress	elt;
+
+	for (elt = sm_rbt_first(ionwm, vdb->contactIndex); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		noteRevisedContact(sm_rbt_data(ionwm, elt));
+	}
+}
+
 static PsmAddress	insertCXref(IonCXref *cxref)
 {
 	PsmPartition	ionwm = getIonwm();
@@ -960,11 +1033,7 @@ static void	deleteContact(PsmAddress cxaddr)
 
 	/*	Delete contact from index.				*/
 
-	if (cxref->toTime > currentTime)	/*	Affects routes.	*/
-	{
-		vdb->lastEditTime = currentTime;
-	}
-
+	noteRevisedContact(cxaddr);
 	sm_rbt_delete(ionwm, vdb->contactIndex, rfx_order_contacts, cxref,
 			rfx_erase_data, NULL);
 }
@@ -1293,6 +1362,8 @@ Object	rfx_insert_range(time_t fromTime, time_t toTime, uvast fromNode,
 			 *	associated events, after which there
 			 *	is no duplication.			*/
 
+			noteRevisedContacts(fromNode, toNode, rxref->fromTime,
+					rxref->toTime);
 			sm_rbt_delete(ionwm, vdb->rangeIndex, rfx_order_ranges,
 					&arg1, rfx_erase_data, NULL);
 			arg2.ref = rxaddr;
@@ -1502,7 +1573,8 @@ static void	deleteRange(PsmAddress rxaddr, int conditional)
 
 	if (rxref->toTime > currentTime)	/*	Affects routes.	*/
 	{
-		vdb->lastEditTime = currentTime;
+		noteRevisedContacts(rxref->fromNode, rxref->toNode,
+				rxref->fromTime, rxref->toTime);
 	}
 
 	sm_rbt_delete(ionwm, vdb->rangeIndex, rfx_order_ranges, rxref,
@@ -1707,6 +1779,7 @@ int	rfx_start()
 	 *	databases.  This prevents contact/range duplication
 	 *	as a result of adds before starting ION.		*/
 
+	noteAllContactsRevised();
 	sm_rbt_destroy(ionwm, vdb->contactIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->rangeIndex, rfx_erase_data, NULL);
 	vdb->contactIndex = sm_rbt_create(ionwm);
@@ -1800,6 +1873,7 @@ void	rfx_stop()
 	/*	Wipe out all red-black trees involved in routing,
 	 *	for reconstruction on restart.				*/
 
+	noteAllContactsRevised();
 	sm_rbt_destroy(ionwm, vdb->contactIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->rangeIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->timeline, rfx_erase_data, NULL);
@@ -17,6 +17,10 @@
 #define ZCODEBUG	0
 #endif
 
+#ifndef ZCO_FD_CACHE_SIZE
+#define ZCO_FD_CACHE_SIZE	8
+#endif
+
 static const char	*bookNames[] = { "inbound", "outbound" };
 
 /*	The INBOUND and OUTBOUND "books" control ZCOs' occupancy of
@@ -728,12 +732,192 @@ int	zco_file_ref_xmit_eof(Sdr sdr, Object fileRefObj)
 	return (fileRef->xmitProgress == fileRef->fileLength);
 }
 
+/*	Each process keeps the files that it has recently read ZCO
+ *	source data from open, so that transmitting a large file
+ *	in many small chunks doesn't cost an open and close per
+ *	chunk.  The cache is keyed by file reference address, which
+ *	may be reused once the reference is destroyed -- possibly by
+ *	some other process -- so a cached file descriptor is used
+ *	only while its file is still linked and is still the file
+ *	at the reference's path name; otherwise the file is
+ *	reopened.  Descriptors of files that have been unlinked are
+ *	closed whenever the cache is searched in vain, so that
+ *	their disk space can be reclaimed.  Access to the cache is
+ *	serialized by the SDR transaction lock, as copyFromSource
+ *	is always invoked within a transaction.				*/
+
+typedef struct
+{
+	Object		fileRefObj;
+	int		fd;
+} ZcoCachedFd;
+
+static ZcoCachedFd	*_fdCache()
+{
+	static ZcoCachedFd	cache[ZCO_FD_CACHE_SIZE];
+	static int		initialized = 0;
+	int			i;
+
+	if (!initialized)
+	{
+		for (i = 0; i < ZCO_FD_CACHE_SIZE; i++)
+		{
+			cache[i].fd = -1;
+		}
+
+		initialized = 1;
+	}
+
+	return cache;
+}
+
+static void	closeCachedFd(ZcoCachedFd *entry)
+{
+	close(entry->fd);
+	entry->fd = -1;
+	entry->fileRefObj = 0;
+}
+
+static void	forgetFd(Object fileRefObj)
+{
+	ZcoCachedFd	*cache = _fdCache();
+	int		i;
+
+	for (i = 0; i < ZCO_FD_CACHE_SIZE; i++)
+	{
+		if (cache[i].fileRefObj == fileRefObj && cache[i].fd >= 0)
+		{
+			closeCachedFd(cache + i);
+		}
+	}
+}
+
+static int	fdIsCurrent(int fd, FileRef *fileRef)
+{
+	struct stat	fdStat;
+	struct stat	pathStat;
+
+	if (fstat(fd, &fdStat) < 0
+	|| fdStat.st_nlink == 0			/*	Unlinked.	*/
+	|| fdStat.st_ino != fileRef->inode)
+	{
+		return 0;
+	}
+
+	if (stat(fileRef->pathName, &pathStat) < 0
+	|| pathStat.st_dev != fdStat.st_dev
+	|| pathStat.st_ino != fdStat.st_ino)	/*	Replaced.	*/
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+static void	closeUnlinkedFds(ZcoCachedFd *cache)
+{
+	int		i;
+	struct stat	statbuf;
+
+	for (i = 0; i < ZCO_FD_CACHE_SIZE; i++)
+	{
+		if (cache[i].fd >= 0)
+		{
+			if (fstat(cache[i].fd, &statbuf) < 0
+			|| statbuf.st_nlink == 0)
+			{
+				closeCachedFd(cache + i);
+			}
+		}
+	}
+}
+
+static int	getFd(FileRef *fileRef, Object fileRefObj)
+{
+	static int	nextVictim = 0;
+	ZcoCachedFd	*cache = _fdCache();
+	int		i;
+	ZcoCachedFd	*entry;
+	int		fd;
+	struct stat	statbuf;
+
+	for (i = 0; i < ZCO_FD_CACHE_SIZE; i++)
+	{
+		entry = cache + i;
+		if (entry->fileRefObj == fileRefObj && entry->fd >= 0)
+		{
+			if (fdIsCurrent(entry->fd, fileRef))
+			{
+				return entry->fd;
+			}
+
+			closeCachedFd(entry);	/*	File changed.	*/
+		}
+	}
+
+	closeUnlinkedFds(cache);
+	fd = iopen(fileRef->pathName, O_RDONLY, 0);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	if (fstat(fd, &statbuf) < 0	/*	Can't check.		*/
+	|| statbuf.st_ino != fileRef->inode)	/*	File changed.	*/
+	{
+		close(fd);
+		return -1;
+	}
+
+#ifdef FD_CLOEXEC
+	oK(fcntl(fd, F_SETFD, FD_CLOEXEC));
+#endif
+
+	/*	Use an empty slot if any, else replace the oldest.	*/
+
+	entry = NULL;
+	for (i = 0; i < ZCO_FD_CACHE_SIZE; i++)
+	{
+		if (cache[i].fd < 0)
+		{
+			entry = cache + i;
+			break;
+		}
+	}
+
+	if (entry == NULL)
+	{
+		entry = cache + nextVictim;
+		nextVictim = (nextVictim + 1) % ZCO_FD_CACHE_SIZE;
+		close(entry->fd);
+	}
+
+	entry->fileRefObj = fileRefObj;
+	entry->fd = fd;
+	return fd;
+}
+
+static int	readFromFd(int fd, char *buffer, vast length, vast offset)
+{
+#if (defined(mingw) || defined(ION4WIN))
+	if (lseek(fd, offset, SEEK_SET) < 0)
+	{
+		return -1;
+	}
+
+	return read(fd, buffer, length);
+#else
+	return pread(fd, buffer, length, offset);
+#endif
+}
+
 static void	destroyFileReference(Sdr sdr, FileRef *fileRef,
 			Object fileRefObj)
 {
 	/*	Destroy the file reference.  Invoke file cleanup
 	 *	script if provided.					*/
 
+	forgetFd(fileRefObj);
 	sdr_free(sdr, fileRefObj);
 	if (fileRef->unlinkOnDestroy)
 	{
@@ -1125,6 +1309,41 @@ static int	appendExtent(Sdr sdr, Object zcoObj, Zco *zco,
 	ZcoLienRef	lienRef;
 	SourceExtent	prevExtent;
 
+	if (sourceMedium == ZcoFileSource && zco->lastExtent != 0)
+	{
+		sdr_stage(sdr, (char *) &prevExtent, zco->lastExtent,
+				sizeof(SourceExtent));
+		if (prevExtent.sourceMedium == ZcoFileSource
+		&& prevExtent.offset + prevExtent.length == offset)
+		{
+			/*	New extent may simply continue the
+			 *	last extent, provided the last extent
+			 *	cites the same file and its lien is
+			 *	not shared with any other extent.	*/
+
+			sdr_stage(sdr, (char *) &lienRef, prevExtent.location,
+					sizeof(ZcoLienRef));
+			if (lienRef.location == location
+			&& lienRef.refCount[acct] == 1
+			&& lienRef.refCount[1 - acct] == 0)
+			{
+				lienRef.length += length;
+				sdr_write(sdr, prevExtent.location,
+					(char *) &lienRef, sizeof(ZcoLienRef));
+				zco_increase_file_occupancy(sdr, length, acct);
+				prevExtent.length += length;
+				sdr_write(sdr, zco->lastExtent,
+					(char *) &prevExtent,
+					sizeof(SourceExtent));
+				zco->sourceLength += length;
+				zco->totalLength += length;
+				sdr_write(sdr, zcoObj, (char *) zco,
+						sizeof(Zco));
+				return length;
+			}
+		}
+	}
+
 	extentObj = sdr_malloc(sdr, sizeof(SourceExtent));
 	if (extentObj == 0)
 	{
@@ -2145,7 +2364,6 @@ static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 	FileRef		fileRef;
 	int		fd;
 	int		bytesRead;
-	struct stat	statbuf;
 	unsigned long	xmitProgress = 0;
 
 	if (extent->sourceMedium == ZcoSdrSource)
@@ -2167,42 +2385,27 @@ static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 				sizeof(ZcoLienRef));
 		sdr_stage(sdr, (char *) &fileRef, lienRef.location,
 				sizeof(FileRef));
-		fd = iopen(fileRef.pathName, O_RDONLY, 0);
+		fd = getFd(&fileRef, lienRef.location);
 		if (fd >= 0)
 		{
-			if (fstat(fd, &statbuf) < 0)
-			{
-				close(fd);	/*	Can't check.	*/
-			}
-			else if (statbuf.st_ino != fileRef.inode)
-			{
-				close(fd);	/*	File changed.	*/
-			}
-			else if (lseek(fd, extent->offset + bytesToSkip,
-					SEEK_SET) < 0)
+			bytesRead = readFromFd(fd, buffer, bytesAvbl,
+					extent->offset + bytesToSkip);
+			if (bytesRead == bytesAvbl)
 			{
-				close(fd);	/*	Can't position.	*/
-			}
-			else
-			{
-				bytesRead = read(fd, buffer, bytesAvbl);
-				close(fd);
-				if (bytesRead == bytesAvbl)
+				/*	Update xmit progress.		*/
+
+				if (xmitProgress > fileRef.xmitProgress)
 				{
-					/*	Update xmit progress.	*/
-
-					if (xmitProgress > fileRef.xmitProgress)
-					{
-						fileRef.xmitProgress
-							= xmitProgress;
-						sdr_write(sdr, lienRef.location,
-							(char *) &fileRef,
-							sizeof(FileRef));
-					}
-
-					return bytesAvbl;
+					fileRef.xmitProgress = xmitProgress;
+					sdr_write(sdr, lienRef.location,
+						(char *) &fileRef,
+						sizeof(FileRef));
 				}
+
+				return bytesAvbl;
 			}
+
+			forgetFd(lienRef.location);
 		}
 
 		/*	On any problem reading from file, write fill
@@ -2231,7 +2434,141 @@ void	zco_track_file_offset(ZcoReader *reader)
 	}
 }
 
-vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
+/*	transmitZco either copies ZCO bytes into a buffer (if
+ *	"spans" is NULL) or else describes them as a list of spans
+ *	of copied heap text and of open files, stopping early if
+ *	the list of spans or the buffer for heap text fills up.
+ *	Heap text is copied and file descriptors are duplicated so
+ *	that the caller can use the spans after the transaction
+ *	ends: the heap may be revised, and the ZCO file descriptor
+ *	cache may close its descriptors, as soon as it does.		*/
+
+typedef struct
+{
+	ZcoSpan		*spans;
+	int		maxSpans;
+	int		*spanCount;
+	char		*text;		/*	Next free byte.		*/
+	vast		textRoom;
+} ZcoSpanList;
+
+static int	addSpan(ZcoSpanList *list, ZcoMedium medium, char *data,
+			int fd, vast offset, vast length)
+{
+	ZcoSpan	*span;
+
+	if (*(list->spanCount) > 0)
+	{
+		span = list->spans + (*(list->spanCount) - 1);
+		if (medium == ZcoSdrSource && span->medium == ZcoSdrSource
+		&& span->data + span->length == data)
+		{
+			span->length += length;	/*	Contiguous.	*/
+			return 0;
+		}
+	}
+
+	if (*(list->spanCount) == list->maxSpans)
+	{
+		return -1;		/*	No more room.		*/
+	}
+
+	span = list->spans + *(list->spanCount);
+	span->medium = medium;
+	span->data = data;
+	span->fd = fd;
+	span->offset = offset;
+	span->length = length;
+	(*(list->spanCount))++;
+	return 0;
+}
+
+static vast	addHeapSpan(Sdr sdr, ZcoSpanList *list, Address from,
+			vast length)
+{
+	/*	Returns the number of bytes copied, possibly fewer
+	 *	than length if the text buffer fills up.		*/
+
+	if (length > list->textRoom)
+	{
+		length = list->textRoom;
+	}
+
+	if (length == 0
+	|| addSpan(list, ZcoSdrSource, list->text, -1, 0, length) < 0)
+	{
+		return 0;
+	}
+
+	sdr_read(sdr, list->text, from, length);
+	list->text += length;
+	list->textRoom -= length;
+	return length;
+}
+
+static vast	addExtentSpan(Sdr sdr, ZcoSpanList *list,
+			SourceExtent *extent, vast bytesToSkip,
+			vast bytesAvbl, ZcoReader *reader)
+{
+	ZcoObjRef	objRef;
+	ZcoLienRef	lienRef;
+	FileRef		fileRef;
+	int		fd;
+	unsigned long	xmitProgress;
+
+	/*	Returns the number of bytes described, or -1 on
+	 *	system failure.						*/
+
+	if (extent->sourceMedium == ZcoSdrSource)
+	{
+		sdr_read(sdr, (char *) &objRef, extent->location,
+				sizeof(ZcoObjRef));
+		return addHeapSpan(sdr, list, objRef.location
+				+ extent->offset + bytesToSkip, bytesAvbl);
+	}
+
+	if (*(list->spanCount) == list->maxSpans)
+	{
+		return 0;
+	}
+
+	sdr_read(sdr, (char *) &lienRef, extent->location,
+			sizeof(ZcoLienRef));
+	sdr_stage(sdr, (char *) &fileRef, lienRef.location, sizeof(FileRef));
+	fd = getFd(&fileRef, lienRef.location);
+	if (fd >= 0)
+	{
+		fd = dup(fd);
+		if (fd < 0)
+		{
+			putSysErrmsg("Can't duplicate ZCO file descriptor",
+					fileRef.pathName);
+			return -1;
+		}
+
+#ifdef FD_CLOEXEC
+		oK(fcntl(fd, F_SETFD, FD_CLOEXEC));
+#endif
+		if (reader->trackFileOffset)
+		{
+			xmitProgress = extent->offset + bytesToSkip + bytesAvbl;
+			if (xmitProgress > fileRef.xmitProgress)
+			{
+				fileRef.xmitProgress = xmitProgress;
+				sdr_write(sdr, lienRef.location,
+						(char *) &fileRef,
+						sizeof(FileRef));
+			}
+		}
+	}
+
+	oK(addSpan(list, ZcoFileSource, NULL, fd, extent->offset
+			+ bytesToSkip, bytesAvbl));
+	return bytesAvbl;
+}
+
+static vast	transmitZco(Sdr sdr, ZcoReader *reader, vast length,
+			char *buffer, ZcoSpanList *list)
 {
 	Zco		zco;
 	vast		bytesToSkip;
@@ -2240,17 +2577,11 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 	Object		obj;
 	Capsule		capsule;
 	vast		bytesAvbl;
+	vast		bytesDescribed;
 	SourceExtent	extent;
+	int		full = 0;
 	int		failed = 0;
 
-	CHKERR(sdr);
-	CHKERR(reader);
-	CHKERR(length >= 0);
-	if (length == 0)
-	{
-		return 0;
-	}
-
 	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
 	bytesToSkip = reader->lengthCopied;
 	bytesToTransmit = length;
@@ -2260,7 +2591,7 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 
 	for (obj = zco.firstHeader; obj; obj = capsule.nextCapsule)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
+		if (bytesToTransmit == 0 || full)	/*	Done.	*/
 		{
 			break;
 		}
@@ -2279,7 +2610,17 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			bytesAvbl = bytesToTransmit;
 		}
 
-		if (buffer)
+		if (list)
+		{
+			bytesDescribed = addHeapSpan(sdr, list, capsule.text
+					+ bytesToSkip, bytesAvbl);
+			if (bytesDescribed < bytesAvbl)
+			{
+				full = 1;
+				bytesAvbl = bytesDescribed;
+			}
+		}
+		else if (buffer)
 		{
 			sdr_read(sdr, buffer, capsule.text + bytesToSkip,
 					bytesAvbl);
@@ -2296,7 +2637,7 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 
 	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
+		if (bytesToTransmit == 0 || full)	/*	Done.	*/
 		{
 			break;
 		}
@@ -2315,7 +2656,28 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			bytesAvbl = bytesToTransmit;
 		}
 
-		if (buffer)
+		if (list)
+		{
+			bytesDescribed = addExtentSpan(sdr, list, &extent,
+					bytesToSkip, bytesAvbl, reader);
+			if (bytesDescribed < 0)
+			{
+				return -1;
+			}
+
+			if (bytesDescribed < bytesAvbl)
+			{
+				full = 1;
+				bytesAvbl = bytesDescribed;
+			}
+			else if (list->spans[*(list->spanCount) - 1].medium
+					== ZcoFileSource
+			&& list->spans[*(list->spanCount) - 1].fd < 0)
+			{
+				failed = 1;	/*	File problem.	*/
+			}
+		}
+		else if (buffer)
 		{
 			if (copyFromSource(sdr, buffer, &extent, bytesToSkip,
 					bytesAvbl, reader) == 0)
@@ -2336,7 +2698,7 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 
 	for (obj = zco.firstTrailer; obj; obj = capsule.nextCapsule)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
+		if (bytesToTransmit == 0 || full)	/*	Done.	*/
 		{
 			break;
 		}
@@ -2355,7 +2717,17 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			bytesAvbl = bytesToTransmit;
 		}
 
-		if (buffer)
+		if (list)
+		{
+			bytesDescribed = addHeapSpan(sdr, list, capsule.text
+					+ bytesToSkip, bytesAvbl);
+			if (bytesDescribed < bytesAvbl)
+			{
+				full = 1;
+				bytesAvbl = bytesDescribed;
+			}
+		}
+		else if (buffer)
 		{
 			sdr_read(sdr, buffer, capsule.text + bytesToSkip,
 					bytesAvbl);
@@ -2376,6 +2748,47 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 	return bytesTransmitted;
 }
 
+vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
+{
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length >= 0);
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	return transmitZco(sdr, reader, length, buffer, NULL);
+}
+
+vast	zco_transmit_iov(Sdr sdr, ZcoReader *reader, vast length,
+		char *buffer, vast bufferLength, ZcoSpan *spans,
+		int *spanCount)
+{
+	ZcoSpanList	list;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length >= 0);
+	CHKERR(buffer);
+	CHKERR(bufferLength >= 0);
+	CHKERR(spans);
+	CHKERR(spanCount);
+	CHKERR(*spanCount > 0);
+	list.spans = spans;
+	list.maxSpans = *spanCount;
+	list.spanCount = spanCount;
+	list.text = buffer;
+	list.textRoom = bufferLength;
+	*spanCount = 0;
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	return transmitZco(sdr, reader, length, NULL, &list);
+}
+
 /*	Functions for delivery to overlying protocol or application
  *	layer.								*/
 
@@ -62,6 +62,31 @@ typedef struct
 	PsmAddress	sdrs;	/*	An SmList of (SdrState *).	*/
 } SdrControlHeader;
 
+/*	SdrReader identifies one thread that currently holds a shared
+ *	read-only transaction on an SDR.  Read-only transactions are
+ *	mutually compatible: any number of them (up to the size of
+ *	the SDR's readers table) may be in progress at once, but no
+ *	update transaction may begin until all of them have ended.	*/
+
+#ifndef SDR_MAX_READERS
+#define	SDR_MAX_READERS	(32)
+#endif
+
+/*	An update transaction that is waiting for read-only
+ *	transactions to end checks the readers table at this
+ *	interval, in microseconds.					*/
+
+#ifndef SDR_READER_POLL_INTERVAL
+#define	SDR_READER_POLL_INTERVAL	(100)
+#endif
+
+typedef struct
+{
+	int		readerTask;		/*	0 = slot free	*/
+	pthread_t	readerThread;
+	int		readDepth;		/*	Nesting level.	*/
+} SdrReader;
+
 /*	SdrState is an object that encapsulates the volatile state of
  *	a single SDR.  It resides in SDR working memory (a shared
  *	memory partition), in the control header's list of sdrs.	*/
@@ -90,6 +115,12 @@ typedef struct sdr_str
 	int		logLength;		/*	All entries.	*/
 	PsmAddress	logEntries;		/*	Offsets in log.	*/
 
+		/*	Shared read-only transactions.		*/
+
+	sm_SemId	readersLock;		/*	Guards table.	*/
+	int		readerCount;
+	SdrReader	readers[SDR_MAX_READERS];
+
 		/*	SDR trace data access.			*/
 
 	int		traceKey;		/*	trace shmKey	*/
@@ -136,6 +167,56 @@ typedef struct	/*	Non-volatile state at front of SDR.		*/
 	long		unassignedSpace;
 } SdrMap;
 
+/*	When an SDR's dataspace resides both in memory and in a file,
+ *	the memory copy is the one that is read, so writes to the file
+ *	can be deferred until the end of the transaction.  Each SdrView
+ *	accumulates the transaction's file writes in a buffer of
+ *	DsWrite extents (each header followed by its data), merging
+ *	writes to contiguous addresses into a single extent, and
+ *	flushes the buffer to the dataspace file when the transaction
+ *	is ended or the buffer fills up.				*/
+
+#ifndef SDR_DS_BUFSIZE
+#define	SDR_DS_BUFSIZE	(16384)
+#endif
+
+typedef struct
+{
+	Address		into;		/*	Offset in dataspace.	*/
+	long		length;		/*	Of data that follows.	*/
+} DsWrite;
+
+/*	A log entry whose data is no longer than SDR_SMALL_LOG_ENTRY
+ *	is assembled in a local buffer and written to the log in a
+ *	single operation.						*/
+
+#ifndef SDR_SMALL_LOG_ENTRY
+#define	SDR_SMALL_LOG_ENTRY	(256)
+#endif
+
+/*	An SDR whose dataspace is either in shared memory or in a
+ *	memory-mapped file is read and written by direct access to
+ *	the dataspace at the SdrView's dssm pointer.			*/
+
+#define	SDR_IN_MEMORY	(SDR_IN_DRAM | SDR_IN_MMAP)
+
+/*	In an SDR_BOUNDED SDR, the extents of all objects that have
+ *	been allocated or staged in the current transaction are noted
+ *	in an array that is kept in ascending order of object address,
+ *	so that they can be found by binary search.  The array is
+ *	retained from one transaction to the next, so that notes are
+ *	not individually allocated; it is enlarged as necessary.	*/
+
+#ifndef SDR_KNOWN_OBJECTS
+#define	SDR_KNOWN_OBJECTS	(64)
+#endif
+
+typedef struct
+{
+	Address		from;	/*	1st byte of object		*/
+	Address		to;	/*	1st byte beyond scope of object	*/
+} ObjectExtent;
+
 /*	SdrView is an object that encapsulates a single process's
  *	transient private access to a single SDR.  It resides in
  *	SDR working memory (a shared memory partition) but is private
@@ -154,9 +235,15 @@ typedef struct sdrv_str
 	char		*logsm;		/*	Log in shared memory.	*/
 	int		logsmId;	/*	Log shmId if applicable.*/
 
-	Lyst		knownObjects;	/*	ObjectExtents.		*/
+	ObjectExtent	*knownObjects;	/*	Ordered by address.	*/
+	int		knownObjectsCount;
+	int		knownObjectsLimit;	/*	Array capacity.	*/
 	int		modified;	/*	Boolean.		*/
 
+	char		*dsBuffer;	/*	Deferred DS file writes.*/
+	long		dsBufLength;	/*	Bytes in dsBuffer.	*/
+	long		lastDsWrite;	/*	Offset in dsBuffer.	*/
+
 	PsmView		traceArea;	/*	local access to trace	*/
 	PsmView		*trace;		/*	local access to trace	*/
 	const char	*currentSourceFileName;	/*	for tracing	*/
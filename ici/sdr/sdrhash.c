@@ -566,3 +566,713 @@ void	Sdr_hash_destroy(const char *file, int line, Sdr sdrv, Object hash)
 
 	Sdr_table_destroy(file, line, sdrv, hash);
 }
+
+/*	*	*	Resizable hash table functions	*	*	*/
+
+/*	A resizable SDR hash table is a "linear hashing" table.  Its
+ *	rows are the heads of singly-linked chains of entries, and
+ *	the rows themselves are stored in fixed-size segments that
+ *	are located by means of a directory of segment addresses,
+ *	so that rows can be added without relocating the existing
+ *	rows.  The table starts with a power-of-2 number of rows
+ *	(the "base" row count for the first round of expansion).
+ *	Whenever an insertion causes the mean number of entries per
+ *	row to exceed the declared maximum search length, one more
+ *	row is added: the entries in the next row due to be split
+ *	are divided between that row and the new row, using one
+ *	more bit of each entry's hash value.  When every row of the
+ *	current round has been split, the base row count doubles
+ *	and a new round begins.  So the work of growing the table
+ *	is spread evenly over the insertions that cause the growth,
+ *	each of which is performed within an ordinary transaction,
+ *	and the addresses of entries never change.			*/
+
+#define	LHASH_SEGMENT_ROWS	256
+#define	LHASH_MIN_ROWS		64
+
+typedef struct
+{
+	Object		directory;	/*	Array of segment addrs.	*/
+	unsigned int	directoryLength;/*	Max number of segments.	*/
+	unsigned int	baseRows;	/*	Power of 2.		*/
+	unsigned int	nextSplit;	/*	Next row to split.	*/
+	unsigned int	entries;
+	unsigned int	maxSearchLength;
+} LhashTable;
+
+typedef struct
+{
+	Object		next;		/*	Next entry in row.	*/
+	Address		value;
+	unsigned int	hashValue;
+	unsigned char	keyLength;
+} LhashEntry;			/*	Immediately followed by key.	*/
+
+static unsigned int	computeHashValue(char *key, int keyLength)
+{
+	unsigned int	h = 2166136261U;	/*	FNV-1a.		*/
+
+	while (keyLength > 0)
+	{
+		h ^= (unsigned char) *key;
+		h *= 16777619U;
+		key++;
+		keyLength--;
+	}
+
+	return h;
+}
+
+static unsigned int	computeLhashRow(LhashTable *table,
+				unsigned int hashValue)
+{
+	unsigned int	row;
+
+	row = hashValue & (table->baseRows - 1);
+	if (row < table->nextSplit)	/*	Row has been split.	*/
+	{
+		row = hashValue & ((table->baseRows << 1) - 1);
+	}
+
+	return row;
+}
+
+static Address	getLhashRowAddr(Sdr sdrv, LhashTable *table, unsigned int row)
+{
+	Object	segment;
+
+	sdr_read(sdrv, (char *) &segment, table->directory
+			+ ((row / LHASH_SEGMENT_ROWS) * sizeof(Object)),
+			sizeof(Object));
+	return segment + ((row % LHASH_SEGMENT_ROWS) * sizeof(Object));
+}
+
+static Object	createLhashSegment(const char *file, int line, Sdr sdrv)
+{
+	static Object	emptyRows[LHASH_SEGMENT_ROWS];
+	Object		segment;
+
+	segment = Sdr_malloc(file, line, sdrv, sizeof emptyRows);
+	if (segment)
+	{
+		_sdrput(file, line, sdrv, segment, (char *) emptyRows,
+				sizeof emptyRows, SystemPut);
+	}
+
+	return segment;
+}
+
+static Object	locateLhashEntry(Sdr sdrv, LhashTable *table, char *key,
+			int keyLength, Address *rowAddr, Object *prevEntry,
+			LhashEntry *entryBuf)
+{
+	unsigned int	hashValue;
+	Object		entry;
+	char		keyBuf[SDR_LHASH_MAX_KEY_LEN];
+
+	hashValue = computeHashValue(key, keyLength);
+	*rowAddr = getLhashRowAddr(sdrv, table,
+			computeLhashRow(table, hashValue));
+	*prevEntry = 0;
+	sdr_read(sdrv, (char *) &entry, *rowAddr, sizeof(Object));
+	while (entry)
+	{
+		sdr_read(sdrv, (char *) entryBuf, entry, sizeof(LhashEntry));
+		if (entryBuf->hashValue == hashValue
+		&& entryBuf->keyLength == keyLength)
+		{
+			sdr_read(sdrv, keyBuf, entry + sizeof(LhashEntry),
+					keyLength);
+			if (memcmp(keyBuf, key, keyLength) == 0)
+			{
+				return entry;
+			}
+		}
+
+		*prevEntry = entry;
+		entry = entryBuf->next;
+	}
+
+	return 0;
+}
+
+static void	unlinkLhashEntry(const char *file, int line, Sdr sdrv,
+			Address rowAddr, Object prevEntry, LhashEntry *entryBuf)
+{
+	/*	The "next" pointer is the first field of an entry.	*/
+
+	if (prevEntry)
+	{
+		sdrPut(prevEntry, entryBuf->next);
+	}
+	else
+	{
+		sdrPut(rowAddr, entryBuf->next);
+	}
+}
+
+static int	growLhashDirectory(const char *file, int line, Sdr sdrv,
+			LhashTable *table)
+{
+	unsigned int	newLength = table->directoryLength << 1;
+	Object		newDirectory;
+	unsigned int	i;
+	Object		segment;
+
+	newDirectory = Sdr_malloc(file, line, sdrv,
+			newLength * sizeof(Object));
+	if (newDirectory == 0)
+	{
+		return -1;
+	}
+
+	for (i = 0; i < newLength; i++)
+	{
+		segment = 0;
+		if (i < table->directoryLength)
+		{
+			sdr_read(sdrv, (char *) &segment, table->directory
+					+ (i * sizeof(Object)), sizeof(Object));
+		}
+
+		sdrPut(newDirectory + (i * sizeof(Object)), segment);
+	}
+
+	Sdr_free(file, line, sdrv, table->directory);
+	table->directory = newDirectory;
+	table->directoryLength = newLength;
+	return 0;
+}
+
+static int	splitLhashRow(const char *file, int line, Sdr sdrv,
+			LhashTable *table)
+{
+	unsigned int	oldRow = table->nextSplit;
+	unsigned int	newRow = oldRow + table->baseRows;
+	unsigned int	mask = (table->baseRows << 1) - 1;
+	unsigned int	segmentNbr = newRow / LHASH_SEGMENT_ROWS;
+	Address		segmentAddr;
+	Object		segment;
+	Address		oldRowAddr;
+	Address		newRowAddr;
+	Object		entry;
+	LhashEntry	entryBuf;
+	Object		nextEntry;
+	Object		oldChain = 0;
+	Object		newChain = 0;
+
+	/*	Make sure the new row exists.				*/
+
+	if (segmentNbr >= table->directoryLength)
+	{
+		if (growLhashDirectory(file, line, sdrv, table) < 0)
+		{
+			return -1;
+		}
+	}
+
+	segmentAddr = table->directory + (segmentNbr * sizeof(Object));
+	sdr_read(sdrv, (char *) &segment, segmentAddr, sizeof(Object));
+	if (segment == 0)
+	{
+		segment = createLhashSegment(file, line, sdrv);
+		if (segment == 0)
+		{
+			return -1;
+		}
+
+		sdrPut(segmentAddr, segment);
+	}
+
+	/*	Divide the entries of the old row between the old row
+	 *	and the new row, without moving them.			*/
+
+	oldRowAddr = getLhashRowAddr(sdrv, table, oldRow);
+	newRowAddr = getLhashRowAddr(sdrv, table, newRow);
+	sdr_read(sdrv, (char *) &entry, oldRowAddr, sizeof(Object));
+	while (entry)
+	{
+		sdr_read(sdrv, (char *) &entryBuf, entry, sizeof(LhashEntry));
+		nextEntry = entryBuf.next;
+		if ((entryBuf.hashValue & mask) == newRow)
+		{
+			sdrPut(entry, newChain);
+			newChain = entry;
+		}
+		else
+		{
+			sdrPut(entry, oldChain);
+			oldChain = entry;
+		}
+
+		entry = nextEntry;
+	}
+
+	sdrPut(oldRowAddr, oldChain);
+	sdrPut(newRowAddr, newChain);
+	table->nextSplit++;
+	if (table->nextSplit == table->baseRows)
+	{
+		table->baseRows <<= 1;	/*	Start next round.	*/
+		table->nextSplit = 0;
+	}
+
+	return 0;
+}
+
+Object	Sdr_lhash_create(const char *file, int line, Sdr sdrv,
+		int estNbrOfEntries, int maxSearchLength)
+{
+	LhashTable	table;
+	Object		hash;
+	unsigned int	segmentCount;
+	unsigned int	i;
+	Object		segment;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (estNbrOfEntries < 0 || maxSearchLength < 1)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return 0;
+	}
+
+	/*	Initial row count is the smallest power of 2 that
+	 *	accommodates the estimated number of entries without
+	 *	exceeding the maximum search length, but no less than
+	 *	LHASH_MIN_ROWS.  The directory initially has room for
+	 *	twice as many segments as are needed at first.		*/
+
+	memset((char *) &table, 0, sizeof(LhashTable));
+	table.baseRows = LHASH_MIN_ROWS;
+	while (table.baseRows < estNbrOfEntries / maxSearchLength
+	&& table.baseRows < (1U << 30))
+	{
+		table.baseRows <<= 1;
+	}
+
+	table.maxSearchLength = maxSearchLength;
+	segmentCount = (table.baseRows + LHASH_SEGMENT_ROWS - 1)
+			/ LHASH_SEGMENT_ROWS;
+	table.directoryLength = segmentCount << 1;
+	hash = Sdr_malloc(file, line, sdrv, sizeof(LhashTable));
+	table.directory = Sdr_malloc(file, line, sdrv,
+			table.directoryLength * sizeof(Object));
+	if (hash == 0 || table.directory == 0)
+	{
+		oK(_iEnd(file, line, "hash"));
+		return 0;
+	}
+
+	for (i = 0; i < table.directoryLength; i++)
+	{
+		segment = 0;
+		if (i < segmentCount)
+		{
+			segment = createLhashSegment(file, line, sdrv);
+			if (segment == 0)
+			{
+				oK(_iEnd(file, line, "segment"));
+				return 0;
+			}
+		}
+
+		sdrPut(table.directory + (i * sizeof(Object)), segment);
+	}
+
+	sdrPut(hash, table);
+	return hash;
+}
+
+int	Sdr_lhash_insert(const char *file, int line, Sdr sdrv, Object hash,
+		char *key, int keyLength, Address value, Object *entry)
+{
+	LhashTable	table;
+	Address		rowAddr;
+	Object		prevEntry;
+	LhashEntry	entryBuf;
+	Object		newEntry;
+
+	if (entry)
+	{
+		*entry = 0;	/*	Default result.			*/
+	}
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return -1;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (hash == 0 || key == NULL || keyLength < 1
+	|| keyLength > SDR_LHASH_MAX_KEY_LEN)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return -1;
+	}
+
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	if (locateLhashEntry(sdrv, &table, key, keyLength, &rowAddr,
+			&prevEntry, &entryBuf))
+	{
+		return 0;	/*	Duplicate key, can't insert.	*/
+	}
+
+	newEntry = Sdr_malloc(file, line, sdrv,
+			sizeof(LhashEntry) + keyLength);
+	if (newEntry == 0)
+	{
+		oK(_iEnd(file, line, "newEntry"));
+		return -1;
+	}
+
+	/*	New entry becomes the first entry in its row.		*/
+
+	sdr_read(sdrv, (char *) &entryBuf.next, rowAddr, sizeof(Object));
+	entryBuf.value = value;
+	entryBuf.hashValue = computeHashValue(key, keyLength);
+	entryBuf.keyLength = keyLength;
+	sdrPut(newEntry, entryBuf);
+	_sdrput(file, line, sdrv, newEntry + sizeof(LhashEntry), key,
+			keyLength, SystemPut);
+	sdrPut(rowAddr, newEntry);
+	table.entries++;
+
+	/*	Split one row if the table is now overloaded.		*/
+
+	if (table.entries > (table.baseRows + table.nextSplit)
+			* table.maxSearchLength)
+	{
+		if (splitLhashRow(file, line, sdrv, &table) < 0)
+		{
+			oK(_iEnd(file, line, "split"));
+			return -1;
+		}
+	}
+
+	sdrPut(hash, table);
+	if (entry)
+	{
+		*entry = newEntry;
+	}
+
+	return 1;		/*	Succeeded.			*/
+}
+
+int	Sdr_lhash_delete_entry(const char *file, int line, Sdr sdrv,
+		Object hash, Object entry)
+{
+	LhashTable	table;
+	LhashEntry	entryBuf;
+	Address		rowAddr;
+	Object		prevEntry = 0;
+	Object		elt;
+	LhashEntry	eltBuf;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return -1;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (hash == 0 || entry == 0)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return -1;
+	}
+
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	sdr_read(sdrv, (char *) &entryBuf, entry, sizeof(LhashEntry));
+	rowAddr = getLhashRowAddr(sdrv, &table,
+			computeLhashRow(&table, entryBuf.hashValue));
+	sdr_read(sdrv, (char *) &elt, rowAddr, sizeof(Object));
+	while (elt != entry)
+	{
+		if (elt == 0)
+		{
+			oK(_xniEnd(file, line, "entry", sdrv));
+			return -1;
+		}
+
+		sdr_read(sdrv, (char *) &eltBuf, elt, sizeof(LhashEntry));
+		prevEntry = elt;
+		elt = eltBuf.next;
+	}
+
+	unlinkLhashEntry(file, line, sdrv, rowAddr, prevEntry, &entryBuf);
+	Sdr_free(file, line, sdrv, entry);
+	table.entries--;
+	sdrPut(hash, table);
+	return 1;
+}
+
+Address	sdr_lhash_entry_value(Sdr sdrv, Object hash, Object entry)
+{
+	LhashEntry	entryBuf;
+
+	CHKERR(sdrFetchSafe(sdrv));
+	CHKERR(entry);
+	sdr_read(sdrv, (char *) &entryBuf, entry, sizeof(LhashEntry));
+	return entryBuf.value;
+}
+
+int	sdr_lhash_retrieve(Sdr sdrv, Object hash, char *key, int keyLength,
+		Address *value, Object *entry)
+{
+	LhashTable	table;
+	Address		rowAddr;
+	Object		prevEntry;
+	LhashEntry	entryBuf;
+	Object		elt;
+
+	if (entry)
+	{
+		*entry = 0;	/*	Default result.			*/
+	}
+
+	CHKERR(sdrFetchSafe(sdrv));
+	CHKERR(hash);
+	CHKERR(key);
+	CHKERR(keyLength > 0 && keyLength <= SDR_LHASH_MAX_KEY_LEN);
+	CHKERR(value);
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	elt = locateLhashEntry(sdrv, &table, key, keyLength, &rowAddr,
+			&prevEntry, &entryBuf);
+	if (elt == 0)
+	{
+		return 0;	/*	Unable to retrieve value.	*/
+	}
+
+	*value = entryBuf.value;
+	if (entry)
+	{
+		*entry = elt;
+	}
+
+	return 1;		/*	Got it.				*/
+}
+
+int	sdr_lhash_count(Sdr sdrv, Object hash)
+{
+	LhashTable	table;
+
+	CHKERR(sdrv);
+	CHKERR(hash);
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	return table.entries;
+}
+
+int	sdr_lhash_stats(Sdr sdrv, Object hash, SdrLhashStats *stats)
+{
+	LhashTable	table;
+	unsigned int	row;
+	Object		entry;
+	LhashEntry	entryBuf;
+	unsigned int	chainLength;
+
+	CHKERR(sdrFetchSafe(sdrv));
+	CHKERR(hash);
+	CHKERR(stats);
+	memset((char *) stats, 0, sizeof(SdrLhashStats));
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	stats->rows = table.baseRows + table.nextSplit;
+	for (row = 0; row < stats->rows; row++)
+	{
+		chainLength = 0;
+		sdr_read(sdrv, (char *) &entry, getLhashRowAddr(sdrv, &table,
+				row), sizeof(Object));
+		while (entry)
+		{
+			chainLength++;
+			sdr_read(sdrv, (char *) &entryBuf, entry,
+					sizeof(LhashEntry));
+			entry = entryBuf.next;
+		}
+
+		stats->entries += chainLength;
+		if (chainLength == 0)
+		{
+			stats->emptyRows++;
+		}
+
+		if (chainLength > stats->longestChain)
+		{
+			stats->longestChain = chainLength;
+		}
+	}
+
+	stats->loadFactor = ((double) (stats->entries)) / stats->rows;
+	return 0;
+}
+
+int	sdr_lhash_foreach(Sdr sdrv, Object hash, sdr_lhash_callback callback,
+		void *args)
+{
+	LhashTable	table;
+	unsigned int	rows;
+	unsigned int	row;
+	Object		entry;
+	LhashEntry	entryBuf;
+	char		keyBuf[SDR_LHASH_MAX_KEY_LEN];
+
+	CHKERR(sdrFetchSafe(sdrv));
+	CHKERR(hash);
+	CHKERR(callback);
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	rows = table.baseRows + table.nextSplit;
+	for (row = 0; row < rows; row++)
+	{
+		sdr_read(sdrv, (char *) &entry, getLhashRowAddr(sdrv, &table,
+				row), sizeof(Object));
+		while (entry)
+		{
+			sdr_read(sdrv, (char *) &entryBuf, entry,
+					sizeof(LhashEntry));
+			sdr_read(sdrv, keyBuf, entry + sizeof(LhashEntry),
+					entryBuf.keyLength);
+			callback(sdrv, hash, keyBuf, entryBuf.keyLength,
+					entryBuf.value, args);
+			entry = entryBuf.next;
+		}
+	}
+
+	return 0;
+}
+
+int	Sdr_lhash_revise(const char *file, int line, Sdr sdrv, Object hash,
+		char *key, int keyLength, Address value)
+{
+	LhashTable	table;
+	Address		rowAddr;
+	Object		prevEntry;
+	LhashEntry	entryBuf;
+	Object		entry;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return -1;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (hash == 0 || key == NULL || keyLength < 1
+	|| keyLength > SDR_LHASH_MAX_KEY_LEN)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return -1;
+	}
+
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	entry = locateLhashEntry(sdrv, &table, key, keyLength, &rowAddr,
+			&prevEntry, &entryBuf);
+	if (entry == 0)
+	{
+		return 0;	/*	Unable to revise value.		*/
+	}
+
+	entryBuf.value = value;
+	sdrPut(entry, entryBuf);
+	return 1;		/*	Succeeded.			*/
+}
+
+int	Sdr_lhash_remove(const char *file, int line, Sdr sdrv, Object hash,
+		char *key, int keyLength, Address *value)
+{
+	LhashTable	table;
+	Address		rowAddr;
+	Object		prevEntry;
+	LhashEntry	entryBuf;
+	Object		entry;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return -1;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (hash == 0 || key == NULL || keyLength < 1
+	|| keyLength > SDR_LHASH_MAX_KEY_LEN)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return -1;
+	}
+
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	entry = locateLhashEntry(sdrv, &table, key, keyLength, &rowAddr,
+			&prevEntry, &entryBuf);
+	if (entry == 0)
+	{
+		return 0;	/*	Unable to remove entry.		*/
+	}
+
+	if (value)
+	{
+		*value = entryBuf.value;
+	}
+
+	unlinkLhashEntry(file, line, sdrv, rowAddr, prevEntry, &entryBuf);
+	Sdr_free(file, line, sdrv, entry);
+	table.entries--;
+	sdrPut(hash, table);
+	return 1;		/*	Succeeded.			*/
+}
+
+void	Sdr_lhash_destroy(const char *file, int line, Sdr sdrv, Object hash)
+{
+	LhashTable	table;
+	unsigned int	rows;
+	unsigned int	row;
+	Object		entry;
+	LhashEntry	entryBuf;
+	unsigned int	i;
+	Object		segment;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (hash == 0)
+	{
+		oK(_xniEnd(file, line, "hash", sdrv));
+		return;
+	}
+
+	sdr_read(sdrv, (char *) &table, hash, sizeof(LhashTable));
+	rows = table.baseRows + table.nextSplit;
+	for (row = 0; row < rows; row++)
+	{
+		sdr_read(sdrv, (char *) &entry, getLhashRowAddr(sdrv, &table,
+				row), sizeof(Object));
+		while (entry)
+		{
+			sdr_read(sdrv, (char *) &entryBuf, entry,
+					sizeof(LhashEntry));
+			Sdr_free(file, line, sdrv, entry);
+			entry = entryBuf.next;
+		}
+	}
+
+	for (i = 0; i < table.directoryLength; i++)
+	{
+		sdr_read(sdrv, (char *) &segment, table.directory
+				+ (i * sizeof(Object)), sizeof(Object));
+		if (segment)
+		{
+			Sdr_free(file, line, sdrv, segment);
+		}
+	}
+
+	Sdr_free(file, line, sdrv, table.directory);
+	Sdr_free(file, line, sdrv, hash);
+}
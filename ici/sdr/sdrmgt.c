@@ -25,12 +25,6 @@
 #include "lyst.h"
 #include "sdrmgt.h"
 
-typedef struct
-{
-	Address		from;	/*	1st byte of object		*/
-	Address		to;	/*	1st byte beyond scope of object	*/
-} ObjectExtent;
-
 /*		--	SDR space management stuff.	--		*/
 
 #if SPACE_ORDER == 3
@@ -173,19 +167,85 @@ static ObjectScale	scaleOf(Sdr sdrv, Address addr, Ohd *ohd)
 	return NotAnObject;
 }
 
-static LystElt	noteKnownObject(Sdr sdrv, Address from, Address to)
+static int	findKnownObject(Sdr sdrv, Address addr)
+{
+	ObjectExtent	*extents = sdrv->knownObjects;
+	int		lower = 0;
+	int		upper = sdrv->knownObjectsCount;
+	int		middle;
+
+	/*	Returns the index of the last known object whose first
+	 *	byte is at or before addr, or -1 if there is none.	*/
+
+	while (lower < upper)
+	{
+		middle = lower + ((upper - lower) >> 1);
+		if (extents[middle].from <= addr)
+		{
+			lower = middle + 1;
+		}
+		else
+		{
+			upper = middle;
+		}
+	}
+
+	return lower - 1;
+}
+
+static int	noteKnownObject(Sdr sdrv, Address from, Address to)
 {
-	ObjectExtent	*extent;
+	int		i;
+	int		newLimit;
+	ObjectExtent	*newExtents;
 
-	extent = (ObjectExtent *) MTAKE(sizeof(ObjectExtent));
-	if (extent == NULL)
+	i = findKnownObject(sdrv, from);
+	if (i >= 0 && sdrv->knownObjects[i].from == from)
 	{
-		return NULL;
+		return 0;		/*	Already known.		*/
+	}
+
+	i++;				/*	Insertion point.	*/
+	if (sdrv->knownObjectsCount == sdrv->knownObjectsLimit)
+	{
+		newLimit = sdrv->knownObjectsLimit * 2;
+		newExtents = (ObjectExtent *)
+				MTAKE(newLimit * sizeof(ObjectExtent));
+		if (newExtents == NULL)
+		{
+			return -1;
+		}
+
+		memcpy((char *) newExtents, (char *) sdrv->knownObjects,
+				sdrv->knownObjectsCount * sizeof(ObjectExtent));
+		MRELEASE(sdrv->knownObjects);
+		sdrv->knownObjects = newExtents;
+		sdrv->knownObjectsLimit = newLimit;
 	}
 
-	extent->from = from;
-	extent->to = to;
-	return lyst_insert_last(sdrv->knownObjects, extent);
+	memmove((char *) (sdrv->knownObjects + i + 1),
+			(char *) (sdrv->knownObjects + i),
+			(sdrv->knownObjectsCount - i) * sizeof(ObjectExtent));
+	sdrv->knownObjects[i].from = from;
+	sdrv->knownObjects[i].to = to;
+	sdrv->knownObjectsCount++;
+	return 0;
+}
+
+static void	forgetKnownObject(Sdr sdrv, Address from)
+{
+	int	i;
+
+	i = findKnownObject(sdrv, from);
+	if (i < 0 || sdrv->knownObjects[i].from != from)
+	{
+		return;			/*	Not known.		*/
+	}
+
+	sdrv->knownObjectsCount--;
+	memmove((char *) (sdrv->knownObjects + i),
+			(char *) (sdrv->knownObjects + i + 1),
+			(sdrv->knownObjectsCount - i) * sizeof(ObjectExtent));
 }
 
 void	sdr_stage(Sdr sdrv, char *into, Object from, long length)
@@ -194,8 +254,6 @@ void	sdr_stage(Sdr sdrv, char *into, Object from, long length)
 	Address		addr = (Address) from;
 	Address		to;
 	Ohd		ohd;
-	LystElt		elt;
-	ObjectExtent	*extent;
 
 	CHKVOID(sdr_in_xn(sdrv));
 	XNCHKVOID(length == 0 || (length > 0 && into != NULL));
@@ -223,24 +281,11 @@ void	sdr_stage(Sdr sdrv, char *into, Object from, long length)
 		return;
 	}
 
-	for (elt = lyst_first(sdrv->knownObjects); elt; elt = lyst_next(elt))
-	{
-		extent = (ObjectExtent *) lyst_data(elt);
-		if (extent->from == addr)	/*	Already staged.	*/
-		{
-			break;
-		}
-	}
-
-	if (elt == 0)		/*	Not staged yet.			*/
+	if (noteKnownObject(sdrv, addr, addr + ohd.leading.userDataSize) < 0)
 	{
-		if (noteKnownObject(sdrv, addr,
-			addr + ohd.leading.userDataSize) == NULL)
-		{
-			putErrmsg(_noMemoryMsg(), NULL);
-			crashXn(sdrv);
-			return;
-		}
+		putErrmsg(_noMemoryMsg(), NULL);
+		crashXn(sdrv);
+		return;
 	}
 
 	/*	Length may be zero, in which case the object is just
@@ -712,7 +757,7 @@ Object	_sdrmalloc(Sdr sdrv, unsigned long nbytes)
 			addr = (Address) object;
 			oK(scaleOf(sdrv, addr, &ohd));
 			if (noteKnownObject(sdrv, addr,
-				addr + ohd.leading.userDataSize) == NULL)
+				addr + ohd.leading.userDataSize) < 0)
 			{
 				putErrmsg(_noMemoryMsg(), NULL);
 				crashXn(sdrv);
@@ -861,8 +906,6 @@ void	_sdrfree(Sdr sdrv, Object object, PutSrc src)
 	long		userDataWords;
 	long		i;
 	unsigned long	next;
-	LystElt		elt;
-	ObjectExtent	*extent;
 
 	CHKVOID(sdrv);
 	sdr = sdrv->sdr;
@@ -905,17 +948,7 @@ void	_sdrfree(Sdr sdrv, Object object, PutSrc src)
 		/*	Ensure object isn't in transaction's list of
 			knownObjects any more.				*/
 
-		for (elt = lyst_first(sdrv->knownObjects); elt;
-				elt = lyst_next(elt))
-		{
-			extent = (ObjectExtent *) lyst_data(elt);
-			if (addr == extent->from)
-			{
-				lyst_delete(elt);
-				break;
-			}
-		}
-
+		forgetKnownObject(sdrv, addr);
 		break;
 
 	default:
@@ -952,22 +985,20 @@ void	Sdr_free(const char *file, int line, Sdr sdrv, Object object)
 
 int	sdrBoundaryViolated(Sdr sdrv, Address from, long length)
 {
-	Address		to;
-	LystElt		elt;
-	ObjectExtent	*extent;
+	int	i;
+
+	/*	The only known object that might encompass this write
+		is the one that begins nearest to (but not after) the
+		first byte written.					*/
 
-	to = from + length;
-	for (elt = lyst_first(sdrv->knownObjects); elt; elt = lyst_next(elt))
+	i = findKnownObject(sdrv, from);
+	if (i >= 0 && sdrv->knownObjects[i].to >= from + length)
 	{
-		extent = (ObjectExtent *) lyst_data(elt);
-		if (extent->from <= from || extent->to >= to)
-		{
-			/*	First byte written is within this
-				object and the last byte written is
-				within the same object; write is okay.	*/
+		/*	First byte written is within this object
+			and the last byte written is within the
+			same object; write is okay.			*/
 
-			return 0;
-		}
+		return 0;
 	}
 
 	/*	No known object was found that encompasses this write.	*/
@@ -0,0 +1,847 @@
+/*
+ *	sdrwheel.c:	spacecraft data recorder timing wheel
+ *			management library.
+ *
+ *	Copyright (c) 2008, California Institute of Technology.
+ *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+ *	acknowledged.
+ *
+ *	The wheel is organized in the manner of the hierarchical
+ *	timer wheels of Varghese and Lauck: each of SDR_WHEEL_LEVELS
+ *	levels has SDR_WHEEL_SLOTS slots, each slot of level N spans
+ *	SDR_WHEEL_SLOTS ** N ticks, and an entry is placed in the
+ *	lowest level whose span covers the interval between the
+ *	wheel's cursor and the entry's expiration tick.  Whenever
+ *	the cursor crosses a slot boundary at some level, the
+ *	entries in the slot of the next higher level that has now
+ *	been reached are redistributed to lower levels.  A bitmap
+ *	of occupied slots per level enables the cursor to skip
+ *	over empty slots without examining them.
+ */
+
+#include "sdrP.h"
+#include "sdrwheel.h"
+
+#define	WHEEL_SLOT_BITS		6
+#define	WHEEL_SLOT_MASK		(SDR_WHEEL_SLOTS - 1)
+#define	WHEEL_SPAN_BITS		(WHEEL_SLOT_BITS * SDR_WHEEL_LEVELS)
+#define	WHEEL_OVERFLOW		(SDR_WHEEL_SLOTS * SDR_WHEEL_LEVELS)
+#define	WHEEL_SLOT_COUNT	(WHEEL_OVERFLOW + 1)
+
+/*		Private definitions of SDR timing wheel structures.	*/
+
+typedef struct
+{
+	Object		first;	/*	first entry in the slot		*/
+	Object		last;	/*	last entry in the slot		*/
+} WheelSlot;
+
+typedef struct
+{
+	unsigned int	resolution;	/*	milliseconds per tick	*/
+	uvast		current;	/*	cursor, in ticks	*/
+	unsigned long	length;		/*	number of entries	*/
+	unsigned long	overflowCount;
+	uvast		occupancy[SDR_WHEEL_LEVELS];	/*	bitmaps	*/
+	Object		slots;		/*	array of WheelSlot	*/
+} SdrWheel;
+
+typedef struct
+{
+	Object		wheel;	/*	wheel that this entry is in	*/
+	Address		data;	/*	data for this entry		*/
+	uvast		tick;	/*	expiration tick			*/
+	Object		prev;	/*	previous entry in slot		*/
+	Object		next;	/*	next entry in slot		*/
+	int		slot;	/*	index of slot in slots array	*/
+} SdrWheelEntry;
+
+/*	*	*	Timing wheel management functions	*	*/
+
+static uvast	wheel__ms(struct timeval *time)
+{
+	return ((uvast) time->tv_sec * 1000) + (time->tv_usec / 1000);
+}
+
+static void	wheel__time(SdrWheel *wheel, uvast tick, struct timeval *time)
+{
+	uvast	ms = tick * wheel->resolution;
+
+	time->tv_sec = ms / 1000;
+	time->tv_usec = (ms % 1000) * 1000;
+}
+
+static int	wheel__lowest_bit(uvast bits)
+{
+	int	i = 0;
+
+	while ((bits & 1) == 0)
+	{
+		bits >>= 1;
+		i++;
+	}
+
+	return i;
+}
+
+static int	wheel__slot_for(SdrWheel *wheel, uvast tick)
+{
+	uvast	delta;
+	int	level;
+	int	shift;
+
+	/*	An entry that is already due is placed in the slot
+	 *	at the cursor, so that it is reported promptly.		*/
+
+	if (tick < wheel->current)
+	{
+		tick = wheel->current;
+	}
+
+	delta = tick - wheel->current;
+	for (level = 0, shift = 0; level < SDR_WHEEL_LEVELS;
+			level++, shift += WHEEL_SLOT_BITS)
+	{
+		if (delta < ((uvast) 1 << (shift + WHEEL_SLOT_BITS)))
+		{
+			return (level * SDR_WHEEL_SLOTS)
+				+ ((tick >> shift) & WHEEL_SLOT_MASK);
+		}
+	}
+
+	return WHEEL_OVERFLOW;
+}
+
+static void	wheel__link(const char *file, int line, Sdr sdrv,
+			SdrWheel *wheel, Object entry,
+			SdrWheelEntry *entryBuffer, int slotIdx)
+{
+	Address		slotAddr;
+	WheelSlot	slot;
+	SdrWheelEntry	prevBuffer;
+
+	slotAddr = wheel->slots + (slotIdx * sizeof(WheelSlot));
+	sdrFetch(slot, slotAddr);
+	entryBuffer->slot = slotIdx;
+	entryBuffer->prev = slot.last;
+	entryBuffer->next = 0;
+	sdrPut((Address) entry, *entryBuffer);
+	if (slot.last)
+	{
+		sdrFetch(prevBuffer, (Address) slot.last);
+		prevBuffer.next = entry;
+		sdrPut((Address) slot.last, prevBuffer);
+	}
+	else
+	{
+		slot.first = entry;
+	}
+
+	slot.last = entry;
+	sdrPut(slotAddr, slot);
+	if (slotIdx == WHEEL_OVERFLOW)
+	{
+		wheel->overflowCount++;
+	}
+	else
+	{
+		wheel->occupancy[slotIdx / SDR_WHEEL_SLOTS] |=
+			((uvast) 1 << (slotIdx & WHEEL_SLOT_MASK));
+	}
+}
+
+static void	wheel__unlink(const char *file, int line, Sdr sdrv,
+			SdrWheel *wheel, SdrWheelEntry *entryBuffer)
+{
+	Address		slotAddr;
+	WheelSlot	slot;
+	SdrWheelEntry	nbrBuffer;
+
+	slotAddr = wheel->slots + (entryBuffer->slot * sizeof(WheelSlot));
+	sdrFetch(slot, slotAddr);
+	if (entryBuffer->prev)
+	{
+		sdrFetch(nbrBuffer, (Address) entryBuffer->prev);
+		nbrBuffer.next = entryBuffer->next;
+		sdrPut((Address) entryBuffer->prev, nbrBuffer);
+	}
+	else
+	{
+		slot.first = entryBuffer->next;
+	}
+
+	if (entryBuffer->next)
+	{
+		sdrFetch(nbrBuffer, (Address) entryBuffer->next);
+		nbrBuffer.prev = entryBuffer->prev;
+		sdrPut((Address) entryBuffer->next, nbrBuffer);
+	}
+	else
+	{
+		slot.last = entryBuffer->prev;
+	}
+
+	sdrPut(slotAddr, slot);
+	if (entryBuffer->slot == WHEEL_OVERFLOW)
+	{
+		wheel->overflowCount--;
+	}
+	else if (slot.first == 0)
+	{
+		wheel->occupancy[entryBuffer->slot / SDR_WHEEL_SLOTS] &=
+			~((uvast) 1 << (entryBuffer->slot & WHEEL_SLOT_MASK));
+	}
+}
+
+static void	wheel__cascade_slot(const char *file, int line, Sdr sdrv,
+			SdrWheel *wheel, int slotIdx)
+{
+	Address		slotAddr;
+	WheelSlot	slot;
+	Object		entry;
+	SdrWheelEntry	entryBuffer;
+	Object		next;
+
+	slotAddr = wheel->slots + (slotIdx * sizeof(WheelSlot));
+	sdrFetch(slot, slotAddr);
+	if (slot.first == 0)
+	{
+		return;
+	}
+
+	entry = slot.first;
+	slot.first = 0;
+	slot.last = 0;
+	sdrPut(slotAddr, slot);
+	if (slotIdx == WHEEL_OVERFLOW)
+	{
+		wheel->overflowCount = 0;
+	}
+	else
+	{
+		wheel->occupancy[slotIdx / SDR_WHEEL_SLOTS] &=
+			~((uvast) 1 << (slotIdx & WHEEL_SLOT_MASK));
+	}
+
+	while (entry)
+	{
+		sdrFetch(entryBuffer, (Address) entry);
+		next = entryBuffer.next;
+		wheel__link(file, line, sdrv, wheel, entry, &entryBuffer,
+				wheel__slot_for(wheel, entryBuffer.tick));
+		entry = next;
+	}
+}
+
+static void	wheel__cascade(const char *file, int line, Sdr sdrv,
+			SdrWheel *wheel)
+{
+	int	level;
+	int	shift;
+	int	idx;
+
+	/*	The cursor has just crossed a boundary of level 0, so
+	 *	entries in the newly reached slot of level 1 must be
+	 *	redistributed; if that slot is slot 0 then a boundary
+	 *	of level 1 has been crossed as well, and so on.		*/
+
+	for (level = 1, shift = WHEEL_SLOT_BITS; level < SDR_WHEEL_LEVELS;
+			level++, shift += WHEEL_SLOT_BITS)
+	{
+		idx = (wheel->current >> shift) & WHEEL_SLOT_MASK;
+		wheel__cascade_slot(file, line, sdrv, wheel,
+				(level * SDR_WHEEL_SLOTS) + idx);
+		if (idx != 0)
+		{
+			return;
+		}
+	}
+
+	wheel__cascade_slot(file, line, sdrv, wheel, WHEEL_OVERFLOW);
+}
+
+static uvast	wheel__next_stop(SdrWheel *wheel)
+{
+	int	level;
+	int	shift;
+	int	idx;
+	uvast	later;
+	uvast	base;
+
+	/*	Returns the earliest tick after the cursor at which
+	 *	an entry may be due or a non-empty slot must be
+	 *	cascaded.  Slots at or below the cursor's position
+	 *	in any level belong to the next rotation of that
+	 *	level, which begins at the next boundary of the
+	 *	level above it.						*/
+
+	for (level = 0, shift = 0; level < SDR_WHEEL_LEVELS;
+			level++, shift += WHEEL_SLOT_BITS)
+	{
+		idx = (wheel->current >> shift) & WHEEL_SLOT_MASK;
+		base = (wheel->current >> (shift + WHEEL_SLOT_BITS))
+				<< (shift + WHEEL_SLOT_BITS);
+		if (idx < WHEEL_SLOT_MASK)
+		{
+			later = wheel->occupancy[level] & (~((uvast) 0)
+					<< (idx + 1));
+			if (later)
+			{
+				return base + ((uvast) wheel__lowest_bit(later)
+						<< shift);
+			}
+		}
+
+		if (wheel->occupancy[level])
+		{
+			return base + ((uvast) 1 << (shift + WHEEL_SLOT_BITS));
+		}
+	}
+
+	return ((wheel->current >> WHEEL_SPAN_BITS) + 1) << WHEEL_SPAN_BITS;
+}
+
+static Object	wheel__expired(Sdr sdrv, SdrWheel *wheel, uvast limit)
+{
+	WheelSlot	slot;
+	Object		entry;
+	SdrWheelEntry	entryBuffer;
+
+	sdrFetch(slot, wheel->slots + ((wheel->current & WHEEL_SLOT_MASK)
+			* sizeof(WheelSlot)));
+	for (entry = slot.first; entry; entry = entryBuffer.next)
+	{
+		sdrFetch(entryBuffer, (Address) entry);
+		if (entryBuffer.tick <= limit)
+		{
+			return entry;
+		}
+	}
+
+	return 0;
+}
+
+static uvast	wheel__earliest(Sdr sdrv, SdrWheel *wheel, int idx)
+{
+	WheelSlot	slot;
+	Object		entry;
+	SdrWheelEntry	entryBuffer;
+	uvast		tick = wheel->current;
+
+	/*	Entries in the slot at the cursor expire in the
+	 *	cursor's tick, except for entries whose times had
+	 *	already been reached when they were inserted.		*/
+
+	sdrFetch(slot, wheel->slots + (idx * sizeof(WheelSlot)));
+	for (entry = slot.first; entry; entry = entryBuffer.next)
+	{
+		sdrFetch(entryBuffer, (Address) entry);
+		if (entryBuffer.tick < tick)
+		{
+			tick = entryBuffer.tick;
+		}
+	}
+
+	return tick;
+}
+
+Object	Sdr_wheel_create(const char *file, int line, Sdr sdrv,
+		unsigned int resolution)
+{
+	SdrWheel	wheelBuffer;
+	Object		wheel;
+	struct timeval	now;
+	WheelSlot	slot;
+	int		slotIdx;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (resolution == 0)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return 0;
+	}
+
+	memset((char *) &wheelBuffer, 0, sizeof(SdrWheel));
+	wheelBuffer.resolution = resolution;
+	getCurrentTime(&now);
+	wheelBuffer.current = wheel__ms(&now) / resolution;
+	wheelBuffer.slots = _sdrmalloc(sdrv,
+			WHEEL_SLOT_COUNT * sizeof(WheelSlot));
+	wheel = _sdrzalloc(sdrv, sizeof(SdrWheel));
+	if (wheelBuffer.slots == 0 || wheel == 0)
+	{
+		oK(_iEnd(file, line, "wheel"));
+		return 0;
+	}
+
+	slot.first = 0;
+	slot.last = 0;
+	for (slotIdx = 0; slotIdx < WHEEL_SLOT_COUNT; slotIdx++)
+	{
+		sdrPut(wheelBuffer.slots + (slotIdx * sizeof(WheelSlot)), slot);
+	}
+
+	sdrPut((Address) wheel, wheelBuffer);
+	return wheel;
+}
+
+Object	Sdr_wheel_insert(const char *file, int line, Sdr sdrv, Object wheel,
+		struct timeval *time, Address data)
+{
+	SdrWheel	wheelBuffer;
+	SdrWheelEntry	entryBuffer;
+	Object		entry;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (wheel == 0 || time == NULL)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return 0;
+	}
+
+	entry = _sdrzalloc(sdrv, sizeof(SdrWheelEntry));
+	if (entry == 0)
+	{
+		oK(_iEnd(file, line, "entry"));
+		return 0;
+	}
+
+	sdrFetch(wheelBuffer, (Address) wheel);
+
+	/*	Expiration tick is rounded up, so that no entry is
+	 *	ever reported as due before its expiration time.	*/
+
+	memset((char *) &entryBuffer, 0, sizeof(SdrWheelEntry));
+	entryBuffer.wheel = wheel;
+	entryBuffer.data = data;
+	entryBuffer.tick = (wheel__ms(time) + wheelBuffer.resolution - 1)
+			/ wheelBuffer.resolution;
+	wheel__link(file, line, sdrv, &wheelBuffer, entry, &entryBuffer,
+			wheel__slot_for(&wheelBuffer, entryBuffer.tick));
+	wheelBuffer.length++;
+	sdrPut((Address) wheel, wheelBuffer);
+	return entry;
+}
+
+void	Sdr_wheel_delete(const char *file, int line, Sdr sdrv, Object entry)
+{
+	SdrWheelEntry	entryBuffer;
+	SdrWheel	wheelBuffer;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (entry == 0)
+	{
+		oK(_xniEnd(file, line, "entry", sdrv));
+		return;
+	}
+
+	sdrFetch(entryBuffer, (Address) entry);
+	if (entryBuffer.wheel == 0)
+	{
+		oK(_xniEnd(file, line, "wheel", sdrv));
+		return;
+	}
+
+	sdrFetch(wheelBuffer, (Address) entryBuffer.wheel);
+	wheel__unlink(file, line, sdrv, &wheelBuffer, &entryBuffer);
+	wheelBuffer.length--;
+	sdrPut((Address) entryBuffer.wheel, wheelBuffer);
+
+	/* just in case user accesses later... */
+	memset((char *) &entryBuffer, 0, sizeof(SdrWheelEntry));
+	sdrPut((Address) entry, entryBuffer);
+	sdrFree(entry);
+}
+
+Object	Sdr_wheel_due(const char *file, int line, Sdr sdrv, Object wheel,
+		struct timeval *time)
+{
+	SdrWheel	wheelBuffer;
+	uvast		limit;
+	uvast		stop;
+	int		idx;
+	int		advanced = 0;
+	WheelSlot	slot;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (wheel == 0 || time == NULL)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return 0;
+	}
+
+	/*	The cursor is never advanced beyond the tick that
+	 *	contains the indicated time, so that an entry that
+	 *	is inserted later with an expiration time that has
+	 *	already been reached is reported by the next call.	*/
+
+	sdrFetch(wheelBuffer, (Address) wheel);
+	limit = wheel__ms(time) / wheelBuffer.resolution;
+	if (limit < wheelBuffer.current)
+	{
+		/*	The indicated time precedes the cursor (e.g.,
+		 *	the clock has been set back).  The only entries
+		 *	that can have expired are entries whose times
+		 *	had already been reached when they were
+		 *	inserted, which are in the slot at the cursor.	*/
+
+		return wheel__expired(sdrv, &wheelBuffer, limit);
+	}
+
+	slot.first = 0;
+	while (wheelBuffer.current <= limit)
+	{
+		idx = wheelBuffer.current & WHEEL_SLOT_MASK;
+		if (wheelBuffer.occupancy[0] & ((uvast) 1 << idx))
+		{
+			sdrFetch(slot, wheelBuffer.slots
+					+ (idx * sizeof(WheelSlot)));
+			break;
+		}
+
+		if (wheelBuffer.current == limit)
+		{
+			break;
+		}
+
+		advanced = 1;
+		if (wheelBuffer.length == 0)
+		{
+			wheelBuffer.current = limit;
+			break;
+		}
+
+		stop = wheel__next_stop(&wheelBuffer);
+		wheelBuffer.current = (stop < limit ? stop : limit);
+		if ((wheelBuffer.current & WHEEL_SLOT_MASK) == 0)
+		{
+			wheel__cascade(file, line, sdrv, &wheelBuffer);
+		}
+	}
+
+	if (advanced)
+	{
+		sdrPut((Address) wheel, wheelBuffer);
+	}
+
+	return slot.first;
+}
+
+Address	sdr_wheel_data(Sdr sdrv, Object entry)
+{
+	SdrWheelEntry	entryBuffer;
+
+	CHKZERO(entry);
+	sdrFetch(entryBuffer, (Address) entry);
+	return entryBuffer.data;
+}
+
+void	sdr_wheel_time(Sdr sdrv, Object entry, struct timeval *time)
+{
+	SdrWheelEntry	entryBuffer;
+	SdrWheel	wheelBuffer;
+
+	CHKVOID(entry);
+	CHKVOID(time);
+	sdrFetch(entryBuffer, (Address) entry);
+	sdrFetch(wheelBuffer, (Address) entryBuffer.wheel);
+	wheel__time(&wheelBuffer, entryBuffer.tick, time);
+}
+
+int	sdr_wheel_next_time(Sdr sdrv, Object wheel, struct timeval *time)
+{
+	SdrWheel	wheelBuffer;
+	int		idx;
+	uvast		tick;
+
+	CHKERR(sdrFetchSafe(sdrv));
+	CHKERR(wheel);
+	CHKERR(time);
+	sdrFetch(wheelBuffer, (Address) wheel);
+	if (wheelBuffer.length == 0)
+	{
+		return 0;
+	}
+
+	idx = wheelBuffer.current & WHEEL_SLOT_MASK;
+	if (wheelBuffer.occupancy[0] & ((uvast) 1 << idx))
+	{
+		tick = wheel__earliest(sdrv, &wheelBuffer, idx);
+	}
+	else
+	{
+		tick = wheel__next_stop(&wheelBuffer);
+	}
+
+	wheel__time(&wheelBuffer, tick, time);
+	return 1;
+}
+
+unsigned long	sdr_wheel_length(Sdr sdrv, Object wheel)
+{
+	SdrWheel	wheelBuffer;
+
+	CHKZERO(sdrFetchSafe(sdrv));
+	CHKZERO(wheel);
+	sdrFetch(wheelBuffer, (Address) wheel);
+	return wheelBuffer.length;
+}
+
+static Object	wheel__first_from(Sdr sdrv, Object wheel, int slotIdx)
+{
+	SdrWheel	wheelBuffer;
+	WheelSlot	slot;
+
+	sdrFetch(wheelBuffer, (Address) wheel);
+	for (; slotIdx < WHEEL_SLOT_COUNT; slotIdx++)
+	{
+		sdrFetch(slot, wheelBuffer.slots
+				+ (slotIdx * sizeof(WheelSlot)));
+		if (slot.first)
+		{
+			return slot.first;
+		}
+	}
+
+	return 0;
+}
+
+Object	sdr_wheel_first(Sdr sdrv, Object wheel)
+{
+	CHKZERO(sdrFetchSafe(sdrv));
+	CHKZERO(wheel);
+	return wheel__first_from(sdrv, wheel, 0);
+}
+
+Object	sdr_wheel_next(Sdr sdrv, Object entry)
+{
+	SdrWheelEntry	entryBuffer;
+
+	CHKZERO(sdrFetchSafe(sdrv));
+	CHKZERO(entry);
+	sdrFetch(entryBuffer, (Address) entry);
+	if (entryBuffer.next)
+	{
+		return entryBuffer.next;
+	}
+
+	return wheel__first_from(sdrv, entryBuffer.wheel,
+			entryBuffer.slot + 1);
+}
+
+void	Sdr_wheel_destroy(const char *file, int line, Sdr sdrv, Object wheel,
+		SdrWheelDeleteFn deleteFn, void *arg)
+{
+	SdrWheel	wheelBuffer;
+	int		slotIdx;
+	WheelSlot	slot;
+	Object		entry;
+	SdrWheelEntry	entryBuffer;
+	Object		next;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (wheel == 0)
+	{
+		oK(_xniEnd(file, line, "wheel", sdrv));
+		return;
+	}
+
+	sdrFetch(wheelBuffer, (Address) wheel);
+	for (slotIdx = 0; slotIdx < WHEEL_SLOT_COUNT; slotIdx++)
+	{
+		sdrFetch(slot, wheelBuffer.slots
+				+ (slotIdx * sizeof(WheelSlot)));
+		for (entry = slot.first; entry; entry = next)
+		{
+			sdrFetch(entryBuffer, (Address) entry);
+			next = entryBuffer.next;
+			if (deleteFn)
+			{
+				deleteFn(sdrv, entry, entryBuffer.data, arg);
+			}
+
+			/* just in case user mistakenly accesses later... */
+			memset((char *) &entryBuffer, 0,
+					sizeof(SdrWheelEntry));
+			sdrPut((Address) entry, entryBuffer);
+			sdrFree(entry);
+		}
+	}
+
+	sdrFree(wheelBuffer.slots);
+
+	/* just in case user mistakenly accesses later... */
+	memset((char *) &wheelBuffer, 0, sizeof(SdrWheel));
+	sdrPut((Address) wheel, wheelBuffer);
+	sdrFree(wheel);
+}
+
+/*	*	*	Timing wheel clock function	*	*	*	*/
+
+static int	wheel__dispatch(Sdr sdrv, Object wheel, int batchLimit,
+			SdrWheelEventFn eventFn, void *arg,
+			struct timeval *currentTime, struct timeval *wakeTime)
+{
+	int		batchSize = 0;
+	Object		entry;
+	struct timeval	nextTime;
+
+	CHKERR(sdr_begin_xn(sdrv));
+	while (1)
+	{
+		/*	Dispatch all due entries in a single transaction
+		 *	per batch, rather than one transaction apiece.	*/
+
+		if (batchSize == batchLimit)
+		{
+			if (sdr_end_xn(sdrv) < 0)
+			{
+				putErrmsg("Failed dispatching due entries.",
+						NULL);
+				return -1;
+			}
+
+			batchSize = 0;
+			CHKERR(sdr_begin_xn(sdrv));
+		}
+
+		entry = sdr_wheel_due(sdrv, wheel, currentTime);
+		if (entry == 0)	/*	No more entries to dispatch.	*/
+		{
+			break;
+		}
+
+		batchSize++;
+		if (eventFn(sdrv, entry, sdr_wheel_data(sdrv, entry),
+				currentTime, arg) < 0)
+		{
+			sdr_cancel_xn(sdrv);
+			putErrmsg("Failed handling due entry.", NULL);
+			return -1;
+		}
+	}
+
+	/*	Wake up in time for the next entry, if it is due
+	 *	before the time at which the clock would otherwise
+	 *	wake up.						*/
+
+	if (sdr_wheel_next_time(sdrv, wheel, &nextTime) == 1
+	&& (nextTime.tv_sec < wakeTime->tv_sec
+		|| (nextTime.tv_sec == wakeTime->tv_sec
+		&& nextTime.tv_usec < wakeTime->tv_usec)))
+	{
+		wakeTime->tv_sec = nextTime.tv_sec;
+		wakeTime->tv_usec = nextTime.tv_usec;
+	}
+
+	if (sdr_end_xn(sdrv) < 0)
+	{
+		putErrmsg("Failed dispatching due entries.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+int	sdr_wheel_run(Sdr sdrv, Object wheel, int batchLimit,
+		SdrWheelTimeFn timeFn, SdrWheelEventFn eventFn,
+		SdrWheelTickFn tickFn, SdrWheelRunningFn runningFn,
+		void *arg)
+{
+	struct timeval	currentTime;
+	struct timeval	wakeTime;
+	time_t		nextSecond;
+	long		interval;
+
+	CHKERR(sdrv);
+	CHKERR(wheel);
+	CHKERR(batchLimit > 0);
+	CHKERR(eventFn);
+	CHKERR(runningFn);
+	if (timeFn == NULL)
+	{
+		timeFn = getCurrentTime;
+	}
+
+	timeFn(&currentTime);
+	nextSecond = currentTime.tv_sec + 1;
+	wakeTime.tv_sec = nextSecond;
+	wakeTime.tv_usec = 0;
+	while (runningFn(arg))
+	{
+		/*	Sleep until the next entry is due or the next
+		 *	second begins, whichever is earlier.  An entry
+		 *	that is inserted in the meantime is dispatched
+		 *	no later than the start of the next second.	*/
+
+		timeFn(&currentTime);
+		interval = ((wakeTime.tv_sec - currentTime.tv_sec) * 1000000)
+				+ (wakeTime.tv_usec - currentTime.tv_usec);
+		if (interval > 1000000)
+		{
+			interval = 1000000;
+		}
+
+		if (interval > 0)
+		{
+			microsnooze(interval);
+		}
+
+		timeFn(&currentTime);
+		wakeTime.tv_sec = currentTime.tv_sec + 1;
+		wakeTime.tv_usec = 0;
+		if (currentTime.tv_sec >= nextSecond)
+		{
+			/*	Once per second, do the caller's
+			 *	periodic work before dispatching, so
+			 *	that the entries are handled in the
+			 *	light of its results.			*/
+
+			nextSecond = currentTime.tv_sec + 1;
+			if (tickFn && tickFn(sdrv, &currentTime, arg) < 0)
+			{
+				putErrmsg("Failed doing periodic work.", NULL);
+				return -1;
+			}
+		}
+
+		if (wheel__dispatch(sdrv, wheel, batchLimit, eventFn, arg,
+				&currentTime, &wakeTime) < 0)
+		{
+			putErrmsg("Can't dispatch due entries.", NULL);
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -27,6 +27,8 @@
 #endif
 
 static PsmPartition	_sdrwm(sm_WmParms *parms);
+static void		deleteReadersLock(SdrState *sdr);
+static int		flushDsBuffer(Sdr sdrv);
 
 #ifndef SDR_TRACE
 char	*_noTraceMsg()
@@ -184,6 +186,8 @@ static SdrControlHeader	*_sch(SdrControlHeader **schp)
 					sm_SemDelete(sdr->sdrSemaphore);
 					sdr->sdrSemaphore = SM_SEM_NONE;
 				}
+
+				deleteReadersLock(sdr);
 			}
 
 			sm_SemGive(lock);
@@ -386,7 +390,7 @@ SdrMap	*_mapImage(Sdr sdrv)
 {
 	static SdrMap	map;
 
-	if (sdrv->sdr->configFlags & SDR_IN_DRAM)
+	if (sdrv->sdr->configFlags & SDR_IN_MEMORY)
 	{
 		return (SdrMap *) (sdrv->dssm);
 	}
@@ -397,6 +401,94 @@ SdrMap	*_mapImage(Sdr sdrv)
 
 /*	*	Mutual exclusion functions	*	*	*	*/
 
+static SdrReader	*findReader(SdrState *sdr)
+{
+	int		task = sm_TaskIdSelf();
+	pthread_t	thread = pthread_self();
+	int		i;
+	SdrReader	*reader;
+
+	/*	Only the calling thread can add or remove its own
+	 *	entry in the readers table, so no lock is needed
+	 *	just to determine whether or not that entry exists.	*/
+
+	if (sdr->readerCount == 0)
+	{
+		return NULL;
+	}
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->readerTask == task
+		&& pthread_equal(reader->readerThread, thread))
+		{
+			return reader;
+		}
+	}
+
+	return NULL;
+}
+
+static void	endRead(SdrState *sdr, SdrReader *reader)
+{
+	oK(sm_SemTake(sdr->readersLock));
+	reader->readerTask = 0;
+	reader->readDepth = 0;
+	sdr->readerCount--;
+	sm_SemGive(sdr->readersLock);
+}
+
+static void	reapDeadReaders(SdrState *sdr)
+{
+	int		i;
+	SdrReader	*reader;
+
+	/*	A task that was terminated in the course of a read-
+	 *	only transaction can never end that transaction, so
+	 *	its entry must be removed by the writer that would
+	 *	otherwise wait for it forever.  Caller holds the
+	 *	readers lock.						*/
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->readerTask != 0
+		&& !sm_TaskExists(reader->readerTask))
+		{
+			reader->readerTask = 0;
+			reader->readDepth = 0;
+			sdr->readerCount--;
+		}
+	}
+}
+
+static int	waitForReaders(SdrState *sdr)
+{
+	/*	The caller holds the SDR's transaction semaphore, so
+	 *	no new read-only transaction can begin; we need only
+	 *	wait for all current readers to finish.  The readers
+	 *	table is polled, rather than awaited on a semaphore,
+	 *	so that a reader that is terminated while we wait is
+	 *	reaped as well.						*/
+
+	while (1)
+	{
+		if (sm_SemTake(sdr->readersLock) < 0)
+		{
+			return -1;
+		}
+
+		reapDeadReaders(sdr);
+		if (sdr->readerCount == 0)
+		{
+			sm_SemGive(sdr->readersLock);
+			return 0;
+		}
+
+		sm_SemGive(sdr->readersLock);
+		microsnooze(SDR_READER_POLL_INTERVAL);
+	}
+}
+
 static int	lockSdr(SdrState *sdr)
 {
 	if (sm_SemTake(sdr->sdrSemaphore) < 0)
@@ -404,6 +496,15 @@ static int	lockSdr(SdrState *sdr)
 		return -1;
 	}
 
+	if (sdr->readerCount > 0)
+	{
+		if (waitForReaders(sdr) < 0)
+		{
+			sm_SemGive(sdr->sdrSemaphore);
+			return -1;
+		}
+	}
+
 	sdr->sdrOwnerThread = pthread_self();
 	sdr->sdrOwnerTask = sm_TaskIdSelf();
 	sdr->xnDepth = 1;
@@ -425,6 +526,13 @@ int	takeSdr(SdrState *sdr)
 		return 0;		/*	Already taken.		*/
 	}
 
+	if (findReader(sdr))
+	{
+		putErrmsg("Can't begin update within read-only transaction.",
+				NULL);
+		return -1;
+	}
+
 	return lockSdr(sdr);
 }
 
@@ -723,11 +831,9 @@ static void	clearTransaction(Sdr sdrv)
 		}
 	}
 
-	if (sdrv->knownObjects)
-	{
-		lyst_clear(sdrv->knownObjects);
-	}
+	sdrv->knownObjectsCount = 0;
 
+	sdrv->dsBufLength = 0;
 	sdrv->sdr->logLength = 0;
 	sm_list_clear(_sdrwm(NULL), sdrv->sdr->logEntries, NULL, NULL);
 }
@@ -760,9 +866,11 @@ static void	terminateXn(Sdr sdrv)
 		return;
 	}
 
-	/*	Initiate cancellation procedure.			*/
+	/*	Initiate cancellation procedure.  Any dataspace file
+	 *	writes that were deferred are simply discarded.		*/
 
 	sdr->xnCanceled = 0;
+	sdrv->dsBufLength = 0;
 	if (!(sdr->configFlags & SDR_REVERSIBLE))
 	{
 		/*	Can't back out; if data modified, bail.	*/
@@ -1028,6 +1136,58 @@ static int	createDsFile(SdrState *sdr, char *dsfilename)
 	return dsfile;
 }
 
+static char	*mapDsFile(SdrState *sdr, char *name)
+{
+#ifdef MMAP_FILES
+	char		dsfilename[PATHLENMAX + 1 + 32 + 1 + 3 + 1];
+	int		dsfile;
+	struct stat	statbuf;
+	void		*dssm;
+
+	isprintf(dsfilename, sizeof dsfilename, "%s%c%s.sdr", sdr->pathName,
+			ION_PATH_DELIMITER, name);
+	dsfile = iopen(dsfilename, O_RDWR, 0777);
+	if (dsfile == -1)
+	{
+		putSysErrmsg("Can't open dataspace file", dsfilename);
+		return NULL;
+	}
+
+	/*	Any reference past the end of the file would be fatal,
+	 *	so the file must span the entire dataspace.		*/
+
+	if (fstat(dsfile, &statbuf) < 0 || statbuf.st_size < sdr->dsSize)
+	{
+		close(dsfile);
+		putErrmsg("Dataspace file is shorter than dataspace.",
+				dsfilename);
+		return NULL;
+	}
+
+	dssm = mmap(NULL, sdr->dsSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+			dsfile, 0);
+	close(dsfile);		/*	Mapping persists.		*/
+	if (dssm == MAP_FAILED)
+	{
+		putSysErrmsg("Can't map dataspace file", dsfilename);
+		return NULL;
+	}
+
+	return (char *) dssm;
+#else
+	putErrmsg("Memory-mapped SDR heap not supported on this platform.",
+			name);
+	return NULL;
+#endif
+}
+
+static void	unmapDsFile(SdrState *sdr, char *dssm)
+{
+#ifdef MMAP_FILES
+	oK(munmap(dssm, sdr->dsSize));
+#endif
+}
+
 static int	restageDsFromFile(SdrState *sdr, int dsfile, char *dssm)
 {
 	long	bytesRemaining = sdr->dsSize;
@@ -1056,6 +1216,28 @@ static int	restageDsFromFile(SdrState *sdr, int dsfile, char *dssm)
 	return 0;
 }
 
+static int	createReadersLock(SdrState *sdr)
+{
+	sdr->readersLock = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	if (sdr->readersLock == SM_SEM_NONE)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static void	deleteReadersLock(SdrState *sdr)
+{
+	if (sdr->readersLock != SM_SEM_NONE)
+	{
+		sm_SemDelete(sdr->readersLock);
+		sdr->readersLock = SM_SEM_NONE;
+	}
+
+	sdr->readerCount = 0;
+}
+
 static void	destroySdr(SdrState *sdr)
 {
 	sm_SemId	lock = _sdrlock(0);
@@ -1074,9 +1256,11 @@ static void	destroySdr(SdrState *sdr)
 		sm_SemDelete(sdr->sdrSemaphore);
 	}
 
+	deleteReadersLock(sdr);
+
 	/*	Destroy file copy of dataspace if any.			*/
 
-	if (sdr->configFlags & SDR_IN_FILE)
+	if (sdr->configFlags & (SDR_IN_FILE | SDR_IN_MMAP))
 	{
 		isprintf(dsfilename, sizeof dsfilename, "%s%c%s.sdr",
 				sdr->pathName, ION_PATH_DELIMITER, sdr->name);
@@ -1170,14 +1354,30 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 	CHKERR(heapWords >= 0);
 	CHKERR(logSize >= 0);
 	CHKERR(pathName);
-	if (!(configFlags & SDR_IN_DRAM || configFlags & SDR_IN_FILE))
+	if (!(configFlags & SDR_IN_DRAM || configFlags & SDR_IN_FILE
+	|| configFlags & SDR_IN_MMAP))
 	{
 		putErrmsg("No SDR heap site specified in configFlags.",
 				itoa(configFlags));
 		return -1;
 	}
+
+	if (configFlags & SDR_IN_MMAP)
+	{
+#ifndef MMAP_FILES
+		putErrmsg("Memory-mapped SDR heap not supported on this \
+platform.", itoa(configFlags));
+		return -1;
+#endif
+		if (configFlags & (SDR_IN_DRAM | SDR_IN_FILE))
+		{
+			putErrmsg("SDR_IN_MMAP can't be combined with \
+SDR_IN_DRAM or SDR_IN_FILE.", itoa(configFlags));
+			return -1;
+		}
+	}
 #if (HEAP_PTRS)
-	if (!(configFlags & SDR_IN_DRAM))
+	if (!(configFlags & SDR_IN_MEMORY))
 	{
 		putErrmsg("When ION is compiled to use pointers to retrieve \
 SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
@@ -1260,6 +1460,15 @@ SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
 	}
 
 	sdr->sdrOwnerTask = -1;
+	sdr->readersLock = SM_SEM_NONE;
+	if (createReadersLock(sdr) < 0)
+	{
+		putErrmsg("Can't create read-only transaction semaphore.",
+				NULL);
+		destroySdr(sdr);		/*	Releases lock.	*/
+		return -1;
+	}
+
 	sdr->logEntries = sm_list_create(sdrwm);
 	if (sdr->logEntries == 0)
 	{
@@ -1275,6 +1484,14 @@ SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
 	if (stat(sdr->pathName, &statbuf) < 0
 	|| (statbuf.st_mode & S_IFDIR) == 0)
 	{
+		if (sdr->configFlags & SDR_IN_MMAP)
+		{
+			putErrmsg("No such directory for memory-mapped \
+dataspace file.", sdr->pathName);
+			destroySdr(sdr);	/*	Releases lock.	*/
+			return -1;
+		}
+
 		writeMemoNote("[?] No such directory; disabling heap residence \
 in file and transaction reversibility", sdr->pathName);
 		sdr->configFlags &= (~SDR_IN_FILE); 
@@ -1345,7 +1562,7 @@ in file and transaction reversibility", sdr->pathName);
 		}
 	}
 
-	if (sdr->configFlags & SDR_IN_FILE)
+	if (sdr->configFlags & (SDR_IN_FILE | SDR_IN_MMAP))
 	{
 		isprintf(dsfilename, sizeof dsfilename, "%s%c%s.sdr",
 				sdr->pathName, ION_PATH_DELIMITER, name);
@@ -1513,6 +1730,7 @@ int	sdr_reload_profile(char *name, int configFlags, long heapWords,
 		 *	that is currently in progress.			*/
 
 		sm_SemDelete(sdr->sdrSemaphore);
+		deleteReadersLock(sdr);
 		psm_free(sdrwm, sdrAddress);
 		oK(sm_list_delete(sdrwm, elt, NULL, NULL));
 	}
@@ -1524,11 +1742,6 @@ int	sdr_reload_profile(char *name, int configFlags, long heapWords,
 			logKey, pathName, restartCmd);
 }
 
-static void	deleteObjectExtent(LystElt elt, void *userData)
-{
-	MRELEASE(lyst_data(elt));
-}
-
 Sdr	Sdr_start_using(char *name)
 {
 	sm_SemId		lock = _sdrlock(0);
@@ -1611,6 +1824,17 @@ Sdr	Sdr_start_using(char *name)
 		}
 	}
 
+	if (sdr->configFlags & SDR_IN_MMAP)
+	{
+		sdrv->dssm = mapDsFile(sdr, name);
+		if (sdrv->dssm == NULL)
+		{
+			sm_SemGive(lock);
+			putErrmsg("Can't map dataspace file.", name);
+			return NULL;
+		}
+	}
+
 	if (sdr->configFlags & SDR_REVERSIBLE)
 	{
 		if (sdr->logSize == 0)	/*	Log is in a file.	*/
@@ -1649,15 +1873,28 @@ Sdr	Sdr_start_using(char *name)
 
 	if (sdr->configFlags & SDR_BOUNDED)
 	{
-		sdrv->knownObjects = lyst_create_using(_sdrMemory(NULL));
-		if (sdrv->knownObjects == 0)
+		sdrv->knownObjects = (ObjectExtent *)
+			MTAKE(SDR_KNOWN_OBJECTS * sizeof(ObjectExtent));
+		if (sdrv->knownObjects == NULL)
 		{
 			sm_SemGive(lock);
 			putErrmsg(_noMemoryMsg(), NULL);
 			return NULL;
 		}
 
-		lyst_delete_set(sdrv->knownObjects, deleteObjectExtent, NULL);
+		sdrv->knownObjectsCount = 0;
+		sdrv->knownObjectsLimit = SDR_KNOWN_OBJECTS;
+	}
+
+	if ((sdr->configFlags & SDR_IN_DRAM) && (sdr->configFlags & SDR_IN_FILE))
+	{
+		sdrv->dsBuffer = MTAKE(SDR_DS_BUFSIZE);
+		if (sdrv->dsBuffer == NULL)
+		{
+			sm_SemGive(lock);
+			putErrmsg(_noMemoryMsg(), NULL);
+			return NULL;
+		}
 	}
 
 	sdrv->trace = NULL;
@@ -1682,6 +1919,7 @@ long	sdr_heap_size(Sdr sdrv)
 void	sdr_stop_using(Sdr sdrv)
 {
 	PsmPartition	sdrwm = _sdrwm(NULL);
+	SdrReader	*reader;
 
 	CHKVOID(sdrv);
 
@@ -1694,6 +1932,12 @@ void	sdr_stop_using(Sdr sdrv)
 		crashXn(sdrv);
 	}
 
+	reader = findReader(sdrv->sdr);
+	if (reader)
+	{
+		endRead(sdrv->sdr, reader);
+	}
+
 	/*	Terminate all local SDR state and destroy the Sdr.	*/
 
 	if (sdrv->dsfile != -1)
@@ -1703,7 +1947,14 @@ void	sdr_stop_using(Sdr sdrv)
 
 	if (sdrv->dssm)
 	{
-		sm_ShmDetach(sdrv->dssm);
+		if (sdrv->sdr->configFlags & SDR_IN_MMAP)
+		{
+			unmapDsFile(sdrv->sdr, sdrv->dssm);
+		}
+		else
+		{
+			sm_ShmDetach(sdrv->dssm);
+		}
 	}
 
 	if (sdrv->logfile != -1)
@@ -1718,7 +1969,12 @@ void	sdr_stop_using(Sdr sdrv)
 
 	if (sdrv->knownObjects)
 	{
-		lyst_destroy(sdrv->knownObjects);
+		MRELEASE(sdrv->knownObjects);
+	}
+
+	if (sdrv->dsBuffer)
+	{
+		MRELEASE(sdrv->dsBuffer);
 	}
 
 	/*	Erase content of SdrView, in case space is re-used
@@ -1787,6 +2043,100 @@ int	sdr_begin_xn(Sdr sdrv)
 	return 1;		/*	Began transaction.		*/
 }
 
+int	sdr_begin_ro_xn(Sdr sdrv)
+{
+	SdrState	*sdr;
+	SdrReader	*reader;
+	int		i;
+
+	CHKZERO(sdrv);
+	sdr = sdrv->sdr;
+	if (sdr_in_xn(sdrv))
+	{
+		/*	Reading within an update transaction: just
+		 *	nest, as for any other transaction.		*/
+
+		sdr->xnDepth++;
+		return 1;
+	}
+
+	reader = findReader(sdr);
+	if (reader)
+	{
+		reader->readDepth++;
+		return 1;
+	}
+
+	/*	Taking the transaction semaphore assures that no
+	 *	update transaction is in progress; releasing it as
+	 *	soon as we are registered as a reader lets other
+	 *	readers in, while any writer that takes it next
+	 *	will wait for all registered readers to finish.		*/
+
+	if (sdr->sdrSemaphore == -1 || sm_SemEnded(sdr->sdrSemaphore)
+	|| sm_SemTake(sdr->sdrSemaphore) < 0)
+	{
+		return 0;	/*	Failed to begin transaction.	*/
+	}
+
+	if (sm_SemTake(sdr->readersLock) < 0)
+	{
+		sm_SemGive(sdr->sdrSemaphore);
+		return 0;	/*	Failed to begin transaction.	*/
+	}
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->readerTask == 0)
+		{
+			break;
+		}
+	}
+
+	if (i == SDR_MAX_READERS)
+	{
+		/*	Readers table is full; fall back to an
+		 *	ordinary, exclusive transaction.		*/
+
+		sm_SemGive(sdr->readersLock);
+		sm_SemGive(sdr->sdrSemaphore);
+		return sdr_begin_xn(sdrv);
+	}
+
+	reader->readerThread = pthread_self();
+	reader->readerTask = sm_TaskIdSelf();
+	reader->readDepth = 1;
+	sdr->readerCount++;
+	sm_SemGive(sdr->readersLock);
+	sm_SemGive(sdr->sdrSemaphore);
+	return 1;		/*	Began transaction.		*/
+}
+
+void	sdr_end_ro_xn(Sdr sdrv)
+{
+	SdrState	*sdr;
+	SdrReader	*reader;
+
+	CHKVOID(sdrv);
+	sdr = sdrv->sdr;
+	reader = findReader(sdr);
+	if (reader == NULL)
+	{
+		/*	Read-only transaction was nested within an
+		 *	update transaction, or else fell back to an
+		 *	exclusive transaction.				*/
+
+		sdr_exit_xn(sdrv);
+		return;
+	}
+
+	reader->readDepth--;
+	if (reader->readDepth == 0)
+	{
+		endRead(sdr, reader);
+	}
+}
+
 int	sdr_in_xn(Sdr sdrv)
 {
 	CHKZERO(sdrv);
@@ -1801,9 +2151,16 @@ int	sdr_heap_is_halted(Sdr sdrv)
 	return (sdrv->sdr != NULL && sdrv->sdr->halted);
 }
 
+int	sdr_in_ro_xn(Sdr sdrv)
+{
+	CHKZERO(sdrv);
+	return (sdrv->sdr != NULL && findReader(sdrv->sdr) != NULL);
+}
+
 int	sdrFetchSafe(Sdr sdrv)
 {
-	return (sdr_in_xn(sdrv) || sdr_heap_is_halted(sdrv));
+	return (sdr_in_xn(sdrv) || sdr_in_ro_xn(sdrv)
+			|| sdr_heap_is_halted(sdrv));
 }
 
 void	sdr_exit_xn(Sdr sdrv)
@@ -1862,6 +2219,18 @@ int	sdr_end_xn(Sdr sdrv)
 		sdr->xnDepth--;
 		if (sdr->xnDepth == 0)
 		{
+			if (sdr->xnCanceled == 0 && sdrv->dsBufLength > 0)
+			{
+				if (flushDsBuffer(sdrv) < 0)
+				{
+					putErrmsg("Can't commit transaction.",
+							NULL);
+					sdr->xnCanceled = 1;
+					terminateXn(sdrv);
+					return -1;
+				}
+			}
+
 			terminateXn(sdrv);
 		}
 
@@ -1893,7 +2262,7 @@ void	sdr_eject_xn(Sdr sdrv)
 void	*sdr_pointer(Sdr sdrv, Address address)
 {
 	CHKNULL(sdrv);
-	if ((sdrv->sdr->configFlags & SDR_IN_DRAM) == 0 || address <= 0)
+	if ((sdrv->sdr->configFlags & SDR_IN_MEMORY) == 0 || address <= 0)
 	{
 		return NULL;
 	}
@@ -1907,7 +2276,7 @@ Address	sdr_address(Sdr sdrv, void *pointer)
 
 	CHKZERO(sdrv);
 	ptr = (char *) pointer;
-	if ((sdrv->sdr->configFlags & SDR_IN_DRAM) == 0 || ptr <= sdrv->dssm)
+	if ((sdrv->sdr->configFlags & SDR_IN_MEMORY) == 0 || ptr <= sdrv->dssm)
 	{
 		return 0;
 	}
@@ -1971,6 +2340,118 @@ static int	writeToLog(const char *file, int line, Sdr sdrv, char *from,
 	return length;
 }
 
+static int	flushDsBuffer(Sdr sdrv)
+{
+	long	offset = 0;
+	DsWrite	dsw;
+
+	while (offset < sdrv->dsBufLength)
+	{
+		memcpy((char *) &dsw, sdrv->dsBuffer + offset, sizeof(DsWrite));
+		offset += sizeof(DsWrite);
+		if (lseek(sdrv->dsfile, dsw.into, SEEK_SET) < 0
+		|| write(sdrv->dsfile, sdrv->dsBuffer + offset, dsw.length)
+				< dsw.length)
+		{
+			sdrv->dsBufLength = 0;
+			putSysErrmsg("Can't write to dataspace", itoa(dsw.length));
+			return -1;
+		}
+
+		offset += dsw.length;
+	}
+
+	sdrv->dsBufLength = 0;
+	return 0;
+}
+
+static int	writeToDs(const char *file, int line, Sdr sdrv, Address into,
+			char *from, long length)
+{
+	DsWrite	dsw;
+
+	if (sdrv->dsBuffer == NULL)	/*	Dataspace is only in file.	*/
+	{
+		if (lseek(sdrv->dsfile, into, SEEK_SET) < 0
+		|| write(sdrv->dsfile, from, length) < length)
+		{
+			_putSysErrmsg(file, line, "Can't write to dataspace",
+					itoa(length));
+			return -1;
+		}
+
+		return 0;
+	}
+
+	/*	Dataspace is also in memory, so writing to the file
+	 *	can be deferred until the transaction is ended.  Note
+	 *	that the log entry for this write has already been
+	 *	written, so the deferred write can be flushed at any
+	 *	time without compromising transaction reversibility.	*/
+
+	if (sdrv->dsBufLength > 0)
+	{
+		memcpy((char *) &dsw, sdrv->dsBuffer + sdrv->lastDsWrite,
+				sizeof(DsWrite));
+		if (into >= dsw.into && into + length <= dsw.into + dsw.length)
+		{
+			/*	Overwrites data in the last extent.	*/
+
+			memcpy(sdrv->dsBuffer + sdrv->lastDsWrite
+				+ sizeof(DsWrite) + (into - dsw.into), from,
+				length);
+			return 0;
+		}
+
+		if (into == dsw.into + dsw.length
+		&& sdrv->dsBufLength + length <= SDR_DS_BUFSIZE)
+		{
+			/*	Extends the last extent.		*/
+
+			memcpy(sdrv->dsBuffer + sdrv->dsBufLength, from,
+					length);
+			sdrv->dsBufLength += length;
+			dsw.length += length;
+			memcpy(sdrv->dsBuffer + sdrv->lastDsWrite,
+					(char *) &dsw, sizeof(DsWrite));
+			return 0;
+		}
+	}
+
+	if (sdrv->dsBufLength + sizeof(DsWrite) + length > SDR_DS_BUFSIZE)
+	{
+		if (flushDsBuffer(sdrv) < 0)
+		{
+			return -1;
+		}
+
+		if (sizeof(DsWrite) + length > SDR_DS_BUFSIZE)
+		{
+			/*	Too large to buffer; write it now.	*/
+
+			if (lseek(sdrv->dsfile, into, SEEK_SET) < 0
+			|| write(sdrv->dsfile, from, length) < length)
+			{
+				_putSysErrmsg(file, line, "Can't write to \
+dataspace", itoa(length));
+				return -1;
+			}
+
+			return 0;
+		}
+	}
+
+	dsw.into = into;
+	dsw.length = length;
+	sdrv->lastDsWrite = sdrv->dsBufLength;
+	memcpy(sdrv->dsBuffer + sdrv->dsBufLength, (char *) &dsw,
+			sizeof(DsWrite));
+	sdrv->dsBufLength += sizeof(DsWrite);
+	memcpy(sdrv->dsBuffer + sdrv->dsBufLength, from, length);
+	sdrv->dsBufLength += length;
+	return 0;
+}
+
 void	_sdrput(const char *file, int line, Sdr sdrv, Address into, char *from,
 		long length, PutSrc src)
 {
@@ -1979,6 +2460,8 @@ void	_sdrput(const char *file, int line, Sdr sdrv, Address into, char *from,
 	unsigned long	logEntryControl[2];
 	char		*buffer;
 	long		logOffset;
+	char		smallEntry[sizeof logEntryControl
+					+ SDR_SMALL_LOG_ENTRY];
 
 	if (length == 0)
 	{
@@ -2008,7 +2491,51 @@ void	_sdrput(const char *file, int line, Sdr sdrv, Address into, char *from,
 		}
 	}
 
-	if (sdr->configFlags & SDR_REVERSIBLE)
+	if (sdr->configFlags & SDR_REVERSIBLE && length <= SDR_SMALL_LOG_ENTRY)
+	{
+		/*	Write the whole log entry in one operation.	*/
+
+		logOffset = sdr->logLength;	/*	Before writing.	*/
+		logEntryControl[0] = into;
+		logEntryControl[1] = length;
+		memcpy(smallEntry, (char *) logEntryControl,
+				sizeof logEntryControl);
+		buffer = smallEntry + sizeof logEntryControl;
+		if (sdr->configFlags & SDR_IN_MEMORY)
+		{
+			memcpy(buffer, sdrv->dssm + into, length);
+		}
+		else	/*	Dataspace is only in file.		*/
+		{
+			if (lseek(sdrv->dsfile, into, SEEK_SET) < 0
+			|| read(sdrv->dsfile, buffer, length) < length)
+			{
+				_putSysErrmsg(file, line, "Can't read old data",
+						itoa(length));
+				crashXn(sdrv);
+				return;
+			}
+		}
+
+		if (writeToLog(file, line, sdrv, smallEntry,
+				sizeof logEntryControl + length) < 0)
+		{
+			_putSysErrmsg(file, line, "Can't write log entry",
+					itoa(length));
+			crashXn(sdrv);
+			return;
+		}
+
+		if (sm_list_insert_last(_sdrwm(NULL), sdr->logEntries,
+				(PsmAddress) logOffset) == 0)
+		{
+			_putErrmsg(file, line, "Can't note transaction log \
+entry.", NULL);
+			crashXn(sdrv);
+			return;
+		}
+	}
+	else if (sdr->configFlags & SDR_REVERSIBLE)
 	{
 		logOffset = sdr->logLength;	/*	Before writing.	*/
 		logEntryControl[0] = into;
@@ -2022,7 +2549,7 @@ void	_sdrput(const char *file, int line, Sdr sdrv, Address into, char *from,
 			return;
 		}
 
-		if (sdr->configFlags & SDR_IN_DRAM)
+		if (sdr->configFlags & SDR_IN_MEMORY)
 		{
 			if (writeToLog(file, line, sdrv, sdrv->dssm + into,
 					length) < 0)
@@ -2080,17 +2607,14 @@ entry.", NULL);
 
 	if (sdr->configFlags & SDR_IN_FILE)
 	{
-		if (lseek(sdrv->dsfile, into, SEEK_SET) < 0
-		|| write(sdrv->dsfile, from, length) < length)
+		if (writeToDs(file, line, sdrv, into, from, length) < 0)
 		{
-			_putSysErrmsg(file, line, "Can't write to dataspace",
-					itoa(length));
 			crashXn(sdrv);
 			return;
 		}
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (sdr->configFlags & SDR_IN_MEMORY)
 	{
 		memcpy(sdrv->dssm + into, from, length);
 	}
@@ -2136,7 +2660,7 @@ void	_sdrfetch(Sdr sdrv, char *into, Address from, long length)
 		return;
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (sdr->configFlags & SDR_IN_MEMORY)
 	{
 		memcpy(into, sdrv->dssm + from, length);
 	}
@@ -2144,8 +2668,12 @@ void	_sdrfetch(Sdr sdrv, char *into, Address from, long length)
 	{
 		if (sdr->configFlags & SDR_IN_FILE)
 		{
-			if (lseek(sdrv->dsfile, from, SEEK_SET) < 0
-			|| read(sdrv->dsfile, into, length) < length)
+			/*	Several threads of this process may be
+			 *	fetching concurrently in read-only
+			 *	transactions, so the shared file offset
+			 *	must not be used.			*/
+
+			if (pread(sdrv->dsfile, into, length, from) < length)
 			{
 				putSysErrmsg("Dataspace read failed",
 						itoa(length));
@@ -0,0 +1,276 @@
+/*
+
+	sdnvbench.c:	a micro-benchmark comparing the performance of
+			the ION SDNV encoding and decoding functions
+			with that of the original byte-at-a-time
+			implementations, which are reproduced here
+			for reference.
+
+									*/
+/*									*/
+/*	Copyright (c) 2008, California Institute of Technology.		*/
+/*	All rights reserved.						*/
+/*									*/
+
+#include "platform.h"
+
+#define	DEFAULT_SDNV_COUNT	(1000000)
+#define	DEFAULT_CYCLES		(10)
+
+static void	refEncodeSdnv(Sdnv *sdnv, uvast val)
+{
+	static uvast	sdnvMask = ((uvast) -1) / 128;
+	uvast		remnant;
+	int		i;
+	unsigned char	flag = 0;
+	unsigned char	*text;
+
+	sdnv->length = 0;
+	remnant = val;
+	do
+	{
+		remnant = (remnant >> 7) & sdnvMask;
+		(sdnv->length)++;
+	} while (remnant > 0);
+
+	text = sdnv->text + sdnv->length;
+	i = sdnv->length;
+	remnant = val;
+	while (i > 0)
+	{
+		text--;
+		*text = (remnant & 0x7f) | flag;
+		remnant = (remnant >> 7) & sdnvMask;
+		flag = 0x80;
+		i--;
+	}
+}
+
+static int	refDecodeSdnv(uvast *val, unsigned char *sdnvTxt)
+{
+	int		sdnvLength = 0;
+	unsigned char	*cursor;
+
+	*val = 0;
+	cursor = sdnvTxt;
+	while (1)
+	{
+		sdnvLength++;
+		if (sdnvLength > 10)
+		{
+			return 0;
+		}
+
+		*val <<= 7;
+		*val |= (*cursor & 0x7f);
+		if ((*cursor & 0x80) == 0)
+		{
+			return sdnvLength;
+		}
+
+		cursor++;
+	}
+}
+
+/*	Values are drawn from a distribution weighted toward the
+ *	small numbers (flags, lengths, sequence numbers) that make up
+ *	the bulk of the SDNVs in real bundle and LTP segment headers,
+ *	with an admixture of large ones (node numbers, timestamps).	*/
+
+static uvast	randomValue()
+{
+	uvast	val = rand();
+	int	bits;
+
+	switch (rand() % 8)
+	{
+	case 0:
+	case 1:
+	case 2:
+		bits = 7;
+		break;
+
+	case 3:
+	case 4:
+		bits = 14;
+		break;
+
+	case 5:
+		bits = 21;
+		break;
+
+	case 6:
+		bits = 32;
+		break;
+
+	default:
+		bits = 8 * sizeof(uvast);
+		val = (val << 31) ^ rand();
+		val = (val << 31) ^ rand();
+	}
+
+	if (bits < 8 * sizeof(uvast))
+	{
+		val &= (((uvast) 1) << bits) - 1;
+	}
+
+	return val;
+}
+
+static long	elapsedUsec(struct timeval *start)
+{
+	struct timeval	done;
+
+	getCurrentTime(&done);
+	return ((done.tv_sec - start->tv_sec) * 1000000)
+			+ (done.tv_usec - start->tv_usec);
+}
+
+static void	report(char *label, long usec, int cycles, int count)
+{
+	double	nsec = (usec * 1000.0) / ((double) cycles * count);
+
+	printf("%-22s %10ld usec  %7.2f nsec/SDNV\n", label, usec, nsec);
+}
+
+#if defined (ION_LWT)
+int	sdnvbench(int a1, int a2, int a3, int a4, int a5,
+		int a6, int a7, int a8, int a9, int a10)
+{
+	int		count = a1 ? atoi((char *) a1) : DEFAULT_SDNV_COUNT;
+	int		cycles = a2 ? atoi((char *) a2) : DEFAULT_CYCLES;
+#else
+int	main(int argc, char **argv)
+{
+	int		count = argc > 1 ? atoi(argv[1]) : DEFAULT_SDNV_COUNT;
+	int		cycles = argc > 2 ? atoi(argv[2]) : DEFAULT_CYCLES;
+#endif
+	uvast		*values;
+	uvast		*decoded;
+	unsigned char	*text;
+	int		textLength = 0;
+	Sdnv		sdnv;
+	Sdnv		refSdnv;
+	struct timeval	start;
+	int		cycle;
+	int		i;
+	int		length;
+	unsigned char	*cursor;
+	uvast		val;
+	uvast		check = 0;
+
+	if (count < 1 || cycles < 1)
+	{
+		PUTS("Usage: sdnvbench [<number of SDNVs> [<cycles>]]");
+		return 0;
+	}
+
+	values = (uvast *) malloc(count * sizeof(uvast));
+	decoded = (uvast *) malloc(count * sizeof(uvast));
+	text = (unsigned char *) malloc(count * sizeof sdnv.text);
+	if (values == NULL || decoded == NULL || text == NULL)
+	{
+		PUTS("Can't allocate benchmark buffers.");
+		return 0;
+	}
+
+	srand(1);
+	for (i = 0; i < count; i++)
+	{
+		values[i] = randomValue();
+		encodeSdnv(&sdnv, values[i]);
+		memcpy(text + textLength, sdnv.text, sdnv.length);
+		textLength += sdnv.length;
+	}
+
+	printf("%d SDNVs (%d bytes), %d cycles\n", count, textLength, cycles);
+
+	/*	Encoding.						*/
+
+	getCurrentTime(&start);
+	for (cycle = 0; cycle < cycles; cycle++)
+	{
+		for (i = 0; i < count; i++)
+		{
+			refEncodeSdnv(&sdnv, values[i]);
+			check += sdnv.length;
+		}
+	}
+
+	report("encode (reference)", elapsedUsec(&start), cycles, count);
+	getCurrentTime(&start);
+	for (cycle = 0; cycle < cycles; cycle++)
+	{
+		for (i = 0; i < count; i++)
+		{
+			encodeSdnv(&sdnv, values[i]);
+			check += sdnv.length;
+		}
+	}
+
+	report("encodeSdnv", elapsedUsec(&start), cycles, count);
+
+	/*	Decoding.						*/
+
+	getCurrentTime(&start);
+	for (cycle = 0; cycle < cycles; cycle++)
+	{
+		cursor = text;
+		for (i = 0; i < count; i++)
+		{
+			cursor += refDecodeSdnv(&val, cursor);
+			check += val;
+		}
+	}
+
+	report("decode (reference)", elapsedUsec(&start), cycles, count);
+	getCurrentTime(&start);
+	for (cycle = 0; cycle < cycles; cycle++)
+	{
+		cursor = text;
+		for (i = 0; i < count; i++)
+		{
+			cursor += decodeSdnv(&val, cursor);
+			check += val;
+		}
+	}
+
+	report("decodeSdnv", elapsedUsec(&start), cycles, count);
+	getCurrentTime(&start);
+	for (cycle = 0; cycle < cycles; cycle++)
+	{
+		length = decodeSdnvArray(decoded, count, text, textLength);
+		check += decoded[count - 1];
+	}
+
+	report("decodeSdnvArray", elapsedUsec(&start), cycles, count);
+
+	/*	Verification.						*/
+
+	if (length != textLength)
+	{
+		printf("decodeSdnvArray decoded %d bytes, not %d.\n", length,
+				textLength);
+	}
+
+	cursor = text;
+	for (i = 0; i < count; i++)
+	{
+		cursor += decodeSdnv(&val, cursor);
+		refEncodeSdnv(&refSdnv, values[i]);
+		encodeSdnv(&sdnv, values[i]);
+		if (val != values[i] || decoded[i] != values[i]
+		|| sdnv.length != refSdnv.length
+		|| memcmp(sdnv.text, refSdnv.text, sdnv.length) != 0)
+		{
+			printf("Mismatch at SDNV %d.\n", i);
+			break;
+		}
+	}
+
+	printf("(checksum " UVAST_FIELDSPEC ")\n", check);
+	free(values);
+	free(decoded);
+	free(text);
+	return 0;
+}
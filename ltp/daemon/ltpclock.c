@@ -10,6 +10,10 @@
 									*/
 #include "ltpP.h"
 
+#ifndef LTP_CLOCK_BATCH
+#define	LTP_CLOCK_BATCH	(64)	/*	Events per transaction.		*/
+#endif
+
 static int	_running(long *newValue)
 {
 	void	*value;
@@ -35,78 +39,54 @@ static void	shutDown()	/*	Commands ltpclock termination.	*/
 	oK(_running(&stop));	/*	Terminates ltpclock.		*/
 }
 
-static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
+static int	isRunning(void *arg)
+{
+	return (_running(NULL) != 0);
+}
+
+static int	dispatchEvent(Sdr sdr, Object entry, Address eventObj,
+			struct timeval *currentTime, void *arg)
 {
-	Object		elt;
-	Object		eventObj;
 	LtpEvent	event;
 	int		result;
 
-	while (1)
+	sdr_read(sdr, (char *) &event, (Object) eventObj, sizeof(LtpEvent));
+	destroyLtpTimelineEvent(entry);
+	switch (event.type)
 	{
-		CHKERR(sdr_begin_xn(sdr));
-		elt = sdr_list_first(sdr, events);
-		if (elt == 0)	/*	No more events to dispatch.	*/
-		{
-			sdr_exit_xn(sdr);
-			return 0;
-		}
-
-		eventObj = sdr_list_data(sdr, elt);
-		sdr_read(sdr, (char *) &event, eventObj, sizeof(LtpEvent));
-		if (event.scheduledTime > currentTime)
-		{
-			/*	This is the first future event.		*/
-
-			sdr_exit_xn(sdr);
-			return 0;
-		}
-
-		sdr_free(sdr, eventObj);
-		sdr_list_delete(sdr, elt, NULL, NULL);
-		switch (event.type)
-		{
-		case LtpResendCheckpoint:
-			result = ltpResendCheckpoint(event.refNbr2,
-					event.refNbr3);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendXmitCancel:
-			result = ltpResendXmitCancel(event.refNbr2);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendReport:
-			result = ltpResendReport(event.refNbr1,
-					event.refNbr2, event.refNbr3);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendRecvCancel:
-			result = ltpResendRecvCancel(event.refNbr1,
-					event.refNbr2);
-			break;		/*	Out of switch.		*/
-
-		case LtpForgetSession:
-			sdr_list_delete(sdr, event.parm, NULL, NULL);
-			result = 0;
-			break;		/*	Out of switch.		*/
-
-		default:		/*	Spurious event.		*/
-			result = 0;	/*	Event is ignored.	*/
-		}
-
-		if (result < 0)		/*	Dispatching failed.	*/
-		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("failed handing LTP event", NULL);
-			return result;
-		}
+	case LtpResendCheckpoint:
+		result = ltpResendCheckpoint(event.refNbr2, event.refNbr3);
+		break;			/*	Out of switch.		*/
+
+	case LtpResendXmitCancel:
+		result = ltpResendXmitCancel(event.refNbr2);
+		break;			/*	Out of switch.		*/
+
+	case LtpResendReport:
+		result = ltpResendReport(event.refNbr1, event.refNbr2,
+				event.refNbr3);
+		break;			/*	Out of switch.		*/
+
+	case LtpResendRecvCancel:
+		result = ltpResendRecvCancel(event.refNbr1, event.refNbr2);
+		break;			/*	Out of switch.		*/
+
+	case LtpForgetSession:
+		sdr_list_delete(sdr, event.parm, NULL, NULL);
+		result = 0;
+		break;			/*	Out of switch.		*/
+
+	default:			/*	Spurious event.		*/
+		result = 0;		/*	Event is ignored.	*/
+	}
 
-		if (sdr_end_xn(sdr) < 0)
-		{
-			putErrmsg("failed dispatching LTP event", NULL);
-			return -1;
-		}
+	if (result < 0)			/*	Dispatching failed.	*/
+	{
+		putErrmsg("failed handing LTP event", NULL);
+		return -1;
 	}
+
+	return 0;
 }
 
 static int	manageLinks(Sdr sdr, time_t currentTime)
@@ -215,6 +195,22 @@ static int	manageLinks(Sdr sdr, time_t currentTime)
 	return 0;
 }
 
+static int	updateLinks(Sdr sdr, struct timeval *currentTime, void *arg)
+{
+	/*	Once per second, infer link state changes from rate
+	 *	changes noted in the shared ION database, so that
+	 *	retransmission events are dispatched as constrained
+	 *	by the new link state.					*/
+
+	if (manageLinks(sdr, currentTime->tv_sec) < 0)
+	{
+		putErrmsg("Can't manage links.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 #if defined (ION_LWT)
 int	ltpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -223,10 +219,9 @@ int	ltpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	LtpDB	*ltpConstants;
-	long	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	LtpDB		*ltpConstants;
+	long		state = 1;
 
 	if (ltpInit(0) < 0)
 	{
@@ -243,36 +238,11 @@ int	main(int argc, char *argv[])
 
 	oK(_running(&state));
 	writeMemo("[i] ltpclock is running.");
-	while (_running(NULL))
+	if (sdr_wheel_run(sdr, ltpConstants->timeline, LTP_CLOCK_BATCH,
+			getUTCTimeval, dispatchEvent, updateLinks, isRunning,
+			NULL) < 0)
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose executions times have now been reached.	*/
-
-		snooze(1);
-		currentTime = getUTCTime();
-
-		/*	Infer link state changes from rate changes
-		 *	noted in the shared ION database.		*/
-
-		if (manageLinks(sdr, currentTime) < 0)
-		{
-			putErrmsg("Can't manage links.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Then dispatch retransmission events, as
-		 *	constrained by the new link state.		*/
-
-		if (dispatchEvents(sdr, ltpConstants->timeline, currentTime)
-				< 0)
-		{
-			putErrmsg("Can't dispatch events.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
+		putErrmsg("Can't dispatch events.", NULL);
 	}
 
 	writeErrmsgMemos();
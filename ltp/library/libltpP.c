@@ -34,10 +34,55 @@
 #define	LTPDEBUG	0
 #endif
 
+#ifndef LTP_BLOCK_FILE_CACHE_SIZE
+#define	LTP_BLOCK_FILE_CACHE_SIZE	8
+#endif
+
 #define LTP_VERSION	0;
 
 /*	*	*	Helpful utility functions	*	*	*/
 
+typedef struct
+{
+	Object		fileRef;	/*	Block file reference.	*/
+	int		fd;
+} BlockFile;
+
+static BlockFile	*_blockFiles()
+{
+	static BlockFile	cache[LTP_BLOCK_FILE_CACHE_SIZE];
+	static int		initialized = 0;
+	int			i;
+
+	if (!initialized)
+	{
+		for (i = 0; i < LTP_BLOCK_FILE_CACHE_SIZE; i++)
+		{
+			cache[i].fd = -1;
+		}
+
+		initialized = 1;
+	}
+
+	return cache;
+}
+
+static void	forgetBlockFile(Object fileRef)
+{
+	BlockFile	*cache = _blockFiles();
+	int		i;
+
+	for (i = 0; i < LTP_BLOCK_FILE_CACHE_SIZE; i++)
+	{
+		if (cache[i].fileRef == fileRef && cache[i].fd >= 0)
+		{
+			close(cache[i].fd);
+			cache[i].fd = -1;
+			cache[i].fileRef = 0;
+		}
+	}
+}
+
 static Object	_ltpdbObject(Object *newDbObj)
 {
 	static Object	obj = 0;
@@ -567,7 +612,11 @@ int	ltpInit(int estMaxExportSessions)
 				LTP_MEAN_SEARCH_LENGTH);
 		ltpdbBuf.deadExports = sdr_list_create(sdr);
 		ltpdbBuf.spans = sdr_list_create(sdr);
-		ltpdbBuf.timeline = sdr_list_create(sdr);
+		ltpdbBuf.timeline = sdr_wheel_create(sdr,
+				LTP_TIMELINE_RESOLUTION);
+		ltpdbBuf.timelineIndex = sdr_hash_create(sdr,
+				sizeof(LtpEventKey), estMaxExportSessions,
+				LTP_MEAN_SEARCH_LENGTH);
 		ltpdbBuf.maxAcqInHeap = 560;
 		sdr_write(sdr, ltpdbObject, (char *) &ltpdbBuf,
 				sizeof(LtpDB));
@@ -1346,15 +1395,52 @@ int	startExportSession(Sdr sdr, Object spanObj, LtpVspan *vspan)
 
 /*	*	*	LTP event mgt and access functions	*	*/
 
+static void	loadEventKey(LtpEventKey *key, LtpEventType type,
+			uvast refNbr1, unsigned int refNbr2,
+			unsigned int refNbr3)
+{
+	memset((char *) key, 0, sizeof(LtpEventKey));
+	key->refNbr1 = refNbr1;
+	key->refNbr2 = refNbr2;
+	key->refNbr3 = refNbr3;
+	key->type = type;
+}
+
+static void	cancelEvent(LtpEventType type, uvast refNbr1,
+			unsigned int refNbr2, unsigned int refNbr3)
+{
+	Sdr		sdr = getIonsdr();
+	LtpEventKey	key;
+	Object		timelineEntry;
+
+	loadEventKey(&key, type, refNbr1, refNbr2, refNbr3);
+	if (sdr_hash_retrieve(sdr, (_ltpConstants())->timelineIndex,
+			(char *) &key, (Address *) &timelineEntry, NULL) == 1)
+	{
+		destroyLtpTimelineEvent(timelineEntry);
+	}
+}
+
 static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 {
-	Sdr	sdr = getIonsdr();
-	LtpDB	*ltpConstants = _ltpConstants();
-	Object	eventObj;
-	Object	elt;
-		OBJ_POINTER(LtpEvent, event);
+	Sdr		sdr = getIonsdr();
+	LtpDB		*ltpConstants = _ltpConstants();
+	Object		eventObj;
+	struct timeval	eventTime;
+	Object		timelineEntry;
+	LtpEventKey	key;
 
 	CHKZERO(ionLocked());
+	if (newEvent->type != LtpForgetSession)
+	{
+		/*	A timer has at most one pending event, so any
+		 *	existing event for the same timer is superseded
+		 *	by the new one.					*/
+
+		cancelEvent(newEvent->type, newEvent->refNbr1,
+				newEvent->refNbr2, newEvent->refNbr3);
+	}
+
 	eventObj = sdr_malloc(sdr, sizeof(LtpEvent));
 	if (eventObj == 0)
 	{
@@ -1362,46 +1448,56 @@ static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 		return 0;
 	}
 
-	/*	Search list from newest to oldest, insert after last
-		event with scheduled time less than or equal to that
-		of the new event.					*/
-
 	sdr_write(sdr, eventObj, (char *) newEvent, sizeof(LtpEvent));
-	for (elt = sdr_list_last(sdr, ltpConstants->timeline); elt;
-			elt = sdr_list_prev(sdr, elt))
+	eventTime.tv_sec = newEvent->scheduledTime;
+	eventTime.tv_usec = 0;
+	timelineEntry = sdr_wheel_insert(sdr, ltpConstants->timeline,
+			&eventTime, eventObj);
+	if (timelineEntry == 0)
 	{
-		GET_OBJ_POINTER(sdr, LtpEvent, event, sdr_list_data(sdr,
-				elt));
-		if (event->scheduledTime <= newEvent->scheduledTime)
+		putErrmsg("Can't insert timeline event.", NULL);
+		return 0;
+	}
+
+	/*	LtpForgetSession events are never canceled, so they
+	 *	are not indexed.					*/
+
+	if (newEvent->type != LtpForgetSession)
+	{
+		loadEventKey(&key, newEvent->type, newEvent->refNbr1,
+				newEvent->refNbr2, newEvent->refNbr3);
+		if (sdr_hash_insert(sdr, ltpConstants->timelineIndex,
+				(char *) &key, timelineEntry, NULL) < 0)
 		{
-			return sdr_list_insert_after(sdr, elt, eventObj);
+			putErrmsg("Can't index timeline event.", NULL);
+			return 0;
 		}
 	}
 
-	return sdr_list_insert_first(sdr, ltpConstants->timeline, eventObj);
+	return timelineEntry;
 }
 
-static void	cancelEvent(LtpEventType type, uvast refNbr1,
-			unsigned int refNbr2, unsigned int refNbr3)
+void	destroyLtpTimelineEvent(Object timelineEntry)
 {
-	Sdr	sdr = getIonsdr();
-	Object	elt;
-	Object	eventObj;
-		OBJ_POINTER(LtpEvent, event);
+	Sdr		sdr = getIonsdr();
+	Object		eventObj;
+	LtpEvent	event;
+	LtpEventKey	key;
+	Address		value;
 
-	for (elt = sdr_list_first(sdr, (_ltpConstants())->timeline); elt;
-			elt = sdr_list_next(sdr, elt))
+	CHKVOID(timelineEntry);
+	eventObj = sdr_wheel_data(sdr, timelineEntry);
+	sdr_read(sdr, (char *) &event, eventObj, sizeof(LtpEvent));
+	if (event.type != LtpForgetSession)
 	{
-		eventObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, LtpEvent, event, eventObj);
-		if (event->type == type && event->refNbr1 == refNbr1
-		&& event->refNbr2 == refNbr2 && event->refNbr3 == refNbr3)
-		{
-			sdr_free(sdr, eventObj);
-			sdr_list_delete(sdr, elt, NULL, NULL);
-			return;
-		}
+		loadEventKey(&key, event.type, event.refNbr1, event.refNbr2,
+				event.refNbr3);
+		oK(sdr_hash_remove(sdr, (_ltpConstants())->timelineIndex,
+				(char *) &key, &value));
 	}
+
+	sdr_free(sdr, eventObj);
+	sdr_wheel_delete(sdr, timelineEntry);
 }
 
 /*	*	*	LTP client mgt and access functions	*	*/
@@ -2112,6 +2208,7 @@ static void	stopImportSession(ImportSession *session)
 	stopVImportSession(session);
 	if (session->blockFileRef)
 	{
+		forgetBlockFile(session->blockFileRef);
 		zco_destroy_file_ref(sdr, session->blockFileRef);
 		session->blockFileRef = 0;
 	}
@@ -2717,15 +2814,12 @@ static int	serializeTrailer(LtpXmitSeg *segment, char *segmentBuffer)
 	return 0;
 }
 
-int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+static int	extractSegment(LtpVspan *vspan, Object spanObj,
+			LtpSpan *spanBuf, Object elt, char *buf, int bufLength)
 {
 	Sdr		sdr = getIonsdr();
 	LtpVdb		*ltpvdb = _ltpvdb(NULL);
 	LtpDB		*ltpConstants = _ltpConstants();
-	Object		spanObj;
-	LtpSpan		spanBuf;
-	Object		elt;
-	char		memo[64];
 	Object		segAddr;
 	LtpXmitSeg	segment;
 	int		segmentLength;
@@ -2738,46 +2832,23 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 	LtpTimer	*timer;
 	ImportSession	rsessionBuf;
 
-	CHKERR(vspan);
-	CHKERR(buf);
-	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
-	CHKERR(sdr_begin_xn(sdr));
-	spanObj = sdr_list_data(sdr, vspan->spanElt);
-	sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-	elt = sdr_list_first(sdr, spanBuf.segments);
-	while (elt == 0 || vspan->localXmitRate == 0)
-	{
-		sdr_exit_xn(sdr);
-
-		/*	Wait until ltpmeter has announced an outbound
-		 *	segment by giving span's segSemaphore.		*/
-
-		if (sm_SemTake(vspan->segSemaphore) < 0)
-		{
-			putErrmsg("LSO can't take segment semaphore.",
-					itoa(vspan->engineId));
-			return -1;
-		}
-
-		if (sm_SemEnded(vspan->segSemaphore))
-		{
-			isprintf(memo, sizeof memo,
-			"[i] LSO to engine " UVAST_FIELDSPEC " is stopped.",
-					vspan->engineId);
-			writeMemo(memo);
-			return 0;
-		}
+	/*	Runs within the caller's transaction.  Returns length
+	 *	of segment serialized into buf, 0 if the segment is
+	 *	longer than bufLength, -1 on system failure.		*/
 
-		CHKERR(sdr_begin_xn(sdr));
-		sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-		elt = sdr_list_first(sdr, spanBuf.segments);
-	}
-
-	/*	Got next outbound segment.  Remove it from the queue
-	 *	for this span.						*/
+	/*	Got next outbound segment.  If it won't fit in the
+	 *	buffer, leave it in the queue.  Otherwise remove it
+	 *	from the queue for this span.				*/
 
 	segAddr = sdr_list_data(sdr, elt);
 	sdr_stage(sdr, (char *) &segment, segAddr, sizeof(LtpXmitSeg));
+	segmentLength = segment.pdu.headerLength + segment.pdu.contentLength
+			+ segment.pdu.trailerLength;
+	if (bufLength >= 0 && segmentLength > bufLength)
+	{
+		return 0;
+	}
+
 	sdr_list_delete(sdr, elt, NULL, NULL);
 	segment.queueListElt = 0;
 
@@ -2797,19 +2868,16 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 
 	/*	Copy segment's content into buffer.			*/
 
-	segmentLength = segment.pdu.headerLength + segment.pdu.contentLength
-			+ segment.pdu.trailerLength;
 	if (segment.segmentClass == LtpDataSeg)
 	{
 		/*	Load client service data at the end of the
 		 *	segment first, before filling in the header.	*/
 
-		if (readFromExportBlock((*buf) + segment.pdu.headerLength
+		if (readFromExportBlock(buf + segment.pdu.headerLength
 				+ segment.pdu.ohdLength, segment.pdu.block,
 				segment.pdu.offset, segment.pdu.length) < 0)
 		{
 			putErrmsg("Can't read data from export block.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 	}
@@ -2862,7 +2930,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				currentTime, vspan, segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -2887,7 +2954,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				currentTime, vspan, segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -2933,7 +2999,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -2970,7 +3035,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -3000,11 +3064,10 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 			{
 				putErrmsg("Can't post XmitComplete notice.",
 						NULL);
-				sdr_cancel_xn(sdr);
 				return -1;
 			}
 
-			sdr_write(sdr, spanObj, (char *) &spanBuf,
+			sdr_write(sdr, spanObj, (char *) spanBuf,
 					sizeof(LtpSpan));
 		}
 
@@ -3052,28 +3115,28 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 	if (segment.pdu.segTypeCode < 8)
 	{
 		ltpSpanTally(vspan, OUT_SEG_POPPED, segment.pdu.length);
-		serializeDataSegment(&segment, *buf);
+		serializeDataSegment(&segment, buf);
 	}
 	else
 	{
 		switch (segment.pdu.segTypeCode)
 		{
 			case 8:		/*	Report.			*/
-				serializeReportSegment(&segment, *buf);
+				serializeReportSegment(&segment, buf);
 				break;
 
 			case 9:		/*	Report acknowledgment.	*/
-				serializeReportAckSegment(&segment, *buf);
+				serializeReportAckSegment(&segment, buf);
 				break;
 
 			case 12:	/*	Cancel by sender.	*/
 			case 14:	/*	Cancel by receiver.	*/
-				serializeCancelSegment(&segment, *buf);
+				serializeCancelSegment(&segment, buf);
 				break;
 
 			case 13:	/*	Cancel acknowledgment.	*/
 			case 15:	/*	Cancel acknowledgment.	*/
-				serializeCancelAckSegment(&segment, *buf);
+				serializeCancelAckSegment(&segment, buf);
 				break;
 
 			default:
@@ -3081,13 +3144,96 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		}
 	}
 
-	if (serializeTrailer(&segment, *buf) < 0)
+	if (serializeTrailer(&segment, buf) < 0)
 	{
 		putErrmsg("Can't serialize segment trailer.", NULL);
-		sdr_cancel_xn(sdr);
 		return -1;
 	}
 
+	return segmentLength;
+}
+
+static int	dequeueSegments(LtpVspan *vspan, char **bufs, int bufLength,
+			int *lengths, int maxSegments)
+{
+	Sdr		sdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	Object		spanObj;
+	LtpSpan		spanBuf;
+	Object		elt;
+	char		memo[64];
+	int		count = 0;
+	int		segmentLength;
+	int		i;
+
+	CHKERR(sdr_begin_xn(sdr));
+	spanObj = sdr_list_data(sdr, vspan->spanElt);
+	sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
+	elt = sdr_list_first(sdr, spanBuf.segments);
+	while (elt == 0 || vspan->localXmitRate == 0)
+	{
+		sdr_exit_xn(sdr);
+
+		/*	Wait until ltpmeter has announced an outbound
+		 *	segment by giving span's segSemaphore.		*/
+
+		if (sm_SemTake(vspan->segSemaphore) < 0)
+		{
+			putErrmsg("LSO can't take segment semaphore.",
+					itoa(vspan->engineId));
+			return -1;
+		}
+
+		if (sm_SemEnded(vspan->segSemaphore))
+		{
+			isprintf(memo, sizeof memo,
+			"[i] LSO to engine " UVAST_FIELDSPEC " is stopped.",
+					vspan->engineId);
+			writeMemo(memo);
+			return 0;
+		}
+
+		CHKERR(sdr_begin_xn(sdr));
+		sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
+		elt = sdr_list_first(sdr, spanBuf.segments);
+	}
+
+	/*	Dequeue as many of the queued segments as will fit
+	 *	in the caller's buffers, all in one transaction.	*/
+
+	while (elt && count < maxSegments)
+	{
+		segmentLength = extractSegment(vspan, spanObj, &spanBuf, elt,
+				bufs[count], bufLength);
+		if (segmentLength < 0)
+		{
+			sdr_cancel_xn(sdr);
+			return -1;
+		}
+
+		if (segmentLength == 0)
+		{
+			if (count == 0)
+			{
+				sdr_exit_xn(sdr);
+				putErrmsg("Segment is too big for LSO buffer.",
+						itoa(bufLength));
+				return -1;
+			}
+
+			break;
+		}
+
+		lengths[count] = segmentLength;
+		count++;
+
+		/*	Extraction may have revised the span, so
+		 *	re-stage it before taking the next segment.	*/
+
+		sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
+		elt = sdr_list_first(sdr, spanBuf.segments);
+	}
+
 	if (sdr_end_xn(sdr))
 	{
 		putErrmsg("Can't get outbound segment for span.", NULL);
@@ -3096,10 +3242,51 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 
 	if (ltpvdb->watching & WATCH_g)
 	{
-		iwatch('g');
+		for (i = 0; i < count; i++)
+		{
+			iwatch('g');
+		}
 	}
 
-	return segmentLength;
+	return count;
+}
+
+int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+{
+	int	segmentLength;
+
+	CHKERR(vspan);
+	CHKERR(buf);
+	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
+	switch (dequeueSegments(vspan, buf, -1, &segmentLength, 1))
+	{
+	case -1:
+		return -1;
+
+	case 0:
+		return 0;
+
+	default:
+		return segmentLength;
+	}
+}
+
+int	ltpDequeueOutboundSegments(LtpVspan *vspan, char **bufs, int bufLength,
+		int *lengths, int maxSegments)
+{
+	/*	Dequeues up to maxSegments outbound segments in a
+	 *	single transaction, serializing each one into the
+	 *	next bufLength-byte buffer in bufs and noting its
+	 *	length in lengths.  Blocks until at least one segment
+	 *	is queued.  Returns the number of segments dequeued,
+	 *	0 if the LSO has been stopped, -1 on any error.		*/
+
+	CHKERR(vspan);
+	CHKERR(bufs);
+	CHKERR(bufLength > 0);
+	CHKERR(lengths);
+	CHKERR(maxSegments > 0);
+	return dequeueSegments(vspan, bufs, bufLength, lengths, maxSegments);
 }
 
 /*	*	Control segment construction functions		*	*/
@@ -4271,22 +4458,99 @@ static int	writeBlockExtentToHeap(ImportSession *session,
 	}
 }
 
-static int	writeBlockExtentToFile(ImportSession *session,
-			LtpRecvSeg *segment, char *from, unsigned int length)
+static int	getBlockFile(ImportSession *session, struct stat *statbuf)
 {
-	Sdr	sdr = getIonsdr();
-	char	fileName[SDRSTRING_BUFSZ];
-	int	fd;
-	int	fileLength;
-	vast	extentLength = length;
+	static int	nextVictim = 0;
+	BlockFile	*cache = _blockFiles();
+	Sdr		sdr = getIonsdr();
+	char		fileName[SDRSTRING_BUFSZ];
+	BlockFile	*entry;
+	int		fd;
+	int		i;
+
+	/*	Import sessions keep their block files open for as
+	 *	long as they are cached.  A cached descriptor for a
+	 *	file that has since been unlinked -- because the file
+	 *	reference was destroyed, possibly by another task --
+	 *	is discarded and the file is re-opened by name.		*/
+
+	for (i = 0; i < LTP_BLOCK_FILE_CACHE_SIZE; i++)
+	{
+		entry = cache + i;
+		if (entry->fileRef == session->blockFileRef && entry->fd >= 0)
+		{
+			if (fstat(entry->fd, statbuf) == 0
+			&& statbuf->st_nlink > 0)
+			{
+				return entry->fd;
+			}
+
+			close(entry->fd);
+			entry->fd = -1;
+			entry->fileRef = 0;
+		}
+	}
 
 	oK(zco_file_ref_path(sdr, session->blockFileRef, fileName,
 			sizeof fileName));
-	fd = iopen(fileName, O_WRONLY, 0666);
+	fd = iopen(fileName, O_WRONLY | O_APPEND, 0666);
 	if (fd < 0)
 	{
 		if (errno == ENOENT)
 		{
+			return -2;
+		}
+
+		putSysErrmsg("Can't open block file", fileName);
+		return -1;
+	}
+
+	if (fstat(fd, statbuf) < 0)
+	{
+		putSysErrmsg("Can't get length of block file", fileName);
+		close(fd);
+		return -1;
+	}
+
+#ifdef FD_CLOEXEC
+	oK(fcntl(fd, F_SETFD, FD_CLOEXEC));
+#endif
+
+	/*	Use an empty slot if any, else replace the oldest.	*/
+
+	for (i = 0; i < LTP_BLOCK_FILE_CACHE_SIZE; i++)
+	{
+		if (cache[i].fd < 0)
+		{
+			break;
+		}
+	}
+
+	if (i == LTP_BLOCK_FILE_CACHE_SIZE)
+	{
+		i = nextVictim;
+		nextVictim = (nextVictim + 1) % LTP_BLOCK_FILE_CACHE_SIZE;
+		close(cache[i].fd);
+	}
+
+	cache[i].fileRef = session->blockFileRef;
+	cache[i].fd = fd;
+	return fd;
+}
+
+static int	writeBlockExtentToFile(ImportSession *session,
+			LtpRecvSeg *segment, char *from, unsigned int length)
+{
+	Sdr		sdr = getIonsdr();
+	int		fd;
+	struct stat	statbuf;
+	vast		fileLength;
+	vast		extentLength = length;
+
+	fd = getBlockFile(session, &statbuf);
+	switch (fd)
+	{
+	case -2:
 		/*	Note: it's possible for a session to be closed,
 		 *	causing the blockFileRef to be flagged for
 		 *	destruction, while there are still references
@@ -4307,33 +4571,32 @@ static int	writeBlockExtentToFile(ImportSession *session,
 		 *	we simply decline to record this retransmitted
 		 *	segment.					*/
 
-			return 0;
-		}
+		return 0;
 
-		putSysErrmsg("Can't open block file", fileName);
+	case -1:
+		putErrmsg("Can't get block file.", NULL);
 		return -1;
 	}
 
-	segment->acqOffset = zco_length(sdr, session->svcData);
-	fileLength = (int) lseek(fd, 0, SEEK_END);
-	if (fileLength < 0)
-	{
-		putSysErrmsg("Can't seek to end of block file", fileName);
-		close(fd);
-		return -1;
-	}
+	/*	The file is opened for appending, and all appending
+	 *	is done within transactions, so the current length
+	 *	of the file is the offset at which this extent will
+	 *	be written.						*/
 
+	segment->acqOffset = zco_length(sdr, session->svcData);
+	fileLength = statbuf.st_size;
 	if (write(fd, from, length) < 0)
 	{
-		putSysErrmsg("Can't append to block file", fileName);
-		close(fd);
+		putSysErrmsg("Can't append to block file", itoa(length));
+		forgetBlockFile(session->blockFileRef);
 		return -1;
 	}
 
-	close(fd);
-
 	/*	Pass additive inverse of length to zco_append_extent
-	 *	to indicate that space is known to be available.	*/
+	 *	to indicate that space is known to be available.  When
+	 *	this extent immediately follows the previous extent
+	 *	of the block file, zco_append_extent simply extends
+	 *	that extent.						*/
 
 	switch (zco_append_extent(sdr, session->svcData, ZcoFileSource,
 			session->blockFileRef, fileLength, 0 - extentLength))
@@ -5022,7 +5285,7 @@ static int	loadClaimsArray(char **cursor, int *bytesRemaining,
 {
 	int			i;
 	LtpReceptionClaim	*claim;
-	unsigned int		offset;
+	uvast			claimSdnvs[2];
 	unsigned int		dataEnd;
 
 	for (i = 0, claim = claims; i < claimCount; i++, claim++)
@@ -5032,9 +5295,9 @@ static int	loadClaimsArray(char **cursor, int *bytesRemaining,
 		 *	compressed to offset from report segment's
 		 *	lower bound rather than from start of block.	*/
 
-		extractSmallSdnv(&offset, cursor, bytesRemaining);
-		claim->offset = offset + lowerBound;
-		extractSmallSdnv(&(claim->length), cursor, bytesRemaining);
+		extractSdnvArray(claimSdnvs, 2, cursor, bytesRemaining);
+		claim->offset = claimSdnvs[0] + lowerBound;
+		claim->length = claimSdnvs[1];
 		if (claim->length == 0)
 		{
 			return 0;
@@ -6792,6 +7055,44 @@ int	ltpHandleInboundSegment(char *buf, int length)
 	return result;		/*	Ignore the segment.		*/
 }
 
+int	ltpHandleInboundSegments(char **bufs, int *lengths, int count)
+{
+	Sdr	sdr = getIonsdr();
+	int	i;
+
+	CHKERR(bufs);
+	CHKERR(lengths);
+
+	/*	Handling of each segment nests within this enclosing
+	 *	transaction, so the SDR is committed only once for
+	 *	the entire batch.  Segment handlers cancel their
+	 *	transactions only on system failure, so a malformed
+	 *	segment never causes the rest of the batch to be lost.	*/
+
+	CHKERR(sdr_begin_xn(sdr));
+	for (i = 0; i < count; i++)
+	{
+		if (lengths[i] <= 0)
+		{
+			continue;
+		}
+
+		if (ltpHandleInboundSegment(bufs[i], lengths[i]) < 0)
+		{
+			sdr_cancel_xn(sdr);
+			return -1;
+		}
+	}
+
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("Can't handle inbound segments.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 /*	*	*	Functions that respond to events	*	*/
 
 void	ltpStartXmit(LtpVspan *vspan)
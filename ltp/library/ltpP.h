@@ -31,6 +31,7 @@
 #include "zco.h"
 #include "ltp.h"
 #include "sdrhash.h"
+#include "sdrwheel.h"
 
 #ifndef _LTPP_H_
 #define _LTPP_H_
@@ -322,6 +323,11 @@ typedef struct
 
 /* Timeline event structure */
 
+/*	LTP event times are whole seconds, so the timeline advances
+ *	in ticks of one second.						*/
+
+#define	LTP_TIMELINE_RESOLUTION	1000
+
 typedef enum
 {
 	LtpResendCheckpoint = 1,
@@ -341,6 +347,19 @@ typedef struct
 	LtpEventType	type;
 } LtpEvent;
 
+/*	An event that may be canceled before it occurs is indexed by
+ *	its type and reference numbers.  The index key is a fixed-
+ *	length structure, so it must be zero-filled before its fields
+ *	are set.							*/
+
+typedef struct
+{
+	uvast		refNbr1;
+	unsigned int	refNbr2;
+	unsigned int	refNbr3;
+	LtpEventType	type;
+} LtpEventKey;
+
 /* Span structure characterizing the communication span between the
  * local engine and some remote engine.  Note that a single LTP span
  * might be serviced by multiple communication links, e.g., simultaneous
@@ -542,7 +561,8 @@ typedef struct
 	Object		exportSessionsHash;
 	Object		deadExports;	/*	SDR list: ExportSession	*/
 	Object		spans;		/*	SDR list: LtpSpan	*/
-	Object		timeline;	/*	SDR list: LtpEvent	*/
+	Object		timeline;	/*	SDR wheel: LtpEvent	*/
+	Object		timelineIndex;	/*	SDR hash: wheel entries	*/
 	unsigned int	maxAcqInHeap;
 	unsigned long	heapBytesReserved;
 	unsigned long	heapBytesOccupied;
@@ -637,7 +657,14 @@ extern int		getMaxReports(int redPartLength,
 				unsigned int maxSegmentSize);
 
 extern int		ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf);
+extern int		ltpDequeueOutboundSegments(LtpVspan *vspan,
+				char **bufs, int bufLength,
+				int *lengths, int maxSegments);
 extern int		ltpHandleInboundSegment(char *buf, int length);
+extern int		ltpHandleInboundSegments(char **bufs,
+				int *lengths, int count);
+
+extern void		destroyLtpTimelineEvent(Object timelineEntry);
 
 extern void		ltpStartXmit(LtpVspan *vspan);
 extern void		ltpStopXmit(LtpVspan *vspan);
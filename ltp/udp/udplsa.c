@@ -0,0 +1,65 @@
+/*
+	udplsa.c:	common functions for UDP link service
+			adapter modules.
+
+	Author: Scott Burleigh, JPL
+
+	Copyright (c) 2007, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#include "udplsa.h"
+
+int	receiveSegmentsByUDP(int linkSocket, int batchSize, char **bufs,
+		int *lengths)
+{
+	int			count;
+#ifdef UDPLSA_MMSG
+	struct mmsghdr		msgs[UDPLSA_BATCH_SIZE];
+	struct iovec		iovs[UDPLSA_BATCH_SIZE];
+	int			i;
+
+	CHKERR(batchSize > 0 && batchSize <= UDPLSA_BATCH_SIZE);
+
+	/*	Every buffer of the batch can hold any datagram, as
+	 *	the peer's segment size need not match our own.	*/
+
+	memset((char *) msgs, 0, sizeof msgs);
+	for (i = 0; i < batchSize; i++)
+	{
+		iovs[i].iov_base = bufs[i];
+		iovs[i].iov_len = UDPLSA_BUFSZ;
+		msgs[i].msg_hdr.msg_iov = iovs + i;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/*	Block until at least one datagram has arrived, then
+	 *	take all others that are already queued, up to the
+	 *	size of the batch.					*/
+
+	do
+	{
+		count = recvmmsg(linkSocket, msgs, batchSize, MSG_WAITFORONE,
+				NULL);
+	} while (count < 0 && errno == EINTR);
+
+	for (i = 0; i < count; i++)
+	{
+		lengths[i] = msgs[i].msg_len;
+	}
+#else
+	struct sockaddr_in	fromAddr;
+	socklen_t		fromSize;
+
+	do
+	{
+		fromSize = sizeof fromAddr;
+		lengths[0] = irecvfrom(linkSocket, bufs[0], UDPLSA_BUFSZ, 0,
+				(struct sockaddr *) &fromAddr, &fromSize);
+	} while (lengths[0] < 0 && errno == EINTR);
+
+	count = (lengths[0] < 0 ? -1 : 1);
+#endif
+	return count;
+}
@@ -11,6 +11,10 @@
 #ifndef _UDPLSA_H_
 #define _UDPLSA_H_
 
+#if defined(linux) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		/*	For sendmmsg and recvmmsg.	*/
+#endif
+
 #include "ltpP.h"
 #include <pthread.h>
 
@@ -21,6 +25,31 @@ extern "C" {
 #define UDPLSA_BUFSZ		((256 * 256) - 1)
 #define LtpUdpDefaultPortNbr	1113
 
+/*	Maximum number of segments sent or received, and handled
+ *	in a single SDR transaction, per system call.		*/
+
+#ifndef UDPLSA_BATCH_SIZE
+#define UDPLSA_BATCH_SIZE	16
+#endif
+
+#if defined(linux) && defined(MSG_WAITFORONE)
+#define UDPLSA_MMSG
+#endif
+
+extern int	receiveSegmentsByUDP(int linkSocket, int batchSize,
+			char **bufs, int *lengths);
+			/*	Blocks until at least one datagram
+			 *	arrives on linkSocket, then receives
+			 *	up to batchSize datagrams (at most
+			 *	one unless UDPLSA_MMSG is defined)
+			 *	into bufs, each of which must be
+			 *	UDPLSA_BUFSZ bytes long, placing
+			 *	their lengths in lengths.  Retries
+			 *	when interrupted by a signal.
+			 *
+			 *	Returns the number of datagrams
+			 *	received, -1 on system error.		*/
+
 #ifdef __cplusplus
 }
 #endif
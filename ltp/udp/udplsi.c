@@ -21,6 +21,7 @@ static void	interruptThread()
 typedef struct
 {
 	int		linkSocket;
+	int		batchSize;
 	int		running;
 } ReceiverThreadParms;
 
@@ -31,12 +32,25 @@ static void	*handleDatagrams(void *parm)
 	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
 	char			*procName = "udplsi";
 	char			*buffer;
-	int			segmentLength;
-	struct sockaddr_in	fromAddr;
-	socklen_t		fromSize;
+	char			*bufs[UDPLSA_BATCH_SIZE];
+	int			lengths[UDPLSA_BATCH_SIZE];
+	int			count;
+	int			i;
 
 	snooze(1);	/*	Let main thread become interruptable.	*/
-	buffer = MTAKE(UDPLSA_BUFSZ);
+	buffer = MTAKE(rtp->batchSize * UDPLSA_BUFSZ);
+	if (buffer == NULL && rtp->batchSize > 1)
+	{
+		/*	Too little working memory for a batch of
+		 *	full-size buffers; receive one datagram at
+		 *	a time instead.					*/
+
+		discardErrmsgs();
+		writeMemo("[i] udplsi receiving one datagram at a time.");
+		rtp->batchSize = 1;
+		buffer = MTAKE(UDPLSA_BUFSZ);
+	}
+
 	if (buffer == NULL)
 	{
 		putErrmsg("udplsi can't get UDP buffer.", NULL);
@@ -44,28 +58,41 @@ static void	*handleDatagrams(void *parm)
 		return NULL;
 	}
 
+	for (i = 0; i < rtp->batchSize; i++)
+	{
+		bufs[i] = buffer + (i * UDPLSA_BUFSZ);
+	}
+
 	/*	Can now start receiving bundles.  On failure, take
 	 *	down the LSI.						*/
 
 	while (rtp->running)
 	{	
-		fromSize = sizeof fromAddr;
-		segmentLength = irecvfrom(rtp->linkSocket, buffer, UDPLSA_BUFSZ,
-				0, (struct sockaddr *) &fromAddr, &fromSize);
-		switch (segmentLength)
+		count = receiveSegmentsByUDP(rtp->linkSocket,
+				rtp->batchSize, bufs, lengths);
+		if (count < 0)
 		{
-		case -1:
 			putSysErrmsg("Can't acquire segment", NULL);
 			ionKillMainThread(procName);
-
-			/*	Intentional fall-through to next case.	*/
-
-		case 1:				/*	Normal stop.	*/
 			rtp->running = 0;
 			continue;
 		}
 
-		if (ltpHandleInboundSegment(buffer, segmentLength) < 0)
+		/*	A 1-byte datagram is the normal stop signal;
+		 *	handle only the segments received before it.	*/
+
+		for (i = 0; i < count; i++)
+		{
+			if (lengths[i] == 1)
+			{
+				rtp->running = 0;
+				count = i;
+				break;
+			}
+		}
+
+		if (count > 0 && ltpHandleInboundSegments(bufs, lengths,
+				count) < 0)
 		{
 			putErrmsg("Can't handle inbound segment.", NULL);
 			ionKillMainThread(procName);
@@ -175,6 +202,11 @@ int	main(int argc, char *argv[])
 
 	/*	Start the receiver thread.				*/
 
+#ifdef UDPLSA_MMSG
+	rtp.batchSize = UDPLSA_BATCH_SIZE;
+#else
+	rtp.batchSize = 1;
+#endif
 	rtp.running = 1;
 	if (pthread_begin(&receiverThread, NULL, handleDatagrams, &rtp))
 	{
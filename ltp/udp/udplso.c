@@ -55,6 +55,7 @@ static void	shutDownLso()	/*	Commands LSO termination.	*/
 typedef struct
 {
 	int		linkSocket;
+	int		batchSize;
 	int		running;
 } ReceiverThreadParms;
 
@@ -64,11 +65,24 @@ static void	*handleDatagrams(void *parm)
 
 	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
 	char			*buffer;
-	int			segmentLength;
-	struct sockaddr_in	fromAddr;
-	socklen_t		fromSize;
+	char			*bufs[UDPLSA_BATCH_SIZE];
+	int			lengths[UDPLSA_BATCH_SIZE];
+	int			count;
+	int			i;
+
+	buffer = MTAKE(rtp->batchSize * UDPLSA_BUFSZ);
+	if (buffer == NULL && rtp->batchSize > 1)
+	{
+		/*	Too little working memory for a batch of
+		 *	full-size buffers; receive one datagram at
+		 *	a time instead.					*/
+
+		discardErrmsgs();
+		writeMemo("[i] udplso receiving one datagram at a time.");
+		rtp->batchSize = 1;
+		buffer = MTAKE(UDPLSA_BUFSZ);
+	}
 
-	buffer = MTAKE(UDPLSA_BUFSZ);
 	if (buffer == NULL)
 	{
 		putErrmsg("udplsi can't get UDP buffer.", NULL);
@@ -76,29 +90,39 @@ static void	*handleDatagrams(void *parm)
 		return NULL;
 	}
 
+	for (i = 0; i < rtp->batchSize; i++)
+	{
+		bufs[i] = buffer + (i * UDPLSA_BUFSZ);
+	}
+
 	/*	Can now start receiving bundles.  On failure, take
 	 *	down the LSO.						*/
 
 	iblock(SIGTERM);
 	while (rtp->running)
 	{	
-		fromSize = sizeof fromAddr;
-		segmentLength = irecvfrom(rtp->linkSocket, buffer, UDPLSA_BUFSZ,
-				0, (struct sockaddr *) &fromAddr, &fromSize);
-		switch (segmentLength)
+		count = receiveSegmentsByUDP(rtp->linkSocket,
+				rtp->batchSize, bufs, lengths);
+		if (count < 0)
 		{
-		case -1:
 			putSysErrmsg("Can't acquire segment", NULL);
 			shutDownLso();
-
-			/*	Intentional fall-through to next case.	*/
-
-		case 1:				/*	Normal stop.	*/
 			rtp->running = 0;
 			continue;
 		}
 
-		if (ltpHandleInboundSegment(buffer, segmentLength) < 0)
+		for (i = 0; i < count; i++)
+		{
+			if (lengths[i] == 1)	/*	Normal stop.	*/
+			{
+				rtp->running = 0;
+				count = i;
+				break;
+			}
+		}
+
+		if (count > 0 && ltpHandleInboundSegments(bufs, lengths,
+				count) < 0)
 		{
 			putErrmsg("Can't handle inbound segment.", NULL);
 			shutDownLso();
@@ -156,6 +180,137 @@ nbytes=%d, rv=%d, errno=%d", (char *) inet_ntoa(saddr->sin_addr),
 	}
 }
 
+static int	sendSegmentsByUDP(int linkSocket, char **bufs, int *lengths,
+			int count, struct sockaddr_in *destAddr)
+{
+	int			i;
+#ifdef UDPLSA_MMSG
+	struct mmsghdr		msgs[UDPLSA_BATCH_SIZE];
+	struct iovec		iovs[UDPLSA_BATCH_SIZE];
+	int			sent;
+
+	memset((char *) msgs, 0, sizeof msgs);
+	for (i = 0; i < count; i++)
+	{
+		iovs[i].iov_base = bufs[i];
+		iovs[i].iov_len = lengths[i];
+		msgs[i].msg_hdr.msg_name = destAddr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr);
+		msgs[i].msg_hdr.msg_iov = iovs + i;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/*	sendmmsg may send fewer than all of the datagrams;
+	 *	keep going until the entire batch has been sent.	*/
+
+	i = 0;
+	while (i < count)
+	{
+		sent = sendmmsg(linkSocket, msgs + i, count - i, 0);
+		if (sent < 0)
+		{
+			if (errno == EINTR)	/*	Interrupted.	*/
+			{
+				continue;	/*	Retry.		*/
+			}
+
+			/*	Fall back to sendto for the rest of
+			 *	the batch, for diagnosis.		*/
+
+			break;
+		}
+
+		i += sent;
+	}
+#else
+	i = 0;
+#endif
+	while (i < count)
+	{
+		if (sendSegmentByUDP(linkSocket, bufs[i], lengths[i], destAddr)
+				< lengths[i])
+		{
+			return -1;
+		}
+
+		i++;
+	}
+
+	return 0;
+}
+
+/*	Token-bucket pacing of transmission at txbps: credit (in bits)
+ *	accrues with elapsed time, up to a limit, and each datagram
+ *	sent debits it.  The LSO sleeps only when the credit is
+ *	exhausted, so the time spent dequeuing and sending segments
+ *	counts toward the transmission interval.  The limit is kept
+ *	short so that the burst sent after an idle period can't
+ *	overrun the receiving host's socket buffer.			*/
+
+#define	UDPLSO_PACING_LIMIT	(10000)	/*	Microseconds.	*/
+
+typedef struct
+{
+	unsigned int	txbps;
+	vast		credit;		/*	Bits.			*/
+	vast		limit;		/*	Bits.			*/
+	struct timeval	lastRefill;
+} Pacer;
+
+static void	initPacer(Pacer *pacer, unsigned int txbps)
+{
+	pacer->txbps = txbps;
+	pacer->credit = 0;
+	pacer->limit = ((vast) txbps * UDPLSO_PACING_LIMIT) / 1000000;
+	getCurrentTime(&pacer->lastRefill);
+}
+
+static void	pace(Pacer *pacer, int *lengths, int count)
+{
+	struct timeval	now;
+	vast		elapsed;
+	vast		usecs;
+	int		i;
+
+	getCurrentTime(&now);
+	elapsed = ((vast) (now.tv_sec - pacer->lastRefill.tv_sec) * 1000000)
+			+ (now.tv_usec - pacer->lastRefill.tv_usec);
+	pacer->lastRefill = now;
+	if (elapsed > UDPLSO_PACING_LIMIT)	/*	Idle.		*/
+	{
+		elapsed = UDPLSO_PACING_LIMIT;
+	}
+
+	if (elapsed > 0)
+	{
+		pacer->credit += (elapsed * pacer->txbps) / 1000000;
+		if (pacer->credit > pacer->limit)
+		{
+			pacer->credit = pacer->limit;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		pacer->credit -= (IPHDR_SIZE + lengths[i]) * 8;
+	}
+
+	if (pacer->credit < 0)
+	{
+		/*	Sleep off the deficit; credit then resumes
+		 *	accruing from the end of the sleep.		*/
+
+		usecs = ((-pacer->credit) * 1000000) / pacer->txbps;
+		if (usecs > 0)
+		{
+			microsnooze((unsigned int) usecs);
+		}
+
+		pacer->credit = 0;
+		getCurrentTime(&pacer->lastRefill);
+	}
+}
+
 #if defined (ION_LWT)
 int	udplso(int a1, int a2, int a3, int a4, int a5,
 	       int a6, int a7, int a8, int a9, int a10)
@@ -173,6 +328,8 @@ int	main(int argc, char *argv[])
 	Sdr			sdr;
 	LtpVspan		*vspan;
 	PsmAddress		vspanElt;
+				OBJ_POINTER(LtpSpan, span);
+	int			segmentSize;
 	unsigned short		portNbr = 0;
 	unsigned int		ipAddress = 0;
 	char			ownHostName[MAXHOSTNAMELEN];
@@ -185,12 +342,12 @@ int	main(int argc, char *argv[])
 	socklen_t		nameLength;
 	ReceiverThreadParms	rtp;
 	pthread_t		receiverThread;
-	int			segmentLength;
-	char			*segment;
-	int			bytesSent;
-	float			sleepSecPerBit = 0;
-	float			sleep_secs;
-	unsigned int		usecs;
+	char			*buffer;
+	char			*bufs[UDPLSA_BATCH_SIZE];
+	int			lengths[UDPLSA_BATCH_SIZE];
+	int			count;
+	int			i;
+	Pacer			pacer;
 	int			fd;
 	char			quit = '\0';
 
@@ -235,7 +392,14 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
+	GET_OBJ_POINTER(sdr, LtpSpan, span, sdr_list_data(sdr,
+			vspan->spanElt));
+	segmentSize = span->maxSegmentSize;
 	sdr_exit_xn(sdr);
+	if (segmentSize > UDPLSA_BUFSZ)
+	{
+		segmentSize = UDPLSA_BUFSZ;
+	}
 
 	/*	All command-line arguments are now validated.  First
 	 *	get peer's socket address.				*/
@@ -297,6 +461,26 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
+	/*	Get buffers for batches of outbound segments.		*/
+
+#ifdef UDPLSA_MMSG
+	rtp.batchSize = UDPLSA_BATCH_SIZE;
+#else
+	rtp.batchSize = 1;
+#endif
+	buffer = MTAKE(rtp.batchSize * segmentSize);
+	if (buffer == NULL)
+	{
+		closesocket(rtp.linkSocket);
+		putErrmsg("udplso can't get segment buffers.", NULL);
+		return 1;
+	}
+
+	for (i = 0; i < rtp.batchSize; i++)
+	{
+		bufs[i] = buffer + (i * segmentSize);
+	}
+
 	/*	Set up signal handling.  SIGTERM is shutdown signal.	*/
 
 	oK(udplsoSemaphore(&(vspan->segSemaphore)));
@@ -307,6 +491,7 @@ int	main(int argc, char *argv[])
 	rtp.running = 1;
 	if (pthread_begin(&receiverThread, NULL, handleDatagrams, &rtp))
 	{
+		MRELEASE(buffer);
 		closesocket(rtp.linkSocket);
 		putSysErrmsg("udplsi can't create receiver thread", NULL);
 		return 1;
@@ -326,50 +511,33 @@ int	main(int argc, char *argv[])
 
 	if (txbps)
 	{
-		sleepSecPerBit = 1.0 / txbps;
+		initPacer(&pacer, txbps);
 	}
 
 	while (rtp.running && !(sm_SemEnded(vspan->segSemaphore)))
 	{
-		segmentLength = ltpDequeueOutboundSegment(vspan, &segment);
-		if (segmentLength < 0)
+		count = ltpDequeueOutboundSegments(vspan, bufs, segmentSize,
+				lengths, rtp.batchSize);
+		if (count < 0)
 		{
 			rtp.running = 0;	/*	Terminate LSO.	*/
 			continue;
 		}
 
-		if (segmentLength == 0)		/*	Interrupted.	*/
+		if (count == 0)			/*	Interrupted.	*/
 		{
 			continue;
 		}
 
-		if (segmentLength > UDPLSA_BUFSZ)
+		if (sendSegmentsByUDP(rtp.linkSocket, bufs, lengths, count,
+				peerInetName) < 0)
 		{
-			putErrmsg("Segment is too big for UDP LSO.",
-					itoa(segmentLength));
 			rtp.running = 0;	/*	Terminate LSO.	*/
 		}
-		else
-		{
-			bytesSent = sendSegmentByUDP(rtp.linkSocket, segment,
-					segmentLength, peerInetName);
-			if (bytesSent < segmentLength)
-			{
-				rtp.running = 0;/*	Terminate LSO.	*/
-			}
 
-			if (txbps)
-			{
-				sleep_secs = sleepSecPerBit
-					* ((IPHDR_SIZE + segmentLength) * 8);
-				usecs = sleep_secs * 1000000.0;
-				if (usecs == 0)
-				{
-					usecs = 1;
-				}
-
-				microsnooze(usecs);
-			}
+		if (txbps)
+		{
+			pace(&pacer, lengths, count);
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
@@ -377,6 +545,8 @@ int	main(int argc, char *argv[])
 		sm_TaskYield();
 	}
 
+	MRELEASE(buffer);
+
 	/*	Create one-use socket for the closing quit byte.	*/
 
 	portNbr = bindInetName->sin_port;	/*	From binding.	*/
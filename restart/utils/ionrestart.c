@@ -32,6 +32,7 @@
 
 extern void	ionDropVdb();
 extern void	ionRaiseVdb();
+extern void	ipnDropVdb();
 
 static void	restartION(Sdr sdrv, char *utaCmd)
 {
@@ -172,6 +173,8 @@ static void	restartION(Sdr sdrv, char *utaCmd)
 	{
 		bpDropVdb();
 		writeMemo("[i] ionrestart: BP volatile database dropped.");
+		ipnDropVdb();
+		writeMemo("[i] ionrestart: IPN volatile database dropped.");
 	}
 
 	if (restart_ltp)
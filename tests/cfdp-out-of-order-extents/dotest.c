@@ -0,0 +1,282 @@
+/* Test for CFDP reception of out-of-order file data.
+ * Delivers file data PDUs out of order, overlapping, adjacent,
+ * and duplicated, checking after every PDU that the extents
+ * reported by cfdp_map are exactly the runs of data delivered
+ * so far.  Then delivers the EOF PDU and checks that the
+ * received file is identical to the file data.		*/
+
+#include <cfdpP.h>
+#include <stdlib.h>
+#include "check.h"
+#include "testutil.h"
+
+#define	FILE_SIZE		(10000)
+#define	MAX_EXTENTS		(FILE_SIZE / 2)
+#define	SOURCE_ENTITY_NBR	(2)
+#define	OWN_ENTITY_NBR		(1)
+#define	TRANSACTION_NBR		(1)
+
+static unsigned char	fileData[FILE_SIZE];
+static unsigned char	received[FILE_SIZE];
+static CfdpExtent	extents[MAX_EXTENTS];
+
+static int	buildHeader(unsigned char *pdu, int pduIsFileData,
+			int dataFieldLength)
+{
+	pdu[0] = (pduIsFileData << 4)	/*	Version 1.		*/
+			| 0x04;		/*	Unacknowledged.		*/
+	pdu[1] = (dataFieldLength >> 8) & 0xff;
+	pdu[2] = dataFieldLength & 0xff;
+	pdu[3] = 0x00;			/*	1-byte numbers.		*/
+	pdu[4] = SOURCE_ENTITY_NBR;
+	pdu[5] = TRANSACTION_NBR;
+	pdu[6] = OWN_ENTITY_NBR;
+	return 7;
+}
+
+static void	putNumber(unsigned char *cursor, unsigned int value)
+{
+	cursor[0] = (value >> 24) & 0xff;
+	cursor[1] = (value >> 16) & 0xff;
+	cursor[2] = (value >> 8) & 0xff;
+	cursor[3] = value & 0xff;
+}
+
+static void	deliver(unsigned char *pdu, int length)
+{
+	fail_unless(cfdpHandleInboundPdu(pdu, length) >= 0);
+}
+
+static void	sendMetadata(char *destFileName)
+{
+	unsigned char	pdu[300];
+	int		hdrLength;
+	int		nameLength = strlen(destFileName);
+	unsigned char	*cursor;
+
+	hdrLength = buildHeader(pdu, 0, 8 + nameLength);
+	cursor = pdu + hdrLength;
+	*cursor++ = 7;			/*	Metadata directive.	*/
+	*cursor++ = 0;			/*	No closure requested.	*/
+	putNumber(cursor, FILE_SIZE);
+	cursor += 4;
+	*cursor++ = 0;			/*	Source file name.	*/
+	*cursor++ = nameLength;
+	memcpy(cursor, destFileName, nameLength);
+	cursor += nameLength;
+	deliver(pdu, cursor - pdu);
+}
+
+static void	sendEof()
+{
+	unsigned char	pdu[32];
+	int		hdrLength;
+	unsigned char	*cursor;
+	uvast		offset = 0;
+	unsigned int	checksum = 0;
+
+	cfdp_update_checksum_buffer(fileData, FILE_SIZE, &offset, &checksum,
+			ModularChecksum);
+	hdrLength = buildHeader(pdu, 0, 10);
+	cursor = pdu + hdrLength;
+	*cursor++ = 4;			/*	EOF directive.		*/
+	*cursor++ = 0;			/*	No error, modular.	*/
+	putNumber(cursor, checksum);
+	cursor += 4;
+	putNumber(cursor, FILE_SIZE);
+	cursor += 4;
+	deliver(pdu, cursor - pdu);
+}
+
+static void	checkExtents(CfdpTransactionId *id)
+{
+	unsigned int	extentCount = MAX_EXTENTS;
+	unsigned int	i = 0;
+	unsigned int	offset = 0;
+	unsigned int	end;
+
+	fail_unless(cfdp_map(id, &extentCount, extents) == 0);
+	while (offset < FILE_SIZE)
+	{
+		if (!received[offset])
+		{
+			offset++;
+			continue;
+		}
+
+		for (end = offset; end < FILE_SIZE && received[end]; end++);
+		fail_unless(i < extentCount, "Extent at %u not mapped.",
+				offset);
+		if (i >= extentCount)
+		{
+			return;
+		}
+
+		fail_unless(extents[i].offset == offset
+				&& extents[i].length == end - offset,
+				"Extent %u is " UVAST_FIELDSPEC "+%u, expected \
+%u+%u.", i,
+				extents[i].offset, extents[i].length,
+				offset, end - offset);
+		i++;
+		offset = end;
+	}
+
+	fail_unless(i == extentCount, "%u extents mapped, expected %u.",
+			extentCount, i);
+}
+
+static void	sendFileData(CfdpTransactionId *id, unsigned int offset,
+			unsigned int length)
+{
+	unsigned char	pdu[FILE_SIZE + 32];
+	int		hdrLength;
+
+	if (offset + length > FILE_SIZE)
+	{
+		length = FILE_SIZE - offset;
+	}
+
+	hdrLength = buildHeader(pdu, 1, 4 + length);
+	putNumber(pdu + hdrLength, offset);
+	memcpy(pdu + hdrLength + 4, fileData + offset, length);
+	deliver(pdu, hdrLength + 4 + length);
+	memset(received + offset, 1, length);
+	checkExtents(id);
+}
+
+static int	checkReceivedFile(char *fileName)
+{
+	FILE		*file;
+	unsigned char	buffer[FILE_SIZE + 1];
+	size_t		length;
+
+	file = fopen(fileName, "rb");
+	if (file == NULL)
+	{
+		printf("Received file %s not found.\n", fileName);
+		return 0;
+	}
+
+	length = fread(buffer, 1, sizeof buffer, file);
+	fclose(file);
+	if (length != FILE_SIZE || memcmp(buffer, fileData, FILE_SIZE) != 0)
+	{
+		printf("Received file differs from file data.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	char			cwd[256];
+	char			destFileName[256];
+	CfdpTransactionId	id;
+	unsigned int		offsets[FILE_SIZE / 100];
+	unsigned int		count = FILE_SIZE / 100;
+	unsigned int		i;
+	unsigned int		j;
+	unsigned int		temp;
+	int			fileOkay;
+
+	failure_mode = CONTINUE_ON_FAIL;	/* So ION is stopped.	*/
+	srand(1);
+	for (i = 0; i < FILE_SIZE; i++)
+	{
+		fileData[i] = rand() & 0xff;
+	}
+
+	fail_unless(getcwd(cwd, sizeof cwd) != NULL);
+	isprintf(destFileName, sizeof destFileName, "%.200s/rcvfile", cwd);
+	memset((char *) &id, 0, sizeof(CfdpTransactionId));
+	cfdp_compress_number(&id.sourceEntityNbr, SOURCE_ENTITY_NBR);
+	cfdp_compress_number(&id.transactionNbr, TRANSACTION_NBR);
+
+	/* Start ION */
+	printf("Starting ION...\n");
+	_xadmin("ionadmin", "", "cfdp.ipn.bp.ltp.udp/config.ionrc");
+	_xadmin("ltpadmin", "", "cfdp.ipn.bp.ltp.udp/config.ltprc");
+	_xadmin("bpadmin", "", "cfdp.ipn.bp.ltp.udp/config.bprc");
+	_xadmin("ipnadmin", "", "cfdp.ipn.bp.ltp.udp/config.ipnrc");
+	_xadmin("cfdpadmin", "", "cfdp.ipn.bp.ltp.udp/config.cfdprc");
+
+	/* Attach to CFDP */
+	fail_unless(cfdp_attach() >= 0);
+
+	printf("Delivering metadata...\n");
+	sendMetadata(destFileName);
+
+	/* Every other 100-byte segment, last first: 50 extents. */
+	printf("Delivering alternate segments in reverse order...\n");
+	for (i = FILE_SIZE - 200; ; i -= 200)
+	{
+		sendFileData(&id, i, 100);
+		if (i == 0) break;
+	}
+
+	/* Duplicates of received segments change nothing. */
+	printf("Delivering duplicate segments...\n");
+	sendFileData(&id, 4000, 100);
+	sendFileData(&id, 0, 100);
+	sendFileData(&id, FILE_SIZE - 200, 100);
+	sendFileData(&id, 3400, 50);
+
+	/* Overlapping, subsuming, and adjacent segments. */
+	printf("Delivering overlapping segments...\n");
+	sendFileData(&id, 150, 350);	/* New extent, subsumes two.	*/
+	sendFileData(&id, 2050, 200);	/* Extends one, subsumes one.	*/
+	sendFileData(&id, 3000, 4100);	/* Subsumes many.		*/
+	sendFileData(&id, 7100, 100);	/* Bridges two exactly.		*/
+	sendFileData(&id, 3500, 100);	/* Entirely old data.		*/
+	sendFileData(&id, FILE_SIZE - 100, 100);	/* Tail.	*/
+
+	/* Fill all gaps, in shuffled order, with overlapping data. */
+	printf("Delivering remaining segments in shuffled order...\n");
+	for (i = 0; i < count; i++)
+	{
+		offsets[i] = i * 100;
+	}
+
+	for (i = count - 1; i > 0; i--)
+	{
+		j = rand() % (i + 1);
+		temp = offsets[i];
+		offsets[i] = offsets[j];
+		offsets[j] = temp;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		sendFileData(&id, offsets[i], 300);
+	}
+
+	fail_unless(extents[0].offset == 0 && extents[0].length == FILE_SIZE);
+
+	printf("Delivering EOF...\n");
+	sendEof();
+	snooze(1);
+	fileOkay = checkReceivedFile(destFileName);
+
+	/* Stop ION */
+	printf("Stopping ION...\n");
+	writeErrmsgMemos();
+	cfdp_detach();
+	_xadmin("cfdpadmin", "", ".");
+	ionstop();
+
+	if (check_summary(argv[0]) == 1)
+	{
+		return 1;
+	}
+
+	if (!fileOkay)
+	{
+		printf("FAILURE!\n");
+		return 1;
+	}
+
+	printf("Received file matches file data. SUCCESS!\n");
+	return 0;
+}
@@ -0,0 +1,465 @@
+/* Test for SDR timing wheels.
+ * Inserts entries at the boundaries of every level of a wheel
+ * and at random times spanning all levels and the overflow
+ * slot, deletes some of them, and then advances the wheel's
+ * clock both from one sdr_wheel_next_time() to the next and
+ * in coarse steps, checking that every remaining entry is
+ * reported once, never before its expiration time and never
+ * later than the first time at or after its expiration time
+ * for which sdr_wheel_due() is called.  Also checks rounding
+ * of expiration times to the wheel's resolution, the effect
+ * of a clock that is set back, traversal, and destruction.	*/
+
+#include <ion.h>
+#include <sdrwheel.h>
+#include <stdlib.h>
+#include "check.h"
+#include "testutil.h"
+
+#define	RANDOM_ENTRIES		(1000)
+#define	MAX_ENTRIES		(RANDOM_ENTRIES + 32)
+#define	COARSE_ENTRIES		(500)
+#define	DESTROY_ENTRIES		(100)
+#define	LEVEL_SPAN(level)	((uvast) 1 << (6 * ((level) + 1)))
+
+typedef struct
+{
+	Object	entry;
+	uvast	time;		/*	milliseconds			*/
+	int	deleted;
+	int	reportCount;
+} Expected;
+
+static Sdr		sdr;
+static Expected		expected[MAX_ENTRIES];
+static int		entryCount;
+static uvast		baseTime;
+static int		destroyCount;
+
+static void	toTimeval(uvast ms, struct timeval *time)
+{
+	time->tv_sec = ms / 1000;
+	time->tv_usec = (ms % 1000) * 1000;
+}
+
+static uvast	toMs(struct timeval *time)
+{
+	return ((uvast) time->tv_sec * 1000) + (time->tv_usec / 1000);
+}
+
+static void	pinWheel(Object wheel, uvast ms)
+{
+	struct timeval	time;
+
+	/*	Advancing an empty wheel moves its cursor directly to
+	 *	the indicated time, so that all deltas are exact.	*/
+
+	toTimeval(ms, &time);
+	oK(sdr_begin_xn(sdr));
+	fail_unless(sdr_wheel_due(sdr, wheel, &time) == 0);
+	fail_unless(sdr_end_xn(sdr) == 0);
+}
+
+static void	addEntry(Object wheel, uvast delta)
+{
+	struct timeval	time;
+	Expected	*exp;
+
+	exp = expected + entryCount;
+	exp->time = baseTime + delta;
+	exp->deleted = 0;
+	exp->reportCount = 0;
+	toTimeval(exp->time, &time);
+	exp->entry = sdr_wheel_insert(sdr, wheel, &time,
+			(Address) (entryCount + 1));
+	fail_unless(exp->entry != 0, "Insertion failed.");
+	entryCount++;
+}
+
+static uvast	randomDelta()
+{
+	int	level = rand() % (SDR_WHEEL_LEVELS + 1);
+
+	if (level < SDR_WHEEL_LEVELS)
+	{
+		return ((uvast) rand()) % LEVEL_SPAN(level);
+	}
+
+	/*	Beyond the span of the highest level: overflow.		*/
+
+	return LEVEL_SPAN(SDR_WHEEL_LEVELS - 1)
+		+ (((uvast) rand()) % (3 * LEVEL_SPAN(SDR_WHEEL_LEVELS - 1)));
+}
+
+static unsigned long	wheelLength(Object wheel)
+{
+	unsigned long	length;
+
+	oK(sdr_begin_xn(sdr));
+	length = sdr_wheel_length(sdr, wheel);
+	sdr_exit_xn(sdr);
+	return length;
+}
+
+static uvast	earliestRemaining()
+{
+	uvast	earliest = (uvast) -1;
+	int	i;
+
+	for (i = 0; i < entryCount; i++)
+	{
+		if (!expected[i].deleted && expected[i].reportCount == 0
+		&& expected[i].time < earliest)
+		{
+			earliest = expected[i].time;
+		}
+	}
+
+	return earliest;
+}
+
+/*	Reports all entries that are due at "now", checking each.	*/
+
+static int	drain(Object wheel, uvast now, uvast previous)
+{
+	struct timeval	time;
+	Object		entry;
+	int		i;
+	int		reported = 0;
+
+	toTimeval(now, &time);
+	oK(sdr_begin_xn(sdr));
+	while ((entry = sdr_wheel_due(sdr, wheel, &time)) != 0)
+	{
+		i = sdr_wheel_data(sdr, entry) - 1;
+		fail_unless(i >= 0 && i < entryCount, "Unknown entry reported.");
+		if (i < 0 || i >= entryCount)
+		{
+			break;
+		}
+
+		fail_unless(entry == expected[i].entry,
+				"Entry %d reported by another handle.", i);
+		fail_unless(!expected[i].deleted, "Deleted entry %d reported.",
+				i);
+		fail_unless(expected[i].reportCount == 0,
+				"Entry %d reported twice.", i);
+		fail_unless(expected[i].time <= now,
+				"Entry %d reported early.", i);
+		fail_unless(expected[i].time > previous,
+				"Entry %d reported late.", i);
+		expected[i].reportCount++;
+		sdr_wheel_delete(sdr, entry);
+		reported++;
+	}
+
+	fail_unless(sdr_end_xn(sdr) == 0);
+	return reported;
+}
+
+static void	checkAllReported(Object wheel)
+{
+	int	i;
+
+	for (i = 0; i < entryCount; i++)
+	{
+		if (expected[i].deleted)
+		{
+			continue;
+		}
+
+		fail_unless(expected[i].reportCount == 1,
+				"Entry %d (+" UVAST_FIELDSPEC " ms) never reported.",
+				i, expected[i].time - baseTime);
+	}
+
+	fail_unless(wheelLength(wheel) == 0);
+}
+
+static void	testPlacementAndCascade()
+{
+	static uvast	boundaries[] = { 0, 1, 63, 64, 65, 4095, 4096,
+				262143, 262144, 16777215, 16777216,
+				16777217, 3 * 16777216 + 5 };
+	int		boundaryCount = sizeof boundaries / sizeof(uvast);
+	Object		wheel;
+	Object		entry;
+	int		i;
+	int		count;
+	struct timeval	time;
+	uvast		now;
+	uvast		previous;
+
+	printf("Checking placement, cascade, and overflow...\n");
+	oK(sdr_begin_xn(sdr));
+	wheel = sdr_wheel_create(sdr, 1);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(wheel != 0);
+	pinWheel(wheel, baseTime);
+	entryCount = 0;
+	oK(sdr_begin_xn(sdr));
+	for (i = 0; i < boundaryCount; i++)
+	{
+		addEntry(wheel, boundaries[i]);
+	}
+
+	for (i = 0; i < RANDOM_ENTRIES; i++)
+	{
+		addEntry(wheel, randomDelta());
+	}
+
+	for (i = 0; i < entryCount; i += 7)
+	{
+		sdr_wheel_delete(sdr, expected[i].entry);
+		expected[i].deleted = 1;
+	}
+
+	fail_unless(sdr_end_xn(sdr) == 0);
+
+	/*	Traversal visits each remaining entry once.		*/
+
+	count = 0;
+	oK(sdr_begin_xn(sdr));
+	for (entry = sdr_wheel_first(sdr, wheel); entry;
+			entry = sdr_wheel_next(sdr, entry))
+	{
+		i = sdr_wheel_data(sdr, entry) - 1;
+		fail_unless(!expected[i].deleted);
+		expected[i].reportCount++;
+		count++;
+	}
+
+	fail_unless(count == sdr_wheel_length(sdr, wheel));
+	sdr_exit_xn(sdr);
+	for (i = 0; i < entryCount; i++)
+	{
+		fail_unless(expected[i].reportCount == !expected[i].deleted,
+				"Entry %d traversed %d times.", i,
+				expected[i].reportCount);
+		expected[i].reportCount = 0;
+	}
+
+	/*	Sleeping until each next time, as a clock daemon does,
+	 *	reports each entry exactly at its expiration time.	*/
+
+	previous = baseTime - 1;
+	while (1)
+	{
+		oK(sdr_begin_xn(sdr));
+		i = sdr_wheel_next_time(sdr, wheel, &time);
+		sdr_exit_xn(sdr);
+		if (i == 0)
+		{
+			break;
+		}
+
+		/*	Once all entries due at one time have been
+		 *	reported, the next time is strictly later.	*/
+
+		fail_unless(i == 1);
+		now = toMs(&time);
+		fail_unless(now <= earliestRemaining(),
+				"Next time is later than earliest entry.");
+		fail_unless(now > previous, "Next time did not advance.");
+		if (i != 1 || now > earliestRemaining() || now <= previous)
+		{
+			break;
+		}
+
+		drain(wheel, now, now - 1);
+		previous = now;
+	}
+
+	checkAllReported(wheel);
+	oK(sdr_begin_xn(sdr));
+	sdr_wheel_destroy(sdr, wheel, NULL, NULL);
+	fail_unless(sdr_end_xn(sdr) == 0);
+}
+
+static void	testCoarseSteps()
+{
+	Object		wheel;
+	int		i;
+	uvast		now;
+	uvast		previous;
+	struct timeval	time;
+
+	printf("Checking coarse advancement...\n");
+	oK(sdr_begin_xn(sdr));
+	wheel = sdr_wheel_create(sdr, 1);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(wheel != 0);
+	pinWheel(wheel, baseTime);
+	entryCount = 0;
+	oK(sdr_begin_xn(sdr));
+	for (i = 0; i < COARSE_ENTRIES; i++)
+	{
+		addEntry(wheel, 1 + (((uvast) rand()) % LEVEL_SPAN(2)));
+	}
+
+	fail_unless(sdr_end_xn(sdr) == 0);
+	previous = baseTime;
+	while (wheelLength(wheel) > 0 && previous <= baseTime + LEVEL_SPAN(2))
+	{
+		now = previous + 1 + (rand() % 50000);
+		drain(wheel, now, previous);
+
+		/*	Nothing remains due.				*/
+
+		oK(sdr_begin_xn(sdr));
+		i = sdr_wheel_next_time(sdr, wheel, &time);
+		sdr_exit_xn(sdr);
+		fail_unless(i == 0 || toMs(&time) > now,
+				"Entry left unreported at " UVAST_FIELDSPEC ".",
+				now - baseTime);
+		previous = now;
+	}
+
+	checkAllReported(wheel);
+	oK(sdr_begin_xn(sdr));
+	sdr_wheel_destroy(sdr, wheel, NULL, NULL);
+	fail_unless(sdr_end_xn(sdr) == 0);
+}
+
+static void	testClockSetBack()
+{
+	Object		wheel;
+	struct timeval	time;
+
+	printf("Checking clock set back...\n");
+	oK(sdr_begin_xn(sdr));
+	wheel = sdr_wheel_create(sdr, 1);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(wheel != 0);
+	pinWheel(wheel, baseTime);
+	entryCount = 0;
+	oK(sdr_begin_xn(sdr));
+	addEntry(wheel, 10);
+	toTimeval(baseTime - 5000, &time);
+	expected[entryCount].time = baseTime - 5000;
+	expected[entryCount].entry = sdr_wheel_insert(sdr, wheel, &time,
+			(Address) (entryCount + 1));
+	expected[entryCount].deleted = 0;
+	expected[entryCount].reportCount = 0;
+	entryCount++;
+	fail_unless(sdr_end_xn(sdr) == 0);
+
+	/*	Only the entry that was already due at insertion can
+	 *	be reported, and only once its time is reached.		*/
+
+	oK(sdr_begin_xn(sdr));
+	fail_unless(sdr_wheel_next_time(sdr, wheel, &time) == 1);
+	fail_unless(toMs(&time) == baseTime - 5000);
+	sdr_exit_xn(sdr);
+	fail_unless(drain(wheel, baseTime - 6000, 0) == 0);
+	fail_unless(drain(wheel, baseTime - 5000, 0) == 1);
+	fail_unless(expected[1].reportCount == 1);
+	fail_unless(drain(wheel, baseTime - 1, 0) == 0);
+	fail_unless(drain(wheel, baseTime + 9, 0) == 0);
+	fail_unless(drain(wheel, baseTime + 10, 0) == 1);
+	checkAllReported(wheel);
+	oK(sdr_begin_xn(sdr));
+	sdr_wheel_destroy(sdr, wheel, NULL, NULL);
+	fail_unless(sdr_end_xn(sdr) == 0);
+}
+
+static void	testResolution()
+{
+	Object		wheel;
+	struct timeval	time;
+
+	printf("Checking resolution...\n");
+	oK(sdr_begin_xn(sdr));
+	wheel = sdr_wheel_create(sdr, 10);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(wheel != 0);
+	pinWheel(wheel, baseTime);
+	entryCount = 0;
+	oK(sdr_begin_xn(sdr));
+	addEntry(wheel, 15);
+	fail_unless(sdr_end_xn(sdr) == 0);
+
+	/*	Expiration time is rounded up to the next tick.		*/
+
+	oK(sdr_begin_xn(sdr));
+	sdr_wheel_time(sdr, expected[0].entry, &time);
+	fail_unless(toMs(&time) == baseTime + 20);
+	fail_unless(sdr_wheel_next_time(sdr, wheel, &time) == 1);
+	fail_unless(toMs(&time) <= baseTime + 20);
+	sdr_exit_xn(sdr);
+	fail_unless(drain(wheel, baseTime + 19, 0) == 0);
+	fail_unless(drain(wheel, baseTime + 20, 0) == 1);
+	checkAllReported(wheel);
+	oK(sdr_begin_xn(sdr));
+	sdr_wheel_destroy(sdr, wheel, NULL, NULL);
+	fail_unless(sdr_end_xn(sdr) == 0);
+}
+
+static void	countDestroyed(Sdr sdrv, Object entry, Address data, void *arg)
+{
+	int	*marks = (int *) arg;
+
+	marks[data - 1]++;
+	destroyCount++;
+}
+
+static void	testDestroy()
+{
+	Object	wheel;
+	int	marks[DESTROY_ENTRIES];
+	int	i;
+
+	printf("Checking destruction...\n");
+	memset((char *) marks, 0, sizeof marks);
+	oK(sdr_begin_xn(sdr));
+	wheel = sdr_wheel_create(sdr, 1);
+	fail_unless(wheel != 0);
+	entryCount = 0;
+	for (i = 0; i < DESTROY_ENTRIES; i++)
+	{
+		addEntry(wheel, randomDelta());
+	}
+
+	destroyCount = 0;
+	sdr_wheel_destroy(sdr, wheel, countDestroyed, marks);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(destroyCount == DESTROY_ENTRIES);
+	for (i = 0; i < DESTROY_ENTRIES; i++)
+	{
+		fail_unless(marks[i] == 1, "Entry %d destroyed %d times.", i,
+				marks[i]);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	struct timeval	now;
+
+	failure_mode = CONTINUE_ON_FAIL;	/* So ION is stopped.	*/
+	srand(1);
+
+	/* Start ION */
+	printf("Starting ION...\n");
+	_xadmin("ionadmin", "", "config.ionrc");
+	fail_unless(ionAttach() >= 0);
+	sdr = getIonsdr();
+
+	/*	All wheels are pinned at a time later than their
+	 *	creation, on a whole second.				*/
+
+	getCurrentTime(&now);
+	baseTime = ((uvast) now.tv_sec + 10) * 1000;
+	testPlacementAndCascade();
+	testCoarseSteps();
+	testClockSetBack();
+	testResolution();
+	testDestroy();
+
+	/* Stop ION */
+	printf("Stopping ION...\n");
+	writeErrmsgMemos();
+	ionDetach();
+	ionstop();
+
+	CHECK_FINISH;
+}